@@ -0,0 +1,238 @@
+/**************************************************************************//**
+*
+* \file        Arena.c
+*
+* \defgroup    Arena        Scratch memory for solvers
+*
+* \details     Solver workspaces (the tabu list, and later DP bitsets or
+*              population buffers) live for exactly one solve. Getting them
+*              from malloc every time fragments the heap, and large ones
+*              come back from the kernel as fresh pages that fault in again
+*              on every solve.
+*
+*              An arena instead reserves one range of address space up
+*              front. Memory is only committed as it is first touched, so a
+*              generous reserve costs nothing. Allocation bumps an offset,
+*              Arena_Reset sets it back to zero in O(1) and the next solve
+*              reuses the same, already faulted in pages. The range is
+*              aligned to, and past its first 2 MB advised as, transparent
+*              huge pages so large workspaces need few TLB entries.
+*
+*              Subset_Sum_Solve resets the arena of the problem it solves,
+*              see Subset_Sum_SetArena. In batch mode every pool thread has
+*              its own arena, reused for all the instances it solves.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Modules
+
+#include "Arena.h"
+
+/**************************************************************************//**
+*
+* \defgroup    Arena Initialization   Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Arena_Init
+*
+* \brief       Reserve address space for an arena
+*
+* \details     Rounded up to whole huge pages. Nothing is committed until
+*              it is used.
+*
+* \param[in]   zptArena             Arena
+* \param[in]   zulReserve           Most the arena can hand out between
+*                                   resets, bytes
+*
+* \retval      bool                 false if the range could not be mapped
+*
+******************************************************************************/
+
+bool Arena_Init (Arena_t * zptArena, size_t zulReserve)
+{
+    uint8_t * xpucMap;
+    uint8_t * xpucBase;
+    size_t xulHead;
+
+    memset(zptArena, 0, sizeof(Arena_t));
+
+    zulReserve = (zulReserve + ARENA_HUGE_PAGE - 1u) &
+                                            ~(size_t)(ARENA_HUGE_PAGE - 1u);
+
+    // Map one huge page extra and trim it off so the base is aligned
+
+    xpucMap = (uint8_t *)mmap(NULL, zulReserve + ARENA_HUGE_PAGE,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (xpucMap == (uint8_t *)MAP_FAILED)
+    {
+        perror("Arena_Init");
+
+        return false;
+    }
+
+    xpucBase = (uint8_t *)(((uintptr_t)xpucMap + ARENA_HUGE_PAGE - 1u) &
+                                        ~(uintptr_t)(ARENA_HUGE_PAGE - 1u));
+    xulHead = (size_t)(xpucBase - xpucMap);
+
+    if (xulHead > 0u)
+    {
+        munmap(xpucMap, xulHead);
+    }
+
+    if (xulHead < ARENA_HUGE_PAGE)
+    {
+        munmap(xpucBase + zulReserve, ARENA_HUGE_PAGE - xulHead);
+    }
+
+    // Huge pages only past the first one. A small workspace would otherwise
+    // pay for clearing a whole 2 MB page on its first touch.
+
+#ifdef MADV_HUGEPAGE
+    if (zulReserve > ARENA_HUGE_PAGE)
+    {
+        madvise(xpucBase + ARENA_HUGE_PAGE, zulReserve - ARENA_HUGE_PAGE,
+                                                            MADV_HUGEPAGE);
+    }
+#endif
+
+    zptArena->spucBase = xpucBase;
+    zptArena->sulSize = zulReserve;
+
+    return true;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Arena Control          Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Arena_Alloc
+*
+* \brief       Take memory from an arena
+*
+* \details     The memory is not cleared, it may still hold whatever the
+*              last solve left there. It stays valid until the next reset.
+*
+* \param[in]   zptArena             Arena
+* \param[in]   zulBytes             Size
+* \param[in]   zulAlign             Alignment, a power of two up to
+*                                   ARENA_HUGE_PAGE, e.g. ARENA_CACHE_LINE
+*
+* \retval      void *               NULL if the reserve is used up
+*
+******************************************************************************/
+
+void * Arena_Alloc (Arena_t * zptArena, size_t zulBytes, size_t zulAlign)
+{
+    size_t xulStart = (zptArena->sulUsed + zulAlign - 1u) & ~(zulAlign - 1u);
+
+    if ((zptArena->spucBase == NULL) || (xulStart > zptArena->sulSize) ||
+        (zulBytes > (zptArena->sulSize - xulStart)))
+    {
+        return NULL;
+    }
+
+    zptArena->sulUsed = xulStart + zulBytes;
+
+    if (zptArena->sulUsed > zptArena->sulPeak)
+    {
+        zptArena->sulPeak = zptArena->sulUsed;
+    }
+
+    return &zptArena->spucBase[xulStart];
+}
+
+/**************************************************************************//**
+*
+* \anchor      Arena_Reset
+*
+* \brief       Give back everything allocated from an arena
+*
+* \param[in]   zptArena             Arena
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Arena_Reset (Arena_t * zptArena)
+{
+    zptArena->sulUsed = 0u;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Arena_Peak
+*
+* \brief       Most memory an arena had handed out at once
+*
+* \param[in]   zptArena             Arena
+*
+* \retval      size_t               Bytes, including alignment padding
+*
+******************************************************************************/
+
+size_t Arena_Peak (const Arena_t * zptArena)
+{
+    return zptArena->sulPeak;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Arena Cleanup          Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Arena_Free
+*
+* \brief       Unmap an arena
+*
+* \param[in]   zptArena             Arena
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Arena_Free (Arena_t * zptArena)
+{
+    if (zptArena->spucBase != NULL)
+    {
+        munmap(zptArena->spucBase, zptArena->sulSize);
+    }
+
+    memset(zptArena, 0, sizeof(Arena_t));
+}
+
+// \}
+
+// \}
@@ -0,0 +1,57 @@
+/**************************************************************************//**
+*
+* \file        Arena.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _ARENA_H
+#define _ARENA_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// ***** Definitions **********************************************************
+
+//! Alignments for Arena_Alloc. Anything up to ARENA_HUGE_PAGE works, as long
+//! as it is a power of two.
+
+#define ARENA_CACHE_LINE        64u
+#define ARENA_HUGE_PAGE         (2u << 20)
+
+//! Scratch memory of one solver at a time. Allocations only move a pointer
+//! and are all given back at once by Arena_Reset. The pages stay mapped, so
+//! the next solve reuses them without faulting them in again. Not thread
+//! safe, give every thread its own.
+
+typedef struct Arena_s
+{
+    uint8_t * spucBase;         // ARENA_HUGE_PAGE aligned, NULL if not set up
+    size_t sulSize;             // Reserved bytes
+    size_t sulUsed;             // Bytes handed out since the last reset
+    size_t sulPeak;             // Most ever in use at once
+} Arena_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Arena_Init (Arena_t * zptArena, size_t zulReserve);
+
+// Control functions
+
+void * Arena_Alloc (Arena_t * zptArena, size_t zulBytes, size_t zulAlign);
+void Arena_Reset (Arena_t * zptArena);
+size_t Arena_Peak (const Arena_t * zptArena);
+
+// Cleanup functions
+
+void Arena_Free (Arena_t * zptArena);
+
+#endif // !defined _ARENA_H
@@ -0,0 +1,315 @@
+/**************************************************************************//**
+*
+* \file        Async.c
+*
+* \defgroup    Async        Run a solver in the background
+*
+* \details     Async_Solve starts the instance's solver on a worker thread and
+*              returns at once. While it runs the caller can read the best
+*              solution found so far (Async_Best), ask it to stop
+*              (Async_Cancel), or wait for it with a timeout (Async_Wait).
+*              Together these give anytime answers within a latency budget:
+*              wait for the budget, cancel, and take the best so far.
+*
+*              The handle links the instance to its own shared incumbent, so
+*              everything goes through the same Subset_Sum_Publish and
+*              Subset_Sum_Cancelled calls the solvers already make for the
+*              portfolio.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+// Modules
+
+#include "Async.h"
+#include "Deadline.h"
+
+// ***** Definitions **********************************************************
+
+struct Async_s
+{
+    Subset_Sum_t * sptInst;
+    Subset_Sum_Shared_t stShared;
+    pthread_t stThread;
+    pthread_mutex_t stLock;
+    pthread_cond_t stFinished;
+    bool sbFinished;
+};
+
+// ***** Local Functions ******************************************************
+
+static void * AS__Thread (void * zpvArg);
+
+/**************************************************************************//**
+*
+* \defgroup    Async Control          Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Async_Solve
+*
+* \brief       Start solving an instance in the background
+*
+* \details     The instance must have its solver set and must not be in a
+*              portfolio. It belongs to the worker until Async_Free, after
+*              which it holds the final solution as usual.
+*
+* \param[in]   zptInst              Instance to solve
+* \param[in]   zpfImproved          Called on every improvement, or NULL. Runs
+*                                   on the worker thread, keep it short.
+* \param[in]   zpvContext           Passed to zpfImproved
+*
+* \retval      Async_t *            NULL if out of memory or the worker
+*                                   could not be started
+*
+******************************************************************************/
+
+Async_t * Async_Solve (Subset_Sum_t * zptInst,
+                        Subset_Sum_Improved_t zpfImproved, void * zpvContext)
+{
+    Async_t * xptAsync;
+    pthread_condattr_t xtAttr;
+
+    xptAsync = (Async_t *)calloc(1u, sizeof(Async_t));
+
+    if (xptAsync == NULL)
+    {
+        return NULL;
+    }
+
+    xptAsync->sptInst = zptInst;
+    xptAsync->stShared.saulSolution = (uint64_t *)calloc(
+                SUBSETSUM_WORDS(zptInst->sptInput->suwSize) + 1u, 
+                                                        sizeof(uint64_t));
+
+    if (xptAsync->stShared.saulSolution == NULL)
+    {
+        free(xptAsync);
+
+        return NULL;
+    }
+
+    xptAsync->stShared.spfImproved = zpfImproved;
+    xptAsync->stShared.spvContext = zpvContext;
+
+    // Timed waits are against the monotonic clock like everything else
+
+    pthread_condattr_init(&xtAttr);
+    pthread_condattr_setclock(&xtAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&xptAsync->stFinished, &xtAttr);
+    pthread_condattr_destroy(&xtAttr);
+    pthread_mutex_init(&xptAsync->stLock, NULL);
+
+    Subset_Sum_SetShared(zptInst, &xptAsync->stShared);
+
+    if (pthread_create(&xptAsync->stThread, NULL, AS__Thread, xptAsync) != 0)
+    {
+        fprintf(stderr, "Could not start solver thread\n");
+        Subset_Sum_SetShared(zptInst, NULL);
+        pthread_cond_destroy(&xptAsync->stFinished);
+        pthread_mutex_destroy(&xptAsync->stLock);
+        free(xptAsync->stShared.saulSolution);
+        free(xptAsync);
+
+        return NULL;
+    }
+
+    return xptAsync;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Async_Cancel
+*
+* \brief       Ask the solver to stop
+*
+* \details     Returns right away. The solver stops the next time it polls
+*              Subset_Sum_Cancelled, use Async_Wait to wait for that.
+*
+* \param[in]   zptAsync             Running solve
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Async_Cancel (Async_t * zptAsync)
+{
+    __atomic_store_n(&zptAsync->stShared.suwCancel, 1u, __ATOMIC_RELEASE);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Async_Wait
+*
+* \brief       Wait for the solver to finish
+*
+* \param[in]   zptAsync             Running solve
+* \param[in]   zulTimeout           Nanoseconds, 0 to just check, or
+*                                   DEADLINE_NONE to wait for good
+*
+* \retval      bool                 true if the solver has finished
+*
+******************************************************************************/
+
+bool Async_Wait (Async_t * zptAsync, uint64_t zulTimeout)
+{
+    struct timespec xtUntil;
+    uint64_t xulUntil;
+    bool xbFinished;
+    int xiResult = 0;
+
+    xulUntil = Deadline_Now();
+    xulUntil = (zulTimeout > (DEADLINE_NONE - xulUntil)) ?
+                                    DEADLINE_NONE : (xulUntil + zulTimeout);
+    xtUntil.tv_sec = (time_t)(xulUntil / DEADLINE_NS_PER_SEC);
+    xtUntil.tv_nsec = (long)(xulUntil % DEADLINE_NS_PER_SEC);
+
+    pthread_mutex_lock(&zptAsync->stLock);
+
+    while ((zptAsync->sbFinished == false) && (xiResult != ETIMEDOUT))
+    {
+        if (zulTimeout == DEADLINE_NONE)
+        {
+            pthread_cond_wait(&zptAsync->stFinished, &zptAsync->stLock);
+        }
+        else
+        {
+            xiResult = pthread_cond_timedwait(&zptAsync->stFinished,
+                                            &zptAsync->stLock, &xtUntil);
+        }
+    }
+
+    xbFinished = zptAsync->sbFinished;
+
+    pthread_mutex_unlock(&zptAsync->stLock);
+
+    return xbFinished;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Async_Best
+*
+* \brief       Best solution found so far
+*
+* \details     Consistent snapshot of the incumbent, safe to take at any
+*              time while the solver runs.
+*
+* \param[in]   zptAsync             Running solve
+* \param[out]  zaulSolution         Packed solution, SUBSETSUM_WORDS of the
+*                                   set size, or NULL for just the sum
+*
+* \retval      uint64_t             Sum of the best solution
+*
+******************************************************************************/
+
+uint64_t Async_Best (Async_t * zptAsync, uint64_t * zaulSolution)
+{
+    return Subset_Sum_Snapshot(&zptAsync->stShared, zaulSolution,
+                    SUBSETSUM_WORDS(zptAsync->sptInst->sptInput->suwSize));
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Async Cleanup          Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Async_Free
+*
+* \brief       Stop the solver and free the handle
+*
+* \details     Cancels the solver if it is still running and waits for it.
+*              The instance is detached from the handle and left with the
+*              best solution published, which a cancelled solver may not
+*              be holding any more (an exhaustive search holds the subset
+*              it got to).
+*
+* \param[in]   zptAsync             Solve to free
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Async_Free (Async_t * zptAsync)
+{
+    Async_Cancel(zptAsync);
+    pthread_join(zptAsync->stThread, NULL);
+
+    zptAsync->sptInst->sulSum = Async_Best(zptAsync, 
+                                            zptAsync->sptInst->saulSolution);
+    Subset_Sum_SetShared(zptAsync->sptInst, NULL);
+
+    pthread_cond_destroy(&zptAsync->stFinished);
+    pthread_mutex_destroy(&zptAsync->stLock);
+    free(zptAsync->stShared.saulSolution);
+    free(zptAsync);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Async Internal         Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      AS__Thread
+*
+* \brief       Worker thread entry
+*
+* \details     Solves, publishes the final solution in case the solver never
+*              did (see Subset_Sum_Offer), and wakes up any waiters.
+*
+* \param[in]   zpvArg               Async_t of the solve
+*
+* \retval      void *
+*
+******************************************************************************/
+
+static void * AS__Thread (void * zpvArg)
+{
+    Async_t * xptAsync = (Async_t *)zpvArg;
+
+    Subset_Sum_Solve(xptAsync->sptInst);
+    Subset_Sum_Offer(xptAsync->sptInst);
+
+    pthread_mutex_lock(&xptAsync->stLock);
+    xptAsync->sbFinished = true;
+    pthread_cond_broadcast(&xptAsync->stFinished);
+    pthread_mutex_unlock(&xptAsync->stLock);
+
+    return NULL;
+}
+
+// \}
+
+// \}
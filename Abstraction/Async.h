@@ -0,0 +1,43 @@
+/**************************************************************************//**
+*
+* \file        Async.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _ASYNC_H
+#define _ASYNC_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+
+// ***** Definitions **********************************************************
+
+//! A solve running on its own thread. Opaque, see Async_Solve.
+
+typedef struct Async_s Async_t;
+
+// ***** Function prototypes **************************************************
+
+// Control functions
+
+Async_t * Async_Solve (Subset_Sum_t * zptInst,
+                        Subset_Sum_Improved_t zpfImproved, void * zpvContext);
+void Async_Cancel (Async_t * zptAsync);
+bool Async_Wait (Async_t * zptAsync, uint64_t zulTimeout);
+uint64_t Async_Best (Async_t * zptAsync, uint64_t * zaulSolution);
+
+// Cleanup functions
+
+void Async_Free (Async_t * zptAsync);
+
+#endif // !defined _ASYNC_H
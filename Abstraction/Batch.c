@@ -0,0 +1,749 @@
+/**************************************************************************//**
+*
+* \file        Batch.c
+*
+* \defgroup    Batch        Solve many instances in one process
+*
+* \details     Replaces the shell loops of run.sh and runme.py. Starting one
+*              process per instance and re-parsing everything costs more
+*              than solving the small instances.
+*
+*              Batch_Collect builds the instance list from a directory (every
+*              .dat and .bin file in it, sorted by name) or from a manifest
+*              (one path per line, '#' starts a comment, relative paths are
+*              relative to the manifest).
+*
+*              Batch_Run solves the list on a fixed pool of threads. Every
+*              thread starts with its own share of the instances, dealt out
+*              round-robin. It works through its own queue in list order,
+*              and once that is empty it steals the next one in list order
+*              from the others. A single slow instance therefore only holds
+*              up its own thread, unlike the fixed file_list[i::t]
+*              partitions of runme.py. Stolen work comes from the same end
+*              the owner works from, so a list sorted lightest first is
+*              still run lightest first and an idle thread never takes the
+*              heaviest instance left over a lighter one.
+*
+*              Instead of one fixed limit per instance a batch can also get a
+*              total wall clock budget. Every instance gets a weight from
+*              Batch_Weight. When it starts it receives its weight's share
+*              of whatever budget is left (Batch_Budget_Slice). Time not
+*              used by instances that finish early is therefore left for
+*              the ones after them. Running the list lightest first solves
+*              as many instances as possible before the budget runs out.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+// Modules
+
+#include "Batch.h"
+#include "Deadline.h"
+
+// ***** Definitions **********************************************************
+
+//! Fixed point scale of the instance weights
+
+#define BA_WEIGHT_ONE       1024u
+
+//! One thread's queue of instance indices, stored last first so the next
+//! in list order (the lightest left) is at the tail. Owner and thieves
+//! both pop from the tail. Jobs are coarse (a whole solve each) so a plain
+//! mutex per queue costs nothing measurable.
+
+typedef struct BA__Queue_s
+{
+    pthread_mutex_t stLock;
+    uint32_t * sauwJobs;
+    uint32_t suwTail;
+} BA__Queue_t;
+
+typedef struct BA__Pool_s
+{
+    BA__Queue_t * satQueues;
+    uint32_t suwThreads;
+    char ** sapsPaths;
+    Batch_Job_t spfJob;
+    void * spvContext;
+} BA__Pool_t;
+
+typedef struct BA__Worker_s
+{
+    BA__Pool_t * sptPool;
+    uint32_t suwId;
+} BA__Worker_t;
+
+// ***** Local Functions ******************************************************
+
+static bool BA__Add_Path (char *** zpppsPaths, uint32_t * zpuwCount,
+                                    uint32_t * zpuwSize, const char * zpsDir,
+                                    const char * zpsName);
+static int BA__Compare (const void * zpvA, const void * zpvB);
+static bool BA__Take (BA__Pool_t * zptPool, uint32_t zuwId, uint32_t * zpuwJob);
+static void * BA__Thread (void * zpvArg);
+
+// ***** Local variables ******************************************************
+
+//! Pool thread number of the calling thread, see Batch_Worker
+
+static __thread uint32_t muwWorker;
+
+/**************************************************************************//**
+*
+* \defgroup    Batch Init             Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Batch_Collect
+*
+* \brief       Build the list of instances to solve
+*
+* \param[in]   zpsSource            Instance directory or manifest file
+* \param[out]  zpppsPaths           Instance paths, free with Batch_Free
+* \param[out]  zpuwCount            Number of paths
+*
+* \retval      bool                 false if the source could not be read
+*
+******************************************************************************/
+
+bool Batch_Collect (const char * zpsSource, char *** zpppsPaths,
+                                                    uint32_t * zpuwCount)
+{
+    struct stat xtStat;
+    struct dirent * xptEntry;
+    DIR * xptDir;
+    FILE * xptFile;
+    char xacLine[4096u];
+    char xacDir[4096u];
+    char * xpcExt;
+    char * xpcSlash;
+    uint32_t xuwSize = 0u;
+    bool xbOk = true;
+
+    *zpppsPaths = NULL;
+    *zpuwCount = 0u;
+
+    if (stat(zpsSource, &xtStat) != 0)
+    {
+        fprintf(stderr, "%s: cannot open\n", zpsSource);
+
+        return false;
+    }
+
+    if (S_ISDIR(xtStat.st_mode))
+    {
+        xptDir = opendir(zpsSource);
+
+        if (xptDir == NULL)
+        {
+            fprintf(stderr, "%s: cannot open\n", zpsSource);
+
+            return false;
+        }
+
+        while ((xbOk == true) && ((xptEntry = readdir(xptDir)) != NULL))
+        {
+            xpcExt = strrchr(xptEntry->d_name, '.');
+
+            if ((xpcExt != NULL) &&
+                ((strcmp(xpcExt, ".dat") == 0) || (strcmp(xpcExt, ".bin") == 0)))
+            {
+                xbOk = BA__Add_Path(zpppsPaths, zpuwCount, &xuwSize,
+                                            zpsSource, xptEntry->d_name);
+            }
+        }
+
+        closedir(xptDir);
+
+        // readdir order is arbitrary, keep runs reproducible
+
+        if (*zpuwCount > 0u)
+        {
+            qsort(*zpppsPaths, *zpuwCount, sizeof(char *), BA__Compare);
+        }
+    }
+    else
+    {
+        xptFile = fopen(zpsSource, "r");
+
+        if (xptFile == NULL)
+        {
+            fprintf(stderr, "%s: cannot open\n", zpsSource);
+
+            return false;
+        }
+
+        // Relative entries are relative to the manifest itself
+
+        snprintf(xacDir, sizeof(xacDir), "%s", zpsSource);
+        xpcSlash = strrchr(xacDir, '/');
+
+        if (xpcSlash != NULL)
+        {
+            *xpcSlash = '\0';
+        }
+        else
+        {
+            snprintf(xacDir, sizeof(xacDir), ".");
+        }
+
+        while ((xbOk == true) && (fgets(xacLine, sizeof(xacLine), xptFile) != NULL))
+        {
+            xacLine[strcspn(xacLine, "#\r\n")] = '\0';
+
+            // Trim trailing blanks, skip empty lines
+
+            xpcExt = xacLine + strlen(xacLine);
+
+            while ((xpcExt > xacLine) && ((xpcExt[-1] == ' ') || (xpcExt[-1] == '\t')))
+            {
+                *--xpcExt = '\0';
+            }
+
+            if (xacLine[0] != '\0')
+            {
+                xbOk = BA__Add_Path(zpppsPaths, zpuwCount, &xuwSize,
+                                (xacLine[0] == '/') ? NULL : xacDir, xacLine);
+            }
+        }
+
+        fclose(xptFile);
+    }
+
+    if (xbOk == false)
+    {
+        Batch_Free(*zpppsPaths, *zpuwCount);
+        *zpppsPaths = NULL;
+        *zpuwCount = 0u;
+    }
+
+    return xbOk;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Batch Scheduling       Scheduling Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Batch_Weight
+*
+* \brief       Estimate how hard an instance is
+*
+* \details     Uses the same features the generator reports: the size n, the
+*              bit width b and the density n/b. One 1-OPT pass costs about
+*              n scans of n elements, and passes are needed until the
+*              target is hit. Dense instances (n/b >= 1) have many subsets
+*              that hit the target, so they are taken as n log n. Below
+*              density 1 exact subsets get exponentially rare. That is
+*              capped at a linear b/n factor so hard instances get more
+*              time without starving everything else.
+*
+* \param[in]   zuwSize              n
+* \param[in]   zuwBits              b
+*
+* \retval      uint64_t             Relative weight, fixed point
+*
+******************************************************************************/
+
+uint64_t Batch_Weight (uint32_t zuwSize, uint32_t zuwBits)
+{
+    uint64_t xulWeight;
+    uint32_t xuwLog = 1u;
+
+    while ((zuwSize >> xuwLog) != 0u)
+    {
+        xuwLog++;
+    }
+
+    xulWeight = (uint64_t)(zuwSize + 1u) * xuwLog * BA_WEIGHT_ONE;
+
+    // Sparse instances: scale by 1 / density
+
+    if (zuwBits > zuwSize)
+    {
+        xulWeight = (xulWeight * zuwBits) / ((zuwSize == 0u) ? 1u : zuwSize);
+    }
+
+    return xulWeight;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Batch_Budget_Start
+*
+* \brief       Start the clock on a batch budget
+*
+* \param[in]   zptBudget            Budget
+* \param[in]   zulBudget            Wall clock budget of the whole batch, ns
+* \param[in]   zuwThreads           Threads solving in parallel
+* \param[in]   zulWeight            Sum of the weights of every instance
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Batch_Budget_Start (Batch_Budget_t * zptBudget, uint64_t zulBudget,
+                                    uint32_t zuwThreads, uint64_t zulWeight)
+{
+    uint64_t xulNow = Deadline_Now();
+
+    zptBudget->sulEnd = (zulBudget > (DEADLINE_NONE - xulNow)) ?
+                                        DEADLINE_NONE : (xulNow + zulBudget);
+    zptBudget->sulWeightLeft = (zulWeight == 0u) ? 1u : zulWeight;
+    zptBudget->suwThreads = (zuwThreads == 0u) ? 1u : zuwThreads;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Batch_Budget_Slice
+*
+* \brief       Time limit for an instance that is about to start
+*
+* \details     The instance gets its weight's share of the thread time left
+*              (time left times threads) among everything not started yet,
+*              but never past the end of the batch. Thread safe.
+*
+* \param[in]   zptBudget            Budget
+* \param[in]   zulWeight            Weight of the starting instance
+*
+* \retval      uint64_t             Time limit in ns, 0 once the budget is
+*                                   used up
+*
+******************************************************************************/
+
+uint64_t Batch_Budget_Slice (Batch_Budget_t * zptBudget, uint64_t zulWeight)
+{
+    uint64_t xulNow = Deadline_Now();
+    uint64_t xulLeft, xulWeightLeft;
+    unsigned __int128 xSlice;
+
+    if (xulNow >= zptBudget->sulEnd)
+    {
+        return 0u;
+    }
+
+    xulLeft = zptBudget->sulEnd - xulNow;
+
+    // Take this instance's weight off the pool, the share is computed
+    // against the pool as it was including it
+
+    xulWeightLeft = __atomic_fetch_sub(&zptBudget->sulWeightLeft, zulWeight,
+                                                        __ATOMIC_RELAXED);
+
+    if ((xulWeightLeft <= zulWeight) || (xulLeft == DEADLINE_NONE - xulNow))
+    {
+        return xulLeft;
+    }
+
+    xSlice = ((unsigned __int128)xulLeft * zptBudget->suwThreads * zulWeight) /
+                                                                xulWeightLeft;
+
+    return (xSlice > xulLeft) ? xulLeft : (uint64_t)xSlice;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Batch Control          Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Batch_Threads
+*
+* \brief       Number of pool threads Batch_Run will use
+*
+* \details     For per-thread resources set up before the run, indexed by
+*              Batch_Worker.
+*
+* \param[in]   zuwThreads           Pool size asked for, 0 for one per CPU
+* \param[in]   zuwCount             Number of instances
+*
+* \retval      uint32_t
+*
+******************************************************************************/
+
+uint32_t Batch_Threads (uint32_t zuwThreads, uint32_t zuwCount)
+{
+    zuwThreads = (zuwThreads == 0u) ? (uint32_t)sysconf(_SC_NPROCESSORS_ONLN) : zuwThreads;
+    zuwThreads = (zuwThreads == 0u) ? 1u : zuwThreads;
+    zuwThreads = (zuwThreads > zuwCount) ? zuwCount : zuwThreads;
+
+    return zuwThreads;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Batch_Worker
+*
+* \brief       Pool thread a job runs on
+*
+* \retval      uint32_t             0 to Batch_Threads - 1, 0 outside a pool
+*
+******************************************************************************/
+
+uint32_t Batch_Worker (void)
+{
+    return muwWorker;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Batch_Run
+*
+* \brief       Run a job for every instance on a work stealing pool
+*
+* \details     Returns once every job has finished. The calling thread works
+*              as one of the pool threads. If a thread cannot be created its
+*              queue is simply emptied by the others. Out of memory, no job
+*              runs at all.
+*
+* \param[in]   zapsPaths            Instance paths
+* \param[in]   zuwCount             Number of paths
+* \param[in]   zuwThreads           Pool size, 0 for one per online CPU
+* \param[in]   zpfJob               Called once per instance
+* \param[in]   zpvContext           Passed to every job
+*
+* \retval      bool                 false if out of memory
+*
+******************************************************************************/
+
+bool Batch_Run (char ** zapsPaths, uint32_t zuwCount, uint32_t zuwThreads,
+                                    Batch_Job_t zpfJob, void * zpvContext)
+{
+    BA__Pool_t xtPool;
+    BA__Worker_t * xatWorkers;
+    pthread_t * xatThreads;
+    bool * xabStarted;
+    uint32_t xuwLoop;
+    bool xbMemory;
+
+    if (zuwCount == 0u)
+    {
+        return true;
+    }
+
+    zuwThreads = Batch_Threads(zuwThreads, zuwCount);
+
+    xtPool.satQueues = (BA__Queue_t *)calloc(zuwThreads, sizeof(BA__Queue_t));
+    xtPool.suwThreads = zuwThreads;
+    xtPool.sapsPaths = zapsPaths;
+    xtPool.spfJob = zpfJob;
+    xtPool.spvContext = zpvContext;
+
+    xatWorkers = (BA__Worker_t *)calloc(zuwThreads, sizeof(BA__Worker_t));
+    xatThreads = (pthread_t *)calloc(zuwThreads, sizeof(pthread_t));
+    xabStarted = (bool *)calloc(zuwThreads, sizeof(bool));
+    xbMemory = (xtPool.satQueues != NULL) && (xatWorkers != NULL) &&
+                            (xatThreads != NULL) && (xabStarted != NULL);
+
+    // Deal the instances out round-robin, a thread pops its own from the
+    // back so it starts with its first instance on top of the queue
+
+    for (xuwLoop = 0u; (xbMemory == true) && (xuwLoop < zuwThreads); xuwLoop++)
+    {
+        pthread_mutex_init(&xtPool.satQueues[xuwLoop].stLock, NULL);
+        xtPool.satQueues[xuwLoop].sauwJobs = (uint32_t *)malloc(
+                ((zuwCount / zuwThreads) + 1u) * sizeof(uint32_t));
+        xatWorkers[xuwLoop].sptPool = &xtPool;
+        xatWorkers[xuwLoop].suwId = xuwLoop;
+        xbMemory = (xtPool.satQueues[xuwLoop].sauwJobs != NULL);
+    }
+
+    if (xbMemory == false)
+    {
+        fprintf(stderr, "Out of memory for a pool of %u threads\n", 
+                                                                zuwThreads);
+
+        // The loop stopped right after the queue it could not fill
+
+        while (xuwLoop > 0u)
+        {
+            xuwLoop--;
+            pthread_mutex_destroy(&xtPool.satQueues[xuwLoop].stLock);
+            free(xtPool.satQueues[xuwLoop].sauwJobs);
+        }
+
+        free(xtPool.satQueues);
+        free(xatWorkers);
+        free(xatThreads);
+        free(xabStarted);
+
+        return false;
+    }
+
+    for (xuwLoop = zuwCount; xuwLoop > 0u; xuwLoop--)
+    {
+        BA__Queue_t * xptQueue = &xtPool.satQueues[(xuwLoop - 1u) % zuwThreads];
+
+        xptQueue->sauwJobs[xptQueue->suwTail++] = xuwLoop - 1u;
+    }
+
+    // This thread is worker 0
+
+    for (xuwLoop = 1u; xuwLoop < zuwThreads; xuwLoop++)
+    {
+        xabStarted[xuwLoop] = (pthread_create(&xatThreads[xuwLoop], NULL,
+                                    BA__Thread, &xatWorkers[xuwLoop]) == 0);
+    }
+
+    BA__Thread(&xatWorkers[0u]);
+
+    for (xuwLoop = 1u; xuwLoop < zuwThreads; xuwLoop++)
+    {
+        if (xabStarted[xuwLoop] == true)
+        {
+            pthread_join(xatThreads[xuwLoop], NULL);
+        }
+    }
+
+    for (xuwLoop = 0u; xuwLoop < zuwThreads; xuwLoop++)
+    {
+        pthread_mutex_destroy(&xtPool.satQueues[xuwLoop].stLock);
+        free(xtPool.satQueues[xuwLoop].sauwJobs);
+    }
+
+    free(xtPool.satQueues);
+    free(xatWorkers);
+    free(xatThreads);
+    free(xabStarted);
+
+    return true;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Batch Cleanup          Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Batch_Free
+*
+* \brief       Free a path list from Batch_Collect
+*
+* \param[in]   zapsPaths            Instance paths
+* \param[in]   zuwCount             Number of paths
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Batch_Free (char ** zapsPaths, uint32_t zuwCount)
+{
+    uint32_t xuwLoop;
+
+    for (xuwLoop = 0u; xuwLoop < zuwCount; xuwLoop++)
+    {
+        free(zapsPaths[xuwLoop]);
+    }
+
+    free(zapsPaths);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Batch Internal         Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      BA__Add_Path
+*
+* \brief       Append a path to a growing list
+*
+* \param[in]   zpppsPaths           List
+* \param[in]   zpuwCount            Entries in use
+* \param[in]   zpuwSize             Entries allocated
+* \param[in]   zpsDir               Directory to prefix, or NULL
+* \param[in]   zpsName              File name
+*
+* \retval      bool                 false if out of memory
+*
+******************************************************************************/
+
+static bool BA__Add_Path (char *** zpppsPaths, uint32_t * zpuwCount,
+                                    uint32_t * zpuwSize, const char * zpsDir,
+                                    const char * zpsName)
+{
+    char ** xapsGrown;
+    char * xpsPath;
+    size_t xulLength;
+
+    if (*zpuwCount == *zpuwSize)
+    {
+        *zpuwSize = (*zpuwSize == 0u) ? 64u : (*zpuwSize * 2u);
+        xapsGrown = (char **)realloc(*zpppsPaths, *zpuwSize * sizeof(char *));
+
+        if (xapsGrown == NULL)
+        {
+            return false;
+        }
+
+        *zpppsPaths = xapsGrown;
+    }
+
+    xulLength = strlen(zpsName) + ((zpsDir != NULL) ? (strlen(zpsDir) + 2u) : 1u);
+    xpsPath = (char *)malloc(xulLength);
+
+    if (xpsPath == NULL)
+    {
+        return false;
+    }
+
+    if (zpsDir != NULL)
+    {
+        snprintf(xpsPath, xulLength, "%s/%s", zpsDir, zpsName);
+    }
+    else
+    {
+        snprintf(xpsPath, xulLength, "%s", zpsName);
+    }
+
+    (*zpppsPaths)[(*zpuwCount)++] = xpsPath;
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      BA__Compare
+*
+* \brief       qsort comparison of two paths
+*
+* \param[in]   zpvA                 char ** of the first path
+* \param[in]   zpvB                 char ** of the second path
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int BA__Compare (const void * zpvA, const void * zpvB)
+{
+    return strcmp(*(char * const *)zpvA, *(char * const *)zpvB);
+}
+
+/**************************************************************************//**
+*
+* \anchor      BA__Take
+*
+* \brief       Get the next job for a thread
+*
+* \details     Pops from the tail of the thread's own queue, or steals from
+*              the tail of the next non-empty queue, the light end of both.
+*              Nothing is ever added once the pool runs, so finding every
+*              queue empty means done.
+*
+* \param[in]   zptPool              Pool
+* \param[in]   zuwId                Calling thread
+* \param[out]  zpuwJob              Instance index
+*
+* \retval      bool                 false when there is no work left
+*
+******************************************************************************/
+
+static bool BA__Take (BA__Pool_t * zptPool, uint32_t zuwId, uint32_t * zpuwJob)
+{
+    BA__Queue_t * xptQueue = &zptPool->satQueues[zuwId];
+    uint32_t xuwLoop;
+    bool xbFound = false;
+
+    pthread_mutex_lock(&xptQueue->stLock);
+
+    if (xptQueue->suwTail > 0u)
+    {
+        *zpuwJob = xptQueue->sauwJobs[--xptQueue->suwTail];
+        xbFound = true;
+    }
+
+    pthread_mutex_unlock(&xptQueue->stLock);
+
+    for (xuwLoop = 1u; (xbFound == false) && (xuwLoop < zptPool->suwThreads);
+                                                                xuwLoop++)
+    {
+        xptQueue = &zptPool->satQueues[(zuwId + xuwLoop) % zptPool->suwThreads];
+
+        pthread_mutex_lock(&xptQueue->stLock);
+
+        if (xptQueue->suwTail > 0u)
+        {
+            *zpuwJob = xptQueue->sauwJobs[--xptQueue->suwTail];
+            xbFound = true;
+        }
+
+        pthread_mutex_unlock(&xptQueue->stLock);
+    }
+
+    return xbFound;
+}
+
+/**************************************************************************//**
+*
+* \anchor      BA__Thread
+*
+* \brief       Pool thread entry
+*
+* \param[in]   zpvArg               BA__Worker_t of the thread
+*
+* \retval      void *
+*
+******************************************************************************/
+
+static void * BA__Thread (void * zpvArg)
+{
+    BA__Worker_t * xptWorker = (BA__Worker_t *)zpvArg;
+    BA__Pool_t * xptPool = xptWorker->sptPool;
+    uint32_t xuwJob;
+
+    muwWorker = xptWorker->suwId;
+
+    while (BA__Take(xptPool, xptWorker->suwId, &xuwJob) == true)
+    {
+        (xptPool->spfJob)(xuwJob, xptPool->sapsPaths[xuwJob],
+                                                    xptPool->spvContext);
+    }
+
+    return NULL;
+}
+
+// \}
+
+// \}
@@ -0,0 +1,63 @@
+/**************************************************************************//**
+*
+* \file        Batch.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _BATCH_H
+#define _BATCH_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ***** Definitions **********************************************************
+
+//! Work item callback. Called once per instance on some pool thread, the
+//! index is the instance's position in the path list so results can be kept
+//! in a plain array and written out in order afterwards.
+
+typedef void (*Batch_Job_t)(uint32_t zuwIndex, char * zpsPath,
+                                                    void * zpvContext);
+
+//! Global time budget of a batch, shared out between the instances as they
+//! start, see Batch_Budget_Slice. Weights are the Batch_Weight estimates.
+
+typedef struct Batch_Budget_s
+{
+    uint64_t sulEnd;            // CLOCK_MONOTONIC end of the whole batch, ns
+    uint64_t sulWeightLeft;     // Total weight of instances not started yet
+    uint32_t suwThreads;
+} Batch_Budget_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Batch_Collect (const char * zpsSource, char *** zpppsPaths,
+                                                    uint32_t * zpuwCount);
+
+// Scheduling functions
+
+uint64_t Batch_Weight (uint32_t zuwSize, uint32_t zuwBits);
+void Batch_Budget_Start (Batch_Budget_t * zptBudget, uint64_t zulBudget,
+                                    uint32_t zuwThreads, uint64_t zulWeight);
+uint64_t Batch_Budget_Slice (Batch_Budget_t * zptBudget, uint64_t zulWeight);
+
+// Control functions
+
+uint32_t Batch_Threads (uint32_t zuwThreads, uint32_t zuwCount);
+uint32_t Batch_Worker (void);
+bool Batch_Run (char ** zapsPaths, uint32_t zuwCount, uint32_t zuwThreads,
+                                    Batch_Job_t zpfJob, void * zpvContext);
+
+// Cleanup functions
+
+void Batch_Free (char ** zapsPaths, uint32_t zuwCount);
+
+#endif // !defined _BATCH_H
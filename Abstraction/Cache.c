@@ -0,0 +1,439 @@
+/**************************************************************************//**
+*
+* \file        Cache.c
+*
+* \defgroup    Cache        Persistent cache of solver results
+*
+* \details     A sweep over the instance directory solves every instance
+*              again even when nothing about it has changed. The cache keeps
+*              the best subset every solver has found for every instance,
+*              so a repeated sweep only loads and looks up.
+*
+*              An entry is one small file in the cache directory (a
+*              Cache_Header_t and the packed subset). Its name is a hash of
+*              the element values, the target and the solver name, which
+*              also stands for the solver's parameters (see
+*              Subset_Sum_SetCache). The instance name is not part of it,
+*              the same set under another name finds the same entry.
+*
+*              The time limit is what decides between a hit and a warm
+*              start. An entry solved with at least the asked for limit, or
+*              one that hit the target, is the answer. One solved with less
+*              only hands its subset to the solver as the starting point
+*              (sbWarm, see P5__Warm), and the new run's result replaces it
+*              if it is better. The entry always keeps the best subset and
+*              the longest limit seen.
+*
+*              Entries are written to a temporary file and renamed into
+*              place, so processes and threads sharing the cache only ever
+*              see whole entries. They are not synced, a lost entry is only
+*              solved again.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Modules
+
+#include "Cache.h"
+
+// ***** Local Functions ******************************************************
+
+static void CA__Path (const Subset_Sum_Input_t * zptInput,
+                    const char * zpsSolver, uint64_t zulFingerprint,
+                    char * zpsPath, size_t zulSize);
+static bool CA__Read (const char * zpsPath, const Subset_Sum_Input_t * zptInput,
+                    const char * zpsSolver, uint64_t zulFingerprint,
+                    Cache_Header_t * zptHeader, uint64_t * zaulSolution);
+
+// ***** Local variables ******************************************************
+
+//! Cache directory, NULL while there is none
+
+static char * mpsDir;
+
+/**************************************************************************//**
+*
+* \defgroup    Cache Initialization   Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Cache_Open
+*
+* \brief       Use a directory as the result cache of this process
+*
+* \details     Created if it does not exist. Call before any solve, usually
+*              with getenv(CACHE_ENV), so the cache is only used when the
+*              caller asks for it.
+*
+* \param[in]   zpsDir               Directory, NULL or empty for no cache
+*
+* \retval      bool                 false if there is no cache
+*
+******************************************************************************/
+
+bool Cache_Open (const char * zpsDir)
+{
+    if ((zpsDir == NULL) || (zpsDir[0] == '\0'))
+    {
+        return false;
+    }
+
+    if ((mkdir(zpsDir, 0777) != 0) && (errno != EEXIST))
+    {
+        perror(zpsDir);
+
+        return false;
+    }
+
+    free(mpsDir);
+    mpsDir = strdup(zpsDir);
+
+    return (mpsDir != NULL);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Cache Control          Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Cache_Active
+*
+* \brief       Check if this process has a cache
+*
+* \retval      bool
+*
+******************************************************************************/
+
+bool Cache_Active (void)
+{
+    return (mpsDir != NULL);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Cache_Fetch
+*
+* \brief       Look up a problem's result
+*
+* \details     On a hit the problem gets the cached subset, solve time,
+*              initial solution and counters, as if it had just been
+*              solved. On a warm start it only gets the subset, with sbWarm
+*              set.
+*
+* \param[in]   zptHandle            Problem instance, time limit set
+* \param[in]   zpsSolver            Solver and parameters
+*
+* \retval      uint8_t              CACHE_MISS, CACHE_WARM or CACHE_HIT
+*
+******************************************************************************/
+
+uint8_t Cache_Fetch (Subset_Sum_t * zptHandle, const char * zpsSolver)
+{
+    const Subset_Sum_Input_t * xptInput = zptHandle->sptInput;
+    uint32_t xuwWords = SUBSETSUM_WORDS(xptInput->suwSize);
+    Cache_Header_t xtHeader;
+    uint64_t * xaulSolution;
+    uint64_t xulFingerprint;
+    char xacPath[4096u];
+    bool xbFound;
+
+    if (mpsDir == NULL)
+    {
+        return CACHE_MISS;
+    }
+
+    xulFingerprint = Subset_Sum_Fingerprint(xptInput);
+    CA__Path(xptInput, zpsSolver, xulFingerprint, xacPath, sizeof(xacPath));
+
+    // Read it aside, a damaged entry must not touch the problem
+
+    xaulSolution = (uint64_t *)malloc((xuwWords + 1u) * sizeof(uint64_t));
+    xbFound = (xaulSolution != NULL) &&
+              (CA__Read(xacPath, xptInput, zpsSolver, xulFingerprint,
+                                        &xtHeader, xaulSolution) == true);
+
+    if (xbFound == true)
+    {
+        memcpy(zptHandle->saulSolution, xaulSolution,
+                                            xuwWords * sizeof(uint64_t));
+    }
+
+    free(xaulSolution);
+
+    if (xbFound == false)
+    {
+        return CACHE_MISS;
+    }
+
+    if ((xtHeader.sulBudget >= zptHandle->sulTimeLimit) ||
+        (xtHeader.sulSum == xptInput->sulTarget))
+    {
+        zptHandle->sulTime = xtHeader.sulTime;
+        zptHandle->sulInitialSol = xtHeader.sulInitialSol;
+        zptHandle->stStats = xtHeader.stStats;
+        zptHandle->sbWarm = false;
+
+        return CACHE_HIT;
+    }
+
+    zptHandle->sbWarm = true;
+    zptHandle->sulSum = SUBSETSUM_UNKNOWN;
+
+    return CACHE_WARM;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Cache_Store
+*
+* \brief       Record a problem's result
+*
+* \details     Only written if it improves on the entry there is, either a
+*              better subset or a longer time limit.
+*
+* \param[in]   zptHandle            Solved problem instance
+* \param[in]   zpsSolver            Solver and parameters
+*
+* \retval      bool                 false if the entry could not be written
+*
+******************************************************************************/
+
+bool Cache_Store (Subset_Sum_t * zptHandle, const char * zpsSolver)
+{
+    const Subset_Sum_Input_t * xptInput = zptHandle->sptInput;
+    uint32_t xuwWords = SUBSETSUM_WORDS(xptInput->suwSize);
+    Cache_Header_t xtHeader;
+    Cache_Header_t xtOld;
+    uint64_t * xaulOld;
+    uint64_t xulFingerprint;
+    uint64_t xulSum = Subset_Sum_GetSum(zptHandle);
+    const uint64_t * xaulBest = zptHandle->saulSolution;
+    char xacPath[4096u];
+    char xacTemp[4096u + 8u];
+    FILE * xptFile;
+    int xiFd;
+    bool xbOk;
+
+    if (mpsDir == NULL)
+    {
+        return false;
+    }
+
+    xulFingerprint = Subset_Sum_Fingerprint(xptInput);
+    CA__Path(xptInput, zpsSolver, xulFingerprint, xacPath, sizeof(xacPath));
+
+    memset(&xtHeader, 0, sizeof(xtHeader));
+    memcpy(xtHeader.sacMagic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    xtHeader.suwVersion = CACHE_VERSION;
+    xtHeader.suwSize = xptInput->suwSize;
+    xtHeader.sulTarget = xptInput->sulTarget;
+    xtHeader.sulFingerprint = xulFingerprint;
+    xtHeader.sulBudget = zptHandle->sulTimeLimit;
+    xtHeader.sulSum = xulSum;
+    xtHeader.sulTime = zptHandle->sulTime;
+    xtHeader.sulInitialSol = zptHandle->sulInitialSol;
+    snprintf(xtHeader.sacSolver, sizeof(xtHeader.sacSolver), "%s", zpsSolver);
+    xtHeader.stStats = zptHandle->stStats;
+
+    // Keep whichever subset is better and the longer limit
+
+    xaulOld = (uint64_t *)malloc((xuwWords + 1u) * sizeof(uint64_t));
+
+    if ((xaulOld != NULL) &&
+        (CA__Read(xacPath, xptInput, zpsSolver, xulFingerprint, &xtOld,
+                                                        xaulOld) == true))
+    {
+        if ((xulSum <= xtOld.sulSum) &&
+            (zptHandle->sulTimeLimit <= xtOld.sulBudget))
+        {
+            free(xaulOld);
+
+            return true;
+        }
+
+        if (xulSum <= xtOld.sulSum)
+        {
+            xtOld.sulBudget = zptHandle->sulTimeLimit;
+            xtHeader = xtOld;
+            xaulBest = xaulOld;
+        }
+        else if (xtOld.sulBudget > xtHeader.sulBudget)
+        {
+            xtHeader.sulBudget = xtOld.sulBudget;
+        }
+    }
+
+    snprintf(xacTemp, sizeof(xacTemp), "%s.XXXXXX", xacPath);
+    xiFd = mkstemp(xacTemp);
+    xptFile = (xiFd < 0) ? NULL : fdopen(xiFd, "wb");
+
+    if (xptFile == NULL)
+    {
+        perror(xacTemp);
+
+        if (xiFd >= 0)
+        {
+            close(xiFd);
+            unlink(xacTemp);
+        }
+
+        free(xaulOld);
+
+        return false;
+    }
+
+    xbOk = (fwrite(&xtHeader, sizeof(xtHeader), 1u, xptFile) == 1u) &&
+           (fwrite(xaulBest, sizeof(uint64_t), xuwWords, xptFile) == xuwWords);
+
+    xbOk = (fclose(xptFile) == 0) && xbOk;
+    xbOk = xbOk && (rename(xacTemp, xacPath) == 0);
+
+    if (xbOk == false)
+    {
+        perror(xacPath);
+        unlink(xacTemp);
+    }
+
+    free(xaulOld);
+
+    return xbOk;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Cache Internal         Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      CA__Path
+*
+* \brief       File of a problem's cache entry
+*
+* \details     <dir>/<hash>.sol, the hash continues the fingerprint over
+*              the size, the target and the solver name.
+*
+* \param[in]   zptInput             Input set
+* \param[in]   zpsSolver            Solver and parameters
+* \param[in]   zulFingerprint       Of the input set
+* \param[out]  zpsPath              Path
+* \param[in]   zulSize              Size of zpsPath
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void CA__Path (const Subset_Sum_Input_t * zptInput,
+                    const char * zpsSolver, uint64_t zulFingerprint,
+                    char * zpsPath, size_t zulSize)
+{
+    uint64_t xulHash = zulFingerprint;
+    uint64_t xulValue;
+    uint32_t xuwByte;
+    const char * xpcName;
+
+    xulValue = zptInput->sulTarget ^ ((uint64_t)zptInput->suwSize << 32);
+
+    for (xuwByte = 0u; xuwByte < 8u; xuwByte++)
+    {
+        xulHash ^= (xulValue >> (8u * xuwByte)) & 0xffu;
+        xulHash *= 0x100000001b3ull;
+    }
+
+    for (xpcName = zpsSolver; *xpcName != '\0'; xpcName++)
+    {
+        xulHash ^= (uint8_t)*xpcName;
+        xulHash *= 0x100000001b3ull;
+    }
+
+    snprintf(zpsPath, zulSize, "%s/%016llx.sol", mpsDir,
+                                            (unsigned long long)xulHash);
+}
+
+/**************************************************************************//**
+*
+* \anchor      CA__Read
+*
+* \brief       Read a cache entry
+*
+* \details     Only accepted if it is for exactly this input set and solver,
+*              a hash collision or a damaged file is a miss.
+*
+* \param[in]   zpsPath              Entry file
+* \param[in]   zptInput             Input set
+* \param[in]   zpsSolver            Solver and parameters
+* \param[in]   zulFingerprint       Of the input set
+* \param[out]  zptHeader            Entry header
+* \param[out]  zaulSolution         Best subset, SUBSETSUM_WORDS of the set
+*                                   size
+*
+* \retval      bool                 false if there is no matching entry
+*
+******************************************************************************/
+
+static bool CA__Read (const char * zpsPath, const Subset_Sum_Input_t * zptInput,
+                    const char * zpsSolver, uint64_t zulFingerprint,
+                    Cache_Header_t * zptHeader, uint64_t * zaulSolution)
+{
+    uint32_t xuwWords = SUBSETSUM_WORDS(zptInput->suwSize);
+    FILE * xptFile;
+    bool xbOk;
+
+    xptFile = fopen(zpsPath, "rb");
+
+    if (xptFile == NULL)
+    {
+        return false;
+    }
+
+    xbOk = (fread(zptHeader, sizeof(Cache_Header_t), 1u, xptFile) == 1u) &&
+           (memcmp(zptHeader->sacMagic, CACHE_MAGIC,
+                                            sizeof(CACHE_MAGIC)) == 0) &&
+           (zptHeader->suwVersion == CACHE_VERSION) &&
+           (zptHeader->suwSize == zptInput->suwSize) &&
+           (zptHeader->sulTarget == zptInput->sulTarget) &&
+           (zptHeader->sulFingerprint == zulFingerprint) &&
+           (strncmp(zptHeader->sacSolver, zpsSolver,
+                                    sizeof(zptHeader->sacSolver)) == 0) &&
+           (zptHeader->sulSum <= zptInput->sulTarget) &&
+           (fread(zaulSolution, sizeof(uint64_t), xuwWords, xptFile) ==
+                                                                xuwWords);
+
+    fclose(xptFile);
+
+    return xbOk;
+}
+
+// \}
+
+// \}
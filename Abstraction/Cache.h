@@ -0,0 +1,73 @@
+/**************************************************************************//**
+*
+* \file        Cache.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _CACHE_H
+#define _CACHE_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+#include "Stats.h"
+
+// ***** Definitions **********************************************************
+
+//! Environment variable naming the cache directory, see Cache_Open
+
+#define CACHE_ENV                   "SSUM_CACHE"
+
+//! Cache files start with this header, followed by the best subset,
+//! SUBSETSUM_WORDS of the set size
+
+#define CACHE_MAGIC                 "SSUMCCH"
+#define CACHE_VERSION               1u
+
+typedef struct Cache_Header_s
+{
+    char sacMagic[8u];
+    uint32_t suwVersion;
+    uint32_t suwSize;
+    uint64_t sulTarget;
+    uint64_t sulFingerprint;    // Of the element values, see
+                                // Subset_Sum_Fingerprint
+    uint64_t sulBudget;         // Longest time limit solved with, ns
+    uint64_t sulSum;            // Of the best subset
+    uint64_t sulTime;           // Solve time of the run that found it, ns
+    uint64_t sulInitialSol;     // Its initial solution
+    char sacSolver[48u];        // Solver and parameters
+    Stats_t stStats;            // Its counters
+} Cache_Header_t;
+
+//! Cache_Fetch results
+
+enum
+{
+    CACHE_MISS,                 // Nothing cached, solve from scratch
+    CACHE_WARM,                 // Best subset of a shorter solve loaded
+    CACHE_HIT                   // Result loaded, no need to solve
+};
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Cache_Open (const char * zpsDir);
+
+// Control functions
+
+bool Cache_Active (void);
+uint8_t Cache_Fetch (Subset_Sum_t * zptHandle, const char * zpsSolver);
+bool Cache_Store (Subset_Sum_t * zptHandle, const char * zpsSolver);
+
+#endif // !defined _CACHE_H
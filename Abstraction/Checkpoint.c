@@ -0,0 +1,276 @@
+/**************************************************************************//**
+*
+* \file        Checkpoint.c
+*
+* \defgroup    Checkpoint   Save and resume exact searches
+*
+* \details     An exact search that runs out of time, or whose process is
+*              killed, would otherwise start again from the empty set. The
+*              solver instead saves where it is every so often: the next
+*              subset it would try, the best subset so far and the time it
+*              has spent. A later run loads that and carries on from the
+*              exact same position, so no subset is tried twice.
+*
+*              A checkpoint is a small binary file (Checkpoint_Header_t and
+*              two packed subsets). It is written to a temporary file and
+*              renamed over the old one, so a kill in the middle of a save
+*              leaves the previous checkpoint intact. The header records
+*              the instance's size, target and a fingerprint of its values,
+*              so a checkpoint is never resumed against the wrong instance.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+// Modules
+
+#include "Checkpoint.h"
+
+/**************************************************************************//**
+*
+* \defgroup    Checkpoint Initialization  Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Checkpoint_Init
+*
+* \brief       Start a checkpoint at the beginning of a search
+*
+* \details     Position and best subset are the empty set.
+*
+* \param[in]   zptCheckpoint        Checkpoint
+* \param[in]   zptInput             Input set being searched
+*
+* \retval      bool                 false if out of memory
+*
+******************************************************************************/
+
+bool Checkpoint_Init (Checkpoint_t * zptCheckpoint,
+                                    const Subset_Sum_Input_t * zptInput)
+{
+    uint32_t xuwWords = SUBSETSUM_WORDS(zptInput->suwSize);
+
+    memset(zptCheckpoint, 0, sizeof(Checkpoint_t));
+
+    zptCheckpoint->saulPosition = (uint64_t *)calloc(xuwWords + 1u,
+                                                        sizeof(uint64_t));
+    zptCheckpoint->saulBest = (uint64_t *)calloc(xuwWords + 1u,
+                                                        sizeof(uint64_t));
+
+    if ((zptCheckpoint->saulPosition == NULL) ||
+        (zptCheckpoint->saulBest == NULL))
+    {
+        Checkpoint_Free(zptCheckpoint);
+
+        return false;
+    }
+
+    return true;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Checkpoint Control     Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Checkpoint_Load
+*
+* \brief       Read a saved checkpoint
+*
+* \details     The checkpoint must have been set up with Checkpoint_Init for
+*              the same input set. It is left as it was if the file does
+*              not exist, cannot be read or belongs to another instance.
+*
+* \param[in]   zptCheckpoint        Checkpoint to fill in
+* \param[in]   zptInput             Input set being searched
+* \param[in]   zpsPath              Checkpoint file
+*
+* \retval      bool                 true if the checkpoint was loaded
+*
+******************************************************************************/
+
+bool Checkpoint_Load (Checkpoint_t * zptCheckpoint,
+                const Subset_Sum_Input_t * zptInput, const char * zpsPath)
+{
+    Checkpoint_Header_t xtHeader;
+    uint32_t xuwWords = SUBSETSUM_WORDS(zptInput->suwSize);
+    uint64_t * xaulData;
+    FILE * xptFile;
+    bool xbOk;
+
+    xptFile = fopen(zpsPath, "rb");
+
+    if (xptFile == NULL)
+    {
+        return false;
+    }
+
+    xaulData = (uint64_t *)malloc((2u * xuwWords + 1u) * sizeof(uint64_t));
+
+    xbOk = (xaulData != NULL) &&
+           (fread(&xtHeader, sizeof(xtHeader), 1u, xptFile) == 1u) &&
+           (memcmp(xtHeader.sacMagic, CHECKPOINT_MAGIC,
+                                        sizeof(CHECKPOINT_MAGIC)) == 0) &&
+           (xtHeader.suwVersion == CHECKPOINT_VERSION) &&
+           (fread(xaulData, sizeof(uint64_t), 2u * xuwWords, xptFile) ==
+                                                        2u * xuwWords);
+
+    fclose(xptFile);
+
+    if (xbOk == false)
+    {
+        fprintf(stderr, "%s: not a valid checkpoint\n", zpsPath);
+    }
+    else if ((xtHeader.suwSize != zptInput->suwSize) ||
+             (xtHeader.sulTarget != zptInput->sulTarget) ||
+             (xtHeader.sulFingerprint != Subset_Sum_Fingerprint(zptInput)))
+    {
+        fprintf(stderr, "%s: checkpoint is for another instance\n", zpsPath);
+        xbOk = false;
+    }
+    else
+    {
+        zptCheckpoint->sulElapsed = xtHeader.sulElapsed;
+        zptCheckpoint->sulBestSum = xtHeader.sulBestSum;
+        zptCheckpoint->sbComplete = (xtHeader.suwComplete != 0u);
+        memcpy(zptCheckpoint->saulPosition, xaulData,
+                                            xuwWords * sizeof(uint64_t));
+        memcpy(zptCheckpoint->saulBest, &xaulData[xuwWords],
+                                            xuwWords * sizeof(uint64_t));
+    }
+
+    free(xaulData);
+
+    return xbOk;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Checkpoint_Save
+*
+* \brief       Write a checkpoint
+*
+* \details     Written next to the target file and renamed into place once
+*              it is on disk, so the file is always either the old or the
+*              new checkpoint in full.
+*
+* \param[in]   zptCheckpoint        Checkpoint
+* \param[in]   zptInput             Input set being searched
+* \param[in]   zpsPath              Checkpoint file
+*
+* \retval      bool                 false if the file could not be written
+*
+******************************************************************************/
+
+bool Checkpoint_Save (const Checkpoint_t * zptCheckpoint,
+                const Subset_Sum_Input_t * zptInput, const char * zpsPath)
+{
+    Checkpoint_Header_t xtHeader;
+    uint32_t xuwWords = SUBSETSUM_WORDS(zptInput->suwSize);
+    char * xpsTemp;
+    FILE * xptFile;
+    bool xbOk;
+
+    memset(&xtHeader, 0, sizeof(xtHeader));
+    memcpy(xtHeader.sacMagic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    xtHeader.suwVersion = CHECKPOINT_VERSION;
+    xtHeader.suwSize = zptInput->suwSize;
+    xtHeader.sulTarget = zptInput->sulTarget;
+    xtHeader.sulFingerprint = Subset_Sum_Fingerprint(zptInput);
+    xtHeader.sulElapsed = zptCheckpoint->sulElapsed;
+    xtHeader.sulBestSum = zptCheckpoint->sulBestSum;
+    xtHeader.suwComplete = (zptCheckpoint->sbComplete == true) ? 1u : 0u;
+
+    if (asprintf(&xpsTemp, "%s.tmp", zpsPath) < 0)
+    {
+        return false;
+    }
+
+    xptFile = fopen(xpsTemp, "wb");
+
+    if (xptFile == NULL)
+    {
+        perror(xpsTemp);
+        free(xpsTemp);
+
+        return false;
+    }
+
+    xbOk = (fwrite(&xtHeader, sizeof(xtHeader), 1u, xptFile) == 1u) &&
+           (fwrite(zptCheckpoint->saulPosition, sizeof(uint64_t), xuwWords,
+                                                    xptFile) == xuwWords) &&
+           (fwrite(zptCheckpoint->saulBest, sizeof(uint64_t), xuwWords,
+                                                    xptFile) == xuwWords) &&
+           (fflush(xptFile) == 0) &&
+           (fsync(fileno(xptFile)) == 0);
+
+    xbOk = (fclose(xptFile) == 0) && xbOk;
+    xbOk = xbOk && (rename(xpsTemp, zpsPath) == 0);
+
+    if (xbOk == false)
+    {
+        perror(zpsPath);
+        unlink(xpsTemp);
+    }
+
+    free(xpsTemp);
+
+    return xbOk;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Checkpoint Cleanup     Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Checkpoint_Free
+*
+* \brief       Free a checkpoint's subsets
+*
+* \param[in]   zptCheckpoint        Checkpoint
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Checkpoint_Free (Checkpoint_t * zptCheckpoint)
+{
+    free(zptCheckpoint->saulPosition);
+    free(zptCheckpoint->saulBest);
+
+    zptCheckpoint->saulPosition = NULL;
+    zptCheckpoint->saulBest = NULL;
+}
+
+// \}
+
+// \}
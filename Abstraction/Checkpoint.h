@@ -0,0 +1,73 @@
+/**************************************************************************//**
+*
+* \file        Checkpoint.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+
+// ***** Definitions **********************************************************
+
+//! Checkpoint files start with this header, followed by the position and
+//! the best subset, SUBSETSUM_WORDS of the set size each.
+
+#define CHECKPOINT_MAGIC            "SSUMCKP"
+#define CHECKPOINT_VERSION          1u
+
+typedef struct Checkpoint_Header_s
+{
+    char sacMagic[8u];
+    uint32_t suwVersion;
+    uint32_t suwSize;
+    uint64_t sulTarget;
+    uint64_t sulFingerprint;    // Of the element values, see Checkpoint_Load
+    uint64_t sulElapsed;
+    uint64_t sulBestSum;
+    uint32_t suwComplete;
+    uint32_t suwReserved;
+} Checkpoint_Header_t;
+
+//! Progress of an exact search, enough to carry on where it stopped
+
+typedef struct Checkpoint_s
+{
+    uint64_t sulElapsed;        // Solve time of every run so far, ns
+    uint64_t sulBestSum;        // Sum of saulBest
+    uint64_t * saulPosition;    // Next subset to try, packed
+    uint64_t * saulBest;        // Best subset not over the target, packed
+    bool sbComplete;            // Search is over, saulBest is the answer
+} Checkpoint_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Checkpoint_Init (Checkpoint_t * zptCheckpoint,
+                                    const Subset_Sum_Input_t * zptInput);
+
+// Control functions
+
+bool Checkpoint_Load (Checkpoint_t * zptCheckpoint,
+                const Subset_Sum_Input_t * zptInput, const char * zpsPath);
+bool Checkpoint_Save (const Checkpoint_t * zptCheckpoint,
+                const Subset_Sum_Input_t * zptInput, const char * zpsPath);
+
+// Cleanup functions
+
+void Checkpoint_Free (Checkpoint_t * zptCheckpoint);
+
+#endif // !defined _CHECKPOINT_H
@@ -0,0 +1,279 @@
+/**************************************************************************//**
+*
+* \file        Deadline.c
+*
+* \defgroup    Deadline     Monotonic deadlines with amortized checks
+*
+* \details     Time limits are kept in nanoseconds against CLOCK_MONOTONIC,
+*              so sub-second limits work and wall clock adjustments do not
+*              shorten or stretch a run.
+*
+*              Solvers poll Deadline_Expired from their inner loops. Most
+*              polls only decrement a counter; the clock is read every
+*              suwStride polls, and the stride adapts so that reads happen
+*              roughly every DEADLINE_POLL_NS. The stride only halves once
+*              per read, so this suits loops whose iterations all cost about
+*              the same and are short. Their deadline is overshot by about
+*              one polling interval.
+*
+*              Loops where one iteration is long, like a scan of the whole
+*              set per step of a local search, poll Deadline_Check once per
+*              iteration instead. The clock read is lost in the work and the
+*              overshoot is one iteration. Either way the bound only holds
+*              for the loop that polls: work outside of it (setup, a single
+*              unbroken pass) adds to it.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+
+// Modules
+
+#include "Deadline.h"
+
+// ***** Definitions **********************************************************
+
+//! Aim for one clock read per this many nanoseconds of polling
+
+#define DEADLINE_POLL_NS        100000ull
+
+//! Upper bound of the polling stride
+
+#define DEADLINE_MAX_STRIDE     65536u
+
+/**************************************************************************//**
+*
+* \defgroup    Deadline Init          Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Deadline_Parse
+*
+* \brief       Parse a time limit from the command line
+*
+* \details     Accepts a decimal number with an optional unit: s, ms, us or
+*              ns. A bare number is in seconds, so existing scripts passing
+*              whole seconds keep working. "500ms", "0.25" and "2s" are all
+*              valid, "nan", "inf" and negative numbers are not.
+*
+* \param[in]   zpsText              Text to parse
+* \param[out]  zpulLimit            Limit in nanoseconds
+*
+* \retval      bool                 false if the text is not a valid limit
+*
+******************************************************************************/
+
+bool Deadline_Parse (const char * zpsText, uint64_t * zpulLimit)
+{
+    char * xpcEnd;
+    double xdValue;
+    double xdScale;
+
+    xdValue = strtod(zpsText, &xpcEnd);
+
+    // strtod also takes "nan" and "inf", neither casts to an integer
+
+    if ((xpcEnd == zpsText) || (isfinite(xdValue) == 0) || (xdValue < 0.0))
+    {
+        return false;
+    }
+
+    if ((*xpcEnd == '\0') || (strcmp(xpcEnd, "s") == 0))
+    {
+        xdScale = 1e9;
+    }
+    else if (strcmp(xpcEnd, "ms") == 0)
+    {
+        xdScale = 1e6;
+    }
+    else if (strcmp(xpcEnd, "us") == 0)
+    {
+        xdScale = 1e3;
+    }
+    else if (strcmp(xpcEnd, "ns") == 0)
+    {
+        xdScale = 1.0;
+    }
+    else
+    {
+        return false;
+    }
+
+    // Anything too large to represent simply never expires
+
+    xdValue *= xdScale;
+    *zpulLimit = (xdValue >= 1.8e19) ? DEADLINE_NONE : (uint64_t)xdValue;
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Deadline_Start
+*
+* \brief       Start a deadline
+*
+* \param[in]   zptDeadline          Deadline
+* \param[in]   zulLimit             Limit in nanoseconds, DEADLINE_NONE for
+*                                   none. A zero limit is expired right away.
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Deadline_Start (Deadline_t * zptDeadline, uint64_t zulLimit)
+{
+    zptDeadline->sulStart = Deadline_Now();
+    zptDeadline->sulLast = zptDeadline->sulStart;
+    zptDeadline->sulEnd = ((zulLimit == DEADLINE_NONE) ||
+                           (zulLimit > (DEADLINE_NONE - zptDeadline->sulStart))) ?
+                            DEADLINE_NONE : (zptDeadline->sulStart + zulLimit);
+    zptDeadline->suwStride = 1u;
+    zptDeadline->suwCountdown = 1u;
+    zptDeadline->sbExpired = (zulLimit == 0u);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Deadline Control       Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Deadline_Now
+*
+* \brief       Current CLOCK_MONOTONIC time
+*
+* \details     Goes through the vDSO on Linux, so it does not enter the
+*              kernel.
+*
+* \retval      uint64_t             Nanoseconds
+*
+******************************************************************************/
+
+uint64_t Deadline_Now (void)
+{
+    struct timespec xtNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xtNow);
+
+    return ((uint64_t)xtNow.tv_sec * DEADLINE_NS_PER_SEC) + (uint64_t)xtNow.tv_nsec;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Deadline_Expired
+*
+* \brief       Cheap check for hot loops
+*
+* \details     Only reads the clock once every suwStride calls. After each
+*              read the stride is doubled if the reads came too close
+*              together and halved if they were too far apart.
+*
+* \param[in]   zptDeadline          Deadline
+*
+* \retval      bool                 true once the limit has passed
+*
+******************************************************************************/
+
+bool Deadline_Expired (Deadline_t * zptDeadline)
+{
+    uint64_t xulNow;
+    uint64_t xulGap;
+
+    if (zptDeadline->sbExpired == true)
+    {
+        return true;
+    }
+
+    if (--zptDeadline->suwCountdown != 0u)
+    {
+        return false;
+    }
+
+    xulNow = Deadline_Now();
+    xulGap = xulNow - zptDeadline->sulLast;
+    zptDeadline->sulLast = xulNow;
+
+    if ((xulGap < (DEADLINE_POLL_NS / 2u)) &&
+        (zptDeadline->suwStride < DEADLINE_MAX_STRIDE))
+    {
+        zptDeadline->suwStride <<= 1;
+    }
+    else if ((xulGap > (DEADLINE_POLL_NS * 2u)) && (zptDeadline->suwStride > 1u))
+    {
+        zptDeadline->suwStride >>= 1;
+    }
+
+    zptDeadline->suwCountdown = zptDeadline->suwStride;
+    zptDeadline->sbExpired = (xulNow >= zptDeadline->sulEnd);
+
+    return zptDeadline->sbExpired;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Deadline_Check
+*
+* \brief       Exact check
+*
+* \details     Always reads the clock. Use this outside of hot loops, e.g.
+*              between phases of a solver.
+*
+* \param[in]   zptDeadline          Deadline
+*
+* \retval      bool                 true once the limit has passed
+*
+******************************************************************************/
+
+bool Deadline_Check (Deadline_t * zptDeadline)
+{
+    if (zptDeadline->sbExpired == false)
+    {
+        zptDeadline->sbExpired = (Deadline_Now() >= zptDeadline->sulEnd);
+    }
+
+    return zptDeadline->sbExpired;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Deadline_Elapsed
+*
+* \brief       Time since the deadline was started
+*
+* \param[in]   zptDeadline          Deadline
+*
+* \retval      uint64_t             Nanoseconds
+*
+******************************************************************************/
+
+uint64_t Deadline_Elapsed (const Deadline_t * zptDeadline)
+{
+    return Deadline_Now() - zptDeadline->sulStart;
+}
+
+// \}
+
+// \}
@@ -0,0 +1,54 @@
+/**************************************************************************//**
+*
+* \file        Deadline.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _DEADLINE_H
+#define _DEADLINE_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ***** Definitions **********************************************************
+
+#define DEADLINE_NS_PER_SEC     1000000000ull
+
+//! Limit that never expires
+
+#define DEADLINE_NONE           UINT64_MAX
+
+//! A running deadline. Each solver keeps its own, polling it from the hot
+//! loop is a counter decrement, the clock is only read every suwStride polls.
+
+typedef struct Deadline_s
+{
+    uint64_t sulStart;          // CLOCK_MONOTONIC, ns
+    uint64_t sulEnd;            // DEADLINE_NONE if there is no limit
+    uint64_t sulLast;           // Last clock read
+    uint32_t suwStride;         // Polls between clock reads
+    uint32_t suwCountdown;      // Polls left until the next read
+    bool sbExpired;
+} Deadline_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Deadline_Parse (const char * zpsText, uint64_t * zpulLimit);
+void Deadline_Start (Deadline_t * zptDeadline, uint64_t zulLimit);
+
+// Control functions
+
+uint64_t Deadline_Now (void);
+bool Deadline_Expired (Deadline_t * zptDeadline);
+bool Deadline_Check (Deadline_t * zptDeadline);
+uint64_t Deadline_Elapsed (const Deadline_t * zptDeadline);
+
+#endif // !defined _DEADLINE_H
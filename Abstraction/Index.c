@@ -0,0 +1,717 @@
+/**************************************************************************//**
+*
+* \file        Index.c
+*
+* \defgroup    Index        Prebuilt subset sum index for many targets
+*
+* \details     The solvers keep no state between targets, so asking about the
+*              same set with a new target means starting over. An index is
+*              built once per input set and then answers any target with
+*              the largest subset sum not above it, plus that subset.
+*
+*              Two layouts are used, whichever fits:
+*
+*              - Reachable sums table, when the element total is at most
+*                INDEX_TABLE_MAX. One bit per sum from 0 to the total, built
+*                with a word wide shift-or per element, plus the element
+*                that first reached each sum so the subset can be walked
+*                back. A query is a scan down from the target to the
+*                nearest set bit.
+*
+*              - Meet in the middle, when the set has at most twice
+*                INDEX_HALF_MAX elements. All subset sums of each half,
+*                sorted, with the subset as a mask. A query is one sweep up
+*                the low list with a pointer walking down the high list.
+*                Index_Query_Batch sweeps the low list once for a whole
+*                group of targets instead of once per target.
+*
+*              Larger instances cannot be indexed and Index_Build fails.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Modules
+
+#include "Index.h"
+
+// ***** Definitions **********************************************************
+
+//! Targets handled per sweep of the low list in Index_Query_Batch
+
+#define IX_BATCH            256u
+
+struct Index_s
+{
+    Subset_Sum_Input_t * sptInput;
+    bool sbTable;
+
+    // Reachable sums table
+
+    uint64_t sulTotal;
+    uint64_t * saulReach;       // Bit s set if some subset sums to s
+    uint32_t * sauwLast;        // Element that first reached sum s
+
+    // Meet in the middle, bit k of a low mask is element k, of a high mask
+    // element suwLow + k
+
+    uint32_t suwLow;
+    uint32_t suwLowCount;
+    uint32_t suwHighCount;
+    uint64_t * saulLowSums;
+    uint32_t * sauwLowMasks;
+    uint64_t * saulHighSums;
+    uint32_t * sauwHighMasks;
+};
+
+//! One target of a batch sweep
+
+typedef struct IX__Query_s
+{
+    uint64_t sulTarget;
+    uint64_t sulBest;
+    uint32_t suwSlot;           // Position in the caller's arrays
+    uint32_t suwHigh;           // High list entries still below the target
+    uint32_t suwBestLow;
+    uint32_t suwBestHigh;
+    bool sbDone;
+} IX__Query_t;
+
+// ***** Local Functions ******************************************************
+
+static bool IX__Build_Table (Index_t * zptIndex);
+static bool IX__Build_Half (const Subset_Sum_Input_t * zptInput,
+                            uint32_t zuwFirst, uint32_t zuwCount,
+                            uint64_t ** zpaulSums, uint32_t ** zpauwMasks);
+static void IX__Query_Table (const Index_t * zptIndex, uint64_t zulTarget,
+                            uint64_t * zpulBest, uint64_t * zaulSolution);
+static void IX__Query_Halves (const Index_t * zptIndex, IX__Query_t * zatQueries,
+                            uint32_t zuwCount);
+static int IX__Compare (const void * zpvA, const void * zpvB);
+
+/**************************************************************************//**
+*
+* \defgroup    Index Initialization   Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Index_Build
+*
+* \brief       Build the index of an input set
+*
+* \details     Takes a reference on the input set, Index_Free drops it. The
+*              finished index is read-only, any number of threads can query
+*              it at once.
+*
+* \param[in]   zptInput             Loaded input set
+*
+* \retval      Index_t *            NULL if the set is too large to index or
+*                                   out of memory
+*
+******************************************************************************/
+
+Index_t * Index_Build (Subset_Sum_Input_t * zptInput)
+{
+    Index_t * xptIndex;
+    uint32_t xuwSize = zptInput->suwSize;
+    bool xbOk;
+
+    xptIndex = (Index_t *)calloc(1u, sizeof(Index_t));
+
+    if (xptIndex == NULL)
+    {
+        return NULL;
+    }
+
+    __atomic_add_fetch(&zptInput->suwRefs, 1u, __ATOMIC_RELAXED);
+    xptIndex->sptInput = zptInput;
+    xptIndex->sulTotal = zptInput->sulTotal;
+
+    if (zptInput->sulTotal <= INDEX_TABLE_MAX)
+    {
+        xptIndex->sbTable = true;
+        xbOk = IX__Build_Table(xptIndex);
+    }
+    else if ((xuwSize <= (2u * INDEX_HALF_MAX)) &&
+             (zptInput->sulTotal != UINT64_MAX))
+    {
+        xptIndex->suwLow = xuwSize / 2u;
+        xptIndex->suwLowCount = 1u << xptIndex->suwLow;
+        xptIndex->suwHighCount = 1u << (xuwSize - xptIndex->suwLow);
+
+        xbOk = IX__Build_Half(zptInput, 0u, xptIndex->suwLow,
+                    &xptIndex->saulLowSums, &xptIndex->sauwLowMasks) &&
+               IX__Build_Half(zptInput, xptIndex->suwLow,
+                    xuwSize - xptIndex->suwLow,
+                    &xptIndex->saulHighSums, &xptIndex->sauwHighMasks);
+    }
+    else
+    {
+        fprintf(stderr, "%s: too large to index (%u elements, total %llu)\n",
+                zptInput->sacName, xuwSize,
+                (unsigned long long)zptInput->sulTotal);
+        xbOk = false;
+    }
+
+    if (xbOk == false)
+    {
+        Index_Free(xptIndex);
+
+        return NULL;
+    }
+
+    return xptIndex;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Index Control          Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Index_Query
+*
+* \brief       Best subset sum for one target
+*
+* \param[in]   zptIndex             Index
+* \param[in]   zulTarget            Target
+* \param[out]  zaulSolution         Packed subset, SUBSETSUM_WORDS of the set
+*                                   size, or NULL for just the sum
+*
+* \retval      uint64_t             Largest subset sum not above the target
+*
+******************************************************************************/
+
+uint64_t Index_Query (const Index_t * zptIndex, uint64_t zulTarget,
+                                                    uint64_t * zaulSolution)
+{
+    uint64_t xulBest;
+
+    Index_Query_Batch(zptIndex, &zulTarget, 1u, &xulBest, zaulSolution);
+
+    return xulBest;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Index_Query_Batch
+*
+* \brief       Best subset sums for a group of targets
+*
+* \details     Same answers as calling Index_Query on each target, but a
+*              meet in the middle index reads its lists once per IX_BATCH
+*              targets rather than once per target.
+*
+* \param[in]   zptIndex             Index
+* \param[in]   zaulTargets          Targets
+* \param[in]   zuwCount             Number of targets
+* \param[out]  zaulBest             Best sum of each target
+* \param[out]  zaulSolutions        Packed subset of each target, one after
+*                                   the other, or NULL for just the sums
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Index_Query_Batch (const Index_t * zptIndex, const uint64_t * zaulTargets,
+                uint32_t zuwCount, uint64_t * zaulBest, uint64_t * zaulSolutions)
+{
+    IX__Query_t xatQueries[IX_BATCH];
+    uint32_t xuwWords = SUBSETSUM_WORDS(zptIndex->sptInput->suwSize);
+    uint32_t xuwFirst, xuwLoop, xuwBit, xuwChunk;
+    uint64_t * xaulSolution;
+
+    if (zptIndex->sbTable == true)
+    {
+        for (xuwLoop = 0u; xuwLoop < zuwCount; xuwLoop++)
+        {
+            IX__Query_Table(zptIndex, zaulTargets[xuwLoop], &zaulBest[xuwLoop],
+                (zaulSolutions == NULL) ? NULL :
+                            &zaulSolutions[(uint64_t)xuwLoop * xuwWords]);
+        }
+
+        return;
+    }
+
+    for (xuwFirst = 0u; xuwFirst < zuwCount; xuwFirst += xuwChunk)
+    {
+        xuwChunk = ((zuwCount - xuwFirst) > IX_BATCH) ?
+                                        IX_BATCH : (zuwCount - xuwFirst);
+
+        for (xuwLoop = 0u; xuwLoop < xuwChunk; xuwLoop++)
+        {
+            xatQueries[xuwLoop].sulTarget = zaulTargets[xuwFirst + xuwLoop];
+            xatQueries[xuwLoop].suwSlot = xuwFirst + xuwLoop;
+        }
+
+        IX__Query_Halves(zptIndex, xatQueries, xuwChunk);
+
+        for (xuwLoop = 0u; xuwLoop < xuwChunk; xuwLoop++)
+        {
+            zaulBest[xatQueries[xuwLoop].suwSlot] = xatQueries[xuwLoop].sulBest;
+
+            if (zaulSolutions == NULL)
+            {
+                continue;
+            }
+
+            xaulSolution = &zaulSolutions[(uint64_t)xatQueries[xuwLoop].suwSlot *
+                                                                    xuwWords];
+            memset(xaulSolution, 0, xuwWords * sizeof(uint64_t));
+
+            for (xuwBit = 0u; xuwBit < zptIndex->suwLow; xuwBit++)
+            {
+                if ((zptIndex->sauwLowMasks[xatQueries[xuwLoop].suwBestLow] >>
+                                                            xuwBit) & 1u)
+                {
+                    xaulSolution[xuwBit >> 6] |= 1ull << (xuwBit & 63u);
+                }
+            }
+
+            for (xuwBit = zptIndex->suwLow;
+                 xuwBit < zptIndex->sptInput->suwSize; xuwBit++)
+            {
+                if ((zptIndex->sauwHighMasks[xatQueries[xuwLoop].suwBestHigh] >>
+                                        (xuwBit - zptIndex->suwLow)) & 1u)
+                {
+                    xaulSolution[xuwBit >> 6] |= 1ull << (xuwBit & 63u);
+                }
+            }
+        }
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Index_Kind
+*
+* \brief       Name of the layout the index uses
+*
+* \param[in]   zptIndex             Index
+*
+* \retval      const char *         "table" or "halves"
+*
+******************************************************************************/
+
+const char * Index_Kind (const Index_t * zptIndex)
+{
+    return (zptIndex->sbTable == true) ? "table" : "halves";
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Index Cleanup          Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Index_Free
+*
+* \brief       Free an index and drop its input set reference
+*
+* \param[in]   zptIndex             Index to free
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Index_Free (Index_t * zptIndex)
+{
+    free(zptIndex->saulReach);
+    free(zptIndex->sauwLast);
+    free(zptIndex->saulLowSums);
+    free(zptIndex->sauwLowMasks);
+    free(zptIndex->saulHighSums);
+    free(zptIndex->sauwHighMasks);
+
+    Subset_Sum_Release(zptIndex->sptInput);
+
+    free(zptIndex);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Index Internal         Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      IX__Build_Table
+*
+* \brief       Build the reachable sums table
+*
+* \details     Adds the elements one at a time: reach |= reach << value,
+*              a word at a time from the top down so every word is shifted
+*              in from sums reachable before this element. Every sum that
+*              turns on records the element. Walking a sum back through
+*              those elements only ever goes to lower elements, so each is
+*              used at most once.
+*
+* \param[in]   zptIndex             Index with its input set and total
+*
+* \retval      bool                 false if out of memory
+*
+******************************************************************************/
+
+static bool IX__Build_Table (Index_t * zptIndex)
+{
+    const Subset_Sum_Input_t * xptInput = zptIndex->sptInput;
+    uint64_t * xaulReach;
+    uint32_t xuwWords = (uint32_t)(zptIndex->sulTotal >> 6) + 1u;
+    uint32_t xuwElement, xuwWord, xuwShift, xuwBit;
+    uint64_t xulValue, xulShifted, xulNew;
+
+    xaulReach = (uint64_t *)calloc(xuwWords, sizeof(uint64_t));
+    zptIndex->saulReach = xaulReach;
+    zptIndex->sauwLast = (uint32_t *)malloc(
+                        (zptIndex->sulTotal + 1u) * sizeof(uint32_t));
+
+    if ((xaulReach == NULL) || (zptIndex->sauwLast == NULL))
+    {
+        return false;
+    }
+
+    // The empty set
+
+    xaulReach[0u] = 1u;
+
+    for (xuwElement = 0u; xuwElement < xptInput->suwSize; xuwElement++)
+    {
+        xulValue = SUBSETSUM_VALUE(xptInput, xuwElement);
+
+        if (xulValue == 0u)
+        {
+            continue;
+        }
+
+        xuwShift = (uint32_t)(xulValue >> 6);
+        xuwBit = (uint32_t)(xulValue & 63u);
+
+        for (xuwWord = xuwWords; xuwWord-- > xuwShift; )
+        {
+            xulShifted = xaulReach[xuwWord - xuwShift] << xuwBit;
+
+            if ((xuwBit != 0u) && (xuwWord > xuwShift))
+            {
+                xulShifted |= xaulReach[xuwWord - xuwShift - 1u] >>
+                                                            (64u - xuwBit);
+            }
+
+            xulNew = xulShifted & ~xaulReach[xuwWord];
+            xaulReach[xuwWord] |= xulNew;
+
+            for (; xulNew != 0u; xulNew &= xulNew - 1u)
+            {
+                zptIndex->sauwLast[((uint64_t)xuwWord << 6) +
+                                    __builtin_ctzll(xulNew)] = xuwElement;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      IX__Build_Half
+*
+* \brief       Sorted list of every subset sum of a run of elements
+*
+* \details     Starts from the empty set and merges the list with itself
+*              plus the next element, so it stays sorted without ever
+*              sorting: 2^n work in total for n elements.
+*
+* \param[in]   zptInput             Input set
+* \param[in]   zuwFirst             First element of the run
+* \param[in]   zuwCount             Elements in the run, at most
+*                                   INDEX_HALF_MAX
+* \param[out]  zpaulSums            Sums, 2^zuwCount of them, ascending
+* \param[out]  zpauwMasks           Subset of each sum, bit k for element
+*                                   zuwFirst + k
+*
+* \retval      bool                 false if out of memory
+*
+******************************************************************************/
+
+static bool IX__Build_Half (const Subset_Sum_Input_t * zptInput,
+                            uint32_t zuwFirst, uint32_t zuwCount,
+                            uint64_t ** zpaulSums, uint32_t ** zpauwMasks)
+{
+    uint32_t xuwEntries = 1u << zuwCount;
+    uint64_t * xaulSums = (uint64_t *)malloc(xuwEntries * sizeof(uint64_t));
+    uint32_t * xauwMasks = (uint32_t *)malloc(xuwEntries * sizeof(uint32_t));
+    uint64_t * xaulNext = (uint64_t *)malloc(xuwEntries * sizeof(uint64_t));
+    uint32_t * xauwNext = (uint32_t *)malloc(xuwEntries * sizeof(uint32_t));
+    uint64_t * xaulSwap;
+    uint32_t * xauwSwap;
+    uint32_t xuwLength = 1u;
+    uint32_t xuwElement, xuwOld, xuwNew, xuwOut;
+    uint64_t xulValue;
+
+    *zpaulSums = xaulSums;
+    *zpauwMasks = xauwMasks;
+
+    if ((xaulSums == NULL) || (xauwMasks == NULL) ||
+        (xaulNext == NULL) || (xauwNext == NULL))
+    {
+        free(xaulNext);
+        free(xauwNext);
+
+        return false;
+    }
+
+    xaulSums[0u] = 0u;
+    xauwMasks[0u] = 0u;
+
+    for (xuwElement = 0u; xuwElement < zuwCount; xuwElement++)
+    {
+        xulValue = SUBSETSUM_VALUE(zptInput, zuwFirst + xuwElement);
+        xuwOld = 0u;
+        xuwNew = 0u;
+
+        for (xuwOut = 0u; xuwOut < (2u * xuwLength); xuwOut++)
+        {
+            if ((xuwNew == xuwLength) || ((xuwOld < xuwLength) &&
+                        (xaulSums[xuwOld] <= (xaulSums[xuwNew] + xulValue))))
+            {
+                xaulNext[xuwOut] = xaulSums[xuwOld];
+                xauwNext[xuwOut] = xauwMasks[xuwOld++];
+            }
+            else
+            {
+                xaulNext[xuwOut] = xaulSums[xuwNew] + xulValue;
+                xauwNext[xuwOut] = xauwMasks[xuwNew++] | (1u << xuwElement);
+            }
+        }
+
+        xaulSwap = xaulSums;
+        xaulSums = xaulNext;
+        xaulNext = xaulSwap;
+        xauwSwap = xauwMasks;
+        xauwMasks = xauwNext;
+        xauwNext = xauwSwap;
+        xuwLength *= 2u;
+    }
+
+    *zpaulSums = xaulSums;
+    *zpauwMasks = xauwMasks;
+
+    free(xaulNext);
+    free(xauwNext);
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      IX__Query_Table
+*
+* \brief       Answer one target from the reachable sums table
+*
+* \param[in]   zptIndex             Table index
+* \param[in]   zulTarget            Target
+* \param[out]  zpulBest             Largest reachable sum not above it
+* \param[out]  zaulSolution         Packed subset, or NULL
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void IX__Query_Table (const Index_t * zptIndex, uint64_t zulTarget,
+                            uint64_t * zpulBest, uint64_t * zaulSolution)
+{
+    const Subset_Sum_Input_t * xptInput = zptIndex->sptInput;
+    uint64_t xulSum, xulWord;
+    uint32_t xuwWord, xuwElement;
+
+    if (zulTarget >= zptIndex->sulTotal)
+    {
+        xulSum = zptIndex->sulTotal;
+    }
+    else
+    {
+        // Nearest set bit at or below the target, bit 0 is always set
+
+        xuwWord = (uint32_t)(zulTarget >> 6);
+        xulWord = zptIndex->saulReach[xuwWord] &
+                        (~0ull >> (63u - (uint32_t)(zulTarget & 63u)));
+
+        while (xulWord == 0u)
+        {
+            xulWord = zptIndex->saulReach[--xuwWord];
+        }
+
+        xulSum = ((uint64_t)xuwWord << 6) + 63u - __builtin_clzll(xulWord);
+    }
+
+    *zpulBest = xulSum;
+
+    if (zaulSolution == NULL)
+    {
+        return;
+    }
+
+    memset(zaulSolution, 0, SUBSETSUM_WORDS(xptInput->suwSize) *
+                                                        sizeof(uint64_t));
+
+    while (xulSum != 0u)
+    {
+        xuwElement = zptIndex->sauwLast[xulSum];
+        zaulSolution[xuwElement >> 6] |= 1ull << (xuwElement & 63u);
+        xulSum -= SUBSETSUM_VALUE(xptInput, xuwElement);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      IX__Query_Halves
+*
+* \brief       Answer a group of targets from the meet in the middle lists
+*
+* \details     The targets are sorted ascending, then the low list is swept
+*              once from the bottom. For each low sum every target still
+*              open moves its own pointer down the high list to the largest
+*              high sum that still fits. A target is done once the low sums
+*              pass it, its pointer runs out, or it is hit exactly. Since
+*              the targets are sorted the ones the low sums have passed are
+*              always at the front.
+*
+* \param[in]   zptIndex             Halves index
+* \param[in]   zatQueries           Targets and slots, results filled in
+* \param[in]   zuwCount             Number of targets
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void IX__Query_Halves (const Index_t * zptIndex, IX__Query_t * zatQueries,
+                            uint32_t zuwCount)
+{
+    const uint64_t * xaulLow = zptIndex->saulLowSums;
+    const uint64_t * xaulHigh = zptIndex->saulHighSums;
+    IX__Query_t * xptQuery;
+    uint32_t xuwLow, xuwQuery;
+    uint32_t xuwFirst = 0u;
+    uint32_t xuwOpen = zuwCount;
+    uint64_t xulSum;
+
+    qsort(zatQueries, zuwCount, sizeof(IX__Query_t), IX__Compare);
+
+    // The empty set fits every target
+
+    for (xuwQuery = 0u; xuwQuery < zuwCount; xuwQuery++)
+    {
+        zatQueries[xuwQuery].sulBest = 0u;
+        zatQueries[xuwQuery].suwBestLow = 0u;
+        zatQueries[xuwQuery].suwBestHigh = 0u;
+        zatQueries[xuwQuery].suwHigh = zptIndex->suwHighCount;
+        zatQueries[xuwQuery].sbDone = false;
+    }
+
+    for (xuwLow = 0u; (xuwLow < zptIndex->suwLowCount) && (xuwOpen != 0u);
+                                                                    xuwLow++)
+    {
+        while ((xuwFirst < zuwCount) &&
+               (zatQueries[xuwFirst].sulTarget < xaulLow[xuwLow]))
+        {
+            xuwOpen -= (zatQueries[xuwFirst].sbDone == false) ? 1u : 0u;
+            zatQueries[xuwFirst++].sbDone = true;
+        }
+
+        for (xuwQuery = xuwFirst; xuwQuery < zuwCount; xuwQuery++)
+        {
+            xptQuery = &zatQueries[xuwQuery];
+
+            if (xptQuery->sbDone == true)
+            {
+                continue;
+            }
+
+            while ((xptQuery->suwHigh != 0u) &&
+                   ((xaulLow[xuwLow] + xaulHigh[xptQuery->suwHigh - 1u]) >
+                                                        xptQuery->sulTarget))
+            {
+                xptQuery->suwHigh--;
+            }
+
+            if (xptQuery->suwHigh == 0u)
+            {
+                xptQuery->sbDone = true;
+                xuwOpen--;
+                continue;
+            }
+
+            xulSum = xaulLow[xuwLow] + xaulHigh[xptQuery->suwHigh - 1u];
+
+            if (xulSum > xptQuery->sulBest)
+            {
+                xptQuery->sulBest = xulSum;
+                xptQuery->suwBestLow = xuwLow;
+                xptQuery->suwBestHigh = xptQuery->suwHigh - 1u;
+
+                if (xulSum == xptQuery->sulTarget)
+                {
+                    xptQuery->sbDone = true;
+                    xuwOpen--;
+                }
+            }
+        }
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      IX__Compare
+*
+* \brief       qsort order of batch targets, ascending
+*
+* \param[in]   zpvA                 IX__Query_t
+* \param[in]   zpvB                 IX__Query_t
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int IX__Compare (const void * zpvA, const void * zpvB)
+{
+    const IX__Query_t * xptA = (const IX__Query_t *)zpvA;
+    const IX__Query_t * xptB = (const IX__Query_t *)zpvB;
+
+    if (xptA->sulTarget != xptB->sulTarget)
+    {
+        return (xptA->sulTarget < xptB->sulTarget) ? -1 : 1;
+    }
+
+    return (xptA->suwSlot < xptB->suwSlot) ? -1 : 1;
+}
+
+// \}
+
+// \}
@@ -0,0 +1,58 @@
+/**************************************************************************//**
+*
+* \file        Index.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _INDEX_H
+#define _INDEX_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+
+// ***** Definitions **********************************************************
+
+//! Largest element total the reachable sums table is built for. The table
+//! takes a bit plus four bytes per possible sum, about 66 MB at this size.
+
+#define INDEX_TABLE_MAX         (1u << 24)
+
+//! Largest half of the set the meet-in-the-middle lists are built for. Each
+//! half list takes 12 bytes per subset, about 48 MB at this size.
+
+#define INDEX_HALF_MAX          22u
+
+//! Prebuilt index of every subset sum of one input set, so any number of
+//! targets can be answered without solving again. Opaque, see Index_Build.
+
+typedef struct Index_s Index_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+Index_t * Index_Build (Subset_Sum_Input_t * zptInput);
+
+// Control functions
+
+uint64_t Index_Query (const Index_t * zptIndex, uint64_t zulTarget,
+                                                    uint64_t * zaulSolution);
+void Index_Query_Batch (const Index_t * zptIndex, const uint64_t * zaulTargets,
+                uint32_t zuwCount, uint64_t * zaulBest, uint64_t * zaulSolutions);
+const char * Index_Kind (const Index_t * zptIndex);
+
+// Cleanup functions
+
+void Index_Free (Index_t * zptIndex);
+
+#endif // !defined _INDEX_H
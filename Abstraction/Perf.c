@@ -0,0 +1,417 @@
+/**************************************************************************//**
+*
+* \file        Perf.c
+*
+* \defgroup    Perf         Hardware counters per solver phase
+*
+* \details     Counts cycles, instructions, cache misses and branch misses of
+*              the calling thread with perf_event_open, split by solver
+*              phase: loading the instance, constructing a first solution,
+*              the local search and writing the output. The solver marks
+*              where each phase starts with Perf_Phase, which does nothing
+*              unless the thread has opened a profile, so the calls can stay
+*              in the solvers for good.
+*
+*              The four events are opened as one group so they are counted
+*              over the same intervals. If the kernel multiplexes them with
+*              other users each phase's count is scaled by the time enabled
+*              over the time running during that phase, as perf stat does
+*              for a whole run. Where perf events are not there at
+*              all (no PMU in a VM, perf_event_paranoid, seccomp) or only
+*              some are, the rest is still reported, down to wall time only.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+
+// Modules
+
+#include "Perf.h"
+#include "Deadline.h"
+
+// ***** Definitions **********************************************************
+
+//! Generic hardware events, in the order of the PERF_ event indices
+
+static const uint64_t maulConfig[PERF_EVENTS] =
+{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static const char * const mapsPhases[PERF_PHASES] =
+{
+    "load", "construct", "search", "output"
+};
+
+// ***** Local Functions ******************************************************
+
+static void PF__Read (const Perf_t * zptPerf, uint64_t (* zaaulValues)[3u]);
+
+// ***** Local variables ******************************************************
+
+//! Profile of the calling thread, NULL when it is not profiling
+
+static __thread Perf_t * mptActive;
+
+/**************************************************************************//**
+*
+* \defgroup    Perf Initialization    Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Perf_Open
+*
+* \brief       Start profiling the calling thread
+*
+* \details     The profile becomes the thread's active one, phases marked on
+*              this thread from now on are counted into it. No phase is
+*              running until the first Perf_Phase.
+*
+* \param[in]   zptPerf              Profile
+*
+* \retval      bool                 false if no hardware counter could be
+*                                   opened, only wall time is measured then
+*
+******************************************************************************/
+
+bool Perf_Open (Perf_t * zptPerf)
+{
+    struct perf_event_attr xtAttr;
+    uint32_t xuwEvent;
+    int xiLeader = -1;
+    int xiError = 0;
+
+    memset(zptPerf, 0, sizeof(Perf_t));
+    zptPerf->suwPhase = PERF_PHASES;
+
+    for (xuwEvent = 0u; xuwEvent < PERF_EVENTS; xuwEvent++)
+    {
+        memset(&xtAttr, 0, sizeof(xtAttr));
+        xtAttr.type = PERF_TYPE_HARDWARE;
+        xtAttr.size = sizeof(xtAttr);
+        xtAttr.config = maulConfig[xuwEvent];
+        xtAttr.disabled = (xiLeader < 0) ? 1u : 0u;
+        xtAttr.exclude_kernel = 1u;
+        xtAttr.exclude_hv = 1u;
+        xtAttr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                             PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // This thread only, on any CPU, grouped with the first one opened
+
+        zptPerf->saiFd[xuwEvent] = (int)syscall(SYS_perf_event_open, &xtAttr,
+                                                    0, -1, xiLeader, 0);
+
+        if (zptPerf->saiFd[xuwEvent] < 0)
+        {
+            xiError = (xiError == 0) ? errno : xiError;
+        }
+        else if (xiLeader < 0)
+        {
+            xiLeader = zptPerf->saiFd[xuwEvent];
+        }
+    }
+
+    if (xiLeader < 0)
+    {
+        fprintf(stderr, "Hardware counters unavailable (%s), "
+                        "profiling wall time only\n", strerror(xiError));
+    }
+    else
+    {
+        ioctl(xiLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    mptActive = zptPerf;
+
+    return (xiLeader >= 0);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Perf Control           Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Perf_Phase
+*
+* \brief       Mark the start of a solver phase on the calling thread
+*
+* \details     Ends the phase running so far and adds its counts to the
+*              thread's profile. A phase can be entered any number of times,
+*              its counts add up. PERF_PHASES ends the current phase without
+*              starting another. Without an active profile this is a single
+*              thread local load.
+*
+* \param[in]   zuwPhase             PERF_LOAD etc.
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Perf_Phase (uint32_t zuwPhase)
+{
+    Perf_t * xptPerf = mptActive;
+    uint64_t xaaulNow[PERF_EVENTS][3u];
+    const uint64_t * xaulStart;
+    uint64_t xulNow;
+    uint64_t xulValue, xulEnabled, xulRunning;
+    uint32_t xuwEvent;
+
+    if (xptPerf == NULL)
+    {
+        return;
+    }
+
+    PF__Read(xptPerf, xaaulNow);
+    xulNow = Deadline_Now();
+
+    if (xptPerf->suwPhase < PERF_PHASES)
+    {
+        for (xuwEvent = 0u; xuwEvent < PERF_EVENTS; xuwEvent++)
+        {
+            // Scale the phase's own count by the phase's own share of the
+            // PMU, the ratio over the whole run moves as others come and go
+
+            xaulStart = xptPerf->saaulStart[xuwEvent];
+
+            if ((xaaulNow[xuwEvent][0] < xaulStart[0]) ||
+                (xaaulNow[xuwEvent][2] <= xaulStart[2]))
+            {
+                continue;
+            }
+
+            xulValue = xaaulNow[xuwEvent][0] - xaulStart[0];
+            xulEnabled = xaaulNow[xuwEvent][1] - xaulStart[1];
+            xulRunning = xaaulNow[xuwEvent][2] - xaulStart[2];
+
+            if (xulRunning != xulEnabled)
+            {
+                xulValue = (uint64_t)((double)xulValue * xulEnabled /
+                                                                xulRunning);
+            }
+
+            xptPerf->saaulCounts[xptPerf->suwPhase][xuwEvent] += xulValue;
+        }
+
+        xptPerf->saulTime[xptPerf->suwPhase] += xulNow - xptPerf->sulStart;
+    }
+
+    memcpy(xptPerf->saaulStart, xaaulNow, sizeof(xaaulNow));
+    xptPerf->sulStart = xulNow;
+    xptPerf->suwPhase = zuwPhase;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Perf_Report
+*
+* \brief       Print a profile's phases and start it over
+*
+* \details     Ends the current phase first. One line per phase that ran,
+*              with the instructions per cycle and the misses per thousand
+*              instructions next to the raw counts. The counts are cleared
+*              afterwards so the same profile can go on with the next
+*              instance or solver.
+*
+* \param[in]   zptPerf              Profile, must be the calling thread's
+* \param[in]   zptOut               Where to print
+* \param[in]   zpsLabel             Instance and solver, printed on top
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Perf_Report (Perf_t * zptPerf, FILE * zptOut, const char * zpsLabel)
+{
+    const uint64_t * xaulCounts;
+    uint32_t xuwPhase, xuwEvent;
+    char xaacCell[PERF_EVENTS][24u];
+    double xdInstructions;
+
+    Perf_Phase(PERF_PHASES);
+
+    fprintf(zptOut, "Profile: %s\n", zpsLabel);
+    fprintf(zptOut, "  %-10s %12s %14s %14s %6s %12s %12s %8s %8s\n",
+            "phase", "ms", "cycles", "instructions", "IPC", "cache-miss",
+            "branch-miss", "CM/kI", "BM/kI");
+
+    for (xuwPhase = 0u; xuwPhase < PERF_PHASES; xuwPhase++)
+    {
+        xaulCounts = zptPerf->saaulCounts[xuwPhase];
+
+        if (zptPerf->saulTime[xuwPhase] == 0u)
+        {
+            continue;
+        }
+
+        for (xuwEvent = 0u; xuwEvent < PERF_EVENTS; xuwEvent++)
+        {
+            if (zptPerf->saiFd[xuwEvent] < 0)
+            {
+                strcpy(xaacCell[xuwEvent], "-");
+            }
+            else
+            {
+                snprintf(xaacCell[xuwEvent], sizeof(xaacCell[xuwEvent]),
+                        "%llu", (unsigned long long)xaulCounts[xuwEvent]);
+            }
+        }
+
+        xdInstructions = (double)xaulCounts[PERF_INSTRUCTIONS];
+
+        fprintf(zptOut, "  %-10s %12.3f %14s %14s ", mapsPhases[xuwPhase],
+                zptPerf->saulTime[xuwPhase] / 1e6, xaacCell[PERF_CYCLES],
+                xaacCell[PERF_INSTRUCTIONS]);
+
+        if ((zptPerf->saiFd[PERF_CYCLES] >= 0) &&
+            (zptPerf->saiFd[PERF_INSTRUCTIONS] >= 0) &&
+            (xaulCounts[PERF_CYCLES] > 0u))
+        {
+            fprintf(zptOut, "%6.2f ",
+                                xdInstructions / xaulCounts[PERF_CYCLES]);
+        }
+        else
+        {
+            fprintf(zptOut, "%6s ", "-");
+        }
+
+        fprintf(zptOut, "%12s %12s", xaacCell[PERF_CACHE_MISSES],
+                                        xaacCell[PERF_BRANCH_MISSES]);
+
+        for (xuwEvent = PERF_CACHE_MISSES; xuwEvent <= PERF_BRANCH_MISSES;
+                                                                xuwEvent++)
+        {
+            if ((zptPerf->saiFd[xuwEvent] >= 0) &&
+                (zptPerf->saiFd[PERF_INSTRUCTIONS] >= 0) &&
+                (xdInstructions > 0.0))
+            {
+                fprintf(zptOut, " %8.3f",
+                        1000.0 * xaulCounts[xuwEvent] / xdInstructions);
+            }
+            else
+            {
+                fprintf(zptOut, " %8s", "-");
+            }
+        }
+
+        fprintf(zptOut, "\n");
+    }
+
+    memset(zptPerf->saaulCounts, 0, sizeof(zptPerf->saaulCounts));
+    memset(zptPerf->saulTime, 0, sizeof(zptPerf->saulTime));
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Perf Cleanup           Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Perf_Close
+*
+* \brief       Stop profiling the calling thread
+*
+* \param[in]   zptPerf              Profile
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Perf_Close (Perf_t * zptPerf)
+{
+    uint32_t xuwEvent;
+
+    if (mptActive == zptPerf)
+    {
+        mptActive = NULL;
+    }
+
+    for (xuwEvent = 0u; xuwEvent < PERF_EVENTS; xuwEvent++)
+    {
+        if (zptPerf->saiFd[xuwEvent] >= 0)
+        {
+            close(zptPerf->saiFd[xuwEvent]);
+        }
+
+        zptPerf->saiFd[xuwEvent] = -1;
+    }
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Perf Internal          Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      PF__Read
+*
+* \brief       Read every open counter as it stands
+*
+* \details     Unscaled, Perf_Phase scales the difference between two
+*              readings.
+*
+* \param[in]   zptPerf              Profile
+* \param[out]  zaaulValues          PERF_EVENTS readings of value, time
+*                                   enabled and time running, 0 if not open
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void PF__Read (const Perf_t * zptPerf, uint64_t (* zaaulValues)[3u])
+{
+    uint32_t xuwEvent;
+
+    for (xuwEvent = 0u; xuwEvent < PERF_EVENTS; xuwEvent++)
+    {
+        if ((zptPerf->saiFd[xuwEvent] < 0) ||
+            (read(zptPerf->saiFd[xuwEvent], zaaulValues[xuwEvent],
+                                sizeof(zaaulValues[xuwEvent])) !=
+                                        sizeof(zaaulValues[xuwEvent])))
+        {
+            memset(zaaulValues[xuwEvent], 0, sizeof(zaaulValues[xuwEvent]));
+        }
+    }
+}
+
+// \}
+
+// \}
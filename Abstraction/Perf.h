@@ -0,0 +1,74 @@
+/**************************************************************************//**
+*
+* \file        Perf.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _PERF_H
+#define _PERF_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// ***** Definitions **********************************************************
+
+//! Solver phases, see Perf_Phase
+
+enum
+{
+    PERF_LOAD,
+    PERF_CONSTRUCT,
+    PERF_SEARCH,
+    PERF_OUTPUT,
+    PERF_PHASES
+};
+
+//! Hardware events counted in every phase
+
+enum
+{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_EVENTS
+};
+
+//! Per phase totals of one thread. Counters the kernel or CPU does not
+//! offer have a descriptor of -1 and are reported as "-", the wall time is
+//! always there.
+
+typedef struct Perf_s
+{
+    uint64_t saaulCounts[PERF_PHASES][PERF_EVENTS];
+    uint64_t saulTime[PERF_PHASES];     // ns
+    int saiFd[PERF_EVENTS];
+    uint32_t suwPhase;                  // Current, PERF_PHASES for none
+    uint64_t saaulStart[PERF_EVENTS][3u];   // Value, time enabled and time
+                                            // running when it started, raw
+    uint64_t sulStart;                  // CLOCK_MONOTONIC when it started
+} Perf_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Perf_Open (Perf_t * zptPerf);
+
+// Control functions
+
+void Perf_Phase (uint32_t zuwPhase);
+void Perf_Report (Perf_t * zptPerf, FILE * zptOut, const char * zpsLabel);
+
+// Cleanup functions
+
+void Perf_Close (Perf_t * zptPerf);
+
+#endif // !defined _PERF_H
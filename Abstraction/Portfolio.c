@@ -0,0 +1,203 @@
+/**************************************************************************//**
+*
+* \file        Portfolio.c
+*
+* \defgroup    Portfolio    Run several solvers concurrently on one input set
+*
+* \details     Each instance handed to the portfolio is solved on its own
+*              thread. All of them are linked to one shared incumbent, so the
+*              best-so-far sum is visible to everyone and the first solver to
+*              hit the target cancels the rest. The total wall time is
+*              therefore bounded by a single solver's time limit rather than
+*              the sum of all of them.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// Modules
+
+#include "Portfolio.h"
+
+// ***** Local Functions ******************************************************
+
+static void * PF__Thread (void * zpvArg);
+
+/**************************************************************************//**
+*
+* \defgroup    Portfolio Lookup       Lookup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Portfolio_Find
+*
+* \brief       Find a registered solver by name
+*
+* \details     Linear search of the given solver table.
+*
+* \param[in]   zatSolvers           Solver table
+* \param[in]   zuwCount             Entries in the table
+* \param[in]   zpsName              Name to look for
+*
+* \retval      const Portfolio_Solver_t *    NULL if not registered
+*
+******************************************************************************/
+
+const Portfolio_Solver_t * Portfolio_Find (const Portfolio_Solver_t * zatSolvers,
+                                    uint32_t zuwCount, const char * zpsName)
+{
+    uint32_t xuwLoop;
+
+    for (xuwLoop = 0u; xuwLoop < zuwCount; xuwLoop++)
+    {
+        if (strcmp(zatSolvers[xuwLoop].spsName, zpsName) == 0)
+        {
+            return &zatSolvers[xuwLoop];
+        }
+    }
+
+    return NULL;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Portfolio Control      Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Portfolio_Run
+*
+* \brief       Solve all given instances in parallel
+*
+* \details     Links every instance to a common incumbent, starts one thread
+*              per instance and waits for all of them to finish. Solvers are
+*              expected to poll Subset_Sum_Cancelled and to report their
+*              improvements with Subset_Sum_Publish. The instances are
+*              detached from the incumbent again before returning, so they
+*              can be written out or reused as normal. Without memory for
+*              the thread table the solvers run one after the other on the
+*              calling thread, still sharing the incumbent.
+*
+* \param[in]   zatInsts             Instances with their solvers already set
+* \param[in]   zuwCount             Number of instances
+*
+* \retval      uint64_t             Best feasible sum found by any solver
+*
+******************************************************************************/
+
+uint64_t Portfolio_Run (Subset_Sum_t * zatInsts, uint32_t zuwCount)
+{
+    Subset_Sum_Shared_t xtShared;
+    pthread_t * xatThreads;
+    bool * xabStarted;
+    uint32_t xuwLoop;
+    bool xbThreads;
+
+    memset(&xtShared, 0, sizeof(xtShared));
+
+    xatThreads = (pthread_t *)malloc(zuwCount * sizeof(pthread_t));
+    xabStarted = (bool *)calloc(zuwCount, sizeof(bool));
+    xbThreads = (xatThreads != NULL) && (xabStarted != NULL);
+
+    // Link everyone first so no solver can miss an early hit
+
+    for (xuwLoop = 0u; xuwLoop < zuwCount; xuwLoop++)
+    {
+        Subset_Sum_SetShared(&zatInsts[xuwLoop], &xtShared);
+    }
+
+    // Kick off the solvers. If a thread cannot be created just run that
+    // solver on this thread instead, it will still see the incumbent.
+
+    for (xuwLoop = 0u; xuwLoop < zuwCount; xuwLoop++)
+    {
+        if (xbThreads == true)
+        {
+            xabStarted[xuwLoop] = (pthread_create(&xatThreads[xuwLoop], NULL,
+                                    PF__Thread, &zatInsts[xuwLoop]) == 0);
+        }
+
+        if ((xbThreads == false) || (xabStarted[xuwLoop] == false))
+        {
+            PF__Thread(&zatInsts[xuwLoop]);
+        }
+    }
+
+    // Wait for all of them
+
+    for (xuwLoop = 0u; xuwLoop < zuwCount; xuwLoop++)
+    {
+        if ((xbThreads == true) && (xabStarted[xuwLoop] == true))
+        {
+            pthread_join(xatThreads[xuwLoop], NULL);
+        }
+
+        Subset_Sum_SetShared(&zatInsts[xuwLoop], NULL);
+    }
+
+    free(xatThreads);
+    free(xabStarted);
+
+    return xtShared.sulBestSum;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Portfolio Internal     Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      PF__Thread
+*
+* \brief       Worker thread entry
+*
+* \details     Runs the instance's solver and publishes whatever it ended
+*              with, in case the solver itself never did, see
+*              Subset_Sum_Offer.
+*
+* \param[in]   zpvArg               Subset_Sum_t to solve
+*
+* \retval      void *
+*
+******************************************************************************/
+
+static void * PF__Thread (void * zpvArg)
+{
+    Subset_Sum_t * xptInst = (Subset_Sum_t *)zpvArg;
+
+    Subset_Sum_Solve(xptInst);
+    Subset_Sum_Offer(xptInst);
+
+    return NULL;
+}
+
+// \}
+
+// \}
@@ -0,0 +1,44 @@
+/**************************************************************************//**
+*
+* \file        Portfolio.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _PORTFOLIO_H
+#define _PORTFOLIO_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+
+// ***** Definitions **********************************************************
+
+//! A registered solver. The name doubles as the output folder so each
+//! solver's contribution still lands in its own directory.
+
+typedef struct Portfolio_Solver_s
+{
+    const char * spsName;
+    Algorithm_t spfSolver;
+} Portfolio_Solver_t;
+
+// ***** Function prototypes **************************************************
+
+// Lookup functions
+
+const Portfolio_Solver_t * Portfolio_Find (const Portfolio_Solver_t * zatSolvers,
+                                    uint32_t zuwCount, const char * zpsName);
+
+// Control functions
+
+uint64_t Portfolio_Run (Subset_Sum_t * zatInsts, uint32_t zuwCount);
+
+#endif // !defined _PORTFOLIO_H
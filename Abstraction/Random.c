@@ -0,0 +1,187 @@
+/**************************************************************************//**
+*
+* \file        Random.c
+*
+* \defgroup    Random       Small, fast, seedable pseudo random numbers
+*
+* \details     xoshiro256** seeded through splitmix64. Unlike rand() the
+*              state lives in the caller's Random_t, so threads never share
+*              or lock anything and a given seed always reproduces the same
+*              stream regardless of scheduling.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+// C Standard
+
+#include <stdint.h>
+
+// Modules
+
+#include "Random.h"
+
+// ***** Definitions **********************************************************
+
+#define RND__ROTL(x, k)     (((x) << (k)) | ((x) >> (64 - (k))))
+
+/**************************************************************************//**
+*
+* \defgroup    Random Init        Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Random_Seed
+*
+* \brief       Seed a generator
+*
+* \details     Expands the 64-bit seed into the full state with splitmix64,
+*              which also guarantees the state is never all zero.
+*
+* \param[in]   zptRng               Generator
+* \param[in]   zulSeed              Seed
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Random_Seed (Random_t * zptRng, uint64_t zulSeed)
+{
+    uint32_t xuwLoop;
+
+    for (xuwLoop = 0u; xuwLoop < 4u; xuwLoop++)
+    {
+        zulSeed += 0x9E3779B97F4A7C15ull;
+        zptRng->saulState[xuwLoop] = Random_Mix(zulSeed);
+    }
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Random Generation  Generation Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Random_Next
+*
+* \brief       Next 64 random bits
+*
+* \param[in]   zptRng               Generator
+*
+* \retval      uint64_t
+*
+******************************************************************************/
+
+uint64_t Random_Next (Random_t * zptRng)
+{
+    uint64_t * xpulS = zptRng->saulState;
+    uint64_t xulResult = RND__ROTL(xpulS[1] * 5u, 7) * 9u;
+    uint64_t xulT = xpulS[1] << 17;
+
+    xpulS[2] ^= xpulS[0];
+    xpulS[3] ^= xpulS[1];
+    xpulS[1] ^= xpulS[2];
+    xpulS[0] ^= xpulS[3];
+    xpulS[2] ^= xulT;
+    xpulS[3] = RND__ROTL(xpulS[3], 45);
+
+    return xulResult;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Random_Bits
+*
+* \brief       Uniform random number of the given bit width
+*
+* \details     Takes the top bits of the next output, which are the
+*              strongest ones of xoshiro256**.
+*
+* \param[in]   zptRng               Generator
+* \param[in]   zuwBits              Width, 1 to 64
+*
+* \retval      uint64_t             Value in [0, 2^zuwBits)
+*
+******************************************************************************/
+
+uint64_t Random_Bits (Random_t * zptRng, uint32_t zuwBits)
+{
+    return Random_Next(zptRng) >> (64u - zuwBits);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Random_Below
+*
+* \brief       Unbiased random number below a bound
+*
+* \details     Rejects the few values at the top of the range that would
+*              otherwise make the modulo biased.
+*
+* \param[in]   zptRng               Generator
+* \param[in]   zulBound             Exclusive upper bound, non zero
+*
+* \retval      uint64_t             Value in [0, zulBound)
+*
+******************************************************************************/
+
+uint64_t Random_Below (Random_t * zptRng, uint64_t zulBound)
+{
+    uint64_t xulLimit = UINT64_MAX - (UINT64_MAX % zulBound);
+    uint64_t xulValue;
+
+    do
+    {
+        xulValue = Random_Next(zptRng);
+    } while (xulValue >= xulLimit);
+
+    return xulValue % zulBound;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Random Helpers     Seeding Helpers
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Random_Mix
+*
+* \brief       splitmix64 finalizer
+*
+* \details     Useful on its own to derive independent seeds, e.g. one per
+*              instance of a sweep from a single user seed.
+*
+* \param[in]   zulValue             Value to mix
+*
+* \retval      uint64_t
+*
+******************************************************************************/
+
+uint64_t Random_Mix (uint64_t zulValue)
+{
+    zulValue = (zulValue ^ (zulValue >> 30)) * 0xBF58476D1CE4E5B9ull;
+    zulValue = (zulValue ^ (zulValue >> 27)) * 0x94D049BB133111EBull;
+
+    return zulValue ^ (zulValue >> 31);
+}
+
+// \}
+
+// \}
@@ -0,0 +1,43 @@
+/**************************************************************************//**
+*
+* \file        Random.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _RANDOM_H
+#define _RANDOM_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+
+// ***** Definitions **********************************************************
+
+//! Generator state. Each thread keeps its own, there is nothing global.
+
+typedef struct Random_s
+{
+    uint64_t saulState[4u];
+} Random_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+void Random_Seed (Random_t * zptRng, uint64_t zulSeed);
+
+// Generation functions
+
+uint64_t Random_Next (Random_t * zptRng);
+uint64_t Random_Bits (Random_t * zptRng, uint32_t zuwBits);
+uint64_t Random_Below (Random_t * zptRng, uint64_t zulBound);
+
+// Seeding helpers
+
+uint64_t Random_Mix (uint64_t zulValue);
+
+#endif // !defined _RANDOM_H
@@ -0,0 +1,799 @@
+/**************************************************************************//**
+*
+* \file        Select.c
+*
+* \defgroup    Select       Pick the solver that fits an instance
+*
+* \details     Which solver works best depends on the instance. The
+*              exhaustive search proves the optimum but grows with 2^n, the
+*              greedy constructions are linear but miss exact subsets on
+*              sparse sets, and the tabu list costs 194 bits per element.
+*              Select_Solve (the "auto" solver) measures a few cheap
+*              features of the set and runs whatever the cost model says
+*              does best within the time limit and memory budget.
+*
+*              Features (Select_Features): the size n, the bit width b, the
+*              number of duplicate values and from those the density. Dense
+*              sets (at least as many distinct values as bits) have many
+*              subsets on the target, sparse ones have exponentially few.
+*              Duplicates add no new sums, so they do not count towards the
+*              density.
+*
+*              Every solver has a model row (Select_Model_t): how its
+*              runtime and memory grow with n, the cost per unit of growth
+*              and how often it hits the target on dense and on sparse
+*              sets. The built in rows are a calibration on the instances/
+*              set. bench.py --model fits new ones from a benchmark run,
+*              Select_Open loads them (SSUM_MODEL).
+*
+*              The choice (Select_Choose): an exact solver that is predicted
+*              to finish in time runs alone, nothing can beat it. Otherwise
+*              the solvers that fit the budget are ranked by their hit rate
+*              on this kind of set. A sure one runs alone, uncertain ones
+*              run as a small portfolio sharing one incumbent (Portfolio.c),
+*              as many as there are CPUs and memory for.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+// Modules
+
+#include "Select.h"
+
+// ***** Definitions **********************************************************
+
+//! Hit rate, per mille, at which a solver runs alone
+
+#define SE_CERTAIN          900u
+
+//! Score of an exact solver that runs to the end
+
+#define SE_PROOF            1000u
+
+//! A solver the model has a row for, ranked by Select_Choose
+
+typedef struct SE__Candidate_s
+{
+    uint32_t suwIndex;          // Into the solver table
+    uint32_t suwScore;          // Predicted hit rate, per mille
+    uint64_t sulTime;
+    uint64_t sulMemory;
+    bool sbTime;                // Predicted to finish within the limit
+    bool sbMemory;              // Predicted to fit the memory budget
+} SE__Candidate_t;
+
+// ***** Local Functions ******************************************************
+
+static uint64_t SE__Units (uint8_t zucKind, uint32_t zuwSize);
+static uint8_t SE__Kind (const char * zpsText);
+static int SE__Compare (const void * zpvLeft, const void * zpvRight);
+
+// ***** Local variables ******************************************************
+
+//! Cost models, fitted by bench.py --model to three runs of the instances/
+//! set and its large generated sweep at 100ms (-O0 build). P3 does not time
+//! itself, it counts as free. Memory is what the solvers allocate: the
+//! solution bits, and per element the tabu list's skip bit, the head and
+//! tail of its partner list and two 64-bit ring entries.
+
+static Select_Model_t matModels[SELECT_MODELS] =
+{
+    {"p1.exhaustive", SELECT_EXPONENTIAL, SELECT_LINEAR,    true,
+                                    45638u, 510u,   1u, 4096u, 160u, 400u},
+    {"p3.greedy",     SELECT_LINEAR,      SELECT_LINEAR,    false,
+                                    0u,     0u,     1u, 4096u, 176u, 172u},
+    {"p5.greedy",     SELECT_QUADRATIC,   SELECT_LINEAR,    false,
+                                    1799u,  0u,     1u, 4096u, 294u, 293u},
+    {"p5.random",     SELECT_QUADRATIC,   SELECT_LINEAR,    false,
+                                    1562u,  45421u, 1u, 4096u, 261u, 155u},
+    {"p5.tabu",       SELECT_QUADRATIC,   SELECT_LINEAR,    false,
+                                    1665u,  0u,   194u, 4096u, 294u, 293u},
+};
+
+static uint32_t muwModels = 5u;
+
+/**************************************************************************//**
+*
+* \defgroup    Select Initialization  Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Select_Open
+*
+* \brief       Load a calibrated cost model
+*
+* \details     A CSV as written by bench.py --model, one row per solver:
+*
+*              solver,time,ps_per_unit,ns_fixed,memory,bits_per_unit,
+*              bytes_fixed,exact,dense,sparse
+*
+*              with "n", "n2" or "2n" for the kinds. A row replaces the built
+*              in one of the same solver. The header and lines starting
+*              with '#' are skipped. Nothing is taken from a file with a bad
+*              row. Call before any solve, usually with getenv(SELECT_ENV).
+*
+* \param[in]   zpsPath              Model file, NULL or empty for the built
+*                                   in model
+*
+* \retval      bool                 false if no file was loaded
+*
+******************************************************************************/
+
+bool Select_Open (const char * zpsPath)
+{
+    Select_Model_t xatModels[SELECT_MODELS];
+    Select_Model_t xtRow;
+    const Select_Model_t * xptOld;
+    unsigned long long xaullField[7];
+    char xacTime[8], xacMemory[8];
+    char xacLine[256];
+    uint32_t xuwModels = muwModels;
+    uint32_t xuwLine = 0u;
+    uint32_t xuwLoop;
+    FILE * xptFile;
+
+    if ((zpsPath == NULL) || (zpsPath[0] == '\0'))
+    {
+        return false;
+    }
+
+    xptFile = fopen(zpsPath, "r");
+
+    if (xptFile == NULL)
+    {
+        perror(zpsPath);
+
+        return false;
+    }
+
+    memcpy(xatModels, matModels, sizeof(matModels));
+
+    while (fgets(xacLine, sizeof(xacLine), xptFile) != NULL)
+    {
+        xuwLine++;
+
+        if ((xacLine[0] == '#') || (xacLine[0] == '\n') ||
+            (strncmp(xacLine, "solver,", 7u) == 0))
+        {
+            continue;
+        }
+
+        memset(&xtRow, 0, sizeof(xtRow));
+
+        if ((sscanf(xacLine, "%31[^,],%7[^,],%llu,%llu,%7[^,],%llu,%llu,"
+                             "%llu,%llu,%llu", xtRow.sacSolver, xacTime,
+                    &xaullField[0], &xaullField[1], xacMemory, &xaullField[2],
+                    &xaullField[3], &xaullField[4], &xaullField[5],
+                    &xaullField[6]) != 10) ||
+            (SE__Kind(xacTime) > SELECT_EXPONENTIAL) ||
+            (SE__Kind(xacMemory) > SELECT_EXPONENTIAL))
+        {
+            fprintf(stderr, "%s:%u: bad model row\n", zpsPath, xuwLine);
+            fclose(xptFile);
+
+            return false;
+        }
+
+        xtRow.sucTime = SE__Kind(xacTime);
+        xtRow.sucMemory = SE__Kind(xacMemory);
+        xtRow.sulPsPerUnit = xaullField[0];
+        xtRow.sulNsFixed = xaullField[1];
+        xtRow.sulBitsPerUnit = xaullField[2];
+        xtRow.sulBytesFixed = xaullField[3];
+        xtRow.sbExact = (xaullField[4] != 0u);
+        xtRow.suwDense = (xaullField[5] > SE_PROOF) ? SE_PROOF :
+                                                    (uint32_t)xaullField[5];
+        xtRow.suwSparse = (xaullField[6] > SE_PROOF) ? SE_PROOF :
+                                                    (uint32_t)xaullField[6];
+
+        // Same solver as a built in row or an earlier one: replace it
+
+        xptOld = NULL;
+
+        for (xuwLoop = 0u; xuwLoop < xuwModels; xuwLoop++)
+        {
+            if (strcmp(xatModels[xuwLoop].sacSolver, xtRow.sacSolver) == 0)
+            {
+                xptOld = &xatModels[xuwLoop];
+                break;
+            }
+        }
+
+        if ((xptOld == NULL) && (xuwModels == SELECT_MODELS))
+        {
+            fprintf(stderr, "%s:%u: too many models\n", zpsPath, xuwLine);
+            fclose(xptFile);
+
+            return false;
+        }
+
+        xatModels[xuwLoop] = xtRow;
+        xuwModels += (xptOld == NULL) ? 1u : 0u;
+    }
+
+    fclose(xptFile);
+
+    memcpy(matModels, xatModels, sizeof(matModels));
+    muwModels = xuwModels;
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Select_Parse_Memory
+*
+* \brief       Parse a memory budget from the command line
+*
+* \details     A number of bytes with an optional binary unit: k, M or G.
+*              "512M" and "1.5G" are both valid.
+*
+* \param[in]   zpsText              Text to parse
+* \param[out]  zpulBytes            Budget in bytes
+*
+* \retval      bool                 false if the text is not a valid budget
+*
+******************************************************************************/
+
+bool Select_Parse_Memory (const char * zpsText, uint64_t * zpulBytes)
+{
+    char * xpcEnd;
+    double xdValue;
+    double xdScale;
+
+    xdValue = strtod(zpsText, &xpcEnd);
+
+    if ((xpcEnd == zpsText) || (xdValue < 0.0))
+    {
+        return false;
+    }
+
+    if (*xpcEnd == '\0')
+    {
+        xdScale = 1.0;
+    }
+    else if (strcmp(xpcEnd, "k") == 0)
+    {
+        xdScale = 1024.0;
+    }
+    else if (strcmp(xpcEnd, "M") == 0)
+    {
+        xdScale = 1024.0 * 1024.0;
+    }
+    else if (strcmp(xpcEnd, "G") == 0)
+    {
+        xdScale = 1024.0 * 1024.0 * 1024.0;
+    }
+    else
+    {
+        return false;
+    }
+
+    xdValue *= xdScale;
+    *zpulBytes = (xdValue >= 1.8e19) ? UINT64_MAX : (uint64_t)xdValue;
+
+    return true;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Select Control         Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Select_Features
+*
+* \brief       Measure the features the cost model works from
+*
+* \details     A pass over the set and one over its sorted order. The order
+*              is built on the first call (n log n, 4n bytes) and stays with
+*              the set, see Subset_Sum_GetOrder.
+*
+* \param[in]   zptInput             Input set
+* \param[out]  zptFeatures          Its features
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Select_Features (const Subset_Sum_Input_t * zptInput,
+                                    Select_Features_t * zptFeatures)
+{
+    const uint32_t * xauwOrder = Subset_Sum_GetOrder(zptInput);
+    uint32_t xuwLoop;
+
+    zptFeatures->suwSize = zptInput->suwSize;
+    zptFeatures->suwBits = Subset_Sum_GetBits(zptInput);
+    zptFeatures->suwDuplicates = 0u;
+
+    // Equal values are next to each other in the sorted order
+
+    for (xuwLoop = 1u; (xauwOrder != NULL) && (xuwLoop < zptInput->suwSize);
+         xuwLoop++)
+    {
+        if (SUBSETSUM_VALUE(zptInput, xauwOrder[xuwLoop]) ==
+            SUBSETSUM_VALUE(zptInput, xauwOrder[xuwLoop - 1u]))
+        {
+            zptFeatures->suwDuplicates++;
+        }
+    }
+
+    zptFeatures->sbDense = ((zptFeatures->suwSize -
+                    zptFeatures->suwDuplicates) >= zptFeatures->suwBits);
+    zptFeatures->sbReachable = (zptInput->sulTotal >= zptInput->sulTarget);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Select_Find
+*
+* \brief       Find the cost model of a solver
+*
+* \param[in]   zpsSolver            Cache name of the solver
+*
+* \retval      const Select_Model_t *   NULL if it has none
+*
+******************************************************************************/
+
+const Select_Model_t * Select_Find (const char * zpsSolver)
+{
+    uint32_t xuwLoop;
+
+    for (xuwLoop = 0u; xuwLoop < muwModels; xuwLoop++)
+    {
+        if (strcmp(matModels[xuwLoop].sacSolver, zpsSolver) == 0)
+        {
+            return &matModels[xuwLoop];
+        }
+    }
+
+    return NULL;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Select_Runtime
+*
+* \brief       Predict how long a solver takes to run to the end
+*
+* \param[in]   zptModel             Solver's model
+* \param[in]   zptFeatures          Instance features
+*
+* \retval      uint64_t             ns, saturated
+*
+******************************************************************************/
+
+uint64_t Select_Runtime (const Select_Model_t * zptModel,
+                                    const Select_Features_t * zptFeatures)
+{
+    unsigned __int128 xTime;
+
+    xTime = (unsigned __int128)SE__Units(zptModel->sucTime,
+                    zptFeatures->suwSize) * zptModel->sulPsPerUnit / 1000u +
+            zptModel->sulNsFixed;
+
+    return (xTime > UINT64_MAX) ? UINT64_MAX : (uint64_t)xTime;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Select_Memory
+*
+* \brief       Predict how much memory a solver needs
+*
+* \param[in]   zptModel             Solver's model
+* \param[in]   zptFeatures          Instance features
+*
+* \retval      uint64_t             Bytes, saturated
+*
+******************************************************************************/
+
+uint64_t Select_Memory (const Select_Model_t * zptModel,
+                                    const Select_Features_t * zptFeatures)
+{
+    unsigned __int128 xBytes;
+
+    xBytes = (unsigned __int128)SE__Units(zptModel->sucMemory,
+                    zptFeatures->suwSize) * zptModel->sulBitsPerUnit / 8u +
+             zptModel->sulBytesFixed;
+
+    return (xBytes > UINT64_MAX) ? UINT64_MAX : (uint64_t)xBytes;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Select_Choose
+*
+* \brief       Pick the solver or small portfolio for an instance
+*
+* \details     Solvers without a model row are never picked. If the target
+*              is out of reach every element fits, so the cheapest solver
+*              takes them all. If nothing fits the budget the quickest
+*              solver that fits the memory runs alone, it is cut off at the
+*              time limit like any other.
+*
+* \param[in]   zatSolvers           Solver table
+* \param[in]   zuwCount             Entries in the table
+* \param[in]   zpsPrefix            Turns a table name into the model's
+*                                   cache name, e.g. "p5."
+* \param[in]   zptFeatures          Instance features
+* \param[in]   zulTimeLimit         ns
+* \param[in]   zulMemory            Bytes, 0 for no budget
+* \param[out]  zauwChosen           SELECT_PORTFOLIO table indices, the
+*                                   most promising first
+*
+* \retval      uint32_t             Number chosen, 0 if no solver has a model
+*
+******************************************************************************/
+
+uint32_t Select_Choose (const Portfolio_Solver_t * zatSolvers,
+            uint32_t zuwCount, const char * zpsPrefix,
+            const Select_Features_t * zptFeatures, uint64_t zulTimeLimit,
+            uint64_t zulMemory, uint32_t * zauwChosen)
+{
+    SE__Candidate_t * xatCandidates;
+    SE__Candidate_t * xptCandidate;
+    const Select_Model_t * xptModel;
+    char xacName[64];
+    uint64_t xulUsed;
+    uint32_t xuwCandidates = 0u;
+    uint32_t xuwChosen = 0u;
+    uint32_t xuwMost;
+    uint32_t xuwLoop;
+    long xlCpus;
+
+    zulMemory = (zulMemory == 0u) ? UINT64_MAX : zulMemory;
+
+    xatCandidates = (SE__Candidate_t *)calloc((zuwCount > 0u) ? zuwCount : 1u,
+                                                    sizeof(SE__Candidate_t));
+
+    if (xatCandidates == NULL)
+    {
+        return 0u;
+    }
+
+    for (xuwLoop = 0u; xuwLoop < zuwCount; xuwLoop++)
+    {
+        snprintf(xacName, sizeof(xacName), "%s%s", zpsPrefix,
+                                            zatSolvers[xuwLoop].spsName);
+        xptModel = Select_Find(xacName);
+
+        if (xptModel == NULL)
+        {
+            continue;
+        }
+
+        xptCandidate = &xatCandidates[xuwCandidates++];
+        xptCandidate->suwIndex = xuwLoop;
+        xptCandidate->sulTime = Select_Runtime(xptModel, zptFeatures);
+        xptCandidate->sulMemory = Select_Memory(xptModel, zptFeatures);
+        xptCandidate->sbTime = (xptCandidate->sulTime <= zulTimeLimit);
+        xptCandidate->sbMemory = (xptCandidate->sulMemory <= zulMemory);
+
+        if ((xptModel->sbExact == true) && (xptCandidate->sbTime == true))
+        {
+            xptCandidate->suwScore = SE_PROOF;
+        }
+        else if (zptFeatures->sbReachable == false)
+        {
+            xptCandidate->suwScore = SE_PROOF - 1u;
+        }
+        else
+        {
+            xptCandidate->suwScore = (zptFeatures->sbDense == true) ?
+                                    xptModel->suwDense : xptModel->suwSparse;
+        }
+    }
+
+    if (xuwCandidates == 0u)
+    {
+        free(xatCandidates);
+
+        return 0u;
+    }
+
+    qsort(xatCandidates, xuwCandidates, sizeof(SE__Candidate_t), SE__Compare);
+
+    zauwChosen[xuwChosen++] = xatCandidates[0].suwIndex;
+    xulUsed = xatCandidates[0].sulMemory;
+
+    // One solver is enough if it is sure to do best, or nothing fits
+
+    if ((xatCandidates[0].suwScore >= SE_CERTAIN) ||
+        (xatCandidates[0].sbTime == false) ||
+        (xatCandidates[0].sbMemory == false))
+    {
+        free(xatCandidates);
+
+        return xuwChosen;
+    }
+
+    // Otherwise the next best ones that fit, one CPU each
+
+    xlCpus = sysconf(_SC_NPROCESSORS_ONLN);
+    xuwMost = ((xlCpus > 0) && ((uint32_t)xlCpus < SELECT_PORTFOLIO)) ?
+                                        (uint32_t)xlCpus : SELECT_PORTFOLIO;
+
+    for (xuwLoop = 1u; (xuwLoop < xuwCandidates) && (xuwChosen < xuwMost);
+         xuwLoop++)
+    {
+        xptCandidate = &xatCandidates[xuwLoop];
+
+        if ((xptCandidate->sbTime == true) && (xptCandidate->suwScore > 0u) &&
+            (xptCandidate->sulMemory <= (zulMemory - xulUsed)))
+        {
+            zauwChosen[xuwChosen++] = xptCandidate->suwIndex;
+            xulUsed += xptCandidate->sulMemory;
+        }
+    }
+
+    free(xatCandidates);
+
+    return xuwChosen;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Select_Solve
+*
+* \brief       Solve with whatever Select_Choose picks
+*
+* \details     The handle's time limit is the budget. A single solver runs
+*              on the handle itself, a portfolio on handles of its own
+*              whose best result is copied back. If the handle was given a
+*              cache name, every solver that runs, alone or in the
+*              portfolio, uses its own name (prefix and table name) so auto
+*              shares entries with the plain runs. The portfolio members
+*              allocate from the heap, they cannot share the handle's arena.
+*
+* \param[in]   zptHandle            Attached problem, time limit set
+* \param[in]   zatSolvers           Solver table
+* \param[in]   zuwCount             Entries in the table
+* \param[in]   zpsPrefix            See Select_Choose
+* \param[in]   zulMemory            Bytes, 0 for no budget
+*
+* \retval      const Portfolio_Solver_t *   The solver whose result the
+*                                           handle holds, NULL if none has
+*                                           a model
+*
+******************************************************************************/
+
+const Portfolio_Solver_t * Select_Solve (Subset_Sum_t * zptHandle,
+            const Portfolio_Solver_t * zatSolvers, uint32_t zuwCount,
+            const char * zpsPrefix, uint64_t zulMemory)
+{
+    uint32_t xauwChosen[SELECT_PORTFOLIO];
+    Select_Features_t xtFeatures;
+    Subset_Sum_t * xatMembers = NULL;
+    char xacName[64];
+    uint32_t xuwChosen;
+    uint32_t xuwBest = 0u;
+    uint32_t xuwLoop;
+    bool xbAttached;
+
+    Select_Features(zptHandle->sptInput, &xtFeatures);
+
+    xuwChosen = Select_Choose(zatSolvers, zuwCount, zpsPrefix, &xtFeatures,
+                    zptHandle->sulTimeLimit, zulMemory, xauwChosen);
+
+    if (xuwChosen == 0u)
+    {
+        return NULL;
+    }
+
+    if (xuwChosen > 1u)
+    {
+        xatMembers = (Subset_Sum_t *)calloc(xuwChosen, sizeof(Subset_Sum_t));
+    }
+
+    // Attaching only takes a reference, the set itself stays as it is.
+    // Members never attached free as nothing.
+
+    xbAttached = (xatMembers != NULL);
+
+    for (xuwLoop = 0u; (xbAttached == true) && (xuwLoop < xuwChosen); 
+                                                                xuwLoop++)
+    {
+        xbAttached = Subset_Sum_Attach(&xatMembers[xuwLoop],
+                                (Subset_Sum_Input_t *)zptHandle->sptInput);
+    }
+
+    if ((xatMembers != NULL) && (xbAttached == false))
+    {
+        for (xuwLoop = 0u; xuwLoop < xuwChosen; xuwLoop++)
+        {
+            Subset_Sum_Free(&xatMembers[xuwLoop]);
+        }
+
+        free(xatMembers);
+        xatMembers = NULL;
+    }
+
+    // Just one, or no memory for the others
+
+    if (xatMembers == NULL)
+    {
+        Subset_Sum_SetSolver(zptHandle, zatSolvers[xauwChosen[0]].spfSolver);
+
+        if (zptHandle->sacCache[0] != '\0')
+        {
+            snprintf(xacName, sizeof(xacName), "%s%s", zpsPrefix,
+                                        zatSolvers[xauwChosen[0]].spsName);
+            Subset_Sum_SetCache(zptHandle, xacName);
+        }
+
+        Subset_Sum_Solve(zptHandle);
+
+        return &zatSolvers[xauwChosen[0]];
+    }
+
+    for (xuwLoop = 0u; xuwLoop < xuwChosen; xuwLoop++)
+    {
+        Subset_Sum_SetSolver(&xatMembers[xuwLoop],
+                                    zatSolvers[xauwChosen[xuwLoop]].spfSolver);
+        Subset_Sum_SetTimeLimit(&xatMembers[xuwLoop], zptHandle->sulTimeLimit);
+
+        if (zptHandle->sacCache[0] != '\0')
+        {
+            snprintf(xacName, sizeof(xacName), "%s%s", zpsPrefix,
+                                    zatSolvers[xauwChosen[xuwLoop]].spsName);
+            Subset_Sum_SetCache(&xatMembers[xuwLoop], xacName);
+        }
+    }
+
+    Portfolio_Run(xatMembers, xuwChosen);
+
+    // Keep the best, the first of equals is the most promising one
+
+    for (xuwLoop = 1u; xuwLoop < xuwChosen; xuwLoop++)
+    {
+        if (Subset_Sum_GetSum(&xatMembers[xuwLoop]) >
+            Subset_Sum_GetSum(&xatMembers[xuwBest]))
+        {
+            xuwBest = xuwLoop;
+        }
+    }
+
+    Subset_Sum_Copy(zptHandle, &xatMembers[xuwBest]);
+    zptHandle->sulTime = xatMembers[xuwBest].sulTime;
+    zptHandle->sulInitialSol = xatMembers[xuwBest].sulInitialSol;
+    zptHandle->stStats = xatMembers[xuwBest].stStats;
+
+    for (xuwLoop = 0u; xuwLoop < xuwChosen; xuwLoop++)
+    {
+        Subset_Sum_Free(&xatMembers[xuwLoop]);
+    }
+
+    free(xatMembers);
+
+    return &zatSolvers[xauwChosen[xuwBest]];
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Select Internal        Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      SE__Units
+*
+* \brief       Units of work of a set of n elements
+*
+* \param[in]   zucKind              SELECT_LINEAR ... SELECT_EXPONENTIAL
+* \param[in]   zuwSize              n
+*
+* \retval      uint64_t             Saturated
+*
+******************************************************************************/
+
+static uint64_t SE__Units (uint8_t zucKind, uint32_t zuwSize)
+{
+    switch (zucKind)
+    {
+        case SELECT_LINEAR:
+            return zuwSize;
+
+        case SELECT_QUADRATIC:
+            return (uint64_t)zuwSize * zuwSize;
+
+        default:
+            return (zuwSize >= 64u) ? UINT64_MAX : (1ull << zuwSize);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      SE__Kind
+*
+* \brief       Parse a growth kind of a model file
+*
+* \param[in]   zpsText              "n", "n2" or "2n"
+*
+* \retval      uint8_t              SELECT_EXPONENTIAL + 1 if none of them
+*
+******************************************************************************/
+
+static uint8_t SE__Kind (const char * zpsText)
+{
+    return (strcmp(zpsText, "n") == 0)  ? SELECT_LINEAR :
+           (strcmp(zpsText, "n2") == 0) ? SELECT_QUADRATIC :
+           (strcmp(zpsText, "2n") == 0) ? SELECT_EXPONENTIAL :
+                                          SELECT_EXPONENTIAL + 1u;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SE__Compare
+*
+* \brief       qsort order of the candidates, most promising first
+*
+* \details     Those fitting time and memory first, by score and then
+*              predicted runtime. Then those fitting the memory only, and
+*              then the rest, quickest first.
+*
+* \param[in]   zpvLeft              SE__Candidate_t
+* \param[in]   zpvRight             SE__Candidate_t
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int SE__Compare (const void * zpvLeft, const void * zpvRight)
+{
+    const SE__Candidate_t * xptLeft = (const SE__Candidate_t *)zpvLeft;
+    const SE__Candidate_t * xptRight = (const SE__Candidate_t *)zpvRight;
+    uint32_t xuwLeft = xptLeft->sbMemory + (xptLeft->sbMemory & xptLeft->sbTime);
+    uint32_t xuwRight = xptRight->sbMemory +
+                                    (xptRight->sbMemory & xptRight->sbTime);
+
+    if (xuwLeft != xuwRight)
+    {
+        return (xuwLeft > xuwRight) ? -1 : 1;
+    }
+
+    if ((xuwLeft == 2u) && (xptLeft->suwScore != xptRight->suwScore))
+    {
+        return (xptLeft->suwScore > xptRight->suwScore) ? -1 : 1;
+    }
+
+    if (xptLeft->sulTime != xptRight->sulTime)
+    {
+        return (xptLeft->sulTime < xptRight->sulTime) ? -1 : 1;
+    }
+
+    // Keep the table order otherwise
+
+    return (xptLeft->suwIndex < xptRight->suwIndex) ? -1 : 1;
+}
+
+// \}
+
+// \}
@@ -0,0 +1,99 @@
+/**************************************************************************//**
+*
+* \file        Select.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _SELECT_H
+#define _SELECT_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+#include "Portfolio.h"
+
+// ***** Definitions **********************************************************
+
+//! Environment variable naming a calibrated model file, see Select_Open
+
+#define SELECT_ENV                  "SSUM_MODEL"
+
+//! Most solvers run as one portfolio
+
+#define SELECT_PORTFOLIO            3u
+
+//! Most solver models, built in and loaded
+
+#define SELECT_MODELS               16u
+
+//! How the runtime or memory of a solver grows with n
+
+enum
+{
+    SELECT_LINEAR,              // n
+    SELECT_QUADRATIC,           // n^2
+    SELECT_EXPONENTIAL          // 2^n
+};
+
+//! Cheap features of an input set, see Select_Features
+
+typedef struct Select_Features_s
+{
+    uint32_t suwSize;           // n
+    uint32_t suwBits;           // b, see Subset_Sum_GetBits
+    uint32_t suwDuplicates;     // Elements equal to another one
+    bool sbDense;               // Distinct elements >= b, density >= 1
+    bool sbReachable;           // Sum of every element >= target
+} Select_Features_t;
+
+//! Cost model of one solver. Runtime and memory are a fixed part plus a
+//! part per unit of work, where the unit grows as given by the kind.
+
+typedef struct Select_Model_s
+{
+    char sacSolver[32u];        // Cache name, e.g. "p5.tabu"
+    uint8_t sucTime;            // SELECT_LINEAR ... SELECT_EXPONENTIAL
+    uint8_t sucMemory;
+    bool sbExact;               // Proves the optimum if it runs to the end
+    uint64_t sulPsPerUnit;      // Runtime per unit of work, ps
+    uint64_t sulNsFixed;
+    uint64_t sulBitsPerUnit;    // Memory per unit of work
+    uint64_t sulBytesFixed;
+    uint32_t suwDense;          // Solves hitting the target, per mille, on
+    uint32_t suwSparse;         // dense and sparse instances
+} Select_Model_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Select_Open (const char * zpsPath);
+bool Select_Parse_Memory (const char * zpsText, uint64_t * zpulBytes);
+
+// Control functions
+
+void Select_Features (const Subset_Sum_Input_t * zptInput,
+                                    Select_Features_t * zptFeatures);
+const Select_Model_t * Select_Find (const char * zpsSolver);
+uint64_t Select_Runtime (const Select_Model_t * zptModel,
+                                    const Select_Features_t * zptFeatures);
+uint64_t Select_Memory (const Select_Model_t * zptModel,
+                                    const Select_Features_t * zptFeatures);
+uint32_t Select_Choose (const Portfolio_Solver_t * zatSolvers,
+            uint32_t zuwCount, const char * zpsPrefix,
+            const Select_Features_t * zptFeatures, uint64_t zulTimeLimit,
+            uint64_t zulMemory, uint32_t * zauwChosen);
+const Portfolio_Solver_t * Select_Solve (Subset_Sum_t * zptHandle,
+            const Portfolio_Solver_t * zatSolvers, uint32_t zuwCount,
+            const char * zpsPrefix, uint64_t zulMemory);
+
+#endif // !defined _SELECT_H
@@ -0,0 +1,983 @@
+/**************************************************************************//**
+*
+* \file        Shard.c
+*
+* \defgroup    Shard        Split an exhaustive search between processes
+*
+* \details     The exhaustive search counts through the subsets as a binary
+*              number, so fixing its top suwBits bits cuts it into 2^suwBits
+*              shards of equal size that share nothing. Any number of worker
+*              processes, on one machine or on several sharing a file
+*              system, work through those shards in parallel.
+*
+*              A shard directory holds two files:
+*
+*              - manifest: plain text, one "key value" per line. It names
+*                the instance (by absolute path), its size and target, and
+*                how it is split. Written once by Shard_Create.
+*
+*              - state: binary. A header with the hit and stop flags and the
+*                best sum so far, the best subset, then one record per
+*                shard: open, claimed or done, who holds the claim and when
+*                it was last renewed, and how many of its subsets have been
+*                searched.
+*
+*              All state updates happen under an fcntl lock on the state
+*              file. Unlike flock, fcntl locks also work over NFS. Workers
+*              claim open shards, report the best subset of each, and stop
+*              as soon as anyone hits the target or the coordinator calls
+*              the search off.
+*
+*              A worker renews its claim as it searches (Shard_Renew),
+*              recording how far it got and merging its best subset so far.
+*              A shard whose worker dies goes to the next worker once the
+*              lease runs out, and that one resumes at the last renewal
+*              instead of the start. Only the holder of a claim can renew or
+*              hand back the shard, a worker that lost its lease still gets
+*              its best subset counted.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Modules
+
+#include "Shard.h"
+
+// ***** Definitions **********************************************************
+
+#define SH_MAGIC            "SSUMSHD"
+#define SH_VERSION          2u
+
+//! Start of the state file, followed by the best subset and the records
+
+typedef struct SH__Header_s
+{
+    char sacMagic[8u];
+    uint32_t suwVersion;
+    uint32_t suwShards;
+    uint32_t suwWords;
+    uint32_t suwHit;
+    uint32_t suwStopped;
+    uint32_t suwReserved;
+    uint64_t sulBestSum;
+} SH__Header_t;
+
+typedef struct SH__Record_s
+{
+    uint32_t suwState;
+    uint32_t suwReserved;
+    uint64_t sulOwner;          // sulOwner of the claiming Shard_t, 0 if none
+    uint64_t sulClaimed;        // time() of the claim or its last renewal
+    uint64_t sulDone;           // Subsets searched, the next claim resumes here
+} SH__Record_t;
+
+// ***** Local Functions ******************************************************
+
+static bool SH__Lock (int ziFd, short zhType);
+static bool SH__Read (const Shard_t * zptShard, SH__Header_t * zptHeader,
+                                                SH__Record_t ** zpatRecords);
+static bool SH__Claimed (const Shard_t * zptShard, uint32_t zuwShard,
+                                                SH__Record_t * zptRecord);
+static bool SH__Best (const Shard_t * zptShard, SH__Header_t * zptHeader,
+                        uint64_t zulSum, const uint64_t * zaulBest);
+static uint64_t SH__Owner (void);
+static off_t SH__Record_Offset (const Shard_t * zptShard, uint32_t zuwShard);
+
+/**************************************************************************//**
+*
+* \defgroup    Shard Initialization   Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Shard_Create
+*
+* \brief       Set up a shard directory for an instance
+*
+* \details     Creates the directory if needed. An existing manifest is left
+*              alone so a restarted coordinator carries on with the search
+*              it started before.
+*
+* \param[in]   zpsDir               Shard directory
+* \param[in]   zpsInstance          Instance file, as the workers will load it
+* \param[in]   zptInput             The loaded instance
+* \param[in]   zuwBits              Prefix length, at most the set size and 31
+*
+* \retval      bool                 false if the files could not be written
+*
+******************************************************************************/
+
+bool Shard_Create (const char * zpsDir, const char * zpsInstance,
+                    const Subset_Sum_Input_t * zptInput, uint32_t zuwBits)
+{
+    SH__Header_t xtHeader;
+    SH__Record_t xtRecord;
+    uint32_t xuwWords = SUBSETSUM_WORDS(zptInput->suwSize);
+    uint32_t xuwLoop;
+    uint64_t xulZero = 0u;
+    char * xpsInstance;
+    char * xpsPath = NULL;
+    char * xpsTemp = NULL;
+    FILE * xptFile = NULL;
+    bool xbOk;
+
+    if ((zuwBits > 31u) || (zuwBits > zptInput->suwSize))
+    {
+        fprintf(stderr, "%s: invalid shard prefix length %u\n", zpsDir,
+                                                                    zuwBits);
+
+        return false;
+    }
+
+    if ((mkdir(zpsDir, 0777) != 0) && (errno != EEXIST))
+    {
+        perror(zpsDir);
+
+        return false;
+    }
+
+    if ((asprintf(&xpsPath, "%s/%s", zpsDir, SHARD_MANIFEST) < 0) ||
+        (access(xpsPath, F_OK) == 0))
+    {
+        free(xpsPath);
+
+        return true;
+    }
+
+    xpsInstance = realpath(zpsInstance, NULL);
+
+    if (xpsInstance == NULL)
+    {
+        perror(zpsInstance);
+        free(xpsPath);
+
+        return false;
+    }
+
+    // State first, the manifest appearing means the directory is ready
+
+    memset(&xtHeader, 0, sizeof(xtHeader));
+    memcpy(xtHeader.sacMagic, SH_MAGIC, sizeof(SH_MAGIC));
+    xtHeader.suwVersion = SH_VERSION;
+    xtHeader.suwShards = 1u << zuwBits;
+    xtHeader.suwWords = xuwWords;
+    memset(&xtRecord, 0, sizeof(xtRecord));
+    xtRecord.suwState = SHARD_OPEN;
+
+    xbOk = (asprintf(&xpsTemp, "%s/%s", zpsDir, SHARD_STATE) >= 0) &&
+           ((xptFile = fopen(xpsTemp, "wb")) != NULL) &&
+           (fwrite(&xtHeader, sizeof(xtHeader), 1u, xptFile) == 1u);
+
+    for (xuwLoop = 0u; (xbOk == true) && (xuwLoop < xuwWords); xuwLoop++)
+    {
+        xbOk = (fwrite(&xulZero, sizeof(xulZero), 1u, xptFile) == 1u);
+    }
+
+    for (xuwLoop = 0u; (xbOk == true) && (xuwLoop < xtHeader.suwShards);
+                                                                xuwLoop++)
+    {
+        xbOk = (fwrite(&xtRecord, sizeof(xtRecord), 1u, xptFile) == 1u);
+    }
+
+    if (xptFile != NULL)
+    {
+        xbOk = (fclose(xptFile) == 0) && xbOk;
+    }
+
+    free(xpsTemp);
+    xpsTemp = NULL;
+
+    // Then the manifest, renamed into place once complete
+
+    xbOk = xbOk && (asprintf(&xpsTemp, "%s.tmp", xpsPath) >= 0) &&
+           ((xptFile = fopen(xpsTemp, "w")) != NULL);
+
+    if (xbOk == true)
+    {
+        fprintf(xptFile, "# Sharded exhaustive search, see Shard.c\n");
+        fprintf(xptFile, "instance %s\n", xpsInstance);
+        fprintf(xptFile, "size %u\n", zptInput->suwSize);
+        fprintf(xptFile, "target %llu\n",
+                                (unsigned long long)zptInput->sulTarget);
+        fprintf(xptFile, "bits %u\n", zuwBits);
+        fprintf(xptFile, "shards %u\n", 1u << zuwBits);
+        fprintf(xptFile, "lease %u\n", SHARD_LEASE);
+
+        xbOk = (fclose(xptFile) == 0) && (rename(xpsTemp, xpsPath) == 0);
+    }
+
+    if (xbOk == false)
+    {
+        perror(zpsDir);
+    }
+
+    free(xpsInstance);
+    free(xpsTemp);
+    free(xpsPath);
+
+    return xbOk;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Shard_Open
+*
+* \brief       Open a shard directory made by Shard_Create
+*
+* \param[out]  zptShard             Filled in from the manifest
+* \param[in]   zpsDir               Shard directory
+*
+* \retval      bool                 false if the directory is missing or
+*                                   broken
+*
+******************************************************************************/
+
+bool Shard_Open (Shard_t * zptShard, const char * zpsDir)
+{
+    char * xpsPath = NULL;
+    char * xpsLine = NULL;
+    size_t xulLength = 0u;
+    FILE * xptFile;
+    ssize_t xlRead;
+
+    memset(zptShard, 0, sizeof(Shard_t));
+    zptShard->siFd = -1;
+    zptShard->suwLease = SHARD_LEASE;
+    zptShard->sulOwner = SH__Owner();
+
+    if (asprintf(&xpsPath, "%s/%s", zpsDir, SHARD_MANIFEST) < 0)
+    {
+        return false;
+    }
+
+    xptFile = fopen(xpsPath, "r");
+
+    if (xptFile == NULL)
+    {
+        perror(xpsPath);
+        free(xpsPath);
+
+        return false;
+    }
+
+    while ((xlRead = getline(&xpsLine, &xulLength, xptFile)) > 0)
+    {
+        if (xpsLine[xlRead - 1] == '\n')
+        {
+            xpsLine[xlRead - 1] = '\0';
+        }
+
+        if (strncmp(xpsLine, "instance ", 9u) == 0)
+        {
+            free(zptShard->spsInstance);
+            zptShard->spsInstance = strdup(&xpsLine[9u]);
+        }
+        else if (strncmp(xpsLine, "size ", 5u) == 0)
+        {
+            zptShard->suwSize = (uint32_t)strtoul(&xpsLine[5u], NULL, 10);
+        }
+        else if (strncmp(xpsLine, "target ", 7u) == 0)
+        {
+            zptShard->sulTarget = strtoull(&xpsLine[7u], NULL, 10);
+        }
+        else if (strncmp(xpsLine, "bits ", 5u) == 0)
+        {
+            zptShard->suwBits = (uint32_t)strtoul(&xpsLine[5u], NULL, 10);
+        }
+        else if (strncmp(xpsLine, "shards ", 7u) == 0)
+        {
+            zptShard->suwShards = (uint32_t)strtoul(&xpsLine[7u], NULL, 10);
+        }
+        else if (strncmp(xpsLine, "lease ", 6u) == 0)
+        {
+            zptShard->suwLease = (uint32_t)strtoul(&xpsLine[6u], NULL, 10);
+        }
+    }
+
+    fclose(xptFile);
+    free(xpsLine);
+    free(xpsPath);
+
+    if ((zptShard->spsInstance == NULL) || (zptShard->suwBits > 31u) ||
+        (zptShard->suwShards != (1u << zptShard->suwBits)) ||
+        (zptShard->suwBits > zptShard->suwSize))
+    {
+        fprintf(stderr, "%s: invalid shard manifest\n", zpsDir);
+        Shard_Close(zptShard);
+
+        return false;
+    }
+
+    if (asprintf(&xpsPath, "%s/%s", zpsDir, SHARD_STATE) < 0)
+    {
+        Shard_Close(zptShard);
+
+        return false;
+    }
+
+    zptShard->siFd = open(xpsPath, O_RDWR);
+
+    if (zptShard->siFd < 0)
+    {
+        perror(xpsPath);
+        free(xpsPath);
+        Shard_Close(zptShard);
+
+        return false;
+    }
+
+    free(xpsPath);
+
+    return true;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Shard Control          Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Shard_Claim
+*
+* \brief       Take the next shard to search
+*
+* \details     Open shards go first, in order. After those, shards whose
+*              claim has not been renewed within the lease are handed out
+*              again. sulResume tells how much of the shard an earlier
+*              worker already searched, see Shard_Seek.
+*
+* \param[in]   zptShard             Shard directory
+* \param[out]  zpuwShard            Claimed shard
+*
+* \retval      bool                 false when there is nothing left to do,
+*                                   the target was hit or the search stopped
+*
+******************************************************************************/
+
+bool Shard_Claim (Shard_t * zptShard, uint32_t * zpuwShard)
+{
+    SH__Header_t xtHeader;
+    SH__Record_t * xatRecords = NULL;
+    uint64_t xulNow = (uint64_t)time(NULL);
+    int64_t xlAge;
+    uint32_t xuwLoop;
+    uint32_t xuwPick = zptShard->suwShards;
+    bool xbOk;
+
+    if (SH__Lock(zptShard->siFd, F_WRLCK) == false)
+    {
+        return false;
+    }
+
+    xbOk = SH__Read(zptShard, &xtHeader, &xatRecords) &&
+           (xtHeader.suwHit == 0u) && (xtHeader.suwStopped == 0u);
+
+    for (xuwLoop = 0u; (xbOk == true) && (xuwLoop < zptShard->suwShards) &&
+                                    (xuwPick == zptShard->suwShards); xuwLoop++)
+    {
+        if (xatRecords[xuwLoop].suwState == SHARD_OPEN)
+        {
+            xuwPick = xuwLoop;
+        }
+    }
+
+    // Stamps come from every node's own clock, one running ahead of ours
+    // leaves a stamp in the future, which counts as a fresh lease
+
+    for (xuwLoop = 0u; (xbOk == true) && (xuwLoop < zptShard->suwShards) &&
+                                    (xuwPick == zptShard->suwShards); xuwLoop++)
+    {
+        xlAge = (int64_t)xulNow - (int64_t)xatRecords[xuwLoop].sulClaimed;
+
+        if ((xatRecords[xuwLoop].suwState == SHARD_CLAIMED) &&
+            (xlAge > (int64_t)zptShard->suwLease))
+        {
+            xuwPick = xuwLoop;
+        }
+    }
+
+    xbOk = xbOk && (xuwPick < zptShard->suwShards);
+
+    if (xbOk == true)
+    {
+        xatRecords[xuwPick].suwState = SHARD_CLAIMED;
+        xatRecords[xuwPick].sulOwner = zptShard->sulOwner;
+        xatRecords[xuwPick].sulClaimed = xulNow;
+        zptShard->sulResume = xatRecords[xuwPick].sulDone;
+
+        xbOk = (pwrite(zptShard->siFd, &xatRecords[xuwPick],
+                        sizeof(SH__Record_t), SH__Record_Offset(zptShard,
+                                    xuwPick)) == sizeof(SH__Record_t));
+        *zpuwShard = xuwPick;
+    }
+
+    SH__Lock(zptShard->siFd, F_UNLCK);
+    free(xatRecords);
+
+    return xbOk;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Shard_Seek
+*
+* \brief       Move a handle to the first subset of a shard still to search
+*
+* \details     The shard number becomes the top suwBits elements, the
+*              others count up from sulResume of the claim. Subset_Sum_
+*              Increment then walks the rest of the shard, which ends the
+*              given number of subsets later.
+*
+* \param[in]   zptShard             Shard directory
+* \param[in]   zuwShard             Shard just claimed
+* \param[in]   zptHandle            Problem instance attached to the instance
+*
+* \retval      uint64_t             Subsets left in the shard, saturated
+*
+******************************************************************************/
+
+uint64_t Shard_Seek (const Shard_t * zptShard, uint32_t zuwShard,
+                                                Subset_Sum_t * zptHandle)
+{
+    uint32_t xuwLow = zptShard->suwSize - zptShard->suwBits;
+    uint32_t xuwBit;
+
+    uint64_t xulSubsets = (xuwLow >= 64u) ? UINT64_MAX : (1ull << xuwLow);
+
+    Subset_Sum_Clear(zptHandle);
+
+    for (xuwBit = 0u; xuwBit < zptShard->suwBits; xuwBit++)
+    {
+        Subset_Sum_Select(zptHandle, xuwLow + xuwBit,
+                        ((zuwShard >> xuwBit) & 1u) ? INCLUDED : EXCLUDED);
+    }
+
+    for (xuwBit = 0u; (xuwBit < xuwLow) && (xuwBit < 64u); xuwBit++)
+    {
+        if (((zptShard->sulResume >> xuwBit) & 1u) != 0u)
+        {
+            Subset_Sum_Select(zptHandle, xuwBit, INCLUDED);
+        }
+    }
+
+    return (zptShard->sulResume < xulSubsets) ?
+                                (xulSubsets - zptShard->sulResume) : 0u;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Shard_Renew
+*
+* \brief       Keep a claim alive and checkpoint its progress
+*
+* \details     Restarts the claim's lease, records how many subsets of the
+*              shard have been searched, and merges the best subset among
+*              them as Shard_Report would. Also tells the worker whether to
+*              go on, so it is the one state file access of its poll.
+*
+* \param[in]   zptShard             Shard directory
+* \param[in]   zuwShard             Claimed shard
+* \param[in]   zulDone              Subsets of the shard searched so far
+* \param[in]   zulSum               Sum of the best of them
+* \param[in]   zaulBest             That subset, packed
+*
+* \retval      bool                 false if the claim has been lost, the
+*                                   target was hit, the search stopped or
+*                                   the state could not be updated
+*
+******************************************************************************/
+
+bool Shard_Renew (Shard_t * zptShard, uint32_t zuwShard, uint64_t zulDone,
+                        uint64_t zulSum, const uint64_t * zaulBest)
+{
+    SH__Header_t xtHeader;
+    SH__Record_t xtRecord;
+    bool xbOk;
+
+    if (SH__Lock(zptShard->siFd, F_WRLCK) == false)
+    {
+        return false;
+    }
+
+    xbOk = SH__Read(zptShard, &xtHeader, NULL) &&
+           SH__Claimed(zptShard, zuwShard, &xtRecord) &&
+           SH__Best(zptShard, &xtHeader, zulSum, zaulBest);
+
+    if (xbOk == true)
+    {
+        xtRecord.sulClaimed = (uint64_t)time(NULL);
+        xtRecord.sulDone = zulDone;
+
+        xbOk = (pwrite(zptShard->siFd, &xtRecord, sizeof(xtRecord),
+                SH__Record_Offset(zptShard, zuwShard)) == sizeof(xtRecord));
+    }
+
+    SH__Lock(zptShard->siFd, F_UNLCK);
+
+    return (xbOk == true) &&
+                ((xtHeader.suwHit == 0u) && (xtHeader.suwStopped == 0u));
+}
+
+/**************************************************************************//**
+*
+* \anchor      Shard_Report
+*
+* \brief       Hand a shard back with its best subset
+*
+* \details     The handle's solution is taken as the shard's best. It
+*              becomes the overall best if it beats it without going over
+*              the target, and a hit stops every other worker. An incomplete
+*              shard goes back to open, the next worker to claim it resumes
+*              after the subsets searched so far.
+*
+*              The best subset counts even if the claim has been lost, the
+*              shard itself then belongs to whoever claimed it since.
+*
+* \param[in]   zptShard             Shard directory
+* \param[in]   zuwShard             Claimed shard
+* \param[in]   zulDone              Subsets of the shard searched
+* \param[in]   zbComplete           Every subset of the shard was tried
+* \param[in]   zptHandle            Problem instance holding the best subset
+*
+* \retval      bool                 false if the claim was lost or the state
+*                                   could not be updated
+*
+******************************************************************************/
+
+bool Shard_Report (Shard_t * zptShard, uint32_t zuwShard, uint64_t zulDone,
+                        bool zbComplete, Subset_Sum_t * zptHandle)
+{
+    SH__Header_t xtHeader;
+    SH__Record_t xtRecord;
+    bool xbOk;
+
+    if (SH__Lock(zptShard->siFd, F_WRLCK) == false)
+    {
+        return false;
+    }
+
+    xbOk = SH__Read(zptShard, &xtHeader, NULL) &&
+           SH__Best(zptShard, &xtHeader, Subset_Sum_GetSum(zptHandle),
+                                            zptHandle->saulSolution) &&
+           SH__Claimed(zptShard, zuwShard, &xtRecord);
+
+    memset(&xtRecord, 0, sizeof(xtRecord));
+    xtRecord.suwState = (zbComplete == true) ? SHARD_DONE : SHARD_OPEN;
+    xtRecord.sulDone = zulDone;
+
+    xbOk = xbOk && (pwrite(zptShard->siFd, &xtRecord, sizeof(xtRecord),
+            SH__Record_Offset(zptShard, zuwShard)) == sizeof(xtRecord));
+
+    SH__Lock(zptShard->siFd, F_UNLCK);
+
+    return xbOk;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Shard_Stopped
+*
+* \brief       Check whether workers should stop
+*
+* \details     Reads the state file, so poll it every so often rather than
+*              in the inner loop.
+*
+* \param[in]   zptShard             Shard directory
+*
+* \retval      bool                 true once the target is hit or the
+*                                   search was stopped
+*
+******************************************************************************/
+
+bool Shard_Stopped (Shard_t * zptShard)
+{
+    SH__Header_t xtHeader;
+    bool xbOk;
+
+    if (SH__Lock(zptShard->siFd, F_RDLCK) == false)
+    {
+        return false;
+    }
+
+    xbOk = SH__Read(zptShard, &xtHeader, NULL);
+
+    SH__Lock(zptShard->siFd, F_UNLCK);
+
+    return (xbOk == true) &&
+                ((xtHeader.suwHit != 0u) || (xtHeader.suwStopped != 0u));
+}
+
+/**************************************************************************//**
+*
+* \anchor      Shard_Stop
+*
+* \brief       Call the search off, or back on when resuming it
+*
+* \details     Stopped workers report their shard at the next poll, the
+*              unfinished ones go back to open for a later run.
+*
+* \param[in]   zptShard             Shard directory
+* \param[in]   zbStop               true to stop, false to carry on
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Shard_Stop (Shard_t * zptShard, bool zbStop)
+{
+    SH__Header_t xtHeader;
+
+    if (SH__Lock(zptShard->siFd, F_WRLCK) == false)
+    {
+        return;
+    }
+
+    if (SH__Read(zptShard, &xtHeader, NULL) == true)
+    {
+        xtHeader.suwStopped = (zbStop == true) ? 1u : 0u;
+
+        if (pwrite(zptShard->siFd, &xtHeader, sizeof(xtHeader), 0) !=
+                                                        sizeof(xtHeader))
+        {
+            perror("Shard_Stop");
+        }
+    }
+
+    SH__Lock(zptShard->siFd, F_UNLCK);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Shard_Status
+*
+* \brief       Progress of the whole search
+*
+* \param[in]   zptShard             Shard directory
+* \param[out]  zptStatus            Shard counts, flags and best sum
+* \param[out]  zaulBest             Best subset, packed, or NULL
+*
+* \retval      bool                 false if the state could not be read
+*
+******************************************************************************/
+
+bool Shard_Status (Shard_t * zptShard, Shard_Status_t * zptStatus,
+                                                uint64_t * zaulBest)
+{
+    SH__Header_t xtHeader;
+    SH__Record_t * xatRecords = NULL;
+    uint32_t xuwLoop;
+    bool xbOk;
+
+    if (SH__Lock(zptShard->siFd, F_RDLCK) == false)
+    {
+        return false;
+    }
+
+    xbOk = SH__Read(zptShard, &xtHeader, &xatRecords);
+
+    if ((xbOk == true) && (zaulBest != NULL))
+    {
+        xbOk = (pread(zptShard->siFd, zaulBest,
+                    xtHeader.suwWords * sizeof(uint64_t), sizeof(xtHeader)) ==
+                            (ssize_t)(xtHeader.suwWords * sizeof(uint64_t)));
+    }
+
+    SH__Lock(zptShard->siFd, F_UNLCK);
+
+    if (xbOk == true)
+    {
+        memset(zptStatus, 0, sizeof(Shard_Status_t));
+        zptStatus->sbHit = (xtHeader.suwHit != 0u);
+        zptStatus->sbStopped = (xtHeader.suwStopped != 0u);
+        zptStatus->sulBestSum = xtHeader.sulBestSum;
+
+        for (xuwLoop = 0u; xuwLoop < zptShard->suwShards; xuwLoop++)
+        {
+            switch (xatRecords[xuwLoop].suwState)
+            {
+                case SHARD_OPEN:    zptStatus->suwOpen++;       break;
+                case SHARD_CLAIMED: zptStatus->suwClaimed++;    break;
+                default:            zptStatus->suwDone++;       break;
+            }
+        }
+    }
+
+    free(xatRecords);
+
+    return xbOk;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Shard Cleanup          Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Shard_Close
+*
+* \brief       Close a shard directory
+*
+* \param[in]   zptShard             Shard directory
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Shard_Close (Shard_t * zptShard)
+{
+    if (zptShard->siFd >= 0)
+    {
+        close(zptShard->siFd);
+    }
+
+    free(zptShard->spsInstance);
+
+    zptShard->siFd = -1;
+    zptShard->spsInstance = NULL;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Shard Internal         Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      SH__Lock
+*
+* \brief       Lock or unlock the whole state file, waiting if needed
+*
+* \param[in]   ziFd                 State file
+* \param[in]   zhType               F_RDLCK, F_WRLCK or F_UNLCK
+*
+* \retval      bool                 false if the lock failed
+*
+******************************************************************************/
+
+static bool SH__Lock (int ziFd, short zhType)
+{
+    struct flock xtLock;
+
+    memset(&xtLock, 0, sizeof(xtLock));
+    xtLock.l_type = zhType;
+    xtLock.l_whence = SEEK_SET;
+
+    while (fcntl(ziFd, F_SETLKW, &xtLock) != 0)
+    {
+        if (errno != EINTR)
+        {
+            perror("Shard lock");
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SH__Read
+*
+* \brief       Read the state header and optionally every record
+*
+* \details     The caller holds the lock.
+*
+* \param[in]   zptShard             Shard directory
+* \param[out]  zptHeader            Header
+* \param[out]  zpatRecords          Records, malloc'd, or NULL to skip them
+*
+* \retval      bool                 false if the state file is not valid
+*
+******************************************************************************/
+
+static bool SH__Read (const Shard_t * zptShard, SH__Header_t * zptHeader,
+                                                SH__Record_t ** zpatRecords)
+{
+    size_t xulBytes = zptShard->suwShards * sizeof(SH__Record_t);
+    bool xbOk;
+
+    xbOk = (pread(zptShard->siFd, zptHeader, sizeof(SH__Header_t), 0) ==
+                                                    sizeof(SH__Header_t)) &&
+           (memcmp(zptHeader->sacMagic, SH_MAGIC, sizeof(SH_MAGIC)) == 0) &&
+           (zptHeader->suwVersion == SH_VERSION) &&
+           (zptHeader->suwShards == zptShard->suwShards) &&
+           (zptHeader->suwWords == SUBSETSUM_WORDS(zptShard->suwSize));
+
+    if ((xbOk == true) && (zpatRecords != NULL))
+    {
+        *zpatRecords = (SH__Record_t *)malloc(xulBytes);
+
+        xbOk = (*zpatRecords != NULL) &&
+               (pread(zptShard->siFd, *zpatRecords, xulBytes,
+                        SH__Record_Offset(zptShard, 0u)) == (ssize_t)xulBytes);
+    }
+
+    if (xbOk == false)
+    {
+        fprintf(stderr, "Invalid shard state file\n");
+    }
+
+    return xbOk;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SH__Claimed
+*
+* \brief       Read a shard's record and check the claim is still ours
+*
+* \details     The caller holds the lock.
+*
+* \param[in]   zptShard             Shard directory
+* \param[in]   zuwShard             Shard
+* \param[out]  zptRecord            Its record
+*
+* \retval      bool                 false if someone else holds the claim
+*                                   now, or the record could not be read
+*
+******************************************************************************/
+
+static bool SH__Claimed (const Shard_t * zptShard, uint32_t zuwShard,
+                                                SH__Record_t * zptRecord)
+{
+    return (pread(zptShard->siFd, zptRecord, sizeof(SH__Record_t),
+                SH__Record_Offset(zptShard, zuwShard)) ==
+                                            sizeof(SH__Record_t)) &&
+           (zptRecord->suwState == SHARD_CLAIMED) &&
+           (zptRecord->sulOwner == zptShard->sulOwner);
+}
+
+/**************************************************************************//**
+*
+* \anchor      SH__Best
+*
+* \brief       Make a subset the overall best if it is
+*
+* \details     It is if it beats the best so far without going over the
+*              target, a hit also stops every other worker. The caller
+*              holds the lock and has read the header.
+*
+* \param[in]   zptShard             Shard directory
+* \param[in]   zptHeader            State header, updated
+* \param[in]   zulSum               Sum of the subset
+* \param[in]   zaulBest             The subset, packed
+*
+* \retval      bool                 false if the state could not be written
+*
+******************************************************************************/
+
+static bool SH__Best (const Shard_t * zptShard, SH__Header_t * zptHeader,
+                        uint64_t zulSum, const uint64_t * zaulBest)
+{
+    size_t xulBytes = zptHeader->suwWords * sizeof(uint64_t);
+
+    if ((zulSum > zptShard->sulTarget) || (zulSum <= zptHeader->sulBestSum))
+    {
+        return true;
+    }
+
+    zptHeader->sulBestSum = zulSum;
+    zptHeader->suwHit = (zulSum == zptShard->sulTarget) ? 1u : 0u;
+
+    return (pwrite(zptShard->siFd, zptHeader, sizeof(SH__Header_t), 0) ==
+                                                sizeof(SH__Header_t)) &&
+           (pwrite(zptShard->siFd, zaulBest, xulBytes,
+                        sizeof(SH__Header_t)) == (ssize_t)xulBytes);
+}
+
+/**************************************************************************//**
+*
+* \anchor      SH__Owner
+*
+* \brief       Make up an owner mark for a worker's claims
+*
+* \details     Random, so workers on different machines sharing the
+*              directory do not collide. Without /dev/urandom the process
+*              id and the time still tell the workers of one machine apart.
+*
+* \retval      uint64_t             Never 0, which marks no owner
+*
+******************************************************************************/
+
+static uint64_t SH__Owner (void)
+{
+    struct timespec xtNow;
+    uint64_t xulOwner = 0u;
+    int xiFd = open("/dev/urandom", O_RDONLY);
+
+    if (xiFd >= 0)
+    {
+        if (read(xiFd, &xulOwner, sizeof(xulOwner)) != sizeof(xulOwner))
+        {
+            xulOwner = 0u;
+        }
+
+        close(xiFd);
+    }
+
+    clock_gettime(CLOCK_REALTIME, &xtNow);
+    xulOwner ^= ((uint64_t)getpid() << 32) ^
+                ((uint64_t)xtNow.tv_sec * 1000000000u) ^ (uint64_t)xtNow.tv_nsec;
+
+    return (xulOwner == 0u) ? 1u : xulOwner;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SH__Record_Offset
+*
+* \brief       Position of a shard's record in the state file
+*
+* \param[in]   zptShard             Shard directory
+* \param[in]   zuwShard             Shard
+*
+* \retval      off_t
+*
+******************************************************************************/
+
+static off_t SH__Record_Offset (const Shard_t * zptShard, uint32_t zuwShard)
+{
+    return (off_t)(sizeof(SH__Header_t) +
+                    (SUBSETSUM_WORDS(zptShard->suwSize) * sizeof(uint64_t)) +
+                    ((size_t)zuwShard * sizeof(SH__Record_t)));
+}
+
+// \}
+
+// \}
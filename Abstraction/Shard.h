@@ -0,0 +1,99 @@
+/**************************************************************************//**
+*
+* \file        Shard.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _SHARD_H
+#define _SHARD_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+
+// ***** Definitions **********************************************************
+
+//! Files of a shard directory
+
+#define SHARD_MANIFEST          "manifest"
+#define SHARD_STATE             "state"
+
+//! A claimed shard whose worker has not renewed it for this long is given to
+//! the next worker that asks, in case the first one died. Workers renew at
+//! every poll (see Shard_Renew), seconds
+
+#define SHARD_LEASE             60u
+
+//! Shard states
+
+enum
+{
+    SHARD_OPEN,
+    SHARD_CLAIMED,
+    SHARD_DONE
+};
+
+//! Progress of the whole search, see Shard_Status
+
+typedef struct Shard_Status_s
+{
+    uint32_t suwOpen;
+    uint32_t suwClaimed;
+    uint32_t suwDone;
+    bool sbHit;                 // Some worker hit the target
+    bool sbStopped;             // Coordinator called it off
+    uint64_t sulBestSum;        // Best sum not over the target so far
+} Shard_Status_t;
+
+//! An open shard directory, as described by its manifest
+
+typedef struct Shard_s
+{
+    char * spsInstance;         // Absolute path of the instance file
+    uint32_t suwSize;
+    uint64_t sulTarget;
+    uint32_t suwBits;           // Prefix length, 2^suwBits shards
+    uint32_t suwShards;
+    uint32_t suwLease;          // Seconds
+    int siFd;                   // State file
+    uint64_t sulOwner;          // Marks the claims made through this handle
+    uint64_t sulResume;         // Subsets of the last claimed shard already
+                                // searched by an earlier worker
+} Shard_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Shard_Create (const char * zpsDir, const char * zpsInstance,
+                    const Subset_Sum_Input_t * zptInput, uint32_t zuwBits);
+bool Shard_Open (Shard_t * zptShard, const char * zpsDir);
+
+// Control functions
+
+bool Shard_Claim (Shard_t * zptShard, uint32_t * zpuwShard);
+uint64_t Shard_Seek (const Shard_t * zptShard, uint32_t zuwShard,
+                                                Subset_Sum_t * zptHandle);
+bool Shard_Renew (Shard_t * zptShard, uint32_t zuwShard, uint64_t zulDone,
+                        uint64_t zulSum, const uint64_t * zaulBest);
+bool Shard_Report (Shard_t * zptShard, uint32_t zuwShard, uint64_t zulDone,
+                        bool zbComplete, Subset_Sum_t * zptHandle);
+bool Shard_Stopped (Shard_t * zptShard);
+void Shard_Stop (Shard_t * zptShard, bool zbStop);
+bool Shard_Status (Shard_t * zptShard, Shard_Status_t * zptStatus,
+                                                uint64_t * zaulBest);
+
+// Cleanup functions
+
+void Shard_Close (Shard_t * zptShard);
+
+#endif // !defined _SHARD_H
@@ -0,0 +1,356 @@
+/**************************************************************************//**
+*
+* \file        Sink.c
+*
+* \defgroup    Sink         Buffered output of result records
+*
+* \details     Writing a result used to cost a write() per line and per
+*              selected element, plus an open and close of the instance's
+*              own file. For a batch of thousands of small instances that
+*              was most of the run.
+*
+*              A sink formats whole records into one growing buffer and
+*              hands them to the kernel in writes of about SINK_FLUSH
+*              bytes. It only ever writes up to the end of the last
+*              complete record (see Sink_End), so with O_APPEND or a pipe
+*              a record lands in one piece even if something else writes
+*              to the same file, and a crashed run leaves only whole
+*              records behind.
+*
+*              A sink can be a file, which it replaces, or stdout.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Modules
+
+#include "Sink.h"
+
+// ***** Local constants ******************************************************
+
+//! First buffer allocation, enough for a typical record
+
+#define SK_INITIAL              4096u
+
+// ***** Local function prototypes ********************************************
+
+static bool SK__Reserve (Sink_t * zptSink, size_t zulBytes);
+
+/**************************************************************************//**
+*
+* \defgroup    Sink Initialization    Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Sink_Open
+*
+* \brief       Start a sink on a file or stdout
+*
+* \details     A file is created or emptied, a rerun replaces the records of
+*              the last one instead of adding to them.
+*
+* \param[in]   zptSink              Sink
+* \param[in]   zpsPath              File, or SINK_STDOUT
+*
+* \retval      bool                 false if the file could not be opened
+*
+******************************************************************************/
+
+bool Sink_Open (Sink_t * zptSink, const char * zpsPath)
+{
+    memset(zptSink, 0, sizeof(Sink_t));
+
+    if (strcmp(zpsPath, SINK_STDOUT) == 0)
+    {
+        zptSink->siFd = STDOUT_FILENO;
+
+        return true;
+    }
+
+    zptSink->siFd = open(zpsPath, O_WRONLY | O_CREAT | O_TRUNC, 0777);
+
+    if (zptSink->siFd < 0)
+    {
+        perror(zpsPath);
+
+        return false;
+    }
+
+    zptSink->sbOwned = true;
+
+    return true;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Sink Control           Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Sink_Printf
+*
+* \brief       Add formatted text to the open record
+*
+* \details     Nothing is written yet, the text stays in the buffer until
+*              the record is complete.
+*
+* \param[in]   zptSink              Sink
+* \param[in]   zpsFormat            printf format
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Sink_Printf (Sink_t * zptSink, const char * zpsFormat, ...)
+{
+    va_list xtArgs;
+    int xiLength;
+
+    // Usually it fits the first time, otherwise grow and format again
+
+    va_start(xtArgs, zpsFormat);
+    xiLength = vsnprintf(&zptSink->spcBuffer[zptSink->sulUsed],
+            (zptSink->spcBuffer == NULL) ? 0u :
+                            (zptSink->sulSize - zptSink->sulUsed),
+            zpsFormat, xtArgs);
+    va_end(xtArgs);
+
+    if (xiLength < 0)
+    {
+        zptSink->sbFailed = true;
+
+        return;
+    }
+
+    if ((zptSink->spcBuffer == NULL) ||
+        ((size_t)xiLength >= (zptSink->sulSize - zptSink->sulUsed)))
+    {
+        if (SK__Reserve(zptSink, (size_t)xiLength + 1u) == false)
+        {
+            return;
+        }
+
+        va_start(xtArgs, zpsFormat);
+        vsnprintf(&zptSink->spcBuffer[zptSink->sulUsed],
+                    zptSink->sulSize - zptSink->sulUsed, zpsFormat, xtArgs);
+        va_end(xtArgs);
+    }
+
+    zptSink->sulUsed += (size_t)xiLength;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Sink_End
+*
+* \brief       Complete the open record
+*
+* \details     From here on the record may be written, which happens once
+*              SINK_FLUSH bytes are pending. The next Sink_Printf starts a
+*              new record.
+*
+* \param[in]   zptSink              Sink
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Sink_End (Sink_t * zptSink)
+{
+    zptSink->sulOpen = zptSink->sulUsed;
+    zptSink->sulRecords++;
+
+    if (zptSink->sulOpen >= SINK_FLUSH)
+    {
+        Sink_Flush(zptSink);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Sink_Flush
+*
+* \brief       Write every complete record
+*
+* \details     In as few write() calls as the kernel allows, usually one.
+*              The open record, if any, stays in the buffer. stdio's stdout
+*              is flushed first so a sink on stdout keeps its place among
+*              the printf output.
+*
+* \param[in]   zptSink              Sink
+*
+* \retval      bool                 false if a write failed
+*
+******************************************************************************/
+
+bool Sink_Flush (Sink_t * zptSink)
+{
+    size_t xulDone = 0u;
+    ssize_t xlWritten;
+
+    if (zptSink->sulOpen == 0u)
+    {
+        return (zptSink->sbFailed == false);
+    }
+
+    if (zptSink->siFd == STDOUT_FILENO)
+    {
+        fflush(stdout);
+    }
+
+    while (xulDone < zptSink->sulOpen)
+    {
+        xlWritten = write(zptSink->siFd, &zptSink->spcBuffer[xulDone],
+                                            zptSink->sulOpen - xulDone);
+
+        if (xlWritten < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            zptSink->sbFailed = true;
+            break;
+        }
+
+        xulDone += (size_t)xlWritten;
+    }
+
+    // Whatever could not be written is dropped, it would only fail again
+
+    memmove(zptSink->spcBuffer, &zptSink->spcBuffer[zptSink->sulOpen],
+                                    zptSink->sulUsed - zptSink->sulOpen);
+    zptSink->sulUsed -= zptSink->sulOpen;
+    zptSink->sulOpen = 0u;
+
+    return (zptSink->sbFailed == false);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Sink Cleanup           Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Sink_Close
+*
+* \brief       Write the complete records and release the sink
+*
+* \details     A record that was never ended is dropped. The file is
+*              closed, stdout is left open.
+*
+* \param[in]   zptSink              Sink
+*
+* \retval      bool                 false if anything was lost
+*
+******************************************************************************/
+
+bool Sink_Close (Sink_t * zptSink)
+{
+    bool xbWritten = Sink_Flush(zptSink);
+
+    if ((zptSink->sbOwned == true) && (close(zptSink->siFd) != 0))
+    {
+        xbWritten = false;
+    }
+
+    free(zptSink->spcBuffer);
+    memset(zptSink, 0, sizeof(Sink_t));
+
+    return xbWritten;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Sink Internal          Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      SK__Reserve
+*
+* \brief       Make room for more text in the buffer
+*
+* \details     Writes out the complete records first if that is enough,
+*              otherwise doubles the buffer until it is.
+*
+* \param[in]   zptSink              Sink
+* \param[in]   zulBytes             Room needed after the pending text
+*
+* \retval      bool                 false if out of memory
+*
+******************************************************************************/
+
+static bool SK__Reserve (Sink_t * zptSink, size_t zulBytes)
+{
+    size_t xulSize = (zptSink->sulSize == 0u) ? SK_INITIAL : zptSink->sulSize;
+    char * xpcBuffer;
+
+    if ((zptSink->sulOpen > 0u) && (zptSink->sulUsed >= SINK_FLUSH))
+    {
+        Sink_Flush(zptSink);
+    }
+
+    if ((zptSink->sulSize - zptSink->sulUsed) >= zulBytes)
+    {
+        return true;
+    }
+
+    while ((xulSize - zptSink->sulUsed) < zulBytes)
+    {
+        xulSize *= 2u;
+    }
+
+    xpcBuffer = (char *)realloc(zptSink->spcBuffer, xulSize);
+
+    if (xpcBuffer == NULL)
+    {
+        zptSink->sbFailed = true;
+
+        return false;
+    }
+
+    zptSink->spcBuffer = xpcBuffer;
+    zptSink->sulSize = xulSize;
+
+    return true;
+}
+
+// \}
+
+// \}
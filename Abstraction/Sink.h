@@ -0,0 +1,65 @@
+/**************************************************************************//**
+*
+* \file        Sink.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _SINK_H
+#define _SINK_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// ***** Definitions **********************************************************
+
+//! Path that makes Sink_Open write to stdout
+
+#define SINK_STDOUT             "-"
+
+//! Pending output that triggers a write, bytes. Records are never split, a
+//! record larger than this goes out on its own.
+
+#define SINK_FLUSH              (1u << 20)
+
+//! Buffered output of whole records. Text is formatted into the buffer and
+//! only handed to the kernel in large writes, and only up to the end of the
+//! last complete record, so a reader never sees part of one. Not thread
+//! safe, write from one thread.
+
+typedef struct Sink_s
+{
+    char * spcBuffer;
+    size_t sulSize;             // Allocated bytes
+    size_t sulUsed;             // Bytes pending, including the open record
+    size_t sulOpen;             // Start of the record being formatted
+    uint64_t sulRecords;        // Records completed so far
+    int siFd;
+    bool sbOwned;               // Opened by Sink_Open, closed by Sink_Close
+    bool sbFailed;              // A write or allocation failed
+} Sink_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Sink_Open (Sink_t * zptSink, const char * zpsPath);
+
+// Control functions
+
+void Sink_Printf (Sink_t * zptSink, const char * zpsFormat, ...)
+                                        __attribute__((format(printf, 2, 3)));
+void Sink_End (Sink_t * zptSink);
+bool Sink_Flush (Sink_t * zptSink);
+
+// Cleanup functions
+
+bool Sink_Close (Sink_t * zptSink);
+
+#endif // !defined _SINK_H
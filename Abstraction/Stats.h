@@ -0,0 +1,61 @@
+/**************************************************************************//**
+*
+* \file        Stats.h
+*
+* \details     Solver counters. Every thread has one Stats_t that the solver
+*              it is running bumps through STATS_ADD. Subset_Sum_Solve
+*              clears it before the solve and copies it into the problem
+*              afterwards, and Subset_SumWriteData writes it to the .out
+*              file and the .stats.csv sidecar next to it.
+*
+*              A counter update is one add to thread local memory, no atomics
+*              and no sharing. Build with -DSS_NO_STATS to compile every
+*              update out and leave the counters out of the output.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _STATS_H
+#define _STATS_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+
+// ***** Definitions **********************************************************
+
+typedef struct Stats_s
+{
+    uint64_t sulMoves;          // Swap candidates scored by FindSwap
+    uint64_t sulImprovements;   // Incumbents published
+    uint64_t sulRestarts;       // Neighbourhood scans started over
+    uint64_t sulTabu;           // Swap candidates skipped as tabu
+    uint64_t sulNodes;          // Elements decided by a construction
+    uint64_t sulSubsets;        // Subsets tried by an enumeration
+    uint64_t sulFirst;          // Solve start to first improvement, ns
+    uint64_t sulBest;           // Solve start to last improvement, ns
+    uint64_t sulStart;          // CLOCK_MONOTONIC at solve start, ns
+} Stats_t;
+
+#ifndef SS_NO_STATS
+
+#define SS_STATS                1
+
+//! Counters of the solve running on this thread, see Subset_Sum_Solve
+
+extern __thread Stats_t Stats_Thread;
+
+#define STATS_ADD(Field, Count)     (Stats_Thread.Field += (Count))
+
+#else
+
+#define SS_STATS                0
+
+#define STATS_ADD(Field, Count)     ((void)0)
+
+#endif
+
+#endif // !defined _STATS_H
@@ -32,19 +32,275 @@
 #include <string.h>
 #include <fcntl.h>
 #include <stdint.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // Modules
 
 #include "Subset_Sum.h"
+#include "Telemetry.h"
+#include "Cache.h"
+#include "Deadline.h"
 
 // ***** Definitions **********************************************************
 
+//! Alignment of the value array, one cache line
+
+#define SS_ALIGN            64u
+
+//! The binary header has to stay exactly one cache line
+
+typedef char SS__Header_Size_Check[(sizeof(Subset_Sum_Header_t) == SS_ALIGN) ? 1 : -1];
+
+//! Mask of the valid bits in the last word of a packed solution
+
+#define SS__TAIL_MASK(uwSize)                                                 \
+    ((((uwSize) & 63u) == 0u) ? UINT64_MAX : ((1ull << ((uwSize) & 63u)) - 1u))
+
+//! Swap candidates in one word of a packed solution: excluded, not skipped
+//! and inside the set
+
+#define SS__CANDIDATES(aulSolution, aulSkip, uwWord, uwSize)                  \
+    (~(aulSolution)[uwWord] &                                                 \
+     (((aulSkip) != NULL) ? ~(aulSkip)[uwWord] : UINT64_MAX) &                \
+     (((uwWord) == (SUBSETSUM_WORDS(uwSize) - 1u)) ?                          \
+                                        SS__TAIL_MASK(uwSize) : UINT64_MAX))
+
+//! Largest value that can replace Out without going over the slack,
+//! clamped to the range of the storage type
+
+#define SS__WINDOW_HIGH(Type, Out, ulSlack)                                   \
+    (((ulSlack) >= (uint64_t)((Type)~(Type)0u - (Out))) ?                     \
+                                    (Type)~(Type)0u : (Type)((Out) + (ulSlack)))
+
+//! Width specialized kernels. Each storage width gets its own copy of the
+//! hot loops so the element type is known at compile time, Acc is the sum
+//! accumulator (128 bits for 64-bit elements so large sums saturate instead
+//! of wrapping). Both walk the packed solution a word at a time and only
+//! visit the bits of interest (ctz, then clear the lowest set bit). These
+//! are also the scalar fallback of the SIMD swap kernels below.
+
+#define SS__KERNELS(Type, Acc, Suffix)                                        \
+                                                                              \
+static uint64_t SS__Sum##Suffix (const Type * zaValues,                       \
+                    const uint64_t * zaulSolution, uint32_t zuwSize)          \
+{                                                                             \
+    Acc xSum = 0u;                                                            \
+    uint64_t xulBits;                                                         \
+    uint32_t xuwWord;                                                         \
+                                                                              \
+    for (xuwWord = 0u; xuwWord < SUBSETSUM_WORDS(zuwSize); xuwWord++)         \
+    {                                                                         \
+        for (xulBits = zaulSolution[xuwWord]; xulBits != 0u;                  \
+                                            xulBits &= xulBits - 1u)          \
+        {                                                                     \
+            xSum += zaValues[(xuwWord << 6) + __builtin_ctzll(xulBits)];      \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    return (xSum > (Acc)UINT64_MAX) ? UINT64_MAX : (uint64_t)xSum;            \
+}                                                                             \
+                                                                              \
+static uint32_t SS__Find_Swap##Suffix (const Type * zaValues,                 \
+                    const uint64_t * zaulSolution, uint32_t zuwSize,          \
+                    uint32_t zuwOut, uint64_t zulSlack,                       \
+                    const uint64_t * zaulSkip)                                \
+{                                                                             \
+    Type xOut = zaValues[zuwOut];                                             \
+    Type xHigh = SS__WINDOW_HIGH(Type, xOut, zulSlack);                       \
+    Type xBest = 0u;                                                          \
+    uint64_t xulBits;                                                         \
+    uint32_t xuwWord, xuwLoop, xuwBest = zuwSize;                             \
+                                                                              \
+    for (xuwWord = 0u; xuwWord < SUBSETSUM_WORDS(zuwSize); xuwWord++)         \
+    {                                                                         \
+        xulBits = SS__CANDIDATES(zaulSolution, zaulSkip, xuwWord, zuwSize);   \
+                                                                              \
+        for (; xulBits != 0u; xulBits &= xulBits - 1u)                        \
+        {                                                                     \
+            xuwLoop = (xuwWord << 6) + __builtin_ctzll(xulBits);              \
+                                                                              \
+            if ((zaValues[xuwLoop] > xOut) && (zaValues[xuwLoop] <= xHigh) && \
+                (zaValues[xuwLoop] > xBest))                                  \
+            {                                                                 \
+                xBest = zaValues[xuwLoop];                                    \
+                xuwBest = xuwLoop;                                            \
+            }                                                                 \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    return xuwBest;                                                           \
+}
+
+//! Dispatch a kernel on the storage width of an input set
+
+#define SS__DISPATCH(ptInput, Kernel, ...)                                    \
+    (((ptInput)->sucWidth == 1u) ?                                            \
+        Kernel##_8((const uint8_t *)(ptInput)->spvValues, __VA_ARGS__) :     \
+     ((ptInput)->sucWidth == 2u) ?                                            \
+        Kernel##_16((const uint16_t *)(ptInput)->spvValues, __VA_ARGS__) :   \
+     ((ptInput)->sucWidth == 4u) ?                                            \
+        Kernel##_32((const uint32_t *)(ptInput)->spvValues, __VA_ARGS__) :   \
+        Kernel##_64((const uint64_t *)(ptInput)->spvValues, __VA_ARGS__))
+
+//! SIMD swap scoring. On x86 the 32 and 64-bit widths also get AVX2 and
+//! AVX-512 builds of SS__Find_Swap, picked at run time. They use the GCC
+//! vector extensions rather than intrinsics so one macro covers every
+//! lane count: each step loads Lanes values, turns the matching bits of
+//! the candidate word into a lane mask, keeps the lanes inside the
+//! (Out, High] window and folds them into a running per-lane maximum.
+//! The lanes are reduced to one candidate at the end. Since the new sum
+//! is Sum - Out + In, the largest In in the window is the best swap.
+//! Build with -DSS_NO_SIMD to only use the scalar kernels.
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(SS_NO_SIMD)
+#define SS_SIMD             1
+#else
+#define SS_SIMD             0
+#endif
+
+#define SS__SIMD_KERNEL(Type, Bytes, Suffix, Target)                          \
+                                                                              \
+typedef Type SS__Vec##Suffix                                                  \
+            __attribute__((vector_size(Bytes), aligned(sizeof(Type))));       \
+                                                                              \
+__attribute__((target(Target)))                                              \
+static uint32_t SS__Find_Swap##Suffix (const Type * zaValues,                 \
+                    const uint64_t * zaulSolution, uint32_t zuwSize,          \
+                    uint32_t zuwOut, uint64_t zulSlack,                       \
+                    const uint64_t * zaulSkip)                                \
+{                                                                             \
+    const uint32_t xuwLanes = Bytes / sizeof(Type);                           \
+    const uint64_t xulLaneMask = (1ull << (Bytes / sizeof(Type))) - 1u;       \
+    Type xOut = zaValues[zuwOut];                                             \
+    Type xHigh = SS__WINDOW_HIGH(Type, xOut, zulSlack);                       \
+    SS__Vec##Suffix xvZero = {0u};                                            \
+    SS__Vec##Suffix xvBit, xvLane, xvIn, xvPick;                              \
+    SS__Vec##Suffix xvBest = xvZero, xvBestIndex = xvZero + zuwSize;          \
+    Type xBest = 0u;                                                          \
+    uint64_t xulBits = 0u;                                                    \
+    uint32_t xuwLoop, xuwBest = zuwSize;                                      \
+                                                                              \
+    for (xuwLoop = 0u; xuwLoop < xuwLanes; xuwLoop++)                         \
+    {                                                                         \
+        xvBit[xuwLoop] = (Type)1u << xuwLoop;                                 \
+        xvLane[xuwLoop] = xuwLoop;                                            \
+    }                                                                         \
+                                                                              \
+    /* Full vectors. Lanes divides 64 so a step never straddles a word */     \
+                                                                              \
+    for (xuwLoop = 0u; (xuwLoop + xuwLanes) <= zuwSize; xuwLoop += xuwLanes)  \
+    {                                                                         \
+        if ((xuwLoop & 63u) == 0u)                                            \
+        {                                                                     \
+            xulBits = SS__CANDIDATES(zaulSolution, zaulSkip,                  \
+                                                xuwLoop >> 6, zuwSize);       \
+        }                                                                     \
+                                                                              \
+        if (((xulBits >> (xuwLoop & 63u)) & xulLaneMask) == 0u)               \
+        {                                                                     \
+            continue;                                                         \
+        }                                                                     \
+                                                                              \
+        xvIn = *(const SS__Vec##Suffix *)&zaValues[xuwLoop];                  \
+        xvPick = (SS__Vec##Suffix)((xvBit & (xvZero +                         \
+                            (Type)(xulBits >> (xuwLoop & 63u)))) != 0u);      \
+        xvPick &= (SS__Vec##Suffix)(xvIn > xOut);                             \
+        xvPick &= (SS__Vec##Suffix)(xvIn <= xHigh);                           \
+        xvPick &= (SS__Vec##Suffix)(xvIn > xvBest);                           \
+        xvBest = (xvPick & xvIn) | (~xvPick & xvBest);                        \
+        xvBestIndex = (xvPick & (xvLane + xuwLoop)) | (~xvPick & xvBestIndex);\
+    }                                                                         \
+                                                                              \
+    /* Reduce the lanes, lowest index wins a tie like the scalar kernel */    \
+                                                                              \
+    for (xuwLoop = 0u; xuwLoop < xuwLanes; xuwLoop++)                         \
+    {                                                                         \
+        if ((xvBestIndex[xuwLoop] < zuwSize) &&                               \
+            ((xvBest[xuwLoop] > xBest) ||                                     \
+             ((xvBest[xuwLoop] == xBest) && (xvBestIndex[xuwLoop] < xuwBest))))\
+        {                                                                     \
+            xBest = xvBest[xuwLoop];                                          \
+            xuwBest = (uint32_t)xvBestIndex[xuwLoop];                         \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    /* Leftovers past the last full vector */                                 \
+                                                                              \
+    for (xuwLoop = zuwSize - (zuwSize % xuwLanes); xuwLoop < zuwSize;         \
+                                                                xuwLoop++)    \
+    {                                                                         \
+        if ((((SS__CANDIDATES(zaulSolution, zaulSkip, xuwLoop >> 6, zuwSize)  \
+                                            >> (xuwLoop & 63u)) & 1u) != 0u) &&\
+            (zaValues[xuwLoop] > xOut) && (zaValues[xuwLoop] <= xHigh) &&     \
+            (zaValues[xuwLoop] > xBest))                                      \
+        {                                                                     \
+            xBest = zaValues[xuwLoop];                                        \
+            xuwBest = xuwLoop;                                                \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    return xuwBest;                                                           \
+}
+
+//! SS__Parse_Number results
+
+enum
+{
+    SS_PARSE_OK,
+    SS_PARSE_END,
+    SS_PARSE_BAD
+};
+
 // ***** Local Functions ******************************************************
 
-static void SS__Parse_Info (Subset_Sum_t * zptInst, char * zpnInfo);
-static void SS__Parse_Entry (Subset_Sum_t * zptInst, 
-                                      uint32_t zuwIndex, char * zpnLine);
-static void SS__Write (Subset_Sum_t * zptHandle, int ziFd);
+static void SS__Set_Name (Subset_Sum_Input_t * zptInst, char * zpsFilePath);
+static int SS__Parse_Number (const char ** zppcCur, const char * zpcEnd,
+                                    uint32_t * zpuwLine, uint64_t * zpulValue);
+static bool SS__Parse_Text (Subset_Sum_Input_t * zptInst, const char * zpcData,
+                                    const char * zpcEnd, char * zpsFilePath);
+static bool SS__Parse_Binary (Subset_Sum_Input_t * zptInst, const char * zpcData,
+                                    uint64_t zulLength, char * zpsFilePath);
+static uint64_t SS__Checksum (const void * zpvData, uint64_t zulBytes,
+                                    uint8_t zucWidth, uint64_t * zpulTotal);
+static bool SS__Save_Text (const Subset_Sum_Input_t * zptInst, FILE * zptFile);
+static bool SS__Save_Binary (const Subset_Sum_Input_t * zptInst, FILE * zptFile);
+static bool SS__Save_Ampl (const Subset_Sum_Input_t * zptInst, FILE * zptFile,
+                                    char * zpsFilePath);
+static uint32_t * SS__Sort_Order (const Subset_Sum_Input_t * zptInst);
+static bool SS__Store (Subset_Sum_Input_t * zptInst, uint64_t * zaulValues,
+                                    bool zbOwned);
+static void SS__Write (Subset_Sum_t * zptHandle, Sink_t * zptSink);
+static void SS__Write_Stats (Subset_Sum_t * zptHandle, char * zpnFldr);
+#if SS_STATS
+static bool SS__Write_All (int ziFd, const char * zpcData, size_t zulBytes);
+#endif
+static Subset_Sum_Input_t * SS__Own (Subset_Sum_t * zptHandle, 
+                                    uint32_t zuwSize, uint8_t zucWidth);
+static void SS__Set_Value (Subset_Sum_Input_t * zptInst, uint32_t zuwIndex,
+                                    uint64_t zulValue);
+static uint32_t SS__Lower (const Subset_Sum_Input_t * zptInst,
+            const uint32_t * zauwOrder, uint64_t zulValue, uint32_t zuwIndex);
+static void SS__Repair (Subset_Sum_t * zptHandle, uint32_t zuwEdited);
+
+// ***** Local variables ******************************************************
+
+#if SS_STATS
+__thread Stats_t Stats_Thread;
+#endif
+
+SS__KERNELS(uint8_t,  uint64_t,          _8)
+SS__KERNELS(uint16_t, uint64_t,          _16)
+SS__KERNELS(uint32_t, uint64_t,          _32)
+SS__KERNELS(uint64_t, unsigned __int128, _64)
+
+#if SS_SIMD
+SS__SIMD_KERNEL(uint32_t, 32u, _32_Avx2,   "avx2")
+SS__SIMD_KERNEL(uint32_t, 64u, _32_Avx512, "avx512f")
+SS__SIMD_KERNEL(uint64_t, 32u, _64_Avx2,   "avx2")
+SS__SIMD_KERNEL(uint64_t, 64u, _64_Avx512, "avx512f")
+#endif
 
 /**************************************************************************//**
 *
@@ -55,221 +311,355 @@ static void SS__Write (Subset_Sum_t * zptHandle, int ziFd);
 ******************************************************************************/
 /**************************************************************************//**
 *
-* \anchor      Subset_Sum_Initialize
+* \anchor      Subset_Sum_Load
 *
-* \brief       Parse the given input file
+* \brief       Parse the given input file into a shareable input set
 *
-* \details     Chops the input file into lines and uses that info fill the
-*              given Subset_Sub object pointer.
+* \details     Binary instances (see Subset_Sum_Header_t) are recognised by
+*              their magic and used straight from the mapping.
 *
-* \ref         SS__Parse_Info
-* \ref         SS__Parse_Entry
+*              Text instances are mapped and parsed in a single pass straight
+*              into a cache-line aligned value array, so there is one mmap
+*              instead of a syscall per byte and no limit on the set size.
+*              The caller owns one reference and must Subset_Sum_Release it.
+*
+*              Malformed input (missing or extra values, stray characters,
+*              values out of range) is reported on stderr and NULL returned.
+*
+* \ref         SS__Parse_Text
+* \ref         SS__Parse_Binary
 *
-* \param[in]   zptHandle            Problem instance
 * \param[in]   zpsFilePath          File path
 *
-* \retval      void
+* \retval      Subset_Sum_Input_t *     NULL on failure
 *
 ******************************************************************************/
 
-void Subset_Sum_Initialize (Subset_Sum_t * zptHandle, char * zpsFilePath)
+Subset_Sum_Input_t * Subset_Sum_Load (char * zpsFilePath)
 {
-    char xaacInputFile[256u][64u];
-    char xcRead;
-    uint32_t xuwSize = 0;
-    uint8_t xucLineIndex = 0;
+    Subset_Sum_Input_t * xptInput;
+    struct stat xtStat;
+    const char * xpcData;
+    bool xbOk;
+    int xiFD;
+
+    // Open and map the file
+
+    xiFD = open(zpsFilePath, O_RDONLY);
+
+    if (xiFD < 0)
+    {
+        fprintf(stderr, "%s: %s\n", zpsFilePath, strerror(errno));
+
+        return NULL;
+    }
 
-    // Pull the name of the instance
+    if ((fstat(xiFD, &xtStat) != 0) || (xtStat.st_size == 0))
+    {
+        fprintf(stderr, "%s: empty or unreadable file\n", zpsFilePath);
+        close(xiFD);
 
-    // Make sure the file exists in the first place
-    // Extract base name of file
-    assert(access(zpsFilePath, F_OK) != 1);
-    char *baseName = basename(zpsFilePath);
-    sscanf(baseName, "%s.dat", zptHandle->sacName);
-    while(zptHandle->sacName[++xucLineIndex] != '.'){};
-    zptHandle->sacName[xucLineIndex] = '\0';
-    xucLineIndex = 0;
+        return NULL;
+    }
 
-    // Open the maps file
+    xpcData = (const char *)mmap(NULL, xtStat.st_size, PROT_READ, 
+                                    MAP_PRIVATE, xiFD, 0);
 
-    int xiFD = open(zpsFilePath, O_RDONLY);
+    // The mapping keeps the file alive, the descriptor is no longer needed
 
-    // Chop the file into lines
+    close(xiFD);
 
-    while(read(xiFD, &xcRead, 1u) != 0u)
+    if (xpcData == MAP_FAILED)
     {
-        xaacInputFile[xuwSize][xucLineIndex++] = xcRead;
+        fprintf(stderr, "%s: %s\n", zpsFilePath, strerror(errno));
 
-        if(xcRead == '\n')
-        {
-            xaacInputFile[xuwSize++][xucLineIndex] = '\0';
-            xucLineIndex = 0u;
-        }
+        return NULL;
     }
 
-    // Add last null on final string
-    
-    xaacInputFile[xuwSize][xucLineIndex] = '\0';
+    madvise((void *)xpcData, xtStat.st_size, MADV_SEQUENTIAL);
 
-    // Read the problem info
+    xptInput = (Subset_Sum_Input_t *)calloc(1u, sizeof(Subset_Sum_Input_t));
 
-    SS__Parse_Info(zptHandle, &(xaacInputFile[0u][0u]));
-    
-    // Now that the instance size is known, allocate space for the input
-    // set
-    
-    zptHandle->sauwInputSet = 
-            (uint32_t *)malloc(zptHandle->suwSize * sizeof(uint32_t));
+    if (xptInput == NULL)
+    {
+        fprintf(stderr, "%s: out of memory\n", zpsFilePath);
+        munmap((void *)xpcData, xtStat.st_size);
 
-    zptHandle->saucSolution = (uint8_t *)calloc(zptHandle->suwSize, 1u);
-    
-    // Read the set members one at a time
+        return NULL;
+    }
 
-    for (xucLineIndex = 1u; xucLineIndex < xuwSize; xucLineIndex++)
+    SS__Set_Name(xptInput, zpsFilePath);
+
+    // Binary instances are used in place and keep the mapping, text ones
+    // are parsed in one go and the mapping dropped
+
+    if (((uint64_t)xtStat.st_size >= sizeof(SUBSETSUM_MAGIC)) &&
+        (memcmp(xpcData, SUBSETSUM_MAGIC, sizeof(SUBSETSUM_MAGIC)) == 0))
     {
-        
-                SS__Parse_Entry(zptHandle, 
-                    (xucLineIndex - 1u), &(xaacInputFile[xucLineIndex][0u]));
+        xbOk = SS__Parse_Binary(xptInput, xpcData, xtStat.st_size, 
+                                    zpsFilePath);
     }
+    else
+    {
+        xbOk = SS__Parse_Text(xptInput, xpcData, xpcData + xtStat.st_size, 
+                                    zpsFilePath);
 
-    // Close the file
+        munmap((void *)xpcData, xtStat.st_size);
+    }
 
-    close(xiFD);
-}
+    if (xbOk == false)
+    {
+        if (xptInput->spvMap == NULL)
+        {
+            free(xptInput->spvValues);
+        }
+        else
+        {
+            munmap(xptInput->spvMap, xptInput->sulMapSize);
+        }
 
-// \}
+        free(xptInput);
+
+        return NULL;
+    }
+
+    xptInput->suwRefs = 1u;
+
+    return xptInput;
+}
 
 /**************************************************************************//**
 *
-* \defgroup    Subset_Sum Control       Control Functions
-*
-* \{
-*
-******************************************************************************/
-/**************************************************************************//**
-*
-* \anchor      Subset_Sum_Solve
+* \anchor      Subset_Sum_Create
 *
-* \brief       Attempt to solve the instance
+* \brief       Build an input set from values already in memory
 *
-* \details     Simply call the user supplied solver on the given instance
+* \details     Copies the values into a cache-line aligned array of the
+*              narrowest width that holds them, the same layout
+*              Subset_Sum_Load produces. Used by tools that make up
+*              instances rather than read them. The caller owns one
+*              reference and must Subset_Sum_Release it.
 *
-* \param[in]   zptHandle            Problem instance
+* \param[in]   zpsName              Instance name
+* \param[in]   zaulValues           Element values
+* \param[in]   zuwSize              Number of elements
+* \param[in]   zulTarget            Target sum
 *
-* \retval      void
+* \retval      Subset_Sum_Input_t *     NULL if out of memory
 *
 ******************************************************************************/
 
-void Subset_Sum_Solve (Subset_Sum_t * zptHandle)
+Subset_Sum_Input_t * Subset_Sum_Create (const char * zpsName, 
+            const uint64_t * zaulValues, uint32_t zuwSize, uint64_t zulTarget)
 {
-    // Call the solver function
-    
-    (zptHandle->spfSolver)(zptHandle);
+    Subset_Sum_Input_t * xptInput;
+
+    xptInput = (Subset_Sum_Input_t *)calloc(1u, sizeof(Subset_Sum_Input_t));
+
+    if (xptInput == NULL)
+    {
+        return NULL;
+    }
+
+    snprintf(xptInput->sacName, sizeof(xptInput->sacName), "%s", zpsName);
+
+    xptInput->suwSize = zuwSize;
+    xptInput->sulTarget = zulTarget;
+
+    if (SS__Store(xptInput, (uint64_t *)zaulValues, false) == false)
+    {
+        free(xptInput);
+
+        return NULL;
+    }
+
+    xptInput->suwRefs = 1u;
+
+    return xptInput;
 }
 
 /**************************************************************************//**
 *
-* \anchor      Subset_Sum_GetSum
+* \anchor      Subset_Sum_Wrap
 *
-* \brief       Get the current sum of the solution
+* \brief       Build an input set on values the caller keeps
 *
-* \details     Returns the current sum of the selected items
+* \details     No copy, the solvers read the caller's array in place, so
+*              it must stay unchanged until the last reference is
+*              released. Any of the storage widths works, not only the
+*              narrowest, as long as the array is aligned to it. Used by
+*              the shared library (see Ssum.c) to solve values straight
+*              from the caller's buffers. The caller owns one reference and
+*              must Subset_Sum_Release it.
 *
-* \param[in]   zptHandle            Problem instance
+* \param[in]   zpsName              Instance name
+* \param[in]   zpvValues            Element values, zucWidth bytes each
+* \param[in]   zucWidth             1, 2, 4 or 8
+* \param[in]   zuwSize              Number of elements
+* \param[in]   zulTarget            Target sum
 *
-* \retval      uint32_t
+* \retval      Subset_Sum_Input_t *     NULL if out of memory or the width
+*                                       or alignment is wrong
 *
 ******************************************************************************/
 
-uint32_t Subset_Sum_GetSum (Subset_Sum_t * zptHandle)
+Subset_Sum_Input_t * Subset_Sum_Wrap (const char * zpsName, 
+            const void * zpvValues, uint8_t zucWidth, uint32_t zuwSize, 
+            uint64_t zulTarget)
 {
-    uint32_t xuwSum = 0u;
+    Subset_Sum_Input_t * xptInput;
+    unsigned __int128 xTotal = 0u;
     uint32_t xuwLoop;
 
-    // Sum enabled elements
-    
-    for (xuwLoop = 0u; xuwLoop < zptHandle->suwSize; xuwLoop++)
+    if (((zucWidth != 1u) && (zucWidth != 2u) && (zucWidth != 4u) && 
+         (zucWidth != 8u)) || (((uintptr_t)zpvValues % zucWidth) != 0u) ||
+        ((zpvValues == NULL) && (zuwSize > 0u)))
     {
+        return NULL;
+    }
 
-        if(zptHandle->saucSolution[xuwLoop] == INCLUDED)
-        {
-            xuwSum += zptHandle->sauwInputSet[xuwLoop];
-        }
+    xptInput = (Subset_Sum_Input_t *)calloc(1u, sizeof(Subset_Sum_Input_t));
+
+    if (xptInput == NULL)
+    {
+        return NULL;
     }
 
-    return xuwSum;
-}
+    snprintf(xptInput->sacName, sizeof(xptInput->sacName), "%s", zpsName);
 
-// \}
+    xptInput->spvValues = (void *)zpvValues;
+    xptInput->sucWidth = zucWidth;
+    xptInput->suwSize = zuwSize;
+    xptInput->sulTarget = zulTarget;
+    xptInput->sbBorrowed = true;
+
+    for (xuwLoop = 0u; xuwLoop < zuwSize; xuwLoop++)
+    {
+        xTotal += SUBSETSUM_VALUE(xptInput, xuwLoop);
+    }
+
+    xptInput->sulTotal = (xTotal > UINT64_MAX) ? UINT64_MAX : (uint64_t)xTotal;
+    xptInput->suwRefs = 1u;
+
+    return xptInput;
+}
 
 /**************************************************************************//**
 *
-* \defgroup    Subset_Sum Input          Input Functions
-*
-* \{
-*
-******************************************************************************/
-/**************************************************************************//**
-*
-* \anchor      Subset_Sum_SetSolver
+* \anchor      Subset_Sum_Attach
 *
-* \brief       Set the solver function
+* \brief       Attach per-solver state to a loaded input set
 *
-* \details     Sets the solver function in the given instance handle.
+* \details     Takes a reference on the (read-only) input set and allocates a
+*              fresh, empty solution for this solver. Safe to call from
+*              several threads on the same input set. If the solution cannot
+*              be allocated the handle is left detached, Subset_Sum_Free on
+*              it does nothing.
 *
 * \param[in]   zptHandle            Problem instance
-* \param[in]   ztSolver             Solution function pointer
+* \param[in]   zptInput             Loaded input set
 *
-* \retval      void
+* \retval      bool                 false if out of memory
 *
 ******************************************************************************/
 
-void Subset_Sum_SetSolver (Subset_Sum_t * zptHandle, Algorithm_t ztSolver)
+bool Subset_Sum_Attach (Subset_Sum_t * zptHandle, Subset_Sum_Input_t * zptInput)
 {
-    // Set the solver function
-    
-    zptHandle->spfSolver = ztSolver;
+    zptHandle->saulSolution = (uint64_t *)calloc(
+                        SUBSETSUM_WORDS(zptInput->suwSize), sizeof(uint64_t));
+
+    if (zptHandle->saulSolution == NULL)
+    {
+        zptHandle->sptInput = NULL;
+
+        return false;
+    }
+
+    __atomic_add_fetch(&zptInput->suwRefs, 1u, __ATOMIC_RELAXED);
+
+    zptHandle->sptInput = zptInput;
+    zptHandle->sulTime = 0u;
+    zptHandle->sulTimeLimit = UINT64_MAX;
+    zptHandle->sulInitialSol = 0u;
+    zptHandle->spfSolver = NULL;
+    zptHandle->sptShared = NULL;
+    zptHandle->sbWarm = false;
+    zptHandle->sulSum = 0u;
+    zptHandle->sptArena = NULL;
+    memset(&zptHandle->stStats, 0, sizeof(Stats_t));
+    zptHandle->sacCache[0] = '\0';
+
+    return true;
 }
 
 /**************************************************************************//**
 *
-* \anchor      Subset_Sum_Select
+* \anchor      Subset_Sum_Initialize
 *
-* \brief       Add the given element to the solution
+* \brief       Parse the given input file
 *
-* \details     Sets the inlude state of the given element.
+* \details     Convenience for a single solver: loads the file and attaches
+*              the given handle to it. Use Subset_Sum_Load and
+*              Subset_Sum_Attach directly to share one input set between
+*              several solvers.
 *
 * \param[in]   zptHandle            Problem instance
-* \param[in]   zpuwIndex            Item to set
-* \param[in]   zeState              State to set
+* \param[in]   zpsFilePath          File path
 *
-* \retval      void
+* \retval      bool                 false if the file could not be loaded
+*                                   or out of memory
 *
 ******************************************************************************/
 
-void Subset_Sum_Select (Subset_Sum_t * zptHandle, 
-                                    uint32_t zpuwIndex, uint8_t zeState)
+bool Subset_Sum_Initialize (Subset_Sum_t * zptHandle, char * zpsFilePath)
 {
-    zptHandle->saucSolution[zpuwIndex] = zeState;
+    Subset_Sum_Input_t * xptInput = Subset_Sum_Load(zpsFilePath);
+    bool xbOk;
+
+    if (xptInput == NULL)
+    {
+        return false;
+    }
+
+    xbOk = Subset_Sum_Attach(zptHandle, xptInput);
+
+    if (xbOk == false)
+    {
+        fprintf(stderr, "%s: out of memory\n", zpsFilePath);
+    }
+
+    // If attached the handle now holds the only reference
+
+    Subset_Sum_Release(xptInput);
+
+    return xbOk;
 }
 
 // \}
 
 /**************************************************************************//**
 *
-* \defgroup    Subset_Sum Print       Print Functions
+* \defgroup    Subset_Sum Control       Control Functions
 *
 * \{
 *
 ******************************************************************************/
 /**************************************************************************//**
 *
-* \anchor      Subset_SumDisplayData
+* \anchor      Subset_Sum_Solve
 *
-* \brief       Print solution to console.
+* \brief       Attempt to solve the instance
 *
-* \details     Prints the solution of the given instance to the console in the
-*              same formatting as it would be written to an outfile.
+* \details     Simply call the user supplied solver on the given instance. A
+*              warm start only applies to the first solve after an edit.
+*              The scratch arena, if any, is emptied first. The thread's
+*              counters are cleared before and kept in the problem after.
+*              The start and the end are posted to the telemetry ring.
+*
+*              With a cache (see Subset_Sum_SetCache) a result cached for
+*              at least this time limit is taken as is, without running
+*              the solver, and one cached for less is where the solver
+*              starts. The new result is cached afterwards.
 *
 * \param[in]   zptHandle            Problem instance
 *
@@ -277,198 +667,2659 @@ void Subset_Sum_Select (Subset_Sum_t * zptHandle,
 *
 ******************************************************************************/
 
-void Subset_SumDisplayData (Subset_Sum_t * zptHandle)
+void Subset_Sum_Solve (Subset_Sum_t * zptHandle)
 {
-    // Call generic with file pointer to STDOUT
+    bool xbCached = (zptHandle->sacCache[0] != '\0') && 
+                                                (Cache_Active() == true);
+
+    if ((xbCached == true) && 
+        (Cache_Fetch(zptHandle, zptHandle->sacCache) == CACHE_HIT))
+    {
+        zptHandle->sulSum = Subset_Sum_GetSum(zptHandle);
+
+        return;
+    }
+
+    if (zptHandle->sptArena != NULL)
+    {
+        Arena_Reset(zptHandle->sptArena);
+    }
+
+#if SS_STATS
+    memset(&Stats_Thread, 0, sizeof(Stats_t));
+    Stats_Thread.sulStart = Deadline_Now();
+#endif
+
+    Telemetry_Post(TELEMETRY_START, zptHandle->sptInput->sulTarget);
+
+    // Call the solver function
+    
+    (zptHandle->spfSolver)(zptHandle);
+
+    zptHandle->sbWarm = false;
+    zptHandle->sulSum = Subset_Sum_GetSum(zptHandle);
+
+    Telemetry_Post(TELEMETRY_END, zptHandle->sulSum);
+
+#if SS_STATS
+    zptHandle->stStats = Stats_Thread;
+#endif
 
-    SS__Write(zptHandle, STDOUT_FILENO);
+    if (xbCached == true)
+    {
+        Cache_Store(zptHandle, zptHandle->sacCache);
+    }
 }
 
 /**************************************************************************//**
 *
-* \anchor      Subset_SumWriteData
+* \anchor      Subset_Sum_GetSum
 *
-* \brief       Write solution to output file.
+* \brief       Get the current sum of the solution
 *
-* \details     Prints the solution of the given instance to the given outfile.
+* \details     Returns the current sum of the selected items, using the
+*              kernel for the instance's storage width. Sums that do not fit
+*              in 64 bits saturate.
 *
 * \param[in]   zptHandle            Problem instance
-* \param[in]   zpnFile              File path
 *
-* \retval      void
+* \retval      uint64_t
 *
 ******************************************************************************/
 
-void Subset_SumWriteData (Subset_Sum_t * zptHandle, char * zpnFldr)
+uint64_t Subset_Sum_GetSum (Subset_Sum_t * zptHandle)
 {
-    char xacFileName[128u];
-
-    // Create file
+    const Subset_Sum_Input_t * xptInput = zptHandle->sptInput;
 
-    sprintf(xacFileName, "../outputs/%s/%s.out", zpnFldr, zptHandle->sacName);
-    int xtFile = open(xacFileName, O_RDWR | O_CREAT | O_APPEND, 0777);
-
-    // Call generic write
-
-    SS__Write(zptHandle, xtFile);
-
-    // Close the file
+    // Sum enabled elements
 
-    close(xtFile);
+    return SS__DISPATCH(xptInput, SS__Sum, 
+                                zptHandle->saulSolution, xptInput->suwSize);
 }
 
-// \}
-
-/**************************************************************************//**
-*
-* \defgroup    Subset_Sum Print       Print Functions
-*
-* \{
-*
-******************************************************************************/
 /**************************************************************************//**
 *
-* \anchor      Subset_Sum_Free
+* \anchor      Subset_Sum_FindSwap
 *
-* \brief       Free allocated memory
+* \brief       Find the best element to swap in for an included one
 *
-* \details     Frees input and solution arrays which are allocated dynamically
-*              at initialization.
+* \details     Scores every excluded element as a replacement for the
+*              outgoing one in a single pass and returns the one giving the
+*              largest sum that still fits the target, the 1-OPT move used
+*              by the local search solvers. Candidates whose skip bit is set
+*              (e.g. the outgoing one's tabu partners) are ignored. On x86
+*              the 32 and 64-bit widths use the AVX-512 or AVX2 kernel when
+*              the CPU has it.
 *
 * \param[in]   zptHandle            Problem instance
+* \param[in]   zuwOut               Included element to swap out
+* \param[in]   zulSum               Current sum, at most the target
+* \param[in]   zaulSkip             Packed per element skip bits, or NULL
 *
-* \retval      void
+* \retval      uint32_t             Element to swap in, the set size if none
 *
 ******************************************************************************/
 
-void Subset_Sum_Free (Subset_Sum_t * zptHandle)
+uint32_t Subset_Sum_FindSwap (Subset_Sum_t * zptHandle, uint32_t zuwOut,
+                                    uint64_t zulSum, const uint64_t * zaulSkip)
 {
-    // Free allocated memory
-    
-    free(zptHandle->sauwInputSet);
-    free(zptHandle->saucSolution);
-}
+    const Subset_Sum_Input_t * xptInput = zptHandle->sptInput;
+    uint64_t xulSlack;
 
-// \}
+    if (zulSum > xptInput->sulTarget)
+    {
+        return xptInput->suwSize;
+    }
+
+    xulSlack = xptInput->sulTarget - zulSum;
+
+#if SS_STATS
+    {
+        uint32_t xuwWords = SUBSETSUM_WORDS(xptInput->suwSize);
+        uint32_t xuwWord;
+        uint64_t xulFree;
+
+        for (xuwWord = 0u; xuwWord < xuwWords; xuwWord++)
+        {
+            xulFree = ~zptHandle->saulSolution[xuwWord] &
+                ((xuwWord == (xuwWords - 1u)) ? 
+                                SS__TAIL_MASK(xptInput->suwSize) : UINT64_MAX);
+
+            STATS_ADD(sulMoves, __builtin_popcountll(xulFree));
+
+            if (zaulSkip != NULL)
+            {
+                STATS_ADD(sulTabu, 
+                        __builtin_popcountll(xulFree & zaulSkip[xuwWord]));
+            }
+        }
+    }
+#endif
+
+#if SS_SIMD
+    if ((xptInput->sucWidth >= 4u) && __builtin_cpu_supports("avx512f"))
+    {
+        return (xptInput->sucWidth == 4u) ?
+            SS__Find_Swap_32_Avx512(xptInput->spvValues, zptHandle->saulSolution,
+                        xptInput->suwSize, zuwOut, xulSlack, zaulSkip) :
+            SS__Find_Swap_64_Avx512(xptInput->spvValues, zptHandle->saulSolution,
+                        xptInput->suwSize, zuwOut, xulSlack, zaulSkip);
+    }
+
+    if ((xptInput->sucWidth >= 4u) && __builtin_cpu_supports("avx2"))
+    {
+        return (xptInput->sucWidth == 4u) ?
+            SS__Find_Swap_32_Avx2(xptInput->spvValues, zptHandle->saulSolution,
+                        xptInput->suwSize, zuwOut, xulSlack, zaulSkip) :
+            SS__Find_Swap_64_Avx2(xptInput->spvValues, zptHandle->saulSolution,
+                        xptInput->suwSize, zuwOut, xulSlack, zaulSkip);
+    }
+#endif
+
+    return SS__DISPATCH(xptInput, SS__Find_Swap, zptHandle->saulSolution,
+                        xptInput->suwSize, zuwOut, xulSlack, zaulSkip);
+}
 
 /**************************************************************************//**
 *
-* \defgroup    Subset_Sum Internal       Private Functions
-*
-* \{
-*
-******************************************************************************/
-/**************************************************************************//**
-*
-* \anchor      SS__Parse_Info
-*
-* \brief       Parse the info line at the top of an info file
+* \anchor      Subset_Sum_GetCount
 *
-* \details     Parses the info line and populates the given Subset Sum instance
-*              accordingly.
+* \brief       Get the number of selected items
 *
-* \param[in]   zptInst            Problem instance
-* \param[in]   zpnInfo            Info string
+* \param[in]   zptHandle            Problem instance
 *
-* \retval      void
+* \retval      uint32_t
 *
 ******************************************************************************/
 
-static void SS__Parse_Info (Subset_Sum_t * zptInst, char * zpnInfo)
+uint32_t Subset_Sum_GetCount (Subset_Sum_t * zptHandle)
 {
-    // The format of the first line is [size] [target]\r\n so simply
-    // scan the two expected values into the structure.
+    uint32_t xuwWord, xuwCount = 0u;
+
+    for (xuwWord = 0u; xuwWord < SUBSETSUM_WORDS(zptHandle->sptInput->suwSize);
+                                                                    xuwWord++)
+    {
+        xuwCount += __builtin_popcountll(zptHandle->saulSolution[xuwWord]);
+    }
 
-    sscanf(zpnInfo, "%d %ull\r\n", &zptInst->suwSize, &zptInst->sulTarget);
+    return xuwCount;
 }
 
 /**************************************************************************//**
 *
-* \anchor      SS__ParseInput
+* \anchor      Subset_Sum_NextIncluded
 *
-* \brief       Parse the given line
+* \brief       Find the next selected item
 *
-* \details     Parses the given line and adds the entry to the input set
+* \details     Skips whole words of excluded items, so iterating over the
+*              solution costs one step per selected item plus one per word:
 *
-* \param[in]   zptInst            Problem instance
-* \param[in]   zuwIndex            File path
-* \param[in]   zpnLine            File path
+*              for (i = Subset_Sum_NextIncluded(h, 0u); i < size;
+*                   i = Subset_Sum_NextIncluded(h, i + 1u))
 *
-* \retval      void
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zuwFrom              First item to consider
+*
+* \retval      uint32_t             Item index, the set size if none is left
 *
 ******************************************************************************/
 
-static void SS__Parse_Entry (Subset_Sum_t * zptInst, 
-                                      uint32_t zuwIndex, char * zpnLine)
+uint32_t Subset_Sum_NextIncluded (Subset_Sum_t * zptHandle, uint32_t zuwFrom)
 {
-    // The format of the first line is [item]\r\n so simply
-    // scan the expected values into the structure.
-    
-    uint32_t xuwtemp;
+    uint32_t xuwSize = zptHandle->sptInput->suwSize;
+    uint32_t xuwWord = zuwFrom >> 6;
+    uint64_t xulBits;
+
+    if (zuwFrom >= xuwSize)
+    {
+        return xuwSize;
+    }
+
+    // Drop the bits before the start in the first word
 
-    sscanf(zpnLine, "%u\r\n", &xuwtemp);
+    xulBits = zptHandle->saulSolution[xuwWord] & (UINT64_MAX << (zuwFrom & 63u));
 
-    (zptInst->sauwInputSet)[zuwIndex] = xuwtemp;
+    while (xulBits == 0u)
+    {
+        if (++xuwWord >= SUBSETSUM_WORDS(xuwSize))
+        {
+            return xuwSize;
+        }
+
+        xulBits = zptHandle->saulSolution[xuwWord];
+    }
+
+    return (xuwWord << 6) + __builtin_ctzll(xulBits);
 }
+
 /**************************************************************************//**
 *
-* \anchor      Subset_SumWriteData
+* \anchor      Subset_Sum_NextExcluded
 *
-* \brief       Write solution to given file handle.
+* \brief       Find the next item not in the solution
 *
-* \details     Prints the solution of the given instance to the given outfile.
-*              This can be an actual file handle or 0 for the console.
+* \details     Same as Subset_Sum_NextIncluded for the excluded items.
 *
 * \param[in]   zptHandle            Problem instance
-* \param[in]   ziFd                 File descriptor
+* \param[in]   zuwFrom              First item to consider
 *
-* \retval      void
+* \retval      uint32_t             Item index, the set size if none is left
 *
 ******************************************************************************/
 
-static void SS__Write (Subset_Sum_t * zptHandle, int ziFd)
+uint32_t Subset_Sum_NextExcluded (Subset_Sum_t * zptHandle, uint32_t zuwFrom)
 {
-    char xaucBuffer[80u];
-    uint32_t xuwLoop;
-
-    // File header
-
-    sprintf(xaucBuffer, "Input: %s\n", zptHandle->sacName);
-    write(ziFd, xaucBuffer, strlen(xaucBuffer));
+    uint32_t xuwSize = zptHandle->sptInput->suwSize;
+    uint32_t xuwWord = zuwFrom >> 6;
+    uint64_t xulBits;
 
-    sprintf(xaucBuffer, "Target: %llu\n", zptHandle->sulTarget);
-    write(ziFd, xaucBuffer, strlen(xaucBuffer));
+    if (zuwFrom >= xuwSize)
+    {
+        return xuwSize;
+    }
 
-    sprintf(xaucBuffer, "Size: %d\n", zptHandle->suwSize);
-    write(ziFd, xaucBuffer, strlen(xaucBuffer));
+    xulBits = ~zptHandle->saulSolution[xuwWord] & (UINT64_MAX << (zuwFrom & 63u));
 
-    sprintf(xaucBuffer, "Initial: %llu\n", zptHandle->sulInitialSol);
-    write(ziFd, xaucBuffer, strlen(xaucBuffer));    
+    while (xulBits == 0u)
+    {
+        if (++xuwWord >= SUBSETSUM_WORDS(xuwSize))
+        {
+            return xuwSize;
+        }
+
+        xulBits = ~zptHandle->saulSolution[xuwWord];
+    }
+
+    // The clear bits past the end of the set are not items
+
+    xuwWord = (xuwWord << 6) + __builtin_ctzll(xulBits);
+
+    return (xuwWord < xuwSize) ? xuwWord : xuwSize;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Increment
+*
+* \brief       Step to the next subset in binary counting order
+*
+* \details     Treats the solution as one binary number, item 0 being the
+*              least significant bit, and adds one to it a word at a time.
+*              Starting from the empty set every subset is visited once.
+*
+* \param[in]   zptHandle            Problem instance
+*
+* \retval      bool                 false once it wraps back to the empty set
+*
+******************************************************************************/
+
+bool Subset_Sum_Increment (Subset_Sum_t * zptHandle)
+{
+    uint32_t xuwSize = zptHandle->sptInput->suwSize;
+    uint32_t xuwWords = SUBSETSUM_WORDS(xuwSize);
+    uint32_t xuwWord = 0u;
+
+    zptHandle->sulSum = SUBSETSUM_UNKNOWN;
+
+    // Propagate the carry, almost always stops in the first word
+
+    while ((xuwWord < xuwWords) && (++zptHandle->saulSolution[xuwWord] == 0u))
+    {
+        xuwWord++;
+    }
+
+    if (xuwWord == xuwWords)
+    {
+        return false;
+    }
+
+    // Carry into the padding bits of the last word means we wrapped
+
+    if ((xuwWord == (xuwWords - 1u)) &&
+        ((zptHandle->saulSolution[xuwWord] & ~SS__TAIL_MASK(xuwSize)) != 0u))
+    {
+        zptHandle->saulSolution[xuwWord] = 0u;
+
+        return false;
+    }
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_GetOrder
+*
+* \brief       Get the element indices sorted by ascending value
+*
+* \details     The order is derived data of the input set. It is built the
+*              first time anyone asks for it, so loading stays a single pass
+*              over the file. Concurrent first callers may each sort, the
+*              first to publish wins and the others drop their copy.
+*
+* \param[in]   zptInput             Input set
+*
+* \retval      const uint32_t *     NULL if out of memory, asking again
+*                                   retries
+*
+******************************************************************************/
+
+const uint32_t * Subset_Sum_GetOrder (const Subset_Sum_Input_t * zptInput)
+{
+    Subset_Sum_Input_t * xptInput = (Subset_Sum_Input_t *)zptInput;
+    uint32_t * xauwOrder;
+    uint32_t * xauwExpected = NULL;
+
+    xauwOrder = __atomic_load_n(&xptInput->sauwOrder, __ATOMIC_ACQUIRE);
+
+    if (xauwOrder != NULL)
+    {
+        return xauwOrder;
+    }
+
+    xauwOrder = SS__Sort_Order(zptInput);
+
+    if (__atomic_compare_exchange_n(&xptInput->sauwOrder, &xauwExpected,
+                xauwOrder, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false)
+    {
+        free(xauwOrder);
+        xauwOrder = xauwExpected;
+    }
+
+    return xauwOrder;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_GetBits
+*
+* \brief       Get the bit width of the input set
+*
+* \details     Number of bits of the largest element, the "b" of the
+*              generator and the instance names. Scans the set, so callers
+*              should keep the result rather than ask repeatedly.
+*
+* \param[in]   zptInput             Input set
+*
+* \retval      uint32_t             0 for an empty or all zero set
+*
+******************************************************************************/
+
+uint32_t Subset_Sum_GetBits (const Subset_Sum_Input_t * zptInput)
+{
+    uint64_t xulMax = 0u;
+    uint32_t xuwLoop;
+
+    for (xuwLoop = 0u; xuwLoop < zptInput->suwSize; xuwLoop++)
+    {
+        xulMax |= SUBSETSUM_VALUE(zptInput, xuwLoop);
+    }
+
+    return (xulMax == 0u) ? 0u : (64u - (uint32_t)__builtin_clzll(xulMax));
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Fingerprint
+*
+* \brief       FNV-1a hash of the element values in order
+*
+* \details     Independent of the storage width, file format and name, so
+*              the same set still matches after converting or renaming the
+*              instance. Scans the set.
+*
+* \param[in]   zptInput             Input set
+*
+* \retval      uint64_t
+*
+******************************************************************************/
+
+uint64_t Subset_Sum_Fingerprint (const Subset_Sum_Input_t * zptInput)
+{
+    uint64_t xulHash = 0xcbf29ce484222325ull;
+    uint64_t xulValue;
+    uint32_t xuwLoop, xuwByte;
+
+    for (xuwLoop = 0u; xuwLoop < zptInput->suwSize; xuwLoop++)
+    {
+        xulValue = SUBSETSUM_VALUE(zptInput, xuwLoop);
+
+        for (xuwByte = 0u; xuwByte < 8u; xuwByte++)
+        {
+            xulHash ^= (xulValue >> (8u * xuwByte)) & 0xffu;
+            xulHash *= 0x100000001b3ull;
+        }
+    }
+
+    return xulHash;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Publish
+*
+* \brief       Offer the current solution to the shared incumbent
+*
+* \details     Raises the shared best-so-far sum if the current (feasible)
+*              sum beats it. Once any solver reaches the target the shared
+*              cancel flag is raised so every other solver can stop. When
+*              the instance is not part of a portfolio it only counts as an
+*              improvement in the solver's counters.
+*
+*              On an improvement the solution is also copied to the shared
+*              snapshot (if there is one) and the improvement callback (if
+*              any) is called on this thread.
+*
+* \param[in]   zptHandle            Problem instance
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_Publish (Subset_Sum_t * zptHandle)
+{
+    Subset_Sum_Shared_t * xptShared = zptHandle->sptShared;
+    uint64_t xulSum;
+    uint64_t xulBest;
+    uint32_t xuwWord;
+
+#if SS_STATS
+    // Every call is a new incumbent of this solver
+
+    Stats_Thread.sulBest = Deadline_Now() - Stats_Thread.sulStart;
+
+    if (Stats_Thread.sulImprovements++ == 0u)
+    {
+        Stats_Thread.sulFirst = Stats_Thread.sulBest;
+    }
+#endif
+
+    if (Telemetry_Active() == true)
+    {
+        Telemetry_Post(TELEMETRY_IMPROVED, Subset_Sum_GetSum(zptHandle));
+    }
+
+    if (xptShared == NULL)
+    {
+        return;
+    }
+
+    xulSum = Subset_Sum_GetSum(zptHandle);
+
+    // Infeasible sums are never an incumbent
+
+    if (xulSum > zptHandle->sptInput->sulTarget)
+    {
+        return;
+    }
+
+    // Lock-free max, retry only while someone else raced us with a lower
+    // value
+
+    xulBest = __atomic_load_n(&xptShared->sulBestSum, __ATOMIC_RELAXED);
+
+    while ((xulSum > xulBest) &&
+           (__atomic_compare_exchange_n(&xptShared->sulBestSum, &xulBest,
+                xulSum, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED) == false))
+    {
+    }
+
+    // The CAS only succeeds with xulBest still below our sum
+
+    if (xulSum <= xulBest)
+    {
+        return;
+    }
+
+    // Keep a copy of the new best. Writers take turns, and a faster one may
+    // already have stored something better in the meantime.
+
+    if (xptShared->saulSolution != NULL)
+    {
+        while (__atomic_exchange_n(&xptShared->suwWriter, 1u,
+                                            __ATOMIC_ACQUIRE) != 0u)
+        {
+        }
+
+        if (xulSum > xptShared->sulSolutionSum)
+        {
+            __atomic_add_fetch(&xptShared->suwSequence, 1u, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+
+            for (xuwWord = 0u; 
+                 xuwWord < SUBSETSUM_WORDS(zptHandle->sptInput->suwSize);
+                 xuwWord++)
+            {
+                __atomic_store_n(&xptShared->saulSolution[xuwWord],
+                    zptHandle->saulSolution[xuwWord], __ATOMIC_RELAXED);
+            }
+
+            __atomic_store_n(&xptShared->sulSolutionSum, xulSum, 
+                                                        __ATOMIC_RELAXED);
+            __atomic_add_fetch(&xptShared->suwSequence, 1u, __ATOMIC_RELEASE);
+        }
+
+        __atomic_store_n(&xptShared->suwWriter, 0u, __ATOMIC_RELEASE);
+    }
+
+    if (xptShared->spfImproved != NULL)
+    {
+        (xptShared->spfImproved)(xptShared->spvContext, xulSum);
+    }
+
+    // First hit cancels everyone
+
+    if (xulSum == zptHandle->sptInput->sulTarget)
+    {
+        __atomic_store_n(&xptShared->suwCancel, 1u, __ATOMIC_RELEASE);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Offer
+*
+* \brief       Publish the final solution if the incumbent lacks it
+*
+* \details     For whoever runs a solver against a shared incumbent, once
+*              it has returned. A solver that never published, or a cached
+*              answer, still reaches the incumbent. One that did is not
+*              published again, that would count the same improvement twice.
+*
+* \param[in]   zptHandle            Problem instance with a shared incumbent
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_Offer (Subset_Sum_t * zptHandle)
+{
+    if ((zptHandle->sptShared != NULL) &&
+        (Subset_Sum_GetSum(zptHandle) > 
+            __atomic_load_n(&zptHandle->sptShared->sulBestSum, __ATOMIC_ACQUIRE)))
+    {
+        Subset_Sum_Publish(zptHandle);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Cancelled
+*
+* \brief       Check if the solver should stop
+*
+* \details     Returns true once another solver sharing this instance's
+*              incumbent has hit the target. Cheap enough to poll from the
+*              solver's outer loop, which is also where the solver's
+*              progress is posted to the telemetry ring now and then.
+*
+* \param[in]   zptHandle            Problem instance
+*
+* \retval      bool
+*
+******************************************************************************/
+
+bool Subset_Sum_Cancelled (Subset_Sum_t * zptHandle)
+{
+    Telemetry_Tick();
+
+    if (zptHandle->sptShared == NULL)
+    {
+        return false;
+    }
+
+    return (__atomic_load_n(&zptHandle->sptShared->suwCancel,
+                                            __ATOMIC_ACQUIRE) != 0u);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Snapshot
+*
+* \brief       Copy the best solution found so far
+*
+* \details     Safe to call from any thread while the solvers are running.
+*              The copy is retried until it was not overlapped by a writer,
+*              so the returned sum always matches the copied solution.
+*              Without a shared solution buffer only the sum is returned.
+*
+* \param[in]   zptShared            Shared incumbent
+* \param[out]  zaulSolution         Packed solution, may be NULL
+* \param[in]   zuwWords             Words in zaulSolution
+*
+* \retval      uint64_t             Sum of the copied solution
+*
+******************************************************************************/
+
+uint64_t Subset_Sum_Snapshot (Subset_Sum_Shared_t * zptShared,
+                                    uint64_t * zaulSolution, uint32_t zuwWords)
+{
+    uint64_t xulSum;
+    uint32_t xuwBefore, xuwAfter, xuwWord;
+
+    if ((zptShared->saulSolution == NULL) || (zaulSolution == NULL))
+    {
+        return __atomic_load_n(&zptShared->sulBestSum, __ATOMIC_ACQUIRE);
+    }
+
+    do
+    {
+        xuwBefore = __atomic_load_n(&zptShared->suwSequence, __ATOMIC_ACQUIRE);
+
+        for (xuwWord = 0u; xuwWord < zuwWords; xuwWord++)
+        {
+            zaulSolution[xuwWord] = __atomic_load_n(
+                    &zptShared->saulSolution[xuwWord], __ATOMIC_RELAXED);
+        }
+
+        xulSum = __atomic_load_n(&zptShared->sulSolutionSum, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        xuwAfter = __atomic_load_n(&zptShared->suwSequence, __ATOMIC_RELAXED);
+    } while (((xuwBefore & 1u) != 0u) || (xuwBefore != xuwAfter));
+
+    return xulSum;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Subset_Sum Input          Input Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_SetSolver
+*
+* \brief       Set the solver function
+*
+* \details     Sets the solver function in the given instance handle.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   ztSolver             Solution function pointer
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_SetSolver (Subset_Sum_t * zptHandle, Algorithm_t ztSolver)
+{
+    // Set the solver function
+    
+    zptHandle->spfSolver = ztSolver;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_SetTimeLimit
+*
+* \brief       Set the solver time limit
+*
+* \details     Solvers start their deadline from this when they run. Freshly
+*              attached instances have no limit (UINT64_MAX).
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zulLimit             Limit in nanoseconds
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_SetTimeLimit (Subset_Sum_t * zptHandle, uint64_t zulLimit)
+{
+    zptHandle->sulTimeLimit = zulLimit;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_SetArena
+*
+* \brief       Give the solver scratch memory
+*
+* \details     The solver takes its workspaces from the arena instead of the
+*              heap. Problems solved one after the other can share an arena,
+*              problems solved at the same time cannot. It must outlive
+*              every solve of the problem.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zptArena             Arena, NULL for none
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_SetArena (Subset_Sum_t * zptHandle, Arena_t * zptArena)
+{
+    zptHandle->sptArena = zptArena;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_SetCache
+*
+* \brief       Let the result cache answer or warm start the solves
+*
+* \details     Once set, and if the process has opened a cache (see
+*              Cache_Open), Subset_Sum_Solve looks the instance up first
+*              and stores its result afterwards. The name has to change
+*              whenever the solver or its parameters do, results of the old
+*              version would be taken for the new one's otherwise. Not for
+*              solvers sharing an incumbent, a cached answer is not
+*              published.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zpsSolver            Solver and parameters, e.g. "p5.tabu",
+*                                   NULL for no caching
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_SetCache (Subset_Sum_t * zptHandle, const char * zpsSolver)
+{
+    snprintf(zptHandle->sacCache, sizeof(zptHandle->sacCache), "%s",
+                                        (zpsSolver != NULL) ? zpsSolver : "");
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_SetShared
+*
+* \brief       Attach a shared incumbent
+*
+* \details     Links the instance to an incumbent shared with other solvers
+*              working on the same input set. Pass NULL to detach.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zptShared            Shared incumbent
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_SetShared (Subset_Sum_t * zptHandle, 
+                                    Subset_Sum_Shared_t * zptShared)
+{
+    zptHandle->sptShared = zptShared;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Select
+*
+* \brief       Add the given element to the solution
+*
+* \details     Sets the inlude state of the given element. Kept for
+*              compatibility, the solution is a packed bitset now.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zpuwIndex            Item to set
+* \param[in]   zeState              State to set
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_Select (Subset_Sum_t * zptHandle, 
+                                    uint32_t zpuwIndex, uint8_t zeState)
+{
+    uint64_t xulBit = 1ull << (zpuwIndex & 63u);
+
+    zptHandle->sulSum = SUBSETSUM_UNKNOWN;
+
+    if (zeState == INCLUDED)
+    {
+        zptHandle->saulSolution[zpuwIndex >> 6] |= xulBit;
+    }
+    else
+    {
+        zptHandle->saulSolution[zpuwIndex >> 6] &= ~xulBit;
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Selected
+*
+* \brief       Get the include state of the given element
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zuwIndex             Item to check
+*
+* \retval      uint8_t              INCLUDED or EXCLUDED
+*
+******************************************************************************/
+
+uint8_t Subset_Sum_Selected (Subset_Sum_t * zptHandle, uint32_t zuwIndex)
+{
+    return ((zptHandle->saulSolution[zuwIndex >> 6] >> (zuwIndex & 63u)) & 1u) ?
+                                                        INCLUDED : EXCLUDED;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Clear
+*
+* \brief       Exclude every element
+*
+* \param[in]   zptHandle            Problem instance
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_Clear (Subset_Sum_t * zptHandle)
+{
+    memset(zptHandle->saulSolution, 0,
+            SUBSETSUM_WORDS(zptHandle->sptInput->suwSize) * sizeof(uint64_t));
+    zptHandle->sulSum = 0u;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Copy
+*
+* \brief       Copy a solution between two solvers
+*
+* \details     Both handles must be attached to the same input set. Handy to
+*              keep an incumbent next to a working solution.
+*
+* \param[in]   zptDest              Problem instance to overwrite
+* \param[in]   zptSrc               Problem instance to copy from
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_Copy (Subset_Sum_t * zptDest, const Subset_Sum_t * zptSrc)
+{
+    memcpy(zptDest->saulSolution, zptSrc->saulSolution,
+            SUBSETSUM_WORDS(zptSrc->sptInput->suwSize) * sizeof(uint64_t));
+    zptDest->sulSum = zptSrc->sulSum;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Equal
+*
+* \brief       Compare the solutions of two solvers
+*
+* \param[in]   zptA                 Problem instance
+* \param[in]   zptB                 Problem instance on the same input set
+*
+* \retval      bool                 true if the same items are selected
+*
+******************************************************************************/
+
+bool Subset_Sum_Equal (const Subset_Sum_t * zptA, const Subset_Sum_t * zptB)
+{
+    return (memcmp(zptA->saulSolution, zptB->saulSolution,
+            SUBSETSUM_WORDS(zptA->sptInput->suwSize) * sizeof(uint64_t)) == 0);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Subset_Sum Edit        Edit Functions
+*
+* \details     Change an instance a solver already has, instead of loading it
+*              again and solving from scratch. The input set may be shared,
+*              so it is copy on write: the first edit that changes values
+*              gives the handle its own copy, with room to grow, and every
+*              edit after that works on it in place. A new target alone
+*              never copies the values, the handle gets a set that shares
+*              them (and their sorted order) with the old one. Every other
+*              solver keeps seeing the set it had.
+*
+*              The solution is kept, its sum carried along (sulSum) rather
+*              than summed again, and repaired around the edit: trimmed if
+*              it went over the target, topped up if room opened, and for
+*              a new element tried against the included ones. All of it
+*              goes through binary searches of the sorted order, so an edit
+*              costs O(log n) plus whatever it has to walk past, except
+*              that a removal renumbers the elements after it. sbWarm then
+*              tells the next solve to start its local search from there.
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_SetTarget
+*
+* \brief       Change the target sum
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zulTarget            New target
+*
+* \retval      bool                 false if out of memory, the instance is
+*                                   unchanged
+*
+******************************************************************************/
+
+bool Subset_Sum_SetTarget (Subset_Sum_t * zptHandle, uint64_t zulTarget)
+{
+    Subset_Sum_Input_t * xptOld = (Subset_Sum_Input_t *)zptHandle->sptInput;
+    Subset_Sum_Input_t * xptNew = xptOld;
+
+    // Someone else still uses the old target, share the values instead
+
+    if (__atomic_load_n(&xptOld->suwRefs, __ATOMIC_ACQUIRE) > 1u)
+    {
+        xptNew = (Subset_Sum_Input_t *)malloc(sizeof(Subset_Sum_Input_t));
+
+        if (xptNew == NULL)
+        {
+            return false;
+        }
+
+        *xptNew = *xptOld;
+        xptNew->sauwOrder = __atomic_load_n(&xptOld->sauwOrder, 
+                                                        __ATOMIC_ACQUIRE);
+        xptNew->spvMap = NULL;
+        xptNew->sbBorrowed = false;
+        xptNew->sptBase = xptOld;
+        xptNew->suwCapacity = 0u;
+        xptNew->suwRefs = 1u;
+
+        // The handle's reference on the old set becomes the new one's
+
+        zptHandle->sptInput = xptNew;
+    }
+
+    xptNew->sulTarget = zulTarget;
+
+    SS__Repair(zptHandle, xptNew->suwSize);
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_AddElement
+*
+* \brief       Append an element to the set
+*
+* \details     The new element is last. It is included if it fits, or
+*              swapped in for an included element if that gets closer to
+*              the target.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zulValue             Value of the new element
+*
+* \retval      bool                 false if out of memory, the instance is
+*                                   unchanged
+*
+******************************************************************************/
+
+bool Subset_Sum_AddElement (Subset_Sum_t * zptHandle, uint64_t zulValue)
+{
+    Subset_Sum_Input_t * xptInput;
+    uint32_t xuwSize = zptHandle->sptInput->suwSize;
+    uint64_t * xaulSolution;
+    uint32_t * xauwOrder;
+    uint32_t xuwPos;
+
+    if (xuwSize == UINT32_MAX)
+    {
+        return false;
+    }
+
+    // One more word once the last one is full, its new bit is clear
+
+    if ((xuwSize & 63u) == 0u)
+    {
+        xaulSolution = (uint64_t *)realloc(zptHandle->saulSolution,
+                            (SUBSETSUM_WORDS(xuwSize) + 1u) * sizeof(uint64_t));
+
+        if (xaulSolution == NULL)
+        {
+            return false;
+        }
+
+        xaulSolution[SUBSETSUM_WORDS(xuwSize)] = 0u;
+        zptHandle->saulSolution = xaulSolution;
+    }
+
+    xptInput = SS__Own(zptHandle, xuwSize + 1u, 
+                            (zulValue <= UINT8_MAX)  ? 1u :
+                            (zulValue <= UINT16_MAX) ? 2u :
+                            (zulValue <= UINT32_MAX) ? 4u : 8u);
+
+    if (xptInput == NULL)
+    {
+        return false;
+    }
+
+    SS__Set_Value(xptInput, xuwSize, zulValue);
+    xptInput->sulTotal = (zulValue > (UINT64_MAX - xptInput->sulTotal)) ?
+                                UINT64_MAX : (xptInput->sulTotal + zulValue);
+    xptInput->suwCardinality = 0u;
+
+    // After any equal values, as a stable sort would put it
+
+    xauwOrder = xptInput->sauwOrder;
+
+    if (xauwOrder != NULL)
+    {
+        xuwPos = SS__Lower(xptInput, xauwOrder, zulValue, xuwSize);
+        memmove(&xauwOrder[xuwPos + 1u], &xauwOrder[xuwPos],
+                                    (xuwSize - xuwPos) * sizeof(uint32_t));
+        xauwOrder[xuwPos] = xuwSize;
+    }
+
+    xptInput->suwSize = xuwSize + 1u;
+
+    SS__Repair(zptHandle, xuwSize);
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_RemoveElement
+*
+* \brief       Remove an element from the set
+*
+* \details     The elements after it move down one place, as does their
+*              include state. This renumbering is the O(n) part.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zuwIndex             Element to remove
+*
+* \retval      bool                 false if there is no such element or out
+*                                   of memory, the instance is unchanged
+*
+******************************************************************************/
+
+bool Subset_Sum_RemoveElement (Subset_Sum_t * zptHandle, uint32_t zuwIndex)
+{
+    Subset_Sum_Input_t * xptInput;
+    uint32_t xuwSize = zptHandle->sptInput->suwSize;
+    uint64_t * xaulSolution = zptHandle->saulSolution;
+    uint32_t * xauwOrder;
+    uint64_t xulValue;
+    uint32_t xuwLoop, xuwWord, xuwPos;
+
+    if (zuwIndex >= xuwSize)
+    {
+        return false;
+    }
+
+    xptInput = SS__Own(zptHandle, xuwSize, 1u);
+
+    if (xptInput == NULL)
+    {
+        return false;
+    }
+
+    if (zptHandle->sulSum == SUBSETSUM_UNKNOWN)
+    {
+        zptHandle->sulSum = Subset_Sum_GetSum(zptHandle);
+    }
+
+    xulValue = SUBSETSUM_VALUE(xptInput, zuwIndex);
+
+    if (Subset_Sum_Selected(zptHandle, zuwIndex) == INCLUDED)
+    {
+        zptHandle->sulSum -= xulValue;
+    }
+
+    // Close the gap in the include bits, a word at a time past its own
+
+    xuwWord = zuwIndex >> 6;
+    xaulSolution[xuwWord] = (xaulSolution[xuwWord] & 
+                                ((1ull << (zuwIndex & 63u)) - 1u)) |
+                ((xaulSolution[xuwWord] >> 1) & ~((1ull << (zuwIndex & 63u)) - 1u));
+
+    for (xuwWord++; xuwWord < SUBSETSUM_WORDS(xuwSize); xuwWord++)
+    {
+        xaulSolution[xuwWord - 1u] |= xaulSolution[xuwWord] << 63;
+        xaulSolution[xuwWord] >>= 1;
+    }
+
+    // And in the order, found by value while the values are still in place
+
+    xauwOrder = xptInput->sauwOrder;
+
+    if (xauwOrder != NULL)
+    {
+        xuwPos = SS__Lower(xptInput, xauwOrder, xulValue, zuwIndex);
+        memmove(&xauwOrder[xuwPos], &xauwOrder[xuwPos + 1u],
+                                (xuwSize - xuwPos - 1u) * sizeof(uint32_t));
+
+        for (xuwLoop = 0u; xuwLoop < (xuwSize - 1u); xuwLoop++)
+        {
+            xauwOrder[xuwLoop] -= (xauwOrder[xuwLoop] > zuwIndex) ? 1u : 0u;
+        }
+    }
+
+    memmove((uint8_t *)xptInput->spvValues + 
+                            ((size_t)zuwIndex * xptInput->sucWidth),
+            (uint8_t *)xptInput->spvValues + 
+                            ((size_t)(zuwIndex + 1u) * xptInput->sucWidth),
+            (size_t)(xuwSize - zuwIndex - 1u) * xptInput->sucWidth);
+
+    xptInput->suwSize = xuwSize - 1u;
+    xptInput->suwCardinality = 0u;
+
+    // A saturated total has lost track, count it again
+
+    if (xptInput->sulTotal != UINT64_MAX)
+    {
+        xptInput->sulTotal -= xulValue;
+    }
+    else
+    {
+        unsigned __int128 xTotal = 0u;
+
+        for (xuwLoop = 0u; xuwLoop < xptInput->suwSize; xuwLoop++)
+        {
+            xTotal += SUBSETSUM_VALUE(xptInput, xuwLoop);
+        }
+
+        xptInput->sulTotal = (xTotal > UINT64_MAX) ? UINT64_MAX : 
+                                                        (uint64_t)xTotal;
+    }
+
+    SS__Repair(zptHandle, xptInput->suwSize);
+
+    return true;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Subset_Sum Save        Save Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Save
+*
+* \brief       Write an input set to an instance file
+*
+* \details     Writes the input set in one of the supported formats:
+*
+*              SUBSETSUM_TEXT    "[size] [target]" then one element per line
+*              SUBSETSUM_BINARY  Subset_Sum_Header_t then the value array
+*              SUBSETSUM_AMPL    AMPL .dat at the given path plus the matching
+*                                .run file next to it
+*
+*              Any file already at the path is replaced.
+*
+* \param[in]   zptInput             Input set
+* \param[in]   zpsFilePath          File path
+* \param[in]   zeFormat             File format
+*
+* \retval      bool                 false if the file could not be written
+*
+******************************************************************************/
+
+bool Subset_Sum_Save (const Subset_Sum_Input_t * zptInput, 
+                                    char * zpsFilePath, uint8_t zeFormat)
+{
+    FILE * xptFile;
+    bool xbOk;
+
+    xptFile = fopen(zpsFilePath, "wb");
+
+    if (xptFile == NULL)
+    {
+        fprintf(stderr, "%s: %s\n", zpsFilePath, strerror(errno));
+
+        return false;
+    }
+
+    switch (zeFormat)
+    {
+        case SUBSETSUM_BINARY:
+            xbOk = SS__Save_Binary(zptInput, xptFile);
+            break;
+
+        case SUBSETSUM_AMPL:
+            xbOk = SS__Save_Ampl(zptInput, xptFile, zpsFilePath);
+            break;
+
+        default:
+            xbOk = SS__Save_Text(zptInput, xptFile);
+            break;
+    }
+
+    // A failed flush on close loses data just the same
+
+    xbOk = (fclose(xptFile) == 0) && xbOk;
+
+    if (xbOk == false)
+    {
+        fprintf(stderr, "%s: write failed\n", zpsFilePath);
+    }
+
+    return xbOk;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Subset_Sum Print       Print Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Subset_SumDisplayData
+*
+* \brief       Print solution to console.
+*
+* \details     Prints the solution of the given instance to the console in the
+*              same formatting as it would be written to an outfile.
+*
+* \param[in]   zptHandle            Problem instance
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_SumDisplayData (Subset_Sum_t * zptHandle)
+{
+    Sink_t xtSink;
+
+    // Call generic with a sink on STDOUT
+
+    Sink_Open(&xtSink, SINK_STDOUT);
+    SS__Write(zptHandle, &xtSink);
+    Sink_End(&xtSink);
+    Sink_Close(&xtSink);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_SumWriteData
+*
+* \brief       Write solution to output file.
+*
+* \details     Prints the solution of the given instance to the given outfile.
+*              The file is replaced, so a rerun does not add a second result
+*              to it. The solver's counters also go to a .stats.csv next to
+*              it, see SS__Write_Stats.
+*
+*              Batch runs with many instances should rather collect all
+*              results in one sink, see Subset_Sum_WriteRecord.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zpnFldr              Output folder
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_SumWriteData (Subset_Sum_t * zptHandle, char * zpnFldr)
+{
+    char xacFileName[128u];
+    Sink_t xtSink;
+
+    // Create file
+
+    sprintf(xacFileName, "../outputs/%s/%s.out", zpnFldr, 
+                                    zptHandle->sptInput->sacName);
+
+    if (Sink_Open(&xtSink, xacFileName) == true)
+    {
+        // Call generic write, it all goes out in one write() on close
+
+        SS__Write(zptHandle, &xtSink);
+        Sink_End(&xtSink);
+        Sink_Close(&xtSink);
+    }
+
+    // Counters for scripts
+
+    SS__Write_Stats(zptHandle, zpnFldr);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_WriteRecord
+*
+* \brief       Add a solution to a consolidated result sink
+*
+* \details     The record is what Subset_SumWriteData would write to the
+*              instance's own file, framed by a "Record: <solver>" line and
+*              an "End" line, so any number of instances and solvers can
+*              share one file or stdout. A record without its "End" line
+*              was cut off. The counters are in the record's Stats line,
+*              no sidecar is written.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zptSink              Sink, see Sink_Open
+* \param[in]   zpsSolver            Name of the solver that solved it
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_WriteRecord (Subset_Sum_t * zptHandle, Sink_t * zptSink,
+                                    const char * zpsSolver)
+{
+    Sink_Printf(zptSink, "Record: %s\n", zpsSolver);
+    SS__Write(zptHandle, zptSink);
+    Sink_Printf(zptSink, "End\n");
+    Sink_End(zptSink);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Subset_Sum Print       Print Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Free
+*
+* \brief       Free allocated memory
+*
+* \details     Frees the solution array and drops this solver's reference on
+*              the shared input set.
+*
+* \param[in]   zptHandle            Problem instance
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_Free (Subset_Sum_t * zptHandle)
+{
+    // Free allocated memory
+    
+    free(zptHandle->saulSolution);
+    zptHandle->saulSolution = NULL;
+
+    // A handle whose Subset_Sum_Attach failed holds no reference
+
+    if (zptHandle->sptInput != NULL)
+    {
+        Subset_Sum_Release((Subset_Sum_Input_t *)zptHandle->sptInput);
+        zptHandle->sptInput = NULL;
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Subset_Sum_Release
+*
+* \brief       Drop a reference on an input set
+*
+* \details     Frees the input set and its derived data once the last
+*              reference is gone.
+*
+* \param[in]   zptInput             Loaded input set
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Subset_Sum_Release (Subset_Sum_Input_t * zptInput)
+{
+    if (__atomic_sub_fetch(&zptInput->suwRefs, 1u, __ATOMIC_ACQ_REL) == 0u)
+    {
+        // Binary instances point into their file mapping, wrapped ones
+        // into the caller's memory, retargeted ones into their base set's
+
+        if (zptInput->spvMap != NULL)
+        {
+            munmap(zptInput->spvMap, zptInput->sulMapSize);
+        }
+        else if ((zptInput->sbBorrowed == false) && (zptInput->sptBase == NULL))
+        {
+            free(zptInput->spvValues);
+        }
+
+        if (zptInput->sptBase == NULL)
+        {
+            free(zptInput->sauwOrder);
+        }
+        else
+        {
+            if (zptInput->sauwOrder != __atomic_load_n(
+                            &zptInput->sptBase->sauwOrder, __ATOMIC_ACQUIRE))
+            {
+                free(zptInput->sauwOrder);
+            }
+
+            Subset_Sum_Release(zptInput->sptBase);
+        }
+
+        free(zptInput);
+    }
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Subset_Sum Internal       Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      SS__Set_Name
+*
+* \brief       Derive the instance name from its file path
+*
+* \details     The name is the base name of the file without its extension,
+*              truncated to fit the name buffer.
+*
+* \param[in]   zptInst            Input set
+* \param[in]   zpsFilePath        File path
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void SS__Set_Name (Subset_Sum_Input_t * zptInst, char * zpsFilePath)
+{
+    const char * xpsBase = strrchr(zpsFilePath, '/');
+    char * xpcDot;
+
+    xpsBase = (xpsBase == NULL) ? zpsFilePath : (xpsBase + 1);
+
+    snprintf(zptInst->sacName, sizeof(zptInst->sacName), "%s", xpsBase);
+
+    xpcDot = strrchr(zptInst->sacName, '.');
+
+    if (xpcDot != NULL)
+    {
+        *xpcDot = '\0';
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Parse_Number
+*
+* \brief       Parse the next unsigned integer of a mapped text file
+*
+* \details     Skips white space (counting lines for error messages) and
+*              reads one decimal number, leaving the cursor right after it.
+*
+* \param[in]   zppcCur            Cursor, advanced past the number
+* \param[in]   zpcEnd             End of the mapped data
+* \param[in]   zpuwLine           Current line number, updated
+* \param[out]  zpulValue          Parsed value
+*
+* \retval      int                SS_PARSE_OK, SS_PARSE_END or SS_PARSE_BAD
+*
+******************************************************************************/
+
+static int SS__Parse_Number (const char ** zppcCur, const char * zpcEnd,
+                                    uint32_t * zpuwLine, uint64_t * zpulValue)
+{
+    const char * xpcCur = *zppcCur;
+    uint64_t xulValue = 0u;
+    uint32_t xuwDigit;
+
+    // Skip any white space, the files come with both \n and \r\n endings
+
+    while ((xpcCur < zpcEnd) && 
+           ((*xpcCur == ' ') || (*xpcCur == '\t') ||
+            (*xpcCur == '\r') || (*xpcCur == '\n')))
+    {
+        *zpuwLine += (*xpcCur == '\n');
+        xpcCur++;
+    }
+
+    *zppcCur = xpcCur;
+
+    if (xpcCur == zpcEnd)
+    {
+        return SS_PARSE_END;
+    }
+
+    if ((*xpcCur < '0') || (*xpcCur > '9'))
+    {
+        return SS_PARSE_BAD;
+    }
+
+    // Accumulate digits, refusing anything that would overflow
+
+    while ((xpcCur < zpcEnd) && (*xpcCur >= '0') && (*xpcCur <= '9'))
+    {
+        xuwDigit = (uint32_t)(*xpcCur - '0');
+
+        if (xulValue > ((UINT64_MAX - xuwDigit) / 10u))
+        {
+            return SS_PARSE_BAD;
+        }
+
+        xulValue = (xulValue * 10u) + xuwDigit;
+        xpcCur++;
+    }
+
+    *zppcCur = xpcCur;
+    *zpulValue = xulValue;
+
+    return SS_PARSE_OK;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Parse_Text
+*
+* \brief       Parse a whole text instance file
+*
+* \details     The format is "[size] [target]" on the first line followed by
+*              one element per line. Values are parsed straight into a cache
+*              line aligned array once the size is known, then stored at the
+*              narrowest width that holds them.
+*
+* \param[in]   zptInst            Input set to fill
+* \param[in]   zpcData            Start of the mapped file
+* \param[in]   zpcEnd             End of the mapped file
+* \param[in]   zpsFilePath        File path, for error messages
+*
+* \retval      bool               false if the file is malformed
+*
+******************************************************************************/
+
+static bool SS__Parse_Text (Subset_Sum_Input_t * zptInst, const char * zpcData,
+                                    const char * zpcEnd, char * zpsFilePath)
+{
+    const char * xpcCur = zpcData;
+    uint64_t * xaulValues;
+    uint32_t xuwLine = 1u;
+    uint32_t xuwLoop;
+    uint64_t xulValue;
+    int xiStatus;
+
+    // Read the problem info
+
+    xiStatus = SS__Parse_Number(&xpcCur, zpcEnd, &xuwLine, &xulValue);
+
+    if ((xiStatus != SS_PARSE_OK) || (xulValue > UINT32_MAX))
+    {
+        fprintf(stderr, "%s:%u: bad set size\n", zpsFilePath, xuwLine);
+
+        return false;
+    }
+
+    zptInst->suwSize = (uint32_t)xulValue;
+
+    xiStatus = SS__Parse_Number(&xpcCur, zpcEnd, &xuwLine, &xulValue);
+
+    if (xiStatus != SS_PARSE_OK)
+    {
+        fprintf(stderr, "%s:%u: bad target\n", zpsFilePath, xuwLine);
+
+        return false;
+    }
+
+    zptInst->sulTarget = xulValue;
+
+    // Now that the instance size is known, allocate space for the input
+    // set. The width is not known until every value has been seen, so parse
+    // at full width and let SS__Store narrow it.
+
+    if (posix_memalign((void **)&xaulValues, SS_ALIGN,
+                    (size_t)zptInst->suwSize * sizeof(uint64_t)) != 0)
+    {
+        fprintf(stderr, "%s: out of memory\n", zpsFilePath);
+
+        return false;
+    }
+
+    // Read the set members
+
+    for (xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    {
+        xiStatus = SS__Parse_Number(&xpcCur, zpcEnd, &xuwLine, &xulValue);
+
+        if (xiStatus == SS_PARSE_END)
+        {
+            fprintf(stderr, "%s: expected %u elements, found %u\n", 
+                                zpsFilePath, zptInst->suwSize, xuwLoop);
+            free(xaulValues);
+
+            return false;
+        }
+
+        if (xiStatus != SS_PARSE_OK)
+        {
+            fprintf(stderr, "%s:%u: bad element\n", zpsFilePath, xuwLine);
+            free(xaulValues);
+
+            return false;
+        }
+
+        xaulValues[xuwLoop] = xulValue;
+    }
+
+    // Anything left other than white space is an error
+
+    if (SS__Parse_Number(&xpcCur, zpcEnd, &xuwLine, &xulValue) != SS_PARSE_END)
+    {
+        fprintf(stderr, "%s:%u: unexpected data after %u elements\n", 
+                                zpsFilePath, xuwLine, zptInst->suwSize);
+        free(xaulValues);
+
+        return false;
+    }
+
+    if (SS__Store(zptInst, xaulValues, true) == false)
+    {
+        fprintf(stderr, "%s: out of memory\n", zpsFilePath);
+
+        return false;
+    }
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Parse_Binary
+*
+* \brief       Use a mapped binary instance file in place
+*
+* \details     Validates the header, the file length and the checksum and
+*              then points the input set straight at the value array in the
+*              mapping. The total is not taken from the header but summed in
+*              the checksum pass and has to match it, since the sum index
+*              sizes its table by it (see Index_Build). The mapping is owned by the input set from here on,
+*              even on failure.
+*
+* \param[in]   zptInst            Input set to fill
+* \param[in]   zpcData            Start of the mapped file
+* \param[in]   zulLength          Length of the mapped file
+* \param[in]   zpsFilePath        File path, for error messages
+*
+* \retval      bool               false if the file is malformed
+*
+******************************************************************************/
+
+static bool SS__Parse_Binary (Subset_Sum_Input_t * zptInst, const char * zpcData,
+                                    uint64_t zulLength, char * zpsFilePath)
+{
+    const Subset_Sum_Header_t * xptHeader = (const Subset_Sum_Header_t *)zpcData;
+    uint64_t xulBytes;
+
+    zptInst->spvMap = (void *)zpcData;
+    zptInst->sulMapSize = zulLength;
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+    fprintf(stderr, "%s: binary instances need a little-endian host\n", 
+                                    zpsFilePath);
+
+    return false;
+#endif
+
+    if ((zulLength < sizeof(Subset_Sum_Header_t)) ||
+        (xptHeader->suwVersion != SUBSETSUM_VERSION) ||
+        ((xptHeader->suwWidth != 1u) && (xptHeader->suwWidth != 2u) &&
+         (xptHeader->suwWidth != 4u) && (xptHeader->suwWidth != 8u)))
+    {
+        fprintf(stderr, "%s: unsupported binary header\n", zpsFilePath);
+
+        return false;
+    }
+
+    xulBytes = (uint64_t)xptHeader->suwSize * xptHeader->suwWidth;
+
+    if (zulLength < (sizeof(Subset_Sum_Header_t) + xulBytes))
+    {
+        fprintf(stderr, "%s: truncated, expected %u elements\n", 
+                                    zpsFilePath, xptHeader->suwSize);
+
+        return false;
+    }
+
+    zptInst->suwSize = xptHeader->suwSize;
+    zptInst->sulTarget = xptHeader->sulTarget;
+    zptInst->suwCardinality = xptHeader->suwCardinality;
+    zptInst->sucWidth = (uint8_t)xptHeader->suwWidth;
+    zptInst->spvValues = (void *)(zpcData + sizeof(Subset_Sum_Header_t));
+
+    if (SS__Checksum(zptInst->spvValues, xulBytes, zptInst->sucWidth,
+                        &zptInst->sulTotal) != xptHeader->sulChecksum)
+    {
+        fprintf(stderr, "%s: checksum mismatch\n", zpsFilePath);
+
+        return false;
+    }
+
+    if (zptInst->sulTotal != xptHeader->sulTotal)
+    {
+        fprintf(stderr, "%s: total mismatch, header %llu, elements %llu\n",
+                        zpsFilePath, (unsigned long long)xptHeader->sulTotal,
+                        (unsigned long long)zptInst->sulTotal);
+
+        return false;
+    }
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Checksum
+*
+* \brief       Checksum of a binary value array
+*
+* \details     Fletcher style pair of running sums over 64-bit words, which
+*              keeps verification at memory speed. A short tail is zero
+*              padded to a full word. The same pass can also add up the
+*              elements, saturated like Subset_Sum_Input_t's total.
+*
+* \param[in]   zpvData            Data, 8 byte aligned
+* \param[in]   zulBytes           Length in bytes
+* \param[in]   zucWidth           Bytes per element, 1, 2, 4 or 8
+* \param[out]  zpulTotal          Sum of the elements, NULL if not wanted
+*
+* \retval      uint64_t
+*
+******************************************************************************/
+
+static uint64_t SS__Checksum (const void * zpvData, uint64_t zulBytes,
+                                    uint8_t zucWidth, uint64_t * zpulTotal)
+{
+    const uint64_t * xpulWord = (const uint64_t *)zpvData;
+    uint64_t xulWords = zulBytes / sizeof(uint64_t);
+    uint64_t xulMask = (zucWidth >= 8u) ? UINT64_MAX : 
+                                        ((1ull << (8u * zucWidth)) - 1u);
+    unsigned __int128 xTotal = 0u;
+    uint64_t xulSumA = 0u;
+    uint64_t xulSumB = 0u;
+    uint64_t xulWord;
+    uint64_t xulLoop;
+    uint32_t xuwShift;
+
+    for (xulLoop = 0u; xulLoop <= xulWords; xulLoop++)
+    {
+        if (xulLoop < xulWords)
+        {
+            xulWord = xpulWord[xulLoop];
+        }
+        else if ((zulBytes % sizeof(uint64_t)) != 0u)
+        {
+            xulWord = 0u;
+            memcpy(&xulWord, &xpulWord[xulWords], zulBytes % sizeof(uint64_t));
+        }
+        else
+        {
+            break;
+        }
+
+        xulSumA += xulWord;
+        xulSumB += xulSumA;
+
+        // Every element of the word, the padding adds nothing
+
+        for (xuwShift = 0u; (zpulTotal != NULL) && (xuwShift < 64u); 
+                                                xuwShift += 8u * zucWidth)
+        {
+            xTotal += (xulWord >> xuwShift) & xulMask;
+        }
+    }
+
+    if (zpulTotal != NULL)
+    {
+        *zpulTotal = (xTotal > UINT64_MAX) ? UINT64_MAX : (uint64_t)xTotal;
+    }
+
+    return xulSumB ^ (xulSumA * 0x9E3779B97F4A7C15ull) ^ zulBytes;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Save_Text
+*
+* \brief       Write an input set in the text format
+*
+* \param[in]   zptInst            Input set
+* \param[in]   zptFile            Open output file
+*
+* \retval      bool
+*
+******************************************************************************/
+
+static bool SS__Save_Text (const Subset_Sum_Input_t * zptInst, FILE * zptFile)
+{
+    uint32_t xuwLoop;
+
+    fprintf(zptFile, "%u %llu\n", zptInst->suwSize, 
+                                    (unsigned long long)zptInst->sulTarget);
+
+    for (xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    {
+        fprintf(zptFile, "%llu\n", 
+                    (unsigned long long)SUBSETSUM_VALUE(zptInst, xuwLoop));
+    }
+
+    return (ferror(zptFile) == 0);
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Save_Binary
+*
+* \brief       Write an input set in the binary format
+*
+* \param[in]   zptInst            Input set
+* \param[in]   zptFile            Open output file
+*
+* \retval      bool
+*
+******************************************************************************/
+
+static bool SS__Save_Binary (const Subset_Sum_Input_t * zptInst, FILE * zptFile)
+{
+    Subset_Sum_Header_t xtHeader;
+    uint64_t xulBytes = (uint64_t)zptInst->suwSize * zptInst->sucWidth;
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+    return false;
+#endif
+
+    memset(&xtHeader, 0, sizeof(xtHeader));
+    memcpy(xtHeader.sacMagic, SUBSETSUM_MAGIC, sizeof(SUBSETSUM_MAGIC));
+    xtHeader.suwVersion = SUBSETSUM_VERSION;
+    xtHeader.suwWidth = zptInst->sucWidth;
+    xtHeader.suwSize = zptInst->suwSize;
+    xtHeader.suwCardinality = zptInst->suwCardinality;
+    xtHeader.sulTarget = zptInst->sulTarget;
+    xtHeader.sulTotal = zptInst->sulTotal;
+    xtHeader.sulChecksum = SS__Checksum(zptInst->spvValues, xulBytes, 
+                                        zptInst->sucWidth, NULL);
+
+    return (fwrite(&xtHeader, sizeof(xtHeader), 1u, zptFile) == 1u) &&
+           (fwrite(zptInst->spvValues, 1u, xulBytes, zptFile) == xulBytes);
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Save_Ampl
+*
+* \brief       Write an input set as AMPL data plus its run file
+*
+* \details     Same layout as instance_generator.py --ampl, the .run file is
+*              created next to the .dat and refers to it through the
+*              instances/ampl_instances directory. AMPL writes its results to
+*              a .out named after the .dat.
+*
+* \param[in]   zptInst            Input set
+* \param[in]   zptFile            Open .dat file
+* \param[in]   zpsFilePath        Path of the .dat file
+*
+* \retval      bool
+*
+******************************************************************************/
+
+static bool SS__Save_Ampl (const Subset_Sum_Input_t * zptInst, FILE * zptFile,
+                                    char * zpsFilePath)
+{
+    char xacRunName[256u];
+    char xacOutName[256u];
+    const char * xpsBase;
+    char * xpcDot;
+    FILE * xptRun;
+    uint32_t xuwLoop;
+    bool xbOk;
+
+    // Data file
+
+    fprintf(zptFile, "param set_len = %u;\n", zptInst->suwSize);
+    fprintf(zptFile, "param target_sum = %llu;\n", 
+                                    (unsigned long long)zptInst->sulTarget);
+    fprintf(zptFile, "param values := ");
+
+    for (xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    {
+        fprintf(zptFile, "[%u] %llu ", xuwLoop + 1u, 
+                    (unsigned long long)SUBSETSUM_VALUE(zptInst, xuwLoop));
+    }
+
+    fprintf(zptFile, ";\n");
+
+    // Run file, same name with a .run extension
+
+    snprintf(xacRunName, sizeof(xacRunName), "%s", zpsFilePath);
+    xpcDot = strrchr(xacRunName, '.');
+
+    if ((xpcDot == NULL) || (strchr(xpcDot, '/') != NULL))
+    {
+        xpcDot = xacRunName + strlen(xacRunName);
+    }
+
+    snprintf(xpcDot, sizeof(xacRunName) - (xpcDot - xacRunName), ".run");
+
+    xpsBase = strrchr(zpsFilePath, '/');
+    xpsBase = (xpsBase == NULL) ? zpsFilePath : (xpsBase + 1);
+
+    // Results are named after the data file
+
+    snprintf(xacOutName, sizeof(xacOutName), "%s", xpsBase);
+    xpcDot = strrchr(xacOutName, '.');
+
+    if (xpcDot != NULL)
+    {
+        *xpcDot = '\0';
+    }
+
+    xptRun = fopen(xacRunName, "w");
+
+    if (xptRun == NULL)
+    {
+        return false;
+    }
+
+    fprintf(xptRun, "model ../src/subset_sum.mod;\n");
+    fprintf(xptRun, "data ../../instances/ampl_instances/%s;\n", xpsBase);
+    fprintf(xptRun, "\n");
+    fprintf(xptRun, "option solver cplex;\n");
+    fprintf(xptRun, "option cplex_options 'timelimit=600';\n");
+    fprintf(xptRun, "option cplex_options 'integrality=3e-07';\n");
+    fprintf(xptRun, "solve;\n");
+    fprintf(xptRun, "\n");
+    fprintf(xptRun, "display _solve_elapsed_time > %s.out;\n", xacOutName);
+    fprintf(xptRun, "display calculated_sum > %s.out;\n", xacOutName);
+    fprintf(xptRun, "display target_sum > %s.out;\n", xacOutName);
+    fprintf(xptRun, "display set_len > %s.out;\n", xacOutName);
+    fprintf(xptRun, "display x > %s.out;\n", xacOutName);
+    fprintf(xptRun, "\n");
+
+    xbOk = (ferror(xptRun) == 0);
+    xbOk = (fclose(xptRun) == 0) && xbOk;
+
+    return xbOk && (ferror(zptFile) == 0);
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Sort_Order
+*
+* \brief       Sort the element indices of an input set by value
+*
+* \param[in]   zptInst            Input set
+*
+* \retval      uint32_t *         Newly allocated index array, NULL if out
+*                                 of memory
+*
+******************************************************************************/
+
+static uint32_t * SS__Sort_Order (const Subset_Sum_Input_t * zptInst)
+{
+    uint32_t * xauwOrder;
+    uint32_t * xauwTemp;
+    uint32_t * xauwSwap;
+    uint32_t xauwCount[256u];
+    uint32_t xuwLoop;
+    uint32_t xuwShift;
+    uint32_t xuwBucket;
+    uint32_t xuwIndex;
+    uint32_t xuwPos;
+    uint32_t xuwTemp;
+    size_t xulLength;
+
+    // An edited set keeps room to patch its order in place
+
+    xulLength = ((zptInst->suwCapacity > zptInst->suwSize) ? 
+                    zptInst->suwCapacity : zptInst->suwSize) * sizeof(uint32_t);
+    xauwOrder = (uint32_t *)malloc(xulLength);
+    xauwTemp = (uint32_t *)malloc(xulLength);
+
+    if ((xauwOrder == NULL) || (xauwTemp == NULL))
+    {
+        free(xauwOrder);
+        free(xauwTemp);
+
+        return NULL;
+    }
+
+    for (xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    {
+        xauwOrder[xuwLoop] = xuwLoop;
+    }
+
+    // LSD radix sort of the indices by value, one byte per pass of the
+    // storage width. Linear in the set size so it never dominates loading a
+    // large instance.
+
+    for (xuwShift = 0u; xuwShift < (8u * zptInst->sucWidth); xuwShift += 8u)
+    {
+        memset(xauwCount, 0, sizeof(xauwCount));
+
+        for (xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+        {
+            xauwCount[(SUBSETSUM_VALUE(zptInst, xuwLoop) >> xuwShift) & 0xFFu]++;
+        }
+
+        for (xuwBucket = 0u, xuwPos = 0u; xuwBucket < 256u; xuwBucket++)
+        {
+            xuwTemp = xauwCount[xuwBucket];
+
+            xauwCount[xuwBucket] = xuwPos;
+            xuwPos += xuwTemp;
+        }
+
+        for (xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+        {
+            xuwIndex = xauwOrder[xuwLoop];
+            xuwBucket = (SUBSETSUM_VALUE(zptInst, xuwIndex) >> xuwShift) & 0xFFu;
+            xauwTemp[xauwCount[xuwBucket]++] = xuwIndex;
+        }
+
+        // The pass's output is the next pass's input
+
+        xauwSwap = xauwOrder;
+        xauwOrder = xauwTemp;
+        xauwTemp = xauwSwap;
+    }
+
+    free(xauwTemp);
+
+    return xauwOrder;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Store
+*
+* \brief       Store values at the narrowest width that holds them
+*
+* \details     Picks 1, 2, 4 or 8 bytes per element from the largest value,
+*              so small instances cost a fraction of the memory bandwidth,
+*              and fills the (cache line aligned) value array. A full width
+*              array the caller hands over is used as is. Also computes the
+*              total with a 128-bit accumulator.
+*
+* \param[in]   zptInst            Input set, size already set
+* \param[in]   zaulValues         Values at full width
+* \param[in]   zbOwned            true to hand zaulValues over (freed or kept)
+*
+* \retval      bool               false if out of memory
+*
+******************************************************************************/
+
+static bool SS__Store (Subset_Sum_Input_t * zptInst, uint64_t * zaulValues,
+                                    bool zbOwned)
+{
+    unsigned __int128 xTotal = 0u;
+    uint64_t xulMax = 0u;
+    uint32_t xuwLoop;
+    void * xpvValues;
+
+    for (xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    {
+        xulMax = (zaulValues[xuwLoop] > xulMax) ? zaulValues[xuwLoop] : xulMax;
+        xTotal += zaulValues[xuwLoop];
+    }
+
+    zptInst->sulTotal = (xTotal > UINT64_MAX) ? UINT64_MAX : (uint64_t)xTotal;
+    zptInst->sucWidth = (xulMax <= UINT8_MAX)  ? 1u :
+                        (xulMax <= UINT16_MAX) ? 2u :
+                        (xulMax <= UINT32_MAX) ? 4u : 8u;
+
+    // Full width arrays we own need no copy
+
+    if ((zptInst->sucWidth == 8u) && (zbOwned == true))
+    {
+        zptInst->spvValues = zaulValues;
+
+        return true;
+    }
+
+    if (posix_memalign(&xpvValues, SS_ALIGN, 
+                    (size_t)zptInst->suwSize * zptInst->sucWidth) != 0)
+    {
+        if (zbOwned == true)
+        {
+            free(zaulValues);
+        }
+
+        return false;
+    }
+
+    for (xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    {
+        switch (zptInst->sucWidth)
+        {
+            case 1u: ((uint8_t *)xpvValues)[xuwLoop] = zaulValues[xuwLoop];  break;
+            case 2u: ((uint16_t *)xpvValues)[xuwLoop] = zaulValues[xuwLoop]; break;
+            case 4u: ((uint32_t *)xpvValues)[xuwLoop] = zaulValues[xuwLoop]; break;
+            default: ((uint64_t *)xpvValues)[xuwLoop] = zaulValues[xuwLoop]; break;
+        }
+    }
+
+    zptInst->spvValues = xpvValues;
+
+    if (zbOwned == true)
+    {
+        free(zaulValues);
+    }
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Write
+*
+* \brief       Write solution to given sink.
+*
+* \details     Formats the solution of the given instance into the open
+*              record of the sink, the caller ends the record. The sink can
+*              be an actual file or the console.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zptSink              Sink
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void SS__Write (Subset_Sum_t * zptHandle, Sink_t * zptSink)
+{
+    const Subset_Sum_Input_t * xptInput = zptHandle->sptInput;
+    uint64_t xulSum = Subset_Sum_GetSum(zptHandle);
+    uint32_t xuwLoop;
+
+    // File header
+
+    Sink_Printf(zptSink, "Input: %s\n", xptInput->sacName);
+    Sink_Printf(zptSink, "Target: %llu\n", 
+                                (unsigned long long)xptInput->sulTarget);
+    Sink_Printf(zptSink, "Size: %d\n", xptInput->suwSize);
+    Sink_Printf(zptSink, "Initial: %llu\n", 
+                                (unsigned long long)zptHandle->sulInitialSol);
+
+#if SS_STATS
+    {
+        const Stats_t * xptStats = &zptHandle->stStats;
+
+        Sink_Printf(zptSink, "Stats: moves %llu, improvements "
+                "%llu, restarts %llu, tabu %llu, nodes %llu, subsets %llu, "
+                "first %.9f, best %.9f\n",
+                (unsigned long long)xptStats->sulMoves,
+                (unsigned long long)xptStats->sulImprovements,
+                (unsigned long long)xptStats->sulRestarts,
+                (unsigned long long)xptStats->sulTabu,
+                (unsigned long long)xptStats->sulNodes,
+                (unsigned long long)xptStats->sulSubsets,
+                xptStats->sulFirst / 1e9, xptStats->sulBest / 1e9);
+    }
+#endif
     
-    if (Subset_Sum_GetSum(zptHandle) != zptHandle->sulTarget)
+    if (xulSum != xptInput->sulTarget)
+    {
+        Sink_Printf(zptSink, "Solved: NO, %.9f seconds, %llu, %.10f\n", 
+                zptHandle->sulTime / 1e9, 
+                (unsigned long long)xulSum, xulSum / (float)xptInput->sulTarget);
+    }
+    else
+    {
+        Sink_Printf(zptSink, "Solved: YES, %.9f seconds, %llu, %.10f\n", 
+                zptHandle->sulTime / 1e9, 
+                (unsigned long long)xulSum, xulSum / (float)xptInput->sulTarget);
+        Sink_Printf(zptSink, "Solution:\n");
+
+        for(xuwLoop = Subset_Sum_NextIncluded(zptHandle, 0u); 
+            xuwLoop < xptInput->suwSize;
+            xuwLoop = Subset_Sum_NextIncluded(zptHandle, xuwLoop + 1u))
+        {
+            Sink_Printf(zptSink, "%llu\n", 
+                (unsigned long long)SUBSETSUM_VALUE(xptInput, xuwLoop));
+        }
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Write_Stats
+*
+* \brief       Append a solve's counters to the instance's stats sidecar
+*
+* \details     ../outputs/<folder>/<instance>.stats.csv gets one row per
+*              solve, under a header written when the file is created, for
+*              runme.py -r to aggregate. Nothing is written in a
+*              SS_NO_STATS build. A failed write is reported on stderr,
+*              the solve itself is not affected.
+*
+* \param[in]   zptHandle            Problem instance
+* \param[in]   zpnFldr              Output folder
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void SS__Write_Stats (Subset_Sum_t * zptHandle, char * zpnFldr)
+{
+#if SS_STATS
+    const Subset_Sum_Input_t * xptInput = zptHandle->sptInput;
+    const Stats_t * xptStats = &zptHandle->stStats;
+    uint64_t xulSum = Subset_Sum_GetSum(zptHandle);
+    char xacPath[256u];
+    char xacBuffer[512u];
+    struct stat xtStat;
+    bool xbOk = true;
+    int xiFd;
+
+    snprintf(xacPath, sizeof(xacPath), "../outputs/%s/%s.stats.csv", 
+                                            zpnFldr, xptInput->sacName);
+    xiFd = open(xacPath, O_RDWR | O_CREAT | O_APPEND, 0644);
+
+    if (xiFd < 0)
+    {
+        perror(xacPath);
+
+        return;
+    }
+
+    if ((fstat(xiFd, &xtStat) == 0) && (xtStat.st_size == 0))
+    {
+        snprintf(xacBuffer, sizeof(xacBuffer), "instance,size,target,sum,"
+                "solved,seconds,moves,improvements,restarts,tabu,nodes,"
+                "subsets,first,best\n");
+        xbOk = SS__Write_All(xiFd, xacBuffer, strlen(xacBuffer));
+    }
+
+    snprintf(xacBuffer, sizeof(xacBuffer), "%s,%u,%llu,%llu,%d,%.9f,%llu,"
+            "%llu,%llu,%llu,%llu,%llu,%.9f,%.9f\n",
+            xptInput->sacName, xptInput->suwSize,
+            (unsigned long long)xptInput->sulTarget,
+            (unsigned long long)xulSum, (xulSum == xptInput->sulTarget),
+            zptHandle->sulTime / 1e9,
+            (unsigned long long)xptStats->sulMoves,
+            (unsigned long long)xptStats->sulImprovements,
+            (unsigned long long)xptStats->sulRestarts,
+            (unsigned long long)xptStats->sulTabu,
+            (unsigned long long)xptStats->sulNodes,
+            (unsigned long long)xptStats->sulSubsets,
+            xptStats->sulFirst / 1e9, xptStats->sulBest / 1e9);
+    xbOk = xbOk && SS__Write_All(xiFd, xacBuffer, strlen(xacBuffer));
+
+    xbOk = (close(xiFd) == 0) && xbOk;
+
+    if (xbOk == false)
+    {
+        perror(xacPath);
+    }
+#else
+    (void)zptHandle;
+    (void)zpnFldr;
+#endif
+}
+
+#if SS_STATS
+/**************************************************************************//**
+*
+* \anchor      SS__Write_All
+*
+* \brief       write() all of a buffer
+*
+* \details     Goes on after short writes and interruptions, like
+*              Sink_Flush. On failure errno tells why.
+*
+* \param[in]   ziFd                 Open file
+* \param[in]   zpcData              Bytes to write
+* \param[in]   zulBytes             How many
+*
+* \retval      bool                 false if a write failed
+*
+******************************************************************************/
+
+static bool SS__Write_All (int ziFd, const char * zpcData, size_t zulBytes)
+{
+    ssize_t xlWritten;
+
+    while (zulBytes > 0u)
+    {
+        xlWritten = write(ziFd, zpcData, zulBytes);
+
+        if (xlWritten < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return false;
+        }
+
+        zpcData += xlWritten;
+        zulBytes -= (size_t)xlWritten;
+    }
+
+    return true;
+}
+#endif
+
+/**************************************************************************//**
+*
+* \anchor      SS__Own
+*
+* \brief       Make a handle's input set its own to edit in place
+*
+* \details     Keeps the set if the handle holds its only reference and it
+*              already has the room and width. Otherwise copies values and
+*              sorted order into a new set with room to grow (doubling, so
+*              appends are amortized O(1)), swaps it in and drops the old
+*              one. Must not be called while the handle is solving.
+*
+* \param[in]   zptHandle          Problem instance
+* \param[in]   zuwSize            Elements the set must have room for
+* \param[in]   zucWidth           Storage width they must fit
+*
+* \retval      Subset_Sum_Input_t *   The handle's set, NULL if out of
+*                                     memory and it is unchanged
+*
+******************************************************************************/
+
+static Subset_Sum_Input_t * SS__Own (Subset_Sum_t * zptHandle, 
+                                    uint32_t zuwSize, uint8_t zucWidth)
+{
+    Subset_Sum_Input_t * xptOld = (Subset_Sum_Input_t *)zptHandle->sptInput;
+    Subset_Sum_Input_t * xptNew;
+    const uint32_t * xauwOrder;
+    uint64_t xulCapacity;
+    uint32_t xuwLoop;
+
+    // Only sets made here have room, and nobody else can see them
+
+    if ((__atomic_load_n(&xptOld->suwRefs, __ATOMIC_ACQUIRE) == 1u) &&
+        (xptOld->suwCapacity >= zuwSize) && (xptOld->sucWidth >= zucWidth))
+    {
+        return xptOld;
+    }
+
+    xulCapacity = 2ull * xptOld->suwSize;
+    xulCapacity = (xulCapacity < zuwSize) ? zuwSize : xulCapacity;
+    xulCapacity = (xulCapacity < 16u) ? 16u : xulCapacity;
+    xulCapacity = (xulCapacity > UINT32_MAX) ? UINT32_MAX : xulCapacity;
+
+    xptNew = (Subset_Sum_Input_t *)calloc(1u, sizeof(Subset_Sum_Input_t));
+
+    if (xptNew == NULL)
     {
-      sprintf(xaucBuffer, "Solved: NO, %d seconds, %llu, %.10f\n", zptHandle->suwTime, Subset_Sum_GetSum(zptHandle),
-	      Subset_Sum_GetSum(zptHandle) / (float)zptHandle->sulTarget);
-      write(ziFd, xaucBuffer, strlen(xaucBuffer));
+        return NULL;
+    }
+
+    memcpy(xptNew->sacName, xptOld->sacName, sizeof(xptNew->sacName));
+    xptNew->suwSize = xptOld->suwSize;
+    xptNew->sucWidth = (xptOld->sucWidth > zucWidth) ? xptOld->sucWidth : 
+                                                                zucWidth;
+    xptNew->sulTarget = xptOld->sulTarget;
+    xptNew->sulTotal = xptOld->sulTotal;
+    xptNew->suwCardinality = xptOld->suwCardinality;
+    xptNew->suwCapacity = (uint32_t)xulCapacity;
+    xptNew->suwRefs = 1u;
+
+    if (posix_memalign(&xptNew->spvValues, SS_ALIGN, 
+                                    xulCapacity * xptNew->sucWidth) != 0)
+    {
+        free(xptNew);
+
+        return NULL;
+    }
+
+    if (xptNew->sucWidth == xptOld->sucWidth)
+    {
+        memcpy(xptNew->spvValues, xptOld->spvValues, 
+                            (size_t)xptOld->suwSize * xptOld->sucWidth);
     }
     else
     {
-      sprintf(xaucBuffer, "Solved: YES, %d seconds, %llu, %.10f\n", zptHandle->suwTime, Subset_Sum_GetSum(zptHandle),
-	      Subset_Sum_GetSum(zptHandle) / (float)zptHandle->sulTarget);
-        write(ziFd, xaucBuffer, strlen(xaucBuffer));
+        for (xuwLoop = 0u; xuwLoop < xptOld->suwSize; xuwLoop++)
+        {
+            SS__Set_Value(xptNew, xuwLoop, SUBSETSUM_VALUE(xptOld, xuwLoop));
+        }
+    }
+
+    // A set without its order yet builds it on first use as usual
+
+    xauwOrder = __atomic_load_n(&xptOld->sauwOrder, __ATOMIC_ACQUIRE);
+
+    if (xauwOrder != NULL)
+    {
+        xptNew->sauwOrder = (uint32_t *)malloc(xulCapacity * sizeof(uint32_t));
+
+        if (xptNew->sauwOrder != NULL)
+        {
+            memcpy(xptNew->sauwOrder, xauwOrder, 
+                                    xptOld->suwSize * sizeof(uint32_t));
+        }
+    }
+
+    zptHandle->sptInput = xptNew;
+    Subset_Sum_Release(xptOld);
+
+    return xptNew;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Set_Value
+*
+* \brief       Store one element at the set's width
+*
+* \param[in]   zptInst            Input set, the value must fit its width
+* \param[in]   zuwIndex           Element
+* \param[in]   zulValue           Value
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void SS__Set_Value (Subset_Sum_Input_t * zptInst, uint32_t zuwIndex,
+                                    uint64_t zulValue)
+{
+    switch (zptInst->sucWidth)
+    {
+        case 1u: ((uint8_t *)zptInst->spvValues)[zuwIndex] = zulValue;  break;
+        case 2u: ((uint16_t *)zptInst->spvValues)[zuwIndex] = zulValue; break;
+        case 4u: ((uint32_t *)zptInst->spvValues)[zuwIndex] = zulValue; break;
+        default: ((uint64_t *)zptInst->spvValues)[zuwIndex] = zulValue; break;
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Lower
+*
+* \brief       Binary search of the sorted order
+*
+* \details     The order is by value, then by index among equal values, as
+*              the stable sort leaves it.
+*
+* \param[in]   zptInst            Input set
+* \param[in]   zauwOrder          Its sorted order
+* \param[in]   zulValue           Value to look for
+* \param[in]   zuwIndex           Index to look for among equal values, 0 for
+*                                 the first of them
+*
+* \retval      uint32_t           First position not before (zulValue,
+*                                 zuwIndex), the set size if none
+*
+******************************************************************************/
+
+static uint32_t SS__Lower (const Subset_Sum_Input_t * zptInst,
+            const uint32_t * zauwOrder, uint64_t zulValue, uint32_t zuwIndex)
+{
+    uint32_t xuwLow = 0u;
+    uint32_t xuwHigh = zptInst->suwSize;
+    uint32_t xuwMid;
+    uint64_t xulMid;
+
+    while (xuwLow < xuwHigh)
+    {
+        xuwMid = xuwLow + ((xuwHigh - xuwLow) >> 1);
+        xulMid = SUBSETSUM_VALUE(zptInst, zauwOrder[xuwMid]);
+
+        if ((xulMid < zulValue) || 
+            ((xulMid == zulValue) && (zauwOrder[xuwMid] < zuwIndex)))
+        {
+            xuwLow = xuwMid + 1u;
+        }
+        else
+        {
+            xuwHigh = xuwMid;
+        }
+    }
+
+    return xuwLow;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SS__Repair
+*
+* \brief       Fit a solution to an edited set
+*
+* \details     Works from the running sum and the sorted order, looking only
+*              where the edit can have made a difference:
+*
+*              - over the target, drop the smallest included element that
+*                covers the excess, or the largest one and look again
+*              - below it, include the largest excluded element that fits
+*                the room, as often as one does (1-OPT swaps never add)
+*              - a new element still left out replaces the smallest
+*                included one that makes room for it, if that gains
+*
+*              Sets sulSum and sbWarm. Without an order (out of memory)
+*              the solution is only trimmed, by scanning.
+*
+* \param[in]   zptHandle          Problem instance
+* \param[in]   zuwEdited          Element just added, the set size if none
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void SS__Repair (Subset_Sum_t * zptHandle, uint32_t zuwEdited)
+{
+    const Subset_Sum_Input_t * xptInput = zptHandle->sptInput;
+    uint64_t xulTarget = xptInput->sulTarget;
+    uint32_t xuwSize = xptInput->suwSize;
+    const uint32_t * xauwOrder = Subset_Sum_GetOrder(xptInput);
+    uint64_t xulSum = zptHandle->sulSum;
+    uint64_t xulValue;
+    uint32_t xuwPos, xuwIndex;
+
+    if (xulSum == SUBSETSUM_UNKNOWN)
+    {
+        xulSum = Subset_Sum_GetSum(zptHandle);
+    }
+
+    // Over the target: the smallest included element at least the excess,
+    // walking up from where it would be
+
+    while (xulSum > xulTarget)
+    {
+        xuwIndex = xuwSize;
+
+        if (xauwOrder != NULL)
+        {
+            for (xuwPos = SS__Lower(xptInput, xauwOrder, xulSum - xulTarget, 0u);
+                 (xuwPos < xuwSize) && (xuwIndex == xuwSize); xuwPos++)
+            {
+                if (Subset_Sum_Selected(zptHandle, xauwOrder[xuwPos]) == INCLUDED)
+                {
+                    xuwIndex = xauwOrder[xuwPos];
+                }
+            }
+
+            // None covers it alone, the largest one goes and we look again
+
+            for (xuwPos = xuwSize; (xuwPos > 0u) && (xuwIndex == xuwSize); 
+                                                                    xuwPos--)
+            {
+                if (Subset_Sum_Selected(zptHandle, xauwOrder[xuwPos - 1u]) == 
+                                                                    INCLUDED)
+                {
+                    xuwIndex = xauwOrder[xuwPos - 1u];
+                }
+            }
+        }
+        else
+        {
+            xuwIndex = Subset_Sum_NextIncluded(zptHandle, 0u);
+        }
+
+        Subset_Sum_Select(zptHandle, xuwIndex, EXCLUDED);
+        xulSum -= SUBSETSUM_VALUE(xptInput, xuwIndex);
+    }
+
+    // Below it: the largest excluded element that fits, walking down from
+    // where the room would be. The room only shrinks, so neither does the
+    // start of the walk move up.
+
+    xuwPos = ((xauwOrder == NULL) || (xulSum == xulTarget)) ? 0u :
+             ((xulTarget - xulSum) == UINT64_MAX) ? xuwSize :
+                SS__Lower(xptInput, xauwOrder, xulTarget - xulSum + 1u, 0u);
+
+    while ((xuwPos > 0u) && (xulSum < xulTarget))
+    {
+        xuwIndex = xauwOrder[--xuwPos];
+        xulValue = SUBSETSUM_VALUE(xptInput, xuwIndex);
+
+        if ((xulValue <= (xulTarget - xulSum)) &&
+            (Subset_Sum_Selected(zptHandle, xuwIndex) == EXCLUDED))
+        {
+            Subset_Sum_Select(zptHandle, xuwIndex, INCLUDED);
+            xulSum += xulValue;
+
+            xuwIndex = SS__Lower(xptInput, xauwOrder, 
+                                            xulTarget - xulSum + 1u, 0u);
+            xuwPos = (xuwIndex < xuwPos) ? xuwIndex : xuwPos;
+        }
+    }
+
+    // A new element that did not fit: swap out the smallest included one
+    // that makes room for it, if that gets closer
 
-        sprintf(xaucBuffer, "Solution:\n");
-        write(ziFd, xaucBuffer, strlen(xaucBuffer));
+    xulValue = (zuwEdited < xuwSize) ? SUBSETSUM_VALUE(xptInput, zuwEdited) : 0u;
+
+    if ((xauwOrder != NULL) && (xulValue > (xulTarget - xulSum)) &&
+        (Subset_Sum_Selected(zptHandle, zuwEdited) == EXCLUDED))
+    {
+        xuwIndex = xuwSize;
 
-        for(xuwLoop = 0u; xuwLoop < zptHandle->suwSize; xuwLoop++)
+        for (xuwPos = SS__Lower(xptInput, xauwOrder, 
+                            xulValue - (xulTarget - xulSum), 0u);
+             (xuwPos < xuwSize) && 
+                (SUBSETSUM_VALUE(xptInput, xauwOrder[xuwPos]) < xulValue);
+             xuwPos++)
         {
-            if(zptHandle->saucSolution[xuwLoop] == INCLUDED)
+            if (Subset_Sum_Selected(zptHandle, xauwOrder[xuwPos]) == INCLUDED)
             {
-                sprintf(xaucBuffer, "%d\n", zptHandle->sauwInputSet[xuwLoop]);
-                write(ziFd, xaucBuffer, strlen(xaucBuffer));
+                xuwIndex = xauwOrder[xuwPos];
+                break;
             }
         }
+
+        if (xuwIndex < xuwSize)
+        {
+            Subset_Sum_Select(zptHandle, xuwIndex, EXCLUDED);
+            Subset_Sum_Select(zptHandle, zuwEdited, INCLUDED);
+            xulSum += xulValue - SUBSETSUM_VALUE(xptInput, xuwIndex);
+        }
     }
+
+    zptHandle->sulSum = xulSum;
+    zptHandle->sbWarm = true;
 }
 
 // \}
@@ -14,28 +14,152 @@
 // Basic types
 
 #include <stdint.h>
+#include <stdbool.h>
+
+// Modules
+
+#include "Arena.h"
+#include "Stats.h"
+#include "Sink.h"
 
 // ***** Definitions **********************************************************
 
-//! The Subset_Sum_t struct contains all valid problem info. I might eventually
-//! make this private as origionally intended but for now this is easier.
+//! The Subset_Sum_Input_t struct holds everything read from an instance file
+//! plus anything derived from it. It is never modified while shared, so any
+//! number of solvers (and threads) can use one copy. It is reference
+//! counted, the last Subset_Sum_Release frees it. Only the edit functions
+//! change one, and only when their handle holds the last reference.
+
+typedef struct Subset_Sum_Input_s
+{
+    char sacName[32u];
+    void * spvValues;           // Elements, sucWidth bytes each
+    uint32_t * sauwOrder;       // Built on first use, see Subset_Sum_GetOrder
+    uint32_t suwSize;
+    uint8_t sucWidth;           // 1, 2, 4 or 8, the smallest that fits
+                                // unless wrapped, see Subset_Sum_Wrap
+    uint64_t sulTarget;
+    uint64_t sulTotal;          // Sum of every element, saturated
+    uint32_t suwCardinality;    // Size of the generating subset, 0 if unknown
+    uint32_t suwRefs;
+    void * spvMap;              // Backing file mapping of a binary instance
+    uint64_t sulMapSize;
+    bool sbBorrowed;            // spvValues belongs to the caller
+    struct Subset_Sum_Input_s * sptBase;
+                                // Set whose values (and maybe order) this
+                                // one shares, referenced, see
+                                // Subset_Sum_SetTarget
+    uint32_t suwCapacity;       // Elements spvValues and sauwOrder have
+                                // room for, 0 unless made by an edit
+} Subset_Sum_Input_t;
+
+//! Element access for any storage width. Fine for setup code, hot loops go
+//! through the width specialized kernels (Subset_Sum_GetSum,
+//! Subset_Sum_FindSwap) instead.
+
+#define SUBSETSUM_VALUE(ptInput, uwIndex)                                     \
+    (((ptInput)->sucWidth == 1u) ?                                            \
+        (uint64_t)((const uint8_t *)(ptInput)->spvValues)[uwIndex] :         \
+     ((ptInput)->sucWidth == 2u) ?                                            \
+        (uint64_t)((const uint16_t *)(ptInput)->spvValues)[uwIndex] :        \
+     ((ptInput)->sucWidth == 4u) ?                                            \
+        (uint64_t)((const uint32_t *)(ptInput)->spvValues)[uwIndex] :        \
+        ((const uint64_t *)(ptInput)->spvValues)[uwIndex])
+
+//! Binary instance files start with this header. It is padded to one cache
+//! line so the little-endian value array right after it is 64 byte aligned
+//! in the mapping and can be used in place, without any parsing.
+
+#define SUBSETSUM_MAGIC             "SSUMBIN"
+#define SUBSETSUM_VERSION           1u
+
+typedef struct Subset_Sum_Header_s
+{
+    char sacMagic[8u];
+    uint32_t suwVersion;
+    uint32_t suwWidth;          // Bytes per element, 1, 2, 4 or 8
+    uint32_t suwSize;
+    uint32_t suwCardinality;
+    uint64_t sulTarget;
+    uint64_t sulTotal;          // Sum of every element
+    uint64_t sulChecksum;       // Of the value array
+    uint8_t saucReserved[16u];
+} Subset_Sum_Header_t;
+
+// Instance file formats understood by Subset_Sum_Save
+
+enum
+{
+    SUBSETSUM_TEXT,
+    SUBSETSUM_BINARY,
+    SUBSETSUM_AMPL
+};
+
+//! The Subset_Sum_t struct is the per-solver state: the solution, timing and
+//! solver attached to a shared input set. I might eventually make this
+//! private as origionally intended but for now this is easier.
 
 typedef struct Subset_Sum_s Subset_Sum_t;
 
+//! Called from the solver's thread whenever it improves the shared incumbent
+
+typedef void (*Subset_Sum_Improved_t)(void * zpvContext, uint64_t zulSum);
+
+//! Best-so-far incumbent shared by every solver working on the same input set.
+//! The fields are only ever touched through the GCC __atomic builtins so no
+//! lock is needed, see Subset_Sum_Publish and Subset_Sum_Cancelled.
+//!
+//! If saulSolution is set (SUBSETSUM_WORDS of the input size) the best
+//! solution itself is kept there too. It is written under a sequence count
+//! so Subset_Sum_Snapshot can copy it from any thread without stopping the
+//! solvers. Everything after suwCancel is optional and may be left zero.
+
+typedef struct Subset_Sum_Shared_s
+{
+    uint64_t sulBestSum;
+    uint32_t suwCancel;
+    uint64_t * saulSolution;    // Best solution, NULL to only track the sum
+    uint64_t sulSolutionSum;    // Sum of saulSolution
+    uint32_t suwSequence;       // Odd while saulSolution is being written
+    uint32_t suwWriter;         // Serializes writers of saulSolution
+    Subset_Sum_Improved_t spfImproved;
+    void * spvContext;
+} Subset_Sum_Shared_t;
+
 typedef void (*Algorithm_t)(Subset_Sum_t * zptInst);
 
 struct Subset_Sum_s
 {
-    char sacName[32u];
-    uint32_t suwTime;
-    uint32_t * sauwInputSet;
-    uint8_t * saucSolution;
-    uint32_t suwSize;
-    uint64_t sulTarget;
+    const Subset_Sum_Input_t * sptInput;
+    uint64_t sulTime;           // Solve time, nanoseconds
+    uint64_t sulTimeLimit;      // Solver time limit, nanoseconds
+    uint64_t * saulSolution;    // Packed, bit i set if element i is included
     uint64_t sulInitialSol;
     Algorithm_t spfSolver; 
+    Subset_Sum_Shared_t * sptShared;
+    bool sbWarm;                // Solution carried over an edit, see
+                                // Subset_Sum_SetTarget
+    uint64_t sulSum;            // Solution sum as of the last solve or
+                                // edit, SUBSETSUM_UNKNOWN once changed
+                                // any other way
+    Arena_t * sptArena;         // Solver scratch, NULL for none, see
+                                // Subset_Sum_SetArena
+    Stats_t stStats;            // Counters of the last solve, see Stats.h
+    char sacCache[48u];         // Solver and parameters the result is
+                                // cached under, empty for none, see
+                                // Subset_Sum_SetCache
 };
 
+//! Number of 64-bit words in the packed solution of a set of the given size.
+//! Bits past the end of the set are always kept clear.
+
+#define SUBSETSUM_WORDS(uwSize)         (((uwSize) + 63u) >> 6)
+
+//! sulSum of a solution changed since it was last known. A saturated sum
+//! reads the same, which just costs a Subset_Sum_GetSum.
+
+#define SUBSETSUM_UNKNOWN               UINT64_MAX
+
 //! The solver function and macro are used to easily create and provide
 //! solution functions to the solver.
 
@@ -53,27 +177,71 @@ enum
 
 // Initialization functions
 
-void Subset_Sum_Initialize (Subset_Sum_t * zptHandle, char * zpsFilePath);
+Subset_Sum_Input_t * Subset_Sum_Load (char * zpsFilePath);
+Subset_Sum_Input_t * Subset_Sum_Create (const char * zpsName, 
+            const uint64_t * zaulValues, uint32_t zuwSize, uint64_t zulTarget);
+Subset_Sum_Input_t * Subset_Sum_Wrap (const char * zpsName, 
+            const void * zpvValues, uint8_t zucWidth, uint32_t zuwSize, 
+            uint64_t zulTarget);
+bool Subset_Sum_Attach (Subset_Sum_t * zptHandle, Subset_Sum_Input_t * zptInput);
+bool Subset_Sum_Initialize (Subset_Sum_t * zptHandle, char * zpsFilePath);
 
 // Control functions
 
 void Subset_Sum_Solve (Subset_Sum_t * zptHandle);
-uint32_t Subset_Sum_GetSum (Subset_Sum_t * zptHandle);
+uint64_t Subset_Sum_GetSum (Subset_Sum_t * zptHandle);
+uint32_t Subset_Sum_FindSwap (Subset_Sum_t * zptHandle, uint32_t zuwOut,
+                                    uint64_t zulSum, const uint64_t * zaulSkip);
+uint32_t Subset_Sum_GetCount (Subset_Sum_t * zptHandle);
+uint32_t Subset_Sum_NextIncluded (Subset_Sum_t * zptHandle, uint32_t zuwFrom);
+uint32_t Subset_Sum_NextExcluded (Subset_Sum_t * zptHandle, uint32_t zuwFrom);
+bool Subset_Sum_Increment (Subset_Sum_t * zptHandle);
+const uint32_t * Subset_Sum_GetOrder (const Subset_Sum_Input_t * zptInput);
+uint32_t Subset_Sum_GetBits (const Subset_Sum_Input_t * zptInput);
+uint64_t Subset_Sum_Fingerprint (const Subset_Sum_Input_t * zptInput);
+void Subset_Sum_Publish (Subset_Sum_t * zptHandle);
+void Subset_Sum_Offer (Subset_Sum_t * zptHandle);
+bool Subset_Sum_Cancelled (Subset_Sum_t * zptHandle);
+uint64_t Subset_Sum_Snapshot (Subset_Sum_Shared_t * zptShared,
+                                    uint64_t * zaulSolution, uint32_t zuwWords);
 
 // Input functions
 
 void Subset_Sum_SetSolver (Subset_Sum_t * zptHandle, Algorithm_t ztSolver);
+void Subset_Sum_SetTimeLimit (Subset_Sum_t * zptHandle, uint64_t zulLimit);
+void Subset_Sum_SetArena (Subset_Sum_t * zptHandle, Arena_t * zptArena);
+void Subset_Sum_SetCache (Subset_Sum_t * zptHandle, const char * zpsSolver);
+void Subset_Sum_SetShared (Subset_Sum_t * zptHandle, 
+                                    Subset_Sum_Shared_t * zptShared);
 void Subset_Sum_Select (Subset_Sum_t * zptHandle, 
                                     uint32_t zpuwIndex, uint8_t zeState);
+uint8_t Subset_Sum_Selected (Subset_Sum_t * zptHandle, uint32_t zuwIndex);
+void Subset_Sum_Clear (Subset_Sum_t * zptHandle);
+void Subset_Sum_Copy (Subset_Sum_t * zptDest, const Subset_Sum_t * zptSrc);
+bool Subset_Sum_Equal (const Subset_Sum_t * zptA, const Subset_Sum_t * zptB);
+
+// Edit functions
+
+bool Subset_Sum_SetTarget (Subset_Sum_t * zptHandle, uint64_t zulTarget);
+bool Subset_Sum_AddElement (Subset_Sum_t * zptHandle, uint64_t zulValue);
+bool Subset_Sum_RemoveElement (Subset_Sum_t * zptHandle, uint32_t zuwIndex);
+
+// Save functions
+
+bool Subset_Sum_Save (const Subset_Sum_Input_t * zptInput, 
+                                    char * zpsFilePath, uint8_t zeFormat);
 
 // Print Functions
 
 void Subset_SumDisplayData (Subset_Sum_t * zptHandle);
 void Subset_SumWriteData (Subset_Sum_t * zptHandle, char * zpnFldr);
+void Subset_Sum_WriteRecord (Subset_Sum_t * zptHandle, Sink_t * zptSink,
+                                    const char * zpsSolver);
 
 // Cleanup functions
 
 void Subset_Sum_Free (Subset_Sum_t * zptHandle);
+void Subset_Sum_Release (Subset_Sum_Input_t * zptInput);
 
 #endif // !defined _SUBSUM_H
 
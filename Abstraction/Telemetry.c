@@ -0,0 +1,555 @@
+/**************************************************************************//**
+*
+* \file        Telemetry.c
+*
+* \defgroup    Telemetry    Live progress of a running solver
+*
+* \details     A process that called Telemetry_Open posts what its solvers
+*              do into a ring of records in shared memory, a file in
+*              /dev/shm named after its pid. ss_monitor maps the same file
+*              read-only and follows it while the solve runs, so convergence
+*              can be watched live instead of in the .out file at the end.
+*
+*              Subset_Sum_Solve posts the start and end of every solve,
+*              Subset_Sum_Publish every new incumbent, and the solvers'
+*              Subset_Sum_Cancelled polls a progress record with their
+*              counters every TELEMETRY_PERIOD. Solvers may also post
+*              their phase. Without an open ring all of this returns after
+*              one load.
+*
+*              Posting takes no lock and never waits for the reader. A
+*              poster claims a ticket with one atomic add on the head and
+*              writes the record in slot ticket mod TELEMETRY_SLOTS under a
+*              sequence number, odd while it is being written. The reader
+*              checks the number before and after copying a record, the
+*              same as Subset_Sum_Snapshot, so a record overwritten while
+*              it was read is counted as lost instead of returned torn.
+*
+*              The file is removed when the process exits normally. One left
+*              behind by a killed process stays readable until it is deleted.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Modules
+
+#include "Telemetry.h"
+#include "Stats.h"
+#include "Deadline.h"
+
+// ***** Definitions **********************************************************
+
+//! Subset_Sum_Cancelled calls between two looks at the clock
+
+#define TL__TICKS               256u
+
+#define TL__SIZE    (sizeof(Telemetry_Ring_t) + \
+                        (TELEMETRY_SLOTS * sizeof(Telemetry_Record_t)))
+
+// ***** Local Functions ******************************************************
+
+static void TL__Post (uint32_t zuwKind, uint64_t zulValue, uint64_t zulNow);
+
+// ***** Local variables ******************************************************
+
+//! This process's ring, NULL if it has none
+
+static Telemetry_Ring_t * mptRing;
+static char macPath[256u];
+
+//! Posting thread's number in the ring and when it last posted
+
+static __thread uint32_t muwThread;
+static __thread uint32_t muwTicks;
+static __thread uint64_t mulLast;
+
+/**************************************************************************//**
+*
+* \defgroup    Telemetry Initialization   Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Open
+*
+* \brief       Create this process's ring
+*
+* \details     Any earlier ring of the same pid is replaced. Call it once,
+*              before the solvers start. Without it every post is ignored.
+*
+* \param[in]   zpsName              What the process works on, usually the
+*                                   instance file. Only the last 31
+*                                   characters are kept.
+*
+* \retval      bool                 false if the file could not be created
+*
+******************************************************************************/
+
+bool Telemetry_Open (const char * zpsName)
+{
+    Telemetry_Ring_t * xptRing;
+    size_t xulName = strlen(zpsName);
+    int xiFd;
+
+    if (mptRing != NULL)
+    {
+        return true;
+    }
+
+    Telemetry_Path((uint32_t)getpid(), macPath, sizeof(macPath));
+
+    xiFd = open(macPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (xiFd < 0)
+    {
+        perror(macPath);
+
+        return false;
+    }
+
+    if (ftruncate(xiFd, (off_t)TL__SIZE) != 0)
+    {
+        perror(macPath);
+        close(xiFd);
+        unlink(macPath);
+
+        return false;
+    }
+
+    xptRing = (Telemetry_Ring_t *)mmap(NULL, TL__SIZE,
+                            PROT_READ | PROT_WRITE, MAP_SHARED, xiFd, 0);
+    close(xiFd);
+
+    if (xptRing == (Telemetry_Ring_t *)MAP_FAILED)
+    {
+        perror(macPath);
+        unlink(macPath);
+
+        return false;
+    }
+
+    // The file is fresh and all zero, the magic goes last so a reader never
+    // sees a half written header
+
+    xptRing->suwVersion = TELEMETRY_VERSION;
+    xptRing->suwSlots = TELEMETRY_SLOTS;
+    xptRing->suwPid = (uint32_t)getpid();
+    xptRing->sulStart = Deadline_Now();
+
+    if (xulName >= sizeof(xptRing->sacName))
+    {
+        zpsName += xulName - (sizeof(xptRing->sacName) - 1u);
+    }
+
+    strncpy(xptRing->sacName, zpsName, sizeof(xptRing->sacName) - 1u);
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(xptRing->sacMagic, TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+
+    mptRing = xptRing;
+
+    atexit(Telemetry_Close);
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Attach
+*
+* \brief       Map another process's ring for reading
+*
+* \details     Reading starts at the oldest record still in the ring.
+*
+* \param[in]   zptReader            Reader
+* \param[in]   zuwPid               Process that created the ring
+*
+* \retval      bool                 false if it has none or it is not a ring
+*                                   of this version
+*
+******************************************************************************/
+
+bool Telemetry_Attach (Telemetry_Reader_t * zptReader, uint32_t zuwPid)
+{
+    const Telemetry_Ring_t * xptRing;
+    char xacPath[256u];
+    struct stat xtStat;
+    uint64_t xulHead;
+    int xiFd;
+
+    memset(zptReader, 0, sizeof(Telemetry_Reader_t));
+
+    Telemetry_Path(zuwPid, xacPath, sizeof(xacPath));
+
+    xiFd = open(xacPath, O_RDONLY);
+
+    if (xiFd < 0)
+    {
+        return false;
+    }
+
+    if ((fstat(xiFd, &xtStat) != 0) || ((size_t)xtStat.st_size != TL__SIZE))
+    {
+        close(xiFd);
+
+        return false;
+    }
+
+    xptRing = (const Telemetry_Ring_t *)mmap(NULL, TL__SIZE, PROT_READ,
+                                                    MAP_SHARED, xiFd, 0);
+    close(xiFd);
+
+    if (xptRing == (const Telemetry_Ring_t *)MAP_FAILED)
+    {
+        return false;
+    }
+
+    if ((memcmp(xptRing->sacMagic, TELEMETRY_MAGIC,
+                                    sizeof(TELEMETRY_MAGIC)) != 0) ||
+        (xptRing->suwVersion != TELEMETRY_VERSION) ||
+        (xptRing->suwSlots != TELEMETRY_SLOTS))
+    {
+        munmap((void *)xptRing, TL__SIZE);
+
+        return false;
+    }
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    xulHead = __atomic_load_n(&xptRing->sulHead, __ATOMIC_ACQUIRE);
+
+    zptReader->sptRing = xptRing;
+    zptReader->sulNext = (xulHead > TELEMETRY_SLOTS) ?
+                                        (xulHead - TELEMETRY_SLOTS) : 0u;
+
+    return true;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Telemetry Control      Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Active
+*
+* \brief       Check if this process has a ring
+*
+* \details     For posters that would have to compute the value first.
+*
+* \retval      bool
+*
+******************************************************************************/
+
+bool Telemetry_Active (void)
+{
+    return (mptRing != NULL);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Post
+*
+* \brief       Post a record from the calling thread
+*
+* \details     The record carries the counters of the solve running on this
+*              thread. Safe from any number of threads at once.
+*
+* \param[in]   zuwKind              TELEMETRY_START etc.
+* \param[in]   zulValue             See the record kinds
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Telemetry_Post (uint32_t zuwKind, uint64_t zulValue)
+{
+    if (mptRing == NULL)
+    {
+        return;
+    }
+
+    TL__Post(zuwKind, zulValue, Deadline_Now());
+}
+
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Tick
+*
+* \brief       Post a progress record if the thread has been quiet too long
+*
+* \details     Meant to be called from a solver's main loop, it only reads
+*              the clock every TL__TICKS calls. The rate a monitor shows
+*              is the difference of the counters between two records.
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Telemetry_Tick (void)
+{
+    uint64_t xulNow;
+
+    if ((mptRing == NULL) || (++muwTicks < TL__TICKS))
+    {
+        return;
+    }
+
+    muwTicks = 0u;
+    xulNow = Deadline_Now();
+
+    if ((xulNow - mulLast) >= TELEMETRY_PERIOD)
+    {
+        TL__Post(TELEMETRY_PROGRESS, 0u, xulNow);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Read
+*
+* \brief       Take the next record from a ring
+*
+* \details     Records the poster overwrote before they could be read are
+*              skipped and added to sulLost.
+*
+* \param[in]   zptReader            Reader
+* \param[out]  zptRecord            Record
+*
+* \retval      bool                 false if there is nothing new yet, or
+*                                   the next record is still being written
+*
+******************************************************************************/
+
+bool Telemetry_Read (Telemetry_Reader_t * zptReader,
+                                            Telemetry_Record_t * zptRecord)
+{
+    const Telemetry_Ring_t * xptRing = zptReader->sptRing;
+    const Telemetry_Record_t * xptSlot;
+    uint64_t xulHead, xulSequence, xulWant;
+
+    while (true)
+    {
+        xulHead = __atomic_load_n(&xptRing->sulHead, __ATOMIC_ACQUIRE);
+
+        if (zptReader->sulNext >= xulHead)
+        {
+            return false;
+        }
+
+        // Whatever the posters have lapped is gone
+
+        if ((xulHead - zptReader->sulNext) > TELEMETRY_SLOTS)
+        {
+            zptReader->sulLost += xulHead - TELEMETRY_SLOTS -
+                                                    zptReader->sulNext;
+            zptReader->sulNext = xulHead - TELEMETRY_SLOTS;
+        }
+
+        xptSlot = &xptRing->satRecords[zptReader->sulNext &
+                                                (TELEMETRY_SLOTS - 1u)];
+        xulWant = (2u * zptReader->sulNext) + 2u;
+        xulSequence = __atomic_load_n(&xptSlot->sulSequence,
+                                                        __ATOMIC_ACQUIRE);
+
+        if (xulSequence < xulWant)
+        {
+            return false;
+        }
+
+        if (xulSequence == xulWant)
+        {
+            memcpy(zptRecord, xptSlot, sizeof(Telemetry_Record_t));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+            if (__atomic_load_n(&xptSlot->sulSequence, __ATOMIC_RELAXED) ==
+                                                                    xulWant)
+            {
+                zptReader->sulNext++;
+
+                return true;
+            }
+        }
+
+        zptReader->sulLost++;
+        zptReader->sulNext++;
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Path
+*
+* \brief       File of a process's ring
+*
+* \param[in]   zuwPid               Process
+* \param[out]  zpsPath              Path
+* \param[in]   zulSize              Size of zpsPath
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Telemetry_Path (uint32_t zuwPid, char * zpsPath, size_t zulSize)
+{
+    snprintf(zpsPath, zulSize, "%s/%s%u",
+            (access(TELEMETRY_DIR, F_OK) == 0) ? TELEMETRY_DIR :
+                                        TELEMETRY_DIR_FALLBACK,
+            TELEMETRY_PREFIX, zuwPid);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Telemetry Cleanup      Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Close
+*
+* \brief       Remove this process's ring
+*
+* \details     Called at exit by itself. A child forked after the ring was
+*              created only unmaps it, the file belongs to the parent.
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Telemetry_Close (void)
+{
+    Telemetry_Ring_t * xptRing = mptRing;
+
+    if (xptRing == NULL)
+    {
+        return;
+    }
+
+    mptRing = NULL;
+
+    if (xptRing->suwPid == (uint32_t)getpid())
+    {
+        unlink(macPath);
+    }
+
+    munmap(xptRing, TL__SIZE);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Telemetry_Detach
+*
+* \brief       Unmap a ring opened with Telemetry_Attach
+*
+* \param[in]   zptReader            Reader
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Telemetry_Detach (Telemetry_Reader_t * zptReader)
+{
+    if (zptReader->sptRing != NULL)
+    {
+        munmap((void *)zptReader->sptRing, TL__SIZE);
+    }
+
+    memset(zptReader, 0, sizeof(Telemetry_Reader_t));
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Telemetry Internal     Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      TL__Post
+*
+* \brief       Claim a slot and write a record into it
+*
+* \param[in]   zuwKind              TELEMETRY_START etc.
+* \param[in]   zulValue             See the record kinds
+* \param[in]   zulNow               CLOCK_MONOTONIC, ns
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void TL__Post (uint32_t zuwKind, uint64_t zulValue, uint64_t zulNow)
+{
+    Telemetry_Ring_t * xptRing = mptRing;
+    Telemetry_Record_t * xptSlot;
+    uint64_t xulTicket;
+
+    if (muwThread == 0u)
+    {
+        muwThread = __atomic_add_fetch(&xptRing->suwThreads, 1u,
+                                                        __ATOMIC_RELAXED);
+    }
+
+    xulTicket = __atomic_fetch_add(&xptRing->sulHead, 1u, __ATOMIC_RELAXED);
+    xptSlot = &xptRing->satRecords[xulTicket & (TELEMETRY_SLOTS - 1u)];
+
+    __atomic_store_n(&xptSlot->sulSequence, (2u * xulTicket) + 1u,
+                                                        __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    xptSlot->sulTime = zulNow - xptRing->sulStart;
+    xptSlot->suwKind = zuwKind;
+    xptSlot->suwThread = muwThread;
+    xptSlot->sulValue = zulValue;
+
+#if SS_STATS
+    xptSlot->sulMoves = Stats_Thread.sulMoves;
+    xptSlot->sulNodes = Stats_Thread.sulNodes;
+    xptSlot->sulSubsets = Stats_Thread.sulSubsets;
+    xptSlot->sulImprovements = Stats_Thread.sulImprovements;
+#else
+    xptSlot->sulMoves = 0u;
+    xptSlot->sulNodes = 0u;
+    xptSlot->sulSubsets = 0u;
+    xptSlot->sulImprovements = 0u;
+#endif
+
+    __atomic_store_n(&xptSlot->sulSequence, (2u * xulTicket) + 2u,
+                                                        __ATOMIC_RELEASE);
+
+    mulLast = zulNow;
+}
+
+// \}
+
+// \}
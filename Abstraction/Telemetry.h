@@ -0,0 +1,117 @@
+/**************************************************************************//**
+*
+* \file        Telemetry.h
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// ***** Definitions **********************************************************
+
+//! The ring of a process is the file ssum-<pid> in the first of these
+//! directories that exists
+
+#define TELEMETRY_DIR           "/dev/shm"
+#define TELEMETRY_DIR_FALLBACK  "/tmp"
+#define TELEMETRY_PREFIX        "ssum-"
+
+#define TELEMETRY_MAGIC         "SSUMTLM"
+#define TELEMETRY_VERSION       1u
+
+//! Records kept, a power of two. A reader that falls further behind than
+//! this loses the oldest ones and is told how many.
+
+#define TELEMETRY_SLOTS         4096u
+
+//! A solver reports its counters at most this often, ns
+
+#define TELEMETRY_PERIOD        100000000ull
+
+//! Record kinds
+
+enum
+{
+    TELEMETRY_START,            // Value: target
+    TELEMETRY_PHASE,            // Value: PERF_LOAD etc., see Perf.h
+    TELEMETRY_IMPROVED,         // Value: new sum of this solver
+    TELEMETRY_PROGRESS,         // Value: 0, the counters are the news
+    TELEMETRY_END,              // Value: final sum
+    TELEMETRY_KINDS
+};
+
+//! One event, exactly one cache line. The counters are those of the solve
+//! running on the posting thread (see Stats.h), zero without SS_STATS.
+
+typedef struct Telemetry_Record_s
+{
+    uint64_t sulSequence;       // 2 * ticket + 2 once complete, odd while
+                                // being written
+    uint64_t sulTime;           // Since the ring was created, ns
+    uint32_t suwKind;
+    uint32_t suwThread;         // 1 for the first thread that posted etc.
+    uint64_t sulValue;
+    uint64_t sulMoves;
+    uint64_t sulNodes;
+    uint64_t sulSubsets;
+    uint64_t sulImprovements;
+} Telemetry_Record_t;
+
+//! Start of the shared file, the records follow. The head counts every
+//! record ever posted and has a cache line to itself, it is the only field
+//! the posting threads share.
+
+typedef struct Telemetry_Ring_s
+{
+    char sacMagic[8u];
+    uint32_t suwVersion;
+    uint32_t suwSlots;
+    uint32_t suwPid;
+    uint32_t suwThreads;        // Threads that have posted so far
+    uint64_t sulStart;          // CLOCK_MONOTONIC at creation, ns
+    char sacName[32u];          // What the process is working on
+    uint64_t sulHead __attribute__((aligned(64)));
+    Telemetry_Record_t satRecords[] __attribute__((aligned(64)));
+} Telemetry_Ring_t;
+
+//! A monitor's read-only view of another process's ring
+
+typedef struct Telemetry_Reader_s
+{
+    const Telemetry_Ring_t * sptRing;
+    uint64_t sulNext;           // Ticket of the next record to read
+    uint64_t sulLost;           // Records overwritten before they were read
+} Telemetry_Reader_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+bool Telemetry_Open (const char * zpsName);
+bool Telemetry_Attach (Telemetry_Reader_t * zptReader, uint32_t zuwPid);
+
+// Control functions
+
+bool Telemetry_Active (void);
+void Telemetry_Post (uint32_t zuwKind, uint64_t zulValue);
+void Telemetry_Tick (void);
+bool Telemetry_Read (Telemetry_Reader_t * zptReader,
+                                            Telemetry_Record_t * zptRecord);
+void Telemetry_Path (uint32_t zuwPid, char * zpsPath, size_t zulSize);
+
+// Cleanup functions
+
+void Telemetry_Close (void);
+void Telemetry_Detach (Telemetry_Reader_t * zptReader);
+
+#endif // !defined _TELEMETRY_H
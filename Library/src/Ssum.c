@@ -0,0 +1,955 @@
+/**************************************************************************//**
+*
+* \file        Ssum.c
+*
+* \defgroup    Ssum         Shared library interface
+*
+* \details     libssum.so holds the Subset_Sum module and every project's
+*              solvers, so a harness can load instances and solve them in
+*              its own process instead of starting p1, p3 or p5 per file
+*              and scraping their .out files (see ssum.py).
+*
+*              The interface is plain C types and one opaque handle, see
+*              Ssum.h. Values can be wrapped where the caller has them
+*              (Ssum_Wrap, no copy), the solution is written straight into
+*              the caller's packed array and the result into its struct.
+*
+*              Solvers are named "<project>.<solver>", the same names the
+*              result cache uses (see Subset_Sum_SetCache). Every solve
+*              gets its own problem on the calling thread, so solves of the
+*              same instance can run on any number of threads at once.
+*
+*              "auto" picks one of them, or a small portfolio, per instance
+*              from its features and a cost model, within the time limit and
+*              the memory budget set with Ssum_Memory (see Select.c).
+*
+*              Ssum_Start runs a solve on a thread of its own instead (see
+*              Async.c). The caller polls the best solution so far, cancels
+*              it or waits for it, and collects the result with
+*              Ssum_Finish, so it can answer within a latency budget.
+*
+*              Ssum_Open keeps an instance and its solution together so the
+*              instance can be edited (target, elements) and solved again
+*              from the repaired solution instead of from scratch (see
+*              Subset_Sum_SetTarget).
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Modules
+
+#include "Ssum.h"
+#include "Subset_Sum.h"
+#include "Portfolio.h"
+#include "Cache.h"
+#include "Select.h"
+#include "Async.h"
+
+// ***** Definitions **********************************************************
+
+struct Ssum_Job_s
+{
+    Subset_Sum_t stProblem;
+    Async_t * sptAsync;
+    const Portfolio_Solver_t * sptSolver;
+};
+
+struct Ssum_Problem_s
+{
+    Subset_Sum_t stProblem;
+};
+
+// ***** Local function prototypes ********************************************
+
+//! The projects' solvers, see their main.c
+
+SUBSETSUM_ALGORITHM(P1_Exhaustive);
+SUBSETSUM_ALGORITHM(P3_Greedy);
+SUBSETSUM_ALGORITHM(P5_Greedy);
+SUBSETSUM_ALGORITHM(P5_Random);
+SUBSETSUM_ALGORITHM(P5_Tabu);
+
+static const Portfolio_Solver_t * SM__Find (
+            const Subset_Sum_Input_t * zptInput, const char * zpsSolver,
+            uint64_t zulTimeLimit);
+static int SM__Edited (bool zbDone);
+static void SM__Report (Subset_Sum_t * zptProblem,
+            const Portfolio_Solver_t * zptSolver, uint64_t * zaulSolution,
+            Ssum_Result_t * zptResult);
+
+// ***** Local constants ******************************************************
+
+//! Every solver the library provides
+
+static const Portfolio_Solver_t matSolvers[] =
+{
+    {"p1.exhaustive", P1_Exhaustive},
+    {"p3.greedy",     P3_Greedy},
+    {"p5.greedy",     P5_Greedy},
+    {"p5.random",     P5_Random},
+    {"p5.tabu",       P5_Tabu},
+};
+
+#define SM_SOLVER_COUNT     (sizeof(matSolvers) / sizeof(matSolvers[0]))
+
+// ***** Local variables ******************************************************
+
+//! Memory budget of the auto solver, bytes, 0 for none
+
+static uint64_t mulMemory;
+
+/**************************************************************************//**
+*
+* \defgroup    Ssum Initialization    Initialization Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Ssum_Version
+*
+* \brief       ABI version of the library
+*
+* \details     A caller built against an older Ssum.h works with any library
+*              whose version is at least its SSUM_VERSION.
+*
+* \retval      uint32_t
+*
+******************************************************************************/
+
+uint32_t Ssum_Version (void)
+{
+    return SSUM_VERSION;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Load
+*
+* \brief       Load an instance file
+*
+* \details     Text or binary, see Subset_Sum_Load.
+*
+* \param[in]   zpsPath              File path
+*
+* \retval      Ssum_Instance_t *    NULL if it could not be loaded
+*
+******************************************************************************/
+
+Ssum_Instance_t * Ssum_Load (const char * zpsPath)
+{
+    return Subset_Sum_Load((char *)zpsPath);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Wrap
+*
+* \brief       Use values in the caller's memory as an instance
+*
+* \details     Nothing is copied, the array must stay as it is until the
+*              instance is released. See Subset_Sum_Wrap.
+*
+* \param[in]   zpsName              Instance name
+* \param[in]   zpvValues            Unsigned element values
+* \param[in]   zuwWidth             Bytes per value, 1, 2, 4 or 8
+* \param[in]   zuwSize              Number of values
+* \param[in]   zulTarget            Target sum
+*
+* \retval      Ssum_Instance_t *    NULL if out of memory or the width or
+*                                   alignment is wrong
+*
+******************************************************************************/
+
+Ssum_Instance_t * Ssum_Wrap (const char * zpsName,
+            const void * zpvValues, uint32_t zuwWidth, uint32_t zuwSize,
+            uint64_t zulTarget)
+{
+    if (zuwWidth > 8u)
+    {
+        return NULL;
+    }
+
+    return Subset_Sum_Wrap(zpsName, zpvValues, (uint8_t)zuwWidth, zuwSize,
+                                                                zulTarget);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Cache
+*
+* \brief       Cache the results of every following solve
+*
+* \details     See Cache.c. Call before solving, not while solves run.
+*
+* \param[in]   zpsDir               Cache directory, NULL for none
+*
+* \retval      int                  1 if caching
+*
+******************************************************************************/
+
+int Ssum_Cache (const char * zpsDir)
+{
+    return (Cache_Open(zpsDir) == true) ? 1 : 0;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Model
+*
+* \brief       Load a calibrated cost model for the auto solver
+*
+* \details     See Select_Open. Call before solving, not while solves run.
+*
+* \param[in]   zpsPath              Model file as written by bench.py
+*                                   --model
+*
+* \retval      int                  1 if loaded, the built in model is kept
+*                                   otherwise
+*
+******************************************************************************/
+
+int Ssum_Model (const char * zpsPath)
+{
+    return (Select_Open(zpsPath) == true) ? 1 : 0;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Memory
+*
+* \brief       Set the memory budget of the auto solver
+*
+* \details     Call before solving, not while solves run.
+*
+* \param[in]   zulBytes             Budget per solve, 0 for none
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Ssum_Memory (uint64_t zulBytes)
+{
+    mulMemory = zulBytes;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Open
+*
+* \brief       Start an editable problem on an instance
+*
+* \details     The problem holds its own reference, the caller may release
+*              the instance. Edits never change it, the problem gets a copy
+*              on its first edit (see Subset_Sum_AddElement). The solution
+*              starts out empty.
+*
+* \param[in]   zptInstance          Instance
+*
+* \retval      Ssum_Problem_t *     NULL if out of memory
+*
+******************************************************************************/
+
+Ssum_Problem_t * Ssum_Open (Ssum_Instance_t * zptInstance)
+{
+    Ssum_Problem_t * xptProblem;
+
+    xptProblem = (Ssum_Problem_t *)calloc(1u, sizeof(Ssum_Problem_t));
+
+    if (xptProblem == NULL)
+    {
+        return NULL;
+    }
+
+    if (Subset_Sum_Attach(&xptProblem->stProblem, zptInstance) == false)
+    {
+        free(xptProblem);
+
+        return NULL;
+    }
+
+    return xptProblem;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Ssum Control           Control Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Ssum_Solver
+*
+* \brief       Name of a solver
+*
+* \details     The last one is SSUM_AUTO.
+*
+* \param[in]   zuwIndex             0 for the first
+*
+* \retval      const char *         NULL past the last one
+*
+******************************************************************************/
+
+const char * Ssum_Solver (uint32_t zuwIndex)
+{
+    return (zuwIndex < SM_SOLVER_COUNT) ? matSolvers[zuwIndex].spsName :
+           (zuwIndex == SM_SOLVER_COUNT) ? SSUM_AUTO : NULL;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Name
+*
+* \brief       Name of an instance
+*
+* \param[in]   zptInstance          Instance
+*
+* \retval      const char *
+*
+******************************************************************************/
+
+const char * Ssum_Name (const Ssum_Instance_t * zptInstance)
+{
+    return zptInstance->sacName;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Size
+*
+* \brief       Number of elements of an instance
+*
+* \param[in]   zptInstance          Instance
+*
+* \retval      uint32_t
+*
+******************************************************************************/
+
+uint32_t Ssum_Size (const Ssum_Instance_t * zptInstance)
+{
+    return zptInstance->suwSize;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Target
+*
+* \brief       Target sum of an instance
+*
+* \param[in]   zptInstance          Instance
+*
+* \retval      uint64_t
+*
+******************************************************************************/
+
+uint64_t Ssum_Target (const Ssum_Instance_t * zptInstance)
+{
+    return zptInstance->sulTarget;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Solve
+*
+* \brief       Solve an instance on the calling thread
+*
+* \param[in]   zptInstance          Instance
+* \param[in]   zpsSolver            Solver name, see Ssum_Solver, or
+*                                   SSUM_AUTO
+* \param[in]   zulTimeLimit         Time limit in nanoseconds, 0 for none
+* \param[out]  zaulSolution         SSUM_WORDS(size) words for the packed
+*                                   solution, NULL if not wanted
+* \param[out]  zptResult            Result with suwBytes set, NULL if not
+*                                   wanted
+*
+* \retval      int                  SSUM_OK, SSUM_UNKNOWN_SOLVER or
+*                                   SSUM_NO_MEMORY
+*
+******************************************************************************/
+
+int Ssum_Solve (Ssum_Instance_t * zptInstance, const char * zpsSolver,
+            uint64_t zulTimeLimit, uint64_t * zaulSolution,
+            Ssum_Result_t * zptResult)
+{
+    const Portfolio_Solver_t * xptSolver;
+    Subset_Sum_t xtProblem;
+    bool xbAuto = (strcmp(zpsSolver, SSUM_AUTO) == 0);
+
+    xptSolver = Portfolio_Find(matSolvers, SM_SOLVER_COUNT, zpsSolver);
+
+    if ((xptSolver == NULL) && (xbAuto == false))
+    {
+        return SSUM_UNKNOWN_SOLVER;
+    }
+
+    if (Subset_Sum_Attach(&xtProblem, zptInstance) == false)
+    {
+        return SSUM_NO_MEMORY;
+    }
+
+    Subset_Sum_SetTimeLimit(&xtProblem,
+                            (zulTimeLimit == 0u) ? UINT64_MAX : zulTimeLimit);
+
+    if (xbAuto == true)
+    {
+        // Each pick is cached under its own name, see Select_Solve
+
+        Subset_Sum_SetCache(&xtProblem, SSUM_AUTO);
+        xptSolver = Select_Solve(&xtProblem, matSolvers, SM_SOLVER_COUNT, "",
+                                                                mulMemory);
+    }
+    else
+    {
+        Subset_Sum_SetSolver(&xtProblem, xptSolver->spfSolver);
+        Subset_Sum_SetCache(&xtProblem, xptSolver->spsName);
+        Subset_Sum_Solve(&xtProblem);
+    }
+
+    SM__Report(&xtProblem, xptSolver, zaulSolution, zptResult);
+
+    Subset_Sum_Free(&xtProblem);
+
+    return SSUM_OK;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Start
+*
+* \brief       Start solving an instance in the background
+*
+* \details     Returns at once, the solve runs on a thread of its own. Every
+*              job has to be collected with Ssum_Finish. "auto" runs the
+*              solver Select_Choose ranks first, not a portfolio.
+*
+* \param[in]   zptInstance          Instance
+* \param[in]   zpsSolver            Solver name, see Ssum_Solver, or
+*                                   SSUM_AUTO
+* \param[in]   zulTimeLimit         Time limit in nanoseconds, 0 for none
+* \param[out]  zpptJob              The running job, NULL on failure
+*
+* \retval      int                  SSUM_OK, SSUM_UNKNOWN_SOLVER or
+*                                   SSUM_NO_MEMORY
+*
+******************************************************************************/
+
+int Ssum_Start (Ssum_Instance_t * zptInstance, const char * zpsSolver,
+            uint64_t zulTimeLimit, Ssum_Job_t ** zpptJob)
+{
+    const Portfolio_Solver_t * xptSolver;
+    Ssum_Job_t * xptJob;
+
+    *zpptJob = NULL;
+    zulTimeLimit = (zulTimeLimit == 0u) ? UINT64_MAX : zulTimeLimit;
+    xptSolver = SM__Find(zptInstance, zpsSolver, zulTimeLimit);
+
+    if (xptSolver == NULL)
+    {
+        return SSUM_UNKNOWN_SOLVER;
+    }
+
+    xptJob = (Ssum_Job_t *)calloc(1u, sizeof(Ssum_Job_t));
+
+    if (xptJob == NULL)
+    {
+        return SSUM_NO_MEMORY;
+    }
+
+    if (Subset_Sum_Attach(&xptJob->stProblem, zptInstance) == true)
+    {
+        Subset_Sum_SetTimeLimit(&xptJob->stProblem, zulTimeLimit);
+        Subset_Sum_SetSolver(&xptJob->stProblem, xptSolver->spfSolver);
+        Subset_Sum_SetCache(&xptJob->stProblem, xptSolver->spsName);
+        xptJob->sptSolver = xptSolver;
+        xptJob->sptAsync = Async_Solve(&xptJob->stProblem, NULL, NULL);
+    }
+
+    if (xptJob->sptAsync == NULL)
+    {
+        Subset_Sum_Free(&xptJob->stProblem);
+        free(xptJob);
+
+        return SSUM_NO_MEMORY;
+    }
+
+    *zpptJob = xptJob;
+
+    return SSUM_OK;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Best
+*
+* \brief       Best solution a job has found so far
+*
+* \details     Safe to call at any time until Ssum_Finish, see Async_Best.
+*
+* \param[in]   zptJob               Job
+* \param[out]  zaulSolution         SSUM_WORDS(size) words for the packed
+*                                   solution, NULL if not wanted
+*
+* \retval      uint64_t             Its sum
+*
+******************************************************************************/
+
+uint64_t Ssum_Best (Ssum_Job_t * zptJob, uint64_t * zaulSolution)
+{
+    return Async_Best(zptJob->sptAsync, zaulSolution);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Wait
+*
+* \brief       Wait for a job to finish
+*
+* \param[in]   zptJob               Job
+* \param[in]   zulTimeout           Nanoseconds, 0 to just check, UINT64_MAX
+*                                   to wait until it is done
+*
+* \retval      int                  1 if it has finished
+*
+******************************************************************************/
+
+int Ssum_Wait (Ssum_Job_t * zptJob, uint64_t zulTimeout)
+{
+    return (Async_Wait(zptJob->sptAsync, zulTimeout) == true) ? 1 : 0;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Cancel
+*
+* \brief       Ask a job to stop
+*
+* \details     Returns right away, the solver stops at its next check. Its
+*              best solution so far is what Ssum_Finish then reports.
+*
+* \param[in]   zptJob               Job
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Ssum_Cancel (Ssum_Job_t * zptJob)
+{
+    Async_Cancel(zptJob->sptAsync);
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_SetTarget
+*
+* \brief       Change a problem's target sum
+*
+* \details     The solution is repaired to fit, see Subset_Sum_SetTarget.
+*
+* \param[in]   zptProblem           Problem
+* \param[in]   zulTarget            New target
+*
+* \retval      int                  SSUM_OK or SSUM_NO_MEMORY, the problem is
+*                                   unchanged then
+*
+******************************************************************************/
+
+int Ssum_SetTarget (Ssum_Problem_t * zptProblem, uint64_t zulTarget)
+{
+    return SM__Edited(Subset_Sum_SetTarget(&zptProblem->stProblem,
+                                                                zulTarget));
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_AddElement
+*
+* \brief       Append an element to a problem
+*
+* \details     It gets the next index, Ssum_Size of Ssum_Edited before the
+*              call. Values wider than the instance's widen it.
+*
+* \param[in]   zptProblem           Problem
+* \param[in]   zulValue             Value
+*
+* \retval      int                  SSUM_OK or SSUM_NO_MEMORY, the problem is
+*                                   unchanged then
+*
+******************************************************************************/
+
+int Ssum_AddElement (Ssum_Problem_t * zptProblem, uint64_t zulValue)
+{
+    return SM__Edited(Subset_Sum_AddElement(&zptProblem->stProblem,
+                                                                zulValue));
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_RemoveElement
+*
+* \brief       Remove an element from a problem
+*
+* \details     The elements after it move down one index, in the solution
+*              too.
+*
+* \param[in]   zptProblem           Problem
+* \param[in]   zuwIndex             Index of the element
+*
+* \retval      int                  SSUM_OK, SSUM_NO_ELEMENT or
+*                                   SSUM_NO_MEMORY, the problem is unchanged
+*                                   then
+*
+******************************************************************************/
+
+int Ssum_RemoveElement (Ssum_Problem_t * zptProblem, uint32_t zuwIndex)
+{
+    if (zuwIndex >= zptProblem->stProblem.sptInput->suwSize)
+    {
+        return SSUM_NO_ELEMENT;
+    }
+
+    return SM__Edited(Subset_Sum_RemoveElement(&zptProblem->stProblem,
+                                                                zuwIndex));
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Edited
+*
+* \brief       The instance a problem currently has
+*
+* \details     For Ssum_Name, Ssum_Size and Ssum_Target. Valid until the
+*              next edit or Ssum_Close.
+*
+* \param[in]   zptProblem           Problem
+*
+* \retval      const Ssum_Instance_t *
+*
+******************************************************************************/
+
+const Ssum_Instance_t * Ssum_Edited (const Ssum_Problem_t * zptProblem)
+{
+    return zptProblem->stProblem.sptInput;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Current
+*
+* \brief       A problem's current solution
+*
+* \details     As the last solve left it and every edit since repaired it.
+*
+* \param[in]   zptProblem           Problem
+* \param[out]  zaulSolution         SSUM_WORDS(size) words for the packed
+*                                   solution, NULL if not wanted
+*
+* \retval      uint64_t             Its sum
+*
+******************************************************************************/
+
+uint64_t Ssum_Current (Ssum_Problem_t * zptProblem, uint64_t * zaulSolution)
+{
+    Subset_Sum_t * xptProblem = &zptProblem->stProblem;
+
+    if (xptProblem->sulSum == SUBSETSUM_UNKNOWN)
+    {
+        xptProblem->sulSum = Subset_Sum_GetSum(xptProblem);
+    }
+
+    if (zaulSolution != NULL)
+    {
+        memcpy(zaulSolution, xptProblem->saulSolution,
+            SSUM_WORDS(xptProblem->sptInput->suwSize) * sizeof(uint64_t));
+    }
+
+    return xptProblem->sulSum;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Resolve
+*
+* \brief       Solve a problem again from its current solution
+*
+* \details     The p5 solvers start their local search from it after an
+*              edit, the others solve from scratch. "auto" runs the solver
+*              Select_Choose ranks first. Not cached, a cache warm start
+*              would replace the repaired solution with an older one.
+*
+* \param[in]   zptProblem           Problem
+* \param[in]   zpsSolver            Solver name, see Ssum_Solver, or
+*                                   SSUM_AUTO
+* \param[in]   zulTimeLimit         Time limit in nanoseconds, 0 for none
+* \param[out]  zaulSolution         SSUM_WORDS(size) words for the packed
+*                                   solution, NULL if not wanted
+* \param[out]  zptResult            Result with suwBytes set, NULL if not
+*                                   wanted
+*
+* \retval      int                  SSUM_OK or SSUM_UNKNOWN_SOLVER
+*
+******************************************************************************/
+
+int Ssum_Resolve (Ssum_Problem_t * zptProblem, const char * zpsSolver,
+            uint64_t zulTimeLimit, uint64_t * zaulSolution,
+            Ssum_Result_t * zptResult)
+{
+    Subset_Sum_t * xptProblem = &zptProblem->stProblem;
+    const Portfolio_Solver_t * xptSolver;
+
+    zulTimeLimit = (zulTimeLimit == 0u) ? UINT64_MAX : zulTimeLimit;
+    xptSolver = SM__Find(xptProblem->sptInput, zpsSolver, zulTimeLimit);
+
+    if (xptSolver == NULL)
+    {
+        return SSUM_UNKNOWN_SOLVER;
+    }
+
+    Subset_Sum_SetTimeLimit(xptProblem, zulTimeLimit);
+    Subset_Sum_SetSolver(xptProblem, xptSolver->spfSolver);
+    Subset_Sum_Solve(xptProblem);
+
+    SM__Report(xptProblem, xptSolver, zaulSolution, zptResult);
+
+    return SSUM_OK;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Ssum Cleanup           Cleanup Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      Ssum_Finish
+*
+* \brief       Collect a job's result and free it
+*
+* \details     Cancels the job if it is still running and waits for it,
+*              then reports like Ssum_Solve. The job is gone afterwards.
+*
+* \param[in]   zptJob               Job
+* \param[out]  zaulSolution         SSUM_WORDS(size) words for the packed
+*                                   solution, NULL if not wanted
+* \param[out]  zptResult            Result with suwBytes set, NULL if not
+*                                   wanted
+*
+* \retval      int                  SSUM_OK
+*
+******************************************************************************/
+
+int Ssum_Finish (Ssum_Job_t * zptJob, uint64_t * zaulSolution,
+            Ssum_Result_t * zptResult)
+{
+    // Leaves the best solution published in the problem
+
+    Async_Free(zptJob->sptAsync);
+
+    SM__Report(&zptJob->stProblem, zptJob->sptSolver, zaulSolution, zptResult);
+
+    Subset_Sum_Free(&zptJob->stProblem);
+    free(zptJob);
+
+    return SSUM_OK;
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Release
+*
+* \brief       Drop the caller's reference to an instance
+*
+* \details     Safe while other threads are still solving it, it is freed
+*              when the last solve is done.
+*
+* \param[in]   zptInstance          Instance, NULL is ignored
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Ssum_Release (Ssum_Instance_t * zptInstance)
+{
+    if (zptInstance != NULL)
+    {
+        Subset_Sum_Release(zptInstance);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      Ssum_Close
+*
+* \brief       Free a problem
+*
+* \details     Drops its reference to the instance it was opened on, and
+*              its edited copy.
+*
+* \param[in]   zptProblem           Problem, NULL is ignored
+*
+* \retval      void
+*
+******************************************************************************/
+
+void Ssum_Close (Ssum_Problem_t * zptProblem)
+{
+    if (zptProblem != NULL)
+    {
+        Subset_Sum_Free(&zptProblem->stProblem);
+        free(zptProblem);
+    }
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Ssum Internal          Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      SM__Find
+*
+* \brief       Look up a solver by name
+*
+* \details     SSUM_AUTO is the one Select_Choose ranks first for the
+*              instance.
+*
+* \param[in]   zptInput             Instance
+* \param[in]   zpsSolver            Solver name or SSUM_AUTO
+* \param[in]   zulTimeLimit         Time limit in nanoseconds
+*
+* \retval      const Portfolio_Solver_t *  NULL if there is none
+*
+******************************************************************************/
+
+static const Portfolio_Solver_t * SM__Find (
+            const Subset_Sum_Input_t * zptInput, const char * zpsSolver,
+            uint64_t zulTimeLimit)
+{
+    const Portfolio_Solver_t * xptSolver;
+    uint32_t xauwChosen[SELECT_PORTFOLIO];
+    Select_Features_t xtFeatures;
+
+    xptSolver = Portfolio_Find(matSolvers, SM_SOLVER_COUNT, zpsSolver);
+
+    if ((xptSolver == NULL) && (strcmp(zpsSolver, SSUM_AUTO) == 0))
+    {
+        Select_Features(zptInput, &xtFeatures);
+
+        if (Select_Choose(matSolvers, SM_SOLVER_COUNT, "", &xtFeatures,
+                        zulTimeLimit, mulMemory, xauwChosen) > 0u)
+        {
+            xptSolver = &matSolvers[xauwChosen[0]];
+        }
+    }
+
+    return xptSolver;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SM__Edited
+*
+* \brief       Result of an edit
+*
+* \param[in]   zbDone               What the Subset_Sum edit returned
+*
+* \retval      int                  SSUM_OK or SSUM_NO_MEMORY
+*
+******************************************************************************/
+
+static int SM__Edited (bool zbDone)
+{
+    return (zbDone == true) ? SSUM_OK : SSUM_NO_MEMORY;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SM__Report
+*
+* \brief       Hand a solved problem's solution and result to the caller
+*
+* \param[in]   zptProblem           Solved problem
+* \param[in]   zptSolver            Solver that found it, NULL if none ran
+* \param[out]  zaulSolution         SSUM_WORDS(size) words for the packed
+*                                   solution, NULL if not wanted
+* \param[out]  zptResult            Result with suwBytes set, NULL if not
+*                                   wanted
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void SM__Report (Subset_Sum_t * zptProblem,
+            const Portfolio_Solver_t * zptSolver, uint64_t * zaulSolution,
+            Ssum_Result_t * zptResult)
+{
+    const Subset_Sum_Input_t * xptInput = zptProblem->sptInput;
+    const Stats_t * xptStats = &zptProblem->stStats;
+    Ssum_Result_t xtResult;
+
+    if (zaulSolution != NULL)
+    {
+        memcpy(zaulSolution, zptProblem->saulSolution,
+                    SSUM_WORDS(xptInput->suwSize) * sizeof(uint64_t));
+    }
+
+    if (zptResult == NULL)
+    {
+        return;
+    }
+
+    // Filled in here and copied only as far as the caller's struct goes,
+    // which may be older and shorter than this one
+
+    memset(&xtResult, 0, sizeof(Ssum_Result_t));
+    xtResult.suwBytes = zptResult->suwBytes;
+    xtResult.sulSum = Subset_Sum_GetSum(zptProblem);
+    xtResult.sulTarget = xptInput->sulTarget;
+    xtResult.suwSolved = (xtResult.sulSum == xtResult.sulTarget);
+    xtResult.sulInitial = zptProblem->sulInitialSol;
+    xtResult.sulTime = zptProblem->sulTime;
+    xtResult.sulMoves = xptStats->sulMoves;
+    xtResult.sulImprovements = xptStats->sulImprovements;
+    xtResult.sulRestarts = xptStats->sulRestarts;
+    xtResult.sulTabu = xptStats->sulTabu;
+    xtResult.sulNodes = xptStats->sulNodes;
+    xtResult.sulSubsets = xptStats->sulSubsets;
+    xtResult.sulFirst = xptStats->sulFirst;
+    xtResult.sulBest = xptStats->sulBest;
+    xtResult.suwSelected = Subset_Sum_GetCount(zptProblem);
+    xtResult.suwSolver = (zptSolver != NULL) ?
+                        (uint32_t)(zptSolver - matSolvers) : SM_SOLVER_COUNT;
+
+    memcpy(zptResult, &xtResult,
+                    (zptResult->suwBytes < sizeof(Ssum_Result_t)) ?
+                            zptResult->suwBytes : sizeof(Ssum_Result_t));
+}
+
+// \}
+
+// \}
@@ -0,0 +1,140 @@
+/**************************************************************************//**
+*
+* \file        Ssum.h
+*
+* \details     Public interface of libssum.so, the only header a program or
+*              binding using the library needs. Everything here is part of
+*              the stable ABI: functions are only ever added, the result
+*              struct only ever grows at the end, and SSUM_VERSION goes up
+*              with every addition. Nothing else in the library is
+*              exported.
+*
+*              The caller sets suwBytes of a result to the sizeof it was
+*              built with, and the library never writes past it. A caller
+*              with an older, shorter struct gets the fields it knows, one
+*              with a newer struct keeps zeroes in the fields this library
+*              does not have.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+******************************************************************************/
+
+#ifndef _SSUM_H
+#define _SSUM_H
+
+// ***** Header files *********************************************************
+
+// Basic types
+
+#include <stdint.h>
+
+// ***** Definitions **********************************************************
+
+#define SSUM_VERSION            4u
+
+#ifndef SSUM_API
+#define SSUM_API                __attribute__((visibility("default")))
+#endif
+
+//! 64-bit words of a packed solution, bit i set if element i is included
+
+#define SSUM_WORDS(uwSize)      (((uwSize) + 63u) >> 6)
+
+//! Solver name that picks one of the others per instance, see Select.c
+
+#define SSUM_AUTO               "auto"
+
+//! Ssum_Solve results
+
+#define SSUM_OK                 0
+#define SSUM_UNKNOWN_SOLVER     (-1)
+#define SSUM_NO_MEMORY          (-2)
+#define SSUM_NO_ELEMENT         (-3)
+
+//! A loaded or wrapped input set. Opaque, any number of threads may solve
+//! the same one at once.
+
+typedef struct Subset_Sum_Input_s Ssum_Instance_t;
+
+//! A solve running in the background, see Ssum_Start. Opaque, since
+//! version 3.
+
+typedef struct Ssum_Job_s Ssum_Job_t;
+
+//! An instance being edited and its solution, see Ssum_Open. Opaque, one
+//! thread at a time, since version 4.
+
+typedef struct Ssum_Problem_s Ssum_Problem_t;
+
+//! What a solve found. All times in nanoseconds, the counters are zero if
+//! the library was built with SS_NO_STATS.
+
+typedef struct Ssum_Result_s
+{
+    uint32_t suwBytes;          // Set by the caller, its sizeof(Ssum_Result_t)
+    uint32_t suwSolved;         // 1 if the sum is the target
+    uint64_t sulSum;
+    uint64_t sulTarget;
+    uint64_t sulInitial;        // Sum of the initial solution
+    uint64_t sulTime;           // Solve time
+    uint64_t sulMoves;
+    uint64_t sulImprovements;
+    uint64_t sulRestarts;
+    uint64_t sulTabu;
+    uint64_t sulNodes;
+    uint64_t sulSubsets;
+    uint64_t sulFirst;          // Solve start to first improvement
+    uint64_t sulBest;           // Solve start to last improvement
+    uint32_t suwSelected;       // Elements in the solution
+    uint32_t suwSolver;         // Ssum_Solver index of the solver that
+                                // found it, since version 2
+} Ssum_Result_t;
+
+// ***** Function prototypes **************************************************
+
+// Initialization functions
+
+SSUM_API uint32_t Ssum_Version (void);
+SSUM_API Ssum_Instance_t * Ssum_Load (const char * zpsPath);
+SSUM_API Ssum_Instance_t * Ssum_Wrap (const char * zpsName,
+            const void * zpvValues, uint32_t zuwWidth, uint32_t zuwSize,
+            uint64_t zulTarget);
+SSUM_API int Ssum_Cache (const char * zpsDir);
+SSUM_API int Ssum_Model (const char * zpsPath);
+SSUM_API void Ssum_Memory (uint64_t zulBytes);
+SSUM_API Ssum_Problem_t * Ssum_Open (Ssum_Instance_t * zptInstance);
+
+// Control functions
+
+SSUM_API const char * Ssum_Solver (uint32_t zuwIndex);
+SSUM_API const char * Ssum_Name (const Ssum_Instance_t * zptInstance);
+SSUM_API uint32_t Ssum_Size (const Ssum_Instance_t * zptInstance);
+SSUM_API uint64_t Ssum_Target (const Ssum_Instance_t * zptInstance);
+SSUM_API int Ssum_Solve (Ssum_Instance_t * zptInstance, const char * zpsSolver,
+            uint64_t zulTimeLimit, uint64_t * zaulSolution,
+            Ssum_Result_t * zptResult);
+SSUM_API int Ssum_Start (Ssum_Instance_t * zptInstance, const char * zpsSolver,
+            uint64_t zulTimeLimit, Ssum_Job_t ** zpptJob);
+SSUM_API uint64_t Ssum_Best (Ssum_Job_t * zptJob, uint64_t * zaulSolution);
+SSUM_API int Ssum_Wait (Ssum_Job_t * zptJob, uint64_t zulTimeout);
+SSUM_API void Ssum_Cancel (Ssum_Job_t * zptJob);
+SSUM_API int Ssum_SetTarget (Ssum_Problem_t * zptProblem, uint64_t zulTarget);
+SSUM_API int Ssum_AddElement (Ssum_Problem_t * zptProblem, uint64_t zulValue);
+SSUM_API int Ssum_RemoveElement (Ssum_Problem_t * zptProblem,
+            uint32_t zuwIndex);
+SSUM_API const Ssum_Instance_t * Ssum_Edited (
+            const Ssum_Problem_t * zptProblem);
+SSUM_API uint64_t Ssum_Current (Ssum_Problem_t * zptProblem,
+            uint64_t * zaulSolution);
+SSUM_API int Ssum_Resolve (Ssum_Problem_t * zptProblem, const char * zpsSolver,
+            uint64_t zulTimeLimit, uint64_t * zaulSolution,
+            Ssum_Result_t * zptResult);
+
+// Cleanup functions
+
+SSUM_API int Ssum_Finish (Ssum_Job_t * zptJob, uint64_t * zaulSolution,
+            Ssum_Result_t * zptResult);
+SSUM_API void Ssum_Release (Ssum_Instance_t * zptInstance);
+SSUM_API void Ssum_Close (Ssum_Problem_t * zptProblem);
+
+#endif // !defined _SSUM_H
@@ -11,6 +11,29 @@
 *              This is also where the solution method for this project,
 *              an exhaustive approach, is defined.
 *
+*              Given a checkpoint file as well, the search saves its place
+*              there every P1_CHECKPOINT_INTERVAL and when it stops, and a
+*              later run with the same file carries on from that place. A
+*              hard instance can so be finished over several time limited
+*              or preemptible runs. SIGTERM and SIGINT stop the search
+*              cleanly with a final checkpoint.
+*
+*              A search can also be split into shards (see Shard.c) and run
+*              by several processes. "shard <dir> [workers]" after the time
+*              limit makes this process the coordinator: it sets up the
+*              shard directory, starts the local workers and writes the
+*              result once the target is hit, every shard is done or time
+*              is up. More workers, on other machines sharing the directory,
+*              join with "p1 <dir> <time limit> worker". A coordinator run
+*              again on the same directory resumes the search.
+*
+*              Every process posts its progress to a telemetry ring, see
+*              Telemetry.c, which ss_monitor can follow live.
+*
+*              With SSUM_CACHE set, a plain run (no checkpoint, no shards)
+*              takes its result from that cache if the instance was already
+*              searched at least as long, see Cache.c.
+*
 * \version     01/22/17  gcg  Initial version.
 *
 * \{
@@ -19,27 +42,67 @@
 
 // ***** Header files *********************************************************
 
+#define _GNU_SOURCE
+
 // C Standard
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <stdbool.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 // Modules
 
 #include "Subset_Sum.h"
+#include "Deadline.h"
+#include "Checkpoint.h"
+#include "Shard.h"
+#include "Telemetry.h"
+#include "Cache.h"
+
+// ***** Local constants ******************************************************
+
+//! Time between checkpoints, at most this much work is lost to a kill
+
+#define P1_CHECKPOINT_INTERVAL      (60u * DEADLINE_NS_PER_SEC)
+
+//! A sharded search is cut into 2^P1_SHARD_BITS shards, plenty for a
+//! machine room of workers and a state file of a few kB
+
+#define P1_SHARD_BITS               8u
+
+//! How often workers renew their shard and check whether someone else hit
+//! the target, and the coordinator checks on progress
+
+#define P1_SHARD_POLL               (100u * 1000u * 1000u)
+#define P1_COORDINATOR_POLL         (10u * 1000u * 1000u)
 
 // ***** Local function prototypes ********************************************
 
 //! The solver is defined using the macro provided by the Subset Sum module
 
 SUBSETSUM_ALGORITHM(P1_Exhaustive);
+SUBSETSUM_ALGORITHM(P1_Shard);
+
+static void P1__Stop(int ziSignal);
+static int P1__Coordinate(char * zpsInstance, char * zpsLimit, char * zpsDir,
+                                    uint32_t zuwWorkers, char * zpsSelf);
+static int P1__Work(const char * zpsDir);
 
 // ***** Local variables ******************************************************
 
 static Subset_Sum_t mtProblem;
-static uint32_t muwTimeLimit;
+static uint64_t mulTimeLimit;
+static const char * mpsCheckpoint;
+static volatile sig_atomic_t mbStop;
+static Shard_t mtShard;
+static uint32_t muwShard;
+static bool mbShardComplete;
+static uint64_t mulShardDone;
 
 /**************************************************************************//**
 *
@@ -67,6 +130,10 @@ static uint32_t muwTimeLimit;
 *
 * \param[in]   argv[1]          Input file name
 * \param[in]   argv[2]          Runtime limit
+* \param[in]   argv[3]          Optional checkpoint file, "shard" or "worker"
+* \param[in]   argv[4]          Shard directory, after "shard"
+* \param[in]   argv[5]          Optional number of local workers, after
+*                               "shard", one per CPU if not given
 *
 * \retval      int
 *
@@ -74,25 +141,81 @@ static uint32_t muwTimeLimit;
 
 int main(int argc, char **argv)
 {  
+        bool xbShard = (argc >= 5) && (strcmp(argv[3], "shard") == 0);
+        bool xbWorker = (argc == 4) && (strcmp(argv[3], "worker") == 0);
+        long xlWorkers = sysconf(_SC_NPROCESSORS_ONLN);
         
         // Verify all arguments were recieved
         
-        if (argc != 3)
+        if ((argc != 3) && (argc != 4) && 
+            ((xbShard == false) || (argc > 6)))
         {
             printf("Invalid arguments! \n");
-            printf("Usage: P1 [input file name] [time limit (sec)]\n");
+            printf("Usage: P1 [input file name] [time limit (sec, or ms/us/ns)] "
+                   "[checkpoint file]\n");
+            printf("       P1 [input file name] [time limit] shard [directory] "
+                   "[workers]\n");
+            printf("       P1 [directory] [time limit] worker\n");
             
             return -1;
         }
 
         // Set the time limit
 
-        muwTimeLimit = atoi(argv[2]);
+        if (Deadline_Parse(argv[2], &mulTimeLimit) == false)
+        {
+            printf("Invalid time limit: %s\n", argv[2]);
+
+            return -1;
+        }
+
+        // Let ss_monitor follow the search
+
+        Telemetry_Open(argv[1]);
+
+        // Sharded search
+
+        if (xbShard == true)
+        {
+            if (argc == 6)
+            {
+                xlWorkers = strtol(argv[5], NULL, 10);
+            }
+
+            return P1__Coordinate(argv[1], argv[2], argv[4],
+                        (xlWorkers > 0) ? (uint32_t)xlWorkers : 0u, argv[0]);
+        }
+
+        if (xbWorker == true)
+        {
+            return P1__Work(argv[1]);
+        }
+
+        // Stop cleanly on a preemption so the checkpoint is current
+
+        if (argc == 4)
+        {
+            mpsCheckpoint = argv[3];
+            signal(SIGTERM, P1__Stop);
+            signal(SIGINT, P1__Stop);
+        }
         
         // Initialize the problem
         
-        Subset_Sum_Initialize(&mtProblem, argv[1]);
+        if (Subset_Sum_Initialize(&mtProblem, argv[1]) == false)
+        {
+            return -1;
+        }
+
         Subset_Sum_SetSolver(&mtProblem, P1_Exhaustive);
+        Subset_Sum_SetTimeLimit(&mtProblem, mulTimeLimit);
+
+        // A checkpointed search has its own way of not starting over
+
+        if ((argc == 3) && (Cache_Open(getenv(CACHE_ENV)) == true))
+        {
+            Subset_Sum_SetCache(&mtProblem, "p1.exhaustive");
+        }
         
         // Solve the problem
         
@@ -101,7 +224,7 @@ int main(int argc, char **argv)
         // Write outfile
 
         Subset_SumDisplayData(&mtProblem);
-        Subset_SumWriteData(&mtProblem);
+        Subset_SumWriteData(&mtProblem, ".");
         
         // Cleanup
         
@@ -129,7 +252,13 @@ int main(int argc, char **argv)
 * \brief       Exhaustive Algorithm for solving a subset sum instance.
 *
 * \details     Solves an instance of Subset Sum by trying every solution until
-*              one works.
+*              one works. Without a hit the result is the best subset not
+*              over the target, the optimum if every subset was tried.
+*
+*              With a checkpoint file the search starts from the saved
+*              position instead of the empty set, keeps the best subset not
+*              over the target, and reports that one if it runs out of time.
+*              The reported time is the total over every run.
 *
 * \param[in]   zptInst            Instance to solve
 *
@@ -138,58 +267,494 @@ int main(int argc, char **argv)
 ******************************************************************************/
 SUBSETSUM_ALGORITHM(P1_Exhaustive)
 {
-    uint32_t xuwLoop;
-    time_t xtStartTime, xtCurrTime;
+    const Subset_Sum_Input_t * xptInput = zptInst->sptInput;
+    uint32_t xuwWords = SUBSETSUM_WORDS(xptInput->suwSize);
+    Checkpoint_t xtCheckpoint;
+    Deadline_t xtDeadline;
+    Deadline_t xtSave;
+    uint64_t * xaulBest;
+    uint64_t xulSum;
+    uint64_t xulBestSum = 0u;
+    bool xbCheckpoint = false;
     bool xbDone = false;
+    bool xbHit = false;
 
     // Clear all selections
 
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    Subset_Sum_Clear(zptInst);
+
+    // The solution is the counter, the best subset so far is kept aside
+
+    xaulBest = (uint64_t *)calloc(xuwWords, sizeof(uint64_t));
+
+    if (xaulBest == NULL)
     {
-        Subset_Sum_Select(zptInst, xuwLoop, EXCLUDED);
+        return;
+    }
+
+    // Pick up where an earlier run left off
+
+    if (mpsCheckpoint != NULL)
+    {
+        xbCheckpoint = Checkpoint_Init(&xtCheckpoint, xptInput);
+    }
+
+    if ((xbCheckpoint == true) &&
+        (Checkpoint_Load(&xtCheckpoint, xptInput, mpsCheckpoint) == true))
+    {
+        memcpy(zptInst->saulSolution, (xtCheckpoint.sbComplete == true) ?
+                xtCheckpoint.saulBest : xtCheckpoint.saulPosition,
+                xuwWords * sizeof(uint64_t));
+        xbDone = xtCheckpoint.sbComplete;
+    }
+    else if ((xbCheckpoint == true) && (access(mpsCheckpoint, F_OK) == 0))
+    {
+        // Never overwrite a checkpoint we could not use
+
+        fprintf(stderr, "Not checkpointing to %s\n", mpsCheckpoint);
+        Checkpoint_Free(&xtCheckpoint);
+        xbCheckpoint = false;
     }
 
     // Start the timer
 
-    xtStartTime = time(NULL);
-    xtCurrTime = 0u;
+    Deadline_Start(&xtDeadline, zptInst->sulTimeLimit);
+    Deadline_Start(&xtSave, P1_CHECKPOINT_INTERVAL);
 
     // The loop to find the subsets treats the inpur array elements
     // as the digits in a binary number. This way, every combination
     // is tested as it "counts"
 
-    while((Subset_Sum_GetSum(zptInst) != zptInst->sulTarget) &&
-          (xtCurrTime < muwTimeLimit) &&
-          (xbDone == false))
+    while((xbDone == false) &&
+          (Deadline_Expired(&xtDeadline) == false) &&
+          (Subset_Sum_Cancelled(zptInst) == false) &&
+          (mbStop == 0))
     {
-          // Find next subset
+          xulSum = Subset_Sum_GetSum(zptInst);
+          STATS_ADD(sulSubsets, 1u);
 
-          for(xuwLoop = 0; xuwLoop < zptInst->suwSize; xuwLoop++)
+          if (xulSum == xptInput->sulTarget)
           {
-              if(zptInst->saucSolution[xuwLoop] == INCLUDED)
-              {
-                  zptInst->saucSolution[xuwLoop] = EXCLUDED;
-                  if (xuwLoop == (zptInst->suwSize - 1u))
-                  {
-                      xbDone = true;
-                      break;
-                  }
-              }
-              else
+              xbHit = true;
+              break;
+          }
+
+          // Keep and report every new best under the target as it is found
+
+          if ((xulSum < xptInput->sulTarget) && (xulSum > xulBestSum))
+          {
+              xulBestSum = xulSum;
+              memcpy(xaulBest, zptInst->saulSolution,
+                                            xuwWords * sizeof(uint64_t));
+              Subset_Sum_Publish(zptInst);
+          }
+
+          if (xbCheckpoint == true)
+          {
+              // Keep the best subset under the target
+
+              if ((xulSum < xptInput->sulTarget) &&
+                  (xulSum > xtCheckpoint.sulBestSum))
               {
-                  zptInst->saucSolution[xuwLoop] = INCLUDED;
-                  break;
+                  xtCheckpoint.sulBestSum = xulSum;
+                  memcpy(xtCheckpoint.saulBest, zptInst->saulSolution,
+                                            xuwWords * sizeof(uint64_t));
               }
           }
 
-          // Update the elapsed time
+          // Find next subset
 
-          xtCurrTime = time(NULL) - xtStartTime;
+          xbDone = (Subset_Sum_Increment(zptInst) == false);
+
+          // Save the next subset to try, it has not been tried yet
+
+          if ((xbCheckpoint == true) && (xbDone == false) &&
+              (Deadline_Expired(&xtSave) == true))
+          {
+              memcpy(xtCheckpoint.saulPosition, zptInst->saulSolution,
+                                            xuwWords * sizeof(uint64_t));
+              xtCheckpoint.sulElapsed += Deadline_Elapsed(&xtSave);
+              Checkpoint_Save(&xtCheckpoint, xptInput, mpsCheckpoint);
+              Deadline_Start(&xtSave, P1_CHECKPOINT_INTERVAL);
+          }
     }
 
     // Update the total elapsed time
 
-    zptInst->suwTime = xtCurrTime;
+    zptInst->sulTime = Deadline_Elapsed(&xtDeadline);
+
+    // Without a hit the counter has moved past the best subset (or wrapped
+    // back to the empty set), report the best instead. A checkpointed
+    // search saves its position first and reports the best over every run
+    // below.
+
+    if ((xbHit == false) && (xbCheckpoint == false))
+    {
+        memcpy(zptInst->saulSolution, xaulBest, xuwWords * sizeof(uint64_t));
+    }
+
+    free(xaulBest);
+
+    if (xbCheckpoint == true)
+    {
+        // Final checkpoint. A hit or a full enumeration ends the search,
+        // otherwise the best subset so far is the result of this run.
+
+        if (xtCheckpoint.sbComplete == false)
+        {
+            xtCheckpoint.sulElapsed += Deadline_Elapsed(&xtSave);
+
+            if (Subset_Sum_GetSum(zptInst) == xptInput->sulTarget)
+            {
+                xtCheckpoint.sulBestSum = xptInput->sulTarget;
+                memcpy(xtCheckpoint.saulBest, zptInst->saulSolution,
+                                            xuwWords * sizeof(uint64_t));
+                xbDone = true;
+            }
+
+            xtCheckpoint.sbComplete = xbDone;
+
+            if (xbDone == false)
+            {
+                memcpy(xtCheckpoint.saulPosition, zptInst->saulSolution,
+                                            xuwWords * sizeof(uint64_t));
+            }
+
+            Checkpoint_Save(&xtCheckpoint, xptInput, mpsCheckpoint);
+            memcpy(zptInst->saulSolution, xtCheckpoint.saulBest,
+                                            xuwWords * sizeof(uint64_t));
+        }
+
+        zptInst->sulTime = xtCheckpoint.sulElapsed;
+        Checkpoint_Free(&xtCheckpoint);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      P1_Shard
+*
+* \brief       Exhaustive search of one shard, for a sharded search worker
+*
+* \details     Counts through the subsets of shard muwShard only, from where
+*              an earlier worker left it, keeping the best one not over the
+*              target. Renews the claim at every poll and stops early when
+*              time is up, the claim was lost or another worker hit the
+*              target. Leaves the hit or the best subset in the solution for
+*              Shard_Report, how far it got in mulShardDone and whether the
+*              whole shard was tried in mbShardComplete.
+*
+* \param[in]   zptInst            Instance to solve
+*
+* \retval      void
+*
+******************************************************************************/
+SUBSETSUM_ALGORITHM(P1_Shard)
+{
+    const Subset_Sum_Input_t * xptInput = zptInst->sptInput;
+    uint32_t xuwWords = SUBSETSUM_WORDS(xptInput->suwSize);
+    uint64_t * xaulBest;
+    uint64_t xulBestSum = 0u;
+    uint64_t xulLeft;
+    uint64_t xulEnd;
+    uint64_t xulSum;
+    Deadline_t xtDeadline;
+    Deadline_t xtPoll;
+    bool xbHit = false;
+
+    xaulBest = (uint64_t *)calloc(xuwWords, sizeof(uint64_t));
+    mbShardComplete = false;
+    mulShardDone = mtShard.sulResume;
+
+    if (xaulBest == NULL)
+    {
+        return;
+    }
+
+    // Start at the first subset of the shard not searched yet
+
+    xulLeft = Shard_Seek(&mtShard, muwShard, zptInst);
+    xulEnd = mtShard.sulResume + xulLeft;
+
+    Deadline_Start(&xtDeadline, zptInst->sulTimeLimit);
+    Deadline_Start(&xtPoll, P1_SHARD_POLL);
+
+    while ((xulLeft > 0u) &&
+           (Deadline_Expired(&xtDeadline) == false) &&
+           (mbStop == 0))
+    {
+        xulSum = Subset_Sum_GetSum(zptInst);
+        STATS_ADD(sulSubsets, 1u);
+
+        if (xulSum == xptInput->sulTarget)
+        {
+            xbHit = true;
+            break;
+        }
+
+        if ((xulSum < xptInput->sulTarget) && (xulSum > xulBestSum))
+        {
+            xulBestSum = xulSum;
+            memcpy(xaulBest, zptInst->saulSolution, xuwWords * sizeof(uint64_t));
+            Subset_Sum_Publish(zptInst);
+        }
+
+        // Next subset, the last one carries into the shard prefix
+
+        Subset_Sum_Increment(zptInst);
+        xulLeft--;
+
+        if ((Deadline_Expired(&xtPoll) == true) &&
+            (xulLeft > 0u))
+        {
+            if (Shard_Renew(&mtShard, muwShard, xulEnd - xulLeft, xulBestSum,
+                                                        xaulBest) == false)
+            {
+                break;
+            }
+
+            Deadline_Start(&xtPoll, P1_SHARD_POLL);
+        }
+    }
+
+    mbShardComplete = (xbHit == true) || (xulLeft == 0u);
+    mulShardDone = xulEnd - xulLeft;
+
+    if (xbHit == false)
+    {
+        memcpy(zptInst->saulSolution, xaulBest, xuwWords * sizeof(uint64_t));
+    }
+
+    zptInst->sulTime = Deadline_Elapsed(&xtDeadline);
+
+    free(xaulBest);
+}
+
+/**************************************************************************//**
+*
+* \anchor      P1__Stop
+*
+* \brief       SIGTERM/SIGINT handler, ends the search at the next subset
+*
+* \param[in]   ziSignal           Signal number
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void P1__Stop(int ziSignal)
+{
+    (void)ziSignal;
+
+    mbStop = 1;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P1__Coordinate
+*
+* \brief       Run a sharded search and write its result
+*
+* \details     Sets up (or picks up) the shard directory, forks the local
+*              workers and waits for a hit, the last shard or the time
+*              limit. Then stops the workers and writes the best subset any
+*              of them found, as P1_Exhaustive would have.
+*
+*              With no local workers the coordinator only waits, for workers
+*              started elsewhere on the directory.
+*
+* \param[in]   zpsInstance        Instance file
+* \param[in]   zpsLimit           Time limit as given, passed to the workers
+* \param[in]   zpsDir             Shard directory
+* \param[in]   zuwWorkers         Local workers to start
+* \param[in]   zpsSelf            This program, argv[0]
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int P1__Coordinate(char * zpsInstance, char * zpsLimit, char * zpsDir,
+                                    uint32_t zuwWorkers, char * zpsSelf)
+{
+    const struct timespec xtPoll = { 0, P1_COORDINATOR_POLL };
+    char * xapsArgs[] = { zpsSelf, zpsDir, zpsLimit, "worker", NULL };
+    Shard_Status_t xtStatus;
+    Deadline_t xtDeadline;
+    uint32_t xuwBits;
+    uint32_t xuwLive = 0u;
+    uint32_t xuwLoop;
+    pid_t xiPid;
+
+    if (Subset_Sum_Initialize(&mtProblem, zpsInstance) == false)
+    {
+        return -1;
+    }
+
+    xuwBits = (mtProblem.sptInput->suwSize < P1_SHARD_BITS) ?
+                            mtProblem.sptInput->suwSize : P1_SHARD_BITS;
+
+    if ((Shard_Create(zpsDir, zpsInstance, mtProblem.sptInput, xuwBits) ==
+                                                                    false) ||
+        (Shard_Open(&mtShard, zpsDir) == false))
+    {
+        Subset_Sum_Free(&mtProblem);
+
+        return -1;
+    }
+
+    if ((mtShard.suwSize != mtProblem.sptInput->suwSize) ||
+        (mtShard.sulTarget != mtProblem.sptInput->sulTarget))
+    {
+        fprintf(stderr, "%s: shard directory is for another instance\n",
+                                                                    zpsDir);
+        Shard_Close(&mtShard);
+        Subset_Sum_Free(&mtProblem);
+
+        return -1;
+    }
+
+    // A resumed search was stopped by the last coordinator
+
+    Shard_Stop(&mtShard, false);
+    Deadline_Start(&xtDeadline, mulTimeLimit);
+
+    // Start the local workers
+
+    fflush(stdout);
+
+    for (xuwLoop = 0u; xuwLoop < zuwWorkers; xuwLoop++)
+    {
+        xiPid = fork();
+
+        if (xiPid == 0)
+        {
+            execvp(zpsSelf, xapsArgs);
+            perror(zpsSelf);
+            _exit(127);
+        }
+
+        if (xiPid > 0)
+        {
+            xuwLive++;
+        }
+    }
+
+    // Wait for a hit, the last shard or the time limit
+
+    while ((Shard_Status(&mtShard, &xtStatus, NULL) == true) &&
+           (xtStatus.sbHit == false) &&
+           ((xtStatus.suwOpen + xtStatus.suwClaimed) > 0u) &&
+           (Deadline_Expired(&xtDeadline) == false))
+    {
+        while ((xuwLive > 0u) && (waitpid(-1, NULL, WNOHANG) > 0))
+        {
+            xuwLive--;
+        }
+
+        if ((zuwWorkers > 0u) && (xuwLive == 0u))
+        {
+            fprintf(stderr, "%s: all workers exited\n", zpsDir);
+            break;
+        }
+
+        nanosleep(&xtPoll, NULL);
+    }
+
+    // Call off the workers still searching and wait for their reports
+
+    Shard_Stop(&mtShard, true);
+
+    while ((xuwLive > 0u) && (waitpid(-1, NULL, 0) > 0))
+    {
+        xuwLive--;
+    }
+
+    // Write the best subset of any worker as the result
+
+    Subset_Sum_Clear(&mtProblem);
+    Shard_Status(&mtShard, &xtStatus, mtProblem.saulSolution);
+    mtProblem.sulTime = Deadline_Elapsed(&xtDeadline);
+
+    Subset_SumDisplayData(&mtProblem);
+    Subset_SumWriteData(&mtProblem, ".");
+
+    Shard_Close(&mtShard);
+    Subset_Sum_Free(&mtProblem);
+
+    return 0;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P1__Work
+*
+* \brief       Search shards of a shard directory until none are left
+*
+* \details     Loads the instance named by the manifest, then claims,
+*              searches and reports one shard after the other until the
+*              target is hit, the search is stopped, no shard is left or
+*              the time limit is up.
+*
+* \param[in]   zpsDir             Shard directory
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int P1__Work(const char * zpsDir)
+{
+    Deadline_t xtDeadline;
+    uint64_t xulElapsed;
+
+    signal(SIGTERM, P1__Stop);
+    signal(SIGINT, P1__Stop);
+
+    if (Shard_Open(&mtShard, zpsDir) == false)
+    {
+        return -1;
+    }
+
+    if (Subset_Sum_Initialize(&mtProblem, mtShard.spsInstance) == false)
+    {
+        Shard_Close(&mtShard);
+
+        return -1;
+    }
+
+    if ((mtShard.suwSize != mtProblem.sptInput->suwSize) ||
+        (mtShard.sulTarget != mtProblem.sptInput->sulTarget))
+    {
+        fprintf(stderr, "%s: instance changed since the search started\n",
+                                                        mtShard.spsInstance);
+        Subset_Sum_Free(&mtProblem);
+        Shard_Close(&mtShard);
+
+        return -1;
+    }
+
+    Subset_Sum_SetSolver(&mtProblem, P1_Shard);
+    Deadline_Start(&xtDeadline, mulTimeLimit);
+
+    while ((mbStop == 0) &&
+           (Deadline_Expired(&xtDeadline) == false) &&
+           (Shard_Claim(&mtShard, &muwShard) == true))
+    {
+        // Whatever is left of the time limit goes to this shard
+
+        xulElapsed = Deadline_Elapsed(&xtDeadline);
+        Subset_Sum_SetTimeLimit(&mtProblem, (mulTimeLimit == DEADLINE_NONE) ?
+                DEADLINE_NONE : (mulTimeLimit - ((xulElapsed < mulTimeLimit) ?
+                                            xulElapsed : mulTimeLimit)));
+
+        Subset_Sum_Solve(&mtProblem);
+        Shard_Report(&mtShard, muwShard, mulShardDone, mbShardComplete,
+                                                                &mtProblem);
+    }
+
+    Subset_Sum_Free(&mtProblem);
+    Shard_Close(&mtShard);
+
+    return 0;
 }
 
 // \}
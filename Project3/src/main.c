@@ -11,6 +11,9 @@
 *              This is also where the solution method for this project,
 *              a greedy approach, is defined.
 *
+*              With SSUM_CACHE set, an instance already solved is taken
+*              from that cache, see Cache.c.
+*
 * \version     02/13/17  gcg  Initial version.
 *
 * \{
@@ -29,6 +32,8 @@
 // Modules
 
 #include "Subset_Sum.h"
+#include "Telemetry.h"
+#include "Cache.h"
 
 // ***** Local function prototypes ********************************************
 
@@ -82,11 +87,24 @@ int main(int argc, char **argv)
             
             return -1;
         }
+
+        // Let ss_monitor follow the solve
+
+        Telemetry_Open(argv[1]);
         
         // Initialize the problem
         
-        Subset_Sum_Initialize(&mtProblem, argv[1]);
+        if (Subset_Sum_Initialize(&mtProblem, argv[1]) == false)
+        {
+            return -1;
+        }
+
         Subset_Sum_SetSolver(&mtProblem, P3_Greedy);
+
+        if (Cache_Open(getenv(CACHE_ENV)) == true)
+        {
+            Subset_Sum_SetCache(&mtProblem, "p3.greedy");
+        }
         
         // Solve the problem
         
@@ -95,7 +113,7 @@ int main(int argc, char **argv)
         // Write outfile
 
         Subset_SumDisplayData(&mtProblem);
-        Subset_SumWriteData(&mtProblem);
+        Subset_SumWriteData(&mtProblem, ".");
         
         // Cleanup
         
@@ -130,39 +148,44 @@ int main(int argc, char **argv)
 ******************************************************************************/
 SUBSETSUM_ALGORITHM(P3_Greedy)
 {
+    const Subset_Sum_Input_t * xptInput = zptInst->sptInput;
     uint32_t xuwLoop;
-    uint64_t xulTempSum = 0u;
+    uint64_t xulSum = 0u;
+    uint64_t xulValue;
 
     // Clear all selections
 
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
-    {
-        Subset_Sum_Select(zptInst, xuwLoop, EXCLUDED);
-    }
+    Subset_Sum_Clear(zptInst);
     
     // Loop through the set, adding any element that is legal
     // TBD - Sorted?
     // TBD - Smallest first? Largest first?
     
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    for(xuwLoop = 0u; xuwLoop < xptInput->suwSize; xuwLoop++)
     {
-        // If the instance is solved, stop
+        // If the instance is solved or we were told to stop, stop
         
-        if (Subset_Sum_GetSum(zptInst) == zptInst->sulTarget)
+        if ((xulSum == xptInput->sulTarget) ||
+            (Subset_Sum_Cancelled(zptInst) == true))
         {
             
             break;
         }
         
         // Attempt to add the next element if it is legal. If not,
-        // ignore it.
+        // ignore it. The sum is kept as we go, summing the solution
+        // for every element would make this O(n^2).
         
-        xulTempSum = 
-            Subset_Sum_GetSum(zptInst) + zptInst->sauwInputSet[xuwLoop];
+        xulValue = SUBSETSUM_VALUE(xptInput, xuwLoop);
         
-        zptInst->saucSolution[xuwLoop] = 
-            (xulTempSum <= zptInst->sulTarget) ? INCLUDED : EXCLUDED;
+        if (xulValue <= (xptInput->sulTarget - xulSum))
+        {
+            Subset_Sum_Select(zptInst, xuwLoop, INCLUDED);
+            xulSum += xulValue;
+        }
     }
+
+    STATS_ADD(sulNodes, xuwLoop);
 }
 
 // \}
@@ -12,6 +12,52 @@
 *              a greedy & random initial solution with a "1OPT" neighborhood and
 *              a basic tabu list implementation are defined. 
 *
+*              Passing "portfolio" after the time limit runs the registered
+*              solvers (all of them, or a comma separated subset) concurrently
+*              instead of one after another. They share one incumbent and
+*              stop as soon as any of them hits the target.
+*
+*              Passing "batch" instead takes a directory or manifest of
+*              instances in place of the file and solves all of them in this
+*              one process on a pool of threads, see Batch.c.
+*
+*              Passing "budget" does the same, but the time limit is the
+*              total for the whole batch. Instances are run easiest first
+*              and each gets a share of the time left that matches its
+*              estimated difficulty.
+*
+*              Both write every result to its own .out file like the other
+*              modes, unless they are given an output file (or "-" for
+*              stdout) after the thread count. Then all results of the run
+*              go there as framed records, in a few large writes, see
+*              Subset_Sum_WriteRecord. Their progress and totals go to
+*              stderr, so stdout carries nothing but records.
+*
+*              Solver workspaces come from a scratch arena (see Arena.c),
+*              one per solver running at the same time, so one for the
+*              plain mode and one per pool thread in batch and budget mode.
+*              The peak scratch use is printed at the end.
+*
+*              Passing "profile" runs the solvers one after the other like
+*              the plain mode, but counts cycles, instructions, cache and
+*              branch misses for loading, construction, local search and
+*              output separately and prints them per instance and solver,
+*              see Perf.c.
+*
+*              In every mode the solvers' progress and phases are posted to
+*              a telemetry ring that ss_monitor can follow live, see
+*              Telemetry.c.
+*
+*              Passing "auto" runs only what the cost model picks for the
+*              instance within the time limit and an optional memory
+*              budget, one solver or a small portfolio (see Select.c). The
+*              result goes to the folder of the solver that found it.
+*
+*              With SSUM_CACHE set, the plain, batch and budget modes take
+*              every result that is already cached for the time limit from
+*              there, and a result cached for a shorter limit is where the
+*              solver starts, see Cache.c.
+*
 * \version     04/19/17  gcg  Initial version.
 *
 * \{
@@ -24,12 +70,22 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <stdbool.h>
+#include <unistd.h>
 
 // Modules
 
 #include "Subset_Sum.h"
+#include "Portfolio.h"
+#include "Deadline.h"
+#include "Batch.h"
+#include "Arena.h"
+#include "Perf.h"
+#include "Telemetry.h"
+#include "Cache.h"
+#include "Select.h"
 
 // ***** Local function prototypes ********************************************
 
@@ -41,8 +97,71 @@ SUBSETSUM_ALGORITHM(P5_Tabu);
 
 //! Helper funtions - 1OPT is here since is is called twice
 
-static void P5__1OPT(Subset_Sum_t * zptInst);
-static void P5__1OPT_Tabu(Subset_Sum_t * zptInst);
+static void P5__1OPT(Subset_Sum_t * zptInst, Deadline_t * zptDeadline);
+static void P5__1OPT_Tabu(Subset_Sum_t * zptInst, Deadline_t * zptDeadline);
+static bool P5__Warm(Subset_Sum_t * zptInst);
+static int P5__Portfolio(char * zpsFilePath, char * zpsSolvers);
+static int P5__Auto(char * zpsFilePath, char * zpsMemory);
+static int P5__Batch(char * zpsSource, uint32_t zuwThreads, 
+                                                    char * zpsOutput);
+static void P5__Batch_Job(uint32_t zuwIndex, char * zpsPath, void * zpvContext);
+static int P5__Budget(char * zpsSource, uint32_t zuwThreads, 
+                                                    char * zpsOutput);
+static void P5__Budget_Load(uint32_t zuwIndex, char * zpsPath, 
+                                                    void * zpvContext);
+static void P5__Budget_Job(uint32_t zuwIndex, char * zpsPath, 
+                                                    void * zpvContext);
+static int P5__Budget_Compare(const void * zpvLeft, const void * zpvRight);
+static void P5__Arenas_Start(uint32_t zuwCount);
+static size_t P5__Arenas_Stop(void);
+static int P5__Profile(char * zpsFilePath);
+static void P5__Phase(uint32_t zuwPhase);
+static void P5__Write(Subset_Sum_t * zptProblem, uint32_t zuwSolver, 
+                                                    Sink_t * zptSink);
+
+// ***** Local constants ******************************************************
+
+//! Address space reserved per scratch arena. Only what a solver touches is
+//! committed, this just bounds the largest tabu list (24n + n / 8 bytes).
+
+#define P5_ARENA_RESERVE    (256u << 20)
+
+//! End of a partner list in the tabu list
+
+#define P5_TABU_NONE        UINT32_MAX
+
+//! Every solver this project provides, the name is also its output folder
+
+static const Portfolio_Solver_t matSolvers[] =
+{
+    {"greedy", P5_Greedy},
+    {"random", P5_Random},
+    {"tabu",   P5_Tabu},
+};
+
+#define P5_SOLVER_COUNT     (sizeof(matSolvers) / sizeof(matSolvers[0]))
+
+//! Batch mode keeps every instance's results until the end so they can be
+//! written out in one pass
+
+typedef struct P5__Result_s
+{
+    Subset_Sum_t satProblems[P5_SOLVER_COUNT];
+    Subset_Sum_Input_t * sptInput;  // Budget mode: loaded, not solved yet
+    uint64_t sulWeight;             // Budget mode: Batch_Weight estimate
+    bool sbSolved;
+} P5__Result_t;
+
+//! Budget mode works through the instances sorted by weight
+
+typedef struct P5__Budget_s
+{
+    P5__Result_t ** saptOrder;
+    Batch_Budget_t stBudget;
+} P5__Budget_t;
+
+static bool P5__Solve_All(P5__Result_t * zptResult, 
+                    Subset_Sum_Input_t * zptInput, uint64_t zulTimeLimit);
 
 // ***** Local variables ******************************************************
 
@@ -50,9 +169,14 @@ static Subset_Sum_t mtProblem_Greedy;
 static Subset_Sum_t mtProblem_Random;
 static Subset_Sum_t mtProblem_Tabu;
 
-static uint32_t muwTimeLimit;
+static uint64_t mulTimeLimit;
 char mnOutFldr[64];
 
+//! Scratch arenas, one per solver running at the same time
+
+static Arena_t * matArenas;
+static uint32_t muwArenas;
+
 
 /**************************************************************************//**
 *
@@ -71,14 +195,23 @@ char mnOutFldr[64];
 * \details     Creates a subset sum instance from the provided file and uses
 *              the locally defined greedy search to solve it.
 *
-* \ref         Subset_Sum_Initialize
-* \ref         Subset_Sum_ReadFromFile
-* \ref         Subset_Sum_SetOutputFile
+* \ref         Subset_Sum_Load
+* \ref         Subset_Sum_Attach
 * \ref         Subset_Sum_SetSolver
 * \ref         Subset_Sum_Solve
 * \ref         Subset_Sum_Free
 *
-* \param[in]   argv[1]          Input file name
+* \param[in]   argv[1]          Input file name (directory or manifest in
+*                               batch mode)
+* \param[in]   argv[2]          Runtime limit, for the whole batch in budget
+*                               mode
+* \param[in]   argv[3]          Optional "portfolio", "batch", "budget",
+*                               "profile" or "auto" mode
+* \param[in]   argv[4]          Optional comma separated solver names for
+*                               portfolio mode, thread count for batch and
+*                               budget modes, memory budget for auto mode
+* \param[in]   argv[5]          Optional output file for batch and budget
+*                               modes, "-" for stdout
 *
 * \retval      int
 *
@@ -86,31 +219,131 @@ char mnOutFldr[64];
 
 int main(int argc, char **argv)
 {  
+        Subset_Sum_Input_t * xptInput;
         
         // Verify all arguments were recieved
         
-        if (argc != 3)
+        if ((argc < 3) || (argc > 6) ||
+            ((argc > 3) && (strcmp(argv[3], "portfolio") != 0) &&
+                           (strcmp(argv[3], "batch") != 0) &&
+                           (strcmp(argv[3], "budget") != 0) &&
+                           (strcmp(argv[3], "profile") != 0) &&
+                           (strcmp(argv[3], "auto") != 0)) ||
+            ((argc > 4) && (strcmp(argv[3], "profile") == 0)) ||
+            ((argc > 5) && (strcmp(argv[3], "portfolio") == 0)) ||
+            ((argc > 5) && (strcmp(argv[3], "auto") == 0)))
         {
             printf("Invalid arguments! \n");
-            printf("Usage: P5 [input file name] [time limit (sec)]\n");
+            printf("Usage: P5 [input file name] [time limit (sec, or ms/us/ns)] "
+                   "[portfolio [solver,...]]\n");
+            printf("       P5 [instance dir|manifest] [time limit] "
+                   "batch|budget [threads [output file|-]]\n");
+            printf("       P5 [input file name] [time limit] profile\n");
+            printf("       P5 [input file name] [time limit] "
+                   "auto [memory budget (bytes, or k/M/G)]\n");
             
             return -1;
         }
         
         // Set the time limit
 
-        muwTimeLimit = atoi(argv[2]);
+        if (Deadline_Parse(argv[2], &mulTimeLimit) == false)
+        {
+            printf("Invalid time limit: %s\n", argv[2]);
+
+            return -1;
+        }
+
+        // Let ss_monitor follow the solvers
+
+        Telemetry_Open(argv[1]);
+        Cache_Open(getenv(CACHE_ENV));
+        Select_Open(getenv(SELECT_ENV));
+        
+        // Run every solver at once if asked to
+
+        if ((argc > 3) && (strcmp(argv[3], "batch") == 0))
+        {
+            srand(time(NULL));
+
+            return P5__Batch(argv[1], (argc > 4) ? (uint32_t)atoi(argv[4]) : 0u,
+                                      (argc > 5) ? argv[5] : NULL);
+        }
+
+        if ((argc > 3) && (strcmp(argv[3], "budget") == 0))
+        {
+            srand(time(NULL));
+
+            return P5__Budget(argv[1], (argc > 4) ? (uint32_t)atoi(argv[4]) : 0u,
+                                       (argc > 5) ? argv[5] : NULL);
+        }
+
+        if ((argc > 3) && (strcmp(argv[3], "profile") == 0))
+        {
+            srand(time(NULL));
+
+            return P5__Profile(argv[1]);
+        }
+
+        if ((argc > 3) && (strcmp(argv[3], "auto") == 0))
+        {
+            srand(time(NULL));
+
+            return P5__Auto(argv[1], (argc == 5) ? argv[4] : NULL);
+        }
+
+        if (argc > 3)
+        {
+            srand(time(NULL));
+
+            return P5__Portfolio(argv[1], (argc == 5) ? argv[4] : NULL);
+        }
         
-        // Initialize the problems
+        // Load the input set once and attach every problem to it
         
-        Subset_Sum_Initialize(&mtProblem_Greedy, argv[1]);
+        xptInput = Subset_Sum_Load(argv[1]);
+
+        if (xptInput == NULL)
+        {
+            return -1;
+        }
+
+        // The solvers run one after the other and share one arena
+
+        P5__Arenas_Start(1u);
+
+        if ((Subset_Sum_Attach(&mtProblem_Greedy, xptInput) == false) ||
+            (Subset_Sum_Attach(&mtProblem_Random, xptInput) == false) ||
+            (Subset_Sum_Attach(&mtProblem_Tabu, xptInput) == false))
+        {
+            fprintf(stderr, "%s: out of memory\n", argv[1]);
+            Subset_Sum_Free(&mtProblem_Greedy);
+            Subset_Sum_Free(&mtProblem_Random);
+            Subset_Sum_Free(&mtProblem_Tabu);
+            Subset_Sum_Release(xptInput);
+            P5__Arenas_Stop();
+
+            return -1;
+        }
+
         Subset_Sum_SetSolver(&mtProblem_Greedy, P5_Greedy);
+        Subset_Sum_SetTimeLimit(&mtProblem_Greedy, mulTimeLimit);
+        Subset_Sum_SetArena(&mtProblem_Greedy, &matArenas[0u]);
+        Subset_Sum_SetCache(&mtProblem_Greedy, "p5.greedy");
         
-        Subset_Sum_Initialize(&mtProblem_Random, argv[1]);
         Subset_Sum_SetSolver(&mtProblem_Random, P5_Random);
+        Subset_Sum_SetTimeLimit(&mtProblem_Random, mulTimeLimit);
+        Subset_Sum_SetArena(&mtProblem_Random, &matArenas[0u]);
+        Subset_Sum_SetCache(&mtProblem_Random, "p5.random");
         
-        Subset_Sum_Initialize(&mtProblem_Tabu, argv[1]);
         Subset_Sum_SetSolver(&mtProblem_Tabu, P5_Tabu);
+        Subset_Sum_SetTimeLimit(&mtProblem_Tabu, mulTimeLimit);
+        Subset_Sum_SetArena(&mtProblem_Tabu, &matArenas[0u]);
+        Subset_Sum_SetCache(&mtProblem_Tabu, "p5.tabu");
+
+        // The problems hold their own references from here on
+
+        Subset_Sum_Release(xptInput);
         
         // Initialize random numbers
         
@@ -138,6 +371,8 @@ int main(int argc, char **argv)
         Subset_Sum_Free(&mtProblem_Greedy);
         Subset_Sum_Free(&mtProblem_Random);
         Subset_Sum_Free(&mtProblem_Tabu);
+
+        printf("%s Scratch peak %zu bytes\r\n", argv[1], P5__Arenas_Stop());
         
         return 0;
 }
@@ -168,47 +403,70 @@ int main(int argc, char **argv)
 ******************************************************************************/
 SUBSETSUM_ALGORITHM(P5_Greedy)
 {
+    const Subset_Sum_Input_t * xptInput = zptInst->sptInput;
     uint32_t xuwLoop;
-    uint64_t xulTempSum = 0u;
+    uint64_t xulSum = 0u;
+    uint64_t xulValue;
+    Deadline_t xtDeadline;
 
-    // Clear all selections
+    // The limit covers the whole solve, construction included
+
+    Deadline_Start(&xtDeadline, zptInst->sulTimeLimit);
+    P5__Phase(PERF_CONSTRUCT);
+
+    // After an edit, improve the carried over solution instead
 
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    if (P5__Warm(zptInst) == true)
     {
-        Subset_Sum_Select(zptInst, xuwLoop, EXCLUDED);
+        P5__1OPT(zptInst, &xtDeadline);
+
+        return;
     }
+
+    // Clear all selections
+
+    Subset_Sum_Clear(zptInst);
     
     // Loop through the set, adding any element that is legal
     // TBD - Sorted?
     // TBD - Smallest first? Largest first?
     
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    for(xuwLoop = 0u; xuwLoop < xptInput->suwSize; xuwLoop++)
     {
-        // If the instance is solved, stop
+        // If the instance is solved, time is up or we were told to stop,
+        // stop
         
-        if (Subset_Sum_GetSum(zptInst) == zptInst->sulTarget)
+        if ((xulSum == xptInput->sulTarget) ||
+            (Deadline_Expired(&xtDeadline) == true) ||
+            (Subset_Sum_Cancelled(zptInst) == true))
         {
             
             break;
         }
         
         // Attempt to add the next element if it is legal. If not,
-        // ignore it.
+        // ignore it. The sum is kept as we go, summing the solution
+        // for every element would make this O(n^2).
         
-        xulTempSum = 
-            Subset_Sum_GetSum(zptInst) + zptInst->sauwInputSet[xuwLoop];
+        xulValue = SUBSETSUM_VALUE(xptInput, xuwLoop);
         
-        zptInst->saucSolution[xuwLoop] = 
-            (xulTempSum <= zptInst->sulTarget) ? INCLUDED : EXCLUDED;
+        if (xulValue <= (xptInput->sulTarget - xulSum))
+        {
+            Subset_Sum_Select(zptInst, xuwLoop, INCLUDED);
+            xulSum += xulValue;
+        }
     }
 
+    STATS_ADD(sulNodes, xuwLoop);
+
     // Save the initial solution for reference
 
-    zptInst->sulInitialSol = Subset_Sum_GetSum(zptInst);
+    zptInst->sulInitialSol = xulSum;
+    Subset_Sum_Publish(zptInst);
     
     // Improve the solution if time remains
     
-    P5__1OPT(zptInst);
+    P5__1OPT(zptInst, &xtDeadline);
 }
 
 /**************************************************************************//**
@@ -227,50 +485,73 @@ SUBSETSUM_ALGORITHM(P5_Greedy)
 ******************************************************************************/
 SUBSETSUM_ALGORITHM(P5_Random)
 {
+    const Subset_Sum_Input_t * xptInput = zptInst->sptInput;
     uint32_t xuwLoop;
-    uint64_t xulTempSum = 0u;
+    uint64_t xulSum = 0u;
+    uint64_t xulValue;
+    Deadline_t xtDeadline;
     int xwRand;
 
-    // Clear all selections
+    // The limit covers the whole solve, construction included
 
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    Deadline_Start(&xtDeadline, zptInst->sulTimeLimit);
+    P5__Phase(PERF_CONSTRUCT);
+
+    // After an edit, improve the carried over solution instead
+
+    if (P5__Warm(zptInst) == true)
     {
-        Subset_Sum_Select(zptInst, xuwLoop, EXCLUDED);
+        P5__1OPT(zptInst, &xtDeadline);
+
+        return;
     }
+
+    // Clear all selections
+
+    Subset_Sum_Clear(zptInst);
     
     // Loop through the set, randomly adding any element that is legal
     
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    for(xuwLoop = 0u; xuwLoop < xptInput->suwSize; xuwLoop++)
     {
-        // If the instance is solved, stop
+        // If the instance is solved, time is up or we were told to stop,
+        // stop
         
-        if (Subset_Sum_GetSum(zptInst) == zptInst->sulTarget)
+        if ((xulSum == xptInput->sulTarget) ||
+            (Deadline_Expired(&xtDeadline) == true) ||
+            (Subset_Sum_Cancelled(zptInst) == true))
         {
             
             break;
         }
         
         // Attempt to randomly add the next element if it is legal. If not,
-        // ignore it.
+        // ignore it. The sum is kept as we go, see P5_Greedy.
         
-        xulTempSum = 
-            Subset_Sum_GetSum(zptInst) + zptInst->sauwInputSet[xuwLoop];
+        xulValue = SUBSETSUM_VALUE(xptInput, xuwLoop);
         
-        if(xulTempSum <= zptInst->sulTarget)
+        if (xulValue <= (xptInput->sulTarget - xulSum))
         {
             xwRand = rand() % 2;  // Pseudo random 0 or 1
             
-            zptInst->saucSolution[xuwLoop] = (xwRand > 0) ? INCLUDED : EXCLUDED;
+            if (xwRand > 0)
+            {
+                Subset_Sum_Select(zptInst, xuwLoop, INCLUDED);
+                xulSum += xulValue;
+            }
         }
     }
 
+    STATS_ADD(sulNodes, xuwLoop);
+
     // Save the initial solution for reference
 
-    zptInst->sulInitialSol = Subset_Sum_GetSum(zptInst);
+    zptInst->sulInitialSol = xulSum;
+    Subset_Sum_Publish(zptInst);
 
     // Improve the solution if time remains
     
-    P5__1OPT(zptInst);
+    P5__1OPT(zptInst, &xtDeadline);
 }
 
 /**************************************************************************//**
@@ -290,47 +571,70 @@ SUBSETSUM_ALGORITHM(P5_Random)
 ******************************************************************************/
 SUBSETSUM_ALGORITHM(P5_Tabu)
 {
+    const Subset_Sum_Input_t * xptInput = zptInst->sptInput;
     uint32_t xuwLoop;
-    uint64_t xulTempSum = 0u;
+    uint64_t xulSum = 0u;
+    uint64_t xulValue;
+    Deadline_t xtDeadline;
 
-    // Clear all selections
+    // The limit covers the whole solve, construction included
 
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    Deadline_Start(&xtDeadline, zptInst->sulTimeLimit);
+    P5__Phase(PERF_CONSTRUCT);
+
+    // After an edit, improve the carried over solution instead
+
+    if (P5__Warm(zptInst) == true)
     {
-        Subset_Sum_Select(zptInst, xuwLoop, EXCLUDED);
+        P5__1OPT_Tabu(zptInst, &xtDeadline);
+
+        return;
     }
+
+    // Clear all selections
+
+    Subset_Sum_Clear(zptInst);
     
     // Loop through the set, adding any element that is legal
     // TBD - Sorted?
     // TBD - Smallest first? Largest first?
     
-    for(xuwLoop = 0u; xuwLoop < zptInst->suwSize; xuwLoop++)
+    for(xuwLoop = 0u; xuwLoop < xptInput->suwSize; xuwLoop++)
     {
-        // If the instance is solved, stop
+        // If the instance is solved, time is up or we were told to stop,
+        // stop
         
-        if (Subset_Sum_GetSum(zptInst) == zptInst->sulTarget)
+        if ((xulSum == xptInput->sulTarget) ||
+            (Deadline_Expired(&xtDeadline) == true) ||
+            (Subset_Sum_Cancelled(zptInst) == true))
         {
             
             break;
         }
         
         // Attempt to add the next element if it is legal. If not,
-        // ignore it.
+        // ignore it. The sum is kept as we go, summing the solution
+        // for every element would make this O(n^2).
         
-        xulTempSum = 
-            Subset_Sum_GetSum(zptInst) + zptInst->sauwInputSet[xuwLoop];
+        xulValue = SUBSETSUM_VALUE(xptInput, xuwLoop);
         
-        zptInst->saucSolution[xuwLoop] = 
-            (xulTempSum <= zptInst->sulTarget) ? INCLUDED : EXCLUDED;
+        if (xulValue <= (xptInput->sulTarget - xulSum))
+        {
+            Subset_Sum_Select(zptInst, xuwLoop, INCLUDED);
+            xulSum += xulValue;
+        }
     }
 
+    STATS_ADD(sulNodes, xuwLoop);
+
     // Save the initial solution for reference
 
-    zptInst->sulInitialSol = Subset_Sum_GetSum(zptInst);
+    zptInst->sulInitialSol = xulSum;
+    Subset_Sum_Publish(zptInst);
     
     // Improve the solution if time remains
 	
-    P5__1OPT_Tabu(zptInst);
+    P5__1OPT_Tabu(zptInst, &xtDeadline);
 }
 
 // \}
@@ -353,92 +657,72 @@ SUBSETSUM_ALGORITHM(P5_Tabu)
 *              elements.
 *
 * \param[in]   zptInst            Instance to solve
+* \param[in]   zptDeadline        Started when the solver was, the time
+*                                 reported is from then on
 *
 * \retval      void
 *
 ******************************************************************************/
 
-static void P5__1OPT(Subset_Sum_t * zptInst)
+static void P5__1OPT(Subset_Sum_t * zptInst, Deadline_t * zptDeadline)
 {
+    const Subset_Sum_Input_t * xptInput = zptInst->sptInput;
     uint32_t xuwLoop, xuwIndex;
-    uint64_t xuwTempSum = 0u;
-    time_t xtStartTime, xtCurrTime;
+    uint64_t xulSum = Subset_Sum_GetSum(zptInst);
     bool xbDone = false;
     
-    // Start the timer
-
-    xtStartTime = time(NULL);
-    xtCurrTime = 0u;
+    P5__Phase(PERF_SEARCH);
     
-	while((Subset_Sum_GetSum(zptInst) != zptInst->sulTarget) &&
-	  (xtCurrTime < muwTimeLimit) &&
-	  (xbDone == false))
+	while((xulSum != xptInput->sulTarget) &&
+	  (Deadline_Check(zptDeadline) == false) &&
+	  (xbDone == false) &&
+	  (Subset_Sum_Cancelled(zptInst) == false))
 	{
 		
-		// Scan for an incuded element to exclude
+		// Scan the included elements for one to exclude. If none of
+		// them can be improved this is a local optimum and we are done.
 		
-		for (xuwIndex = 0; xuwIndex < zptInst->suwSize; xuwIndex++)
+		xbDone = true;
+		
+		for (xuwIndex = Subset_Sum_NextIncluded(zptInst, 0u);
+		     xuwIndex < xptInput->suwSize;
+		     xuwIndex = Subset_Sum_NextIncluded(zptInst, xuwIndex + 1u))
 		{
+			// Every index is a full scan of the set, so check the clock
+			// and the other solvers before each one, not once per pass
 			
-			if (zptInst->saucSolution[xuwIndex] == INCLUDED)
+			if ((Deadline_Check(zptDeadline) == true) ||
+			    (Subset_Sum_Cancelled(zptInst) == true))
 			{
-				// Determine the initial "best"
-				
-				xuwTempSum = Subset_Sum_GetSum(zptInst);
-				
-				// Scan for an excluded element to include
-				
-				for (xuwLoop = 0; xuwLoop < zptInst->suwSize; xuwLoop++)
-				{
-					
-					// Test any possible swap candidates for a better solution
-					
-					if ((zptInst->saucSolution[xuwLoop] == EXCLUDED) && 
-						(xuwLoop != xuwIndex))
-					{
-						
-						// If the candidate yields a better solution, improve it and reset the
-						// search
-						
-						if ((zptInst->sauwInputSet[xuwIndex] < zptInst->sauwInputSet[xuwLoop]) &&
-						    (xuwTempSum - zptInst->sauwInputSet[xuwIndex] + zptInst->sauwInputSet[xuwLoop]) <= zptInst->sulTarget)
-						{
-								zptInst->saucSolution[xuwIndex] = EXCLUDED;
-								zptInst->saucSolution[xuwLoop] = INCLUDED;
-								
-								xbDone = true;
-								break;
-						}
-					}
-				}
+				break;
 			}
 			
-			// Update the elapsed time
-
-            xtCurrTime = time(NULL) - xtStartTime;
+			// Score every excluded element as a replacement and take
+			// the best one. If it yields a better solution, improve it
+			// and reset the search
 			
-			// If a better solution was found, reset outter loop as well.
+			xuwLoop = Subset_Sum_FindSwap(zptInst, xuwIndex, xulSum, NULL);
 			
-			if (xbDone == true)
+			if (xuwLoop < xptInput->suwSize)
 			{
+				Subset_Sum_Select(zptInst, xuwIndex, EXCLUDED);
+				Subset_Sum_Select(zptInst, xuwLoop, INCLUDED);
+				xulSum = xulSum - SUBSETSUM_VALUE(xptInput, xuwIndex) + 
+				                    SUBSETSUM_VALUE(xptInput, xuwLoop);
+				Subset_Sum_Publish(zptInst);
+				
+				// A better solution was found, reset the outer loop
+				
+				STATS_ADD(sulRestarts, 1u);
 				xbDone = false;
 				break;
 			}
-			
-			// If we have made it to the last element and no better set was found,
-			// this is a local optimum and we are done.
-			
-			if (xuwIndex == (zptInst->suwSize - 1u))
-			{
-				xbDone = true;
-				break;
-			}
 		}
 	}
 	
-	// Update the total elapsed time
+	// Update the total elapsed time, from the start of the solver
 
-    zptInst->suwTime = xtCurrTime;
+    zptInst->sulTime = Deadline_Elapsed(zptDeadline);
 }
 
 /**************************************************************************//**
@@ -450,116 +734,1083 @@ static void P5__1OPT(Subset_Sum_t * zptInst)
 *
 * \details     Improves an instance of Subset Sum by swapping any valid
 *              elements. Keeps a tabu list of swaps to avoid testing bad
-*			   swaps
+*			   swaps: a pair swapped once is not swapped again, in either
+*			   direction, while it is among the last n swaps. The list is
+*			   a ring of those pairs, linked per element oldest first so
+*			   the pair the ring drops is always at the head of its
+*			   elements' lists. Before scoring an element its partners
+*			   are set in a packed skip row, which Subset_Sum_FindSwap
+*			   ignores, and cleared again after. O(n) memory, O(partners)
+*			   per element scored.
 *
 * \param[in]   zptInst            Instance to solve
+* \param[in]   zptDeadline        Started when the solver was, the time
+*                                 reported is from then on
 *
 * \retval      void
 *
 ******************************************************************************/
 
-static void P5__1OPT_Tabu(Subset_Sum_t * zptInst)
+static void P5__1OPT_Tabu(Subset_Sum_t * zptInst, Deadline_t * zptDeadline)
 {
-   uint32_t xuwLoop, xuwIndex;
-   uint64_t xuwTempSum = 0u;
-   time_t xtStartTime, xtCurrTime;
+    const Subset_Sum_Input_t * xptInput = zptInst->sptInput;
+   uint32_t xuwLoop, xuwIndex, xuwEntry, xuwOwner, xuwSide;
+   uint64_t xulSum = Subset_Sum_GetSum(zptInst);
    bool xbDone = false;
-	bool xaabList[100u][100u]; 	// Use current largest dimensions 
+	uint32_t xuwRow = SUBSETSUM_WORDS(xptInput->suwSize);
+	uint32_t xuwEntries = 2u * xptInput->suwSize;
+	size_t xulBytes = (xuwRow * sizeof(uint64_t)) + 
+	                    ((size_t)6u * xptInput->suwSize * sizeof(uint32_t));
+	uint64_t * xaulSkip = NULL;
+	uint32_t * xauwHead;            // Oldest entry of each element's list
+	uint32_t * xauwTail;            // Newest entry of each element's list
+	uint32_t * xauwPartner;         // Entry 2k and 2k + 1 are one pair,
+	uint32_t * xauwNext;            // each is in one element's list
+	uint32_t xuwRing = 0u;          // Next pair of entries to write
+	bool xbFull = false;
+	bool xbHeap = false;
 	
-	// Initialize tabu list
+	P5__Phase(PERF_SEARCH);
 	
-	for (xuwIndex = 0; xuwIndex < 100; xuwIndex++)
-	{	
-			for (xuwLoop = 0; xuwLoop < 100; xuwLoop++)
-			{
-				xaabList[xuwIndex][xuwLoop] = false;
-			}
+	// Initialize tabu list, the skip row followed by the list heads, tails
+	// and the ring. From the scratch arena if there is one and it has
+	// room, otherwise from the heap. Only ring entries already written are
+	// ever read.
+	
+	if (zptInst->sptArena != NULL)
+	{
+		xaulSkip = (uint64_t *)Arena_Alloc(zptInst->sptArena, xulBytes, 
+		                                            ARENA_CACHE_LINE);
 	}
+	
+	if (xaulSkip == NULL)
+	{
+		xaulSkip = (uint64_t *)malloc(xulBytes);
+		xbHeap = true;
+	}
+	
+	if (xaulSkip == NULL)
+	{
+		// Without a list this is the plain 1OPT search
+		
+		P5__1OPT(zptInst, zptDeadline);
+		
+		return;
+	}
+	
+	xauwHead = (uint32_t *)&xaulSkip[xuwRow];
+	xauwTail = &xauwHead[xptInput->suwSize];
+	xauwPartner = &xauwTail[xptInput->suwSize];
+	xauwNext = &xauwPartner[xuwEntries];
+	memset(xaulSkip, 0, xuwRow * sizeof(uint64_t));
+	memset(xauwHead, 0xFF, 2u * (size_t)xptInput->suwSize * sizeof(uint32_t));
     
-    // Start the timer
-
-    xtStartTime = time(NULL);
-    xtCurrTime = 0u;
-    
-	while((Subset_Sum_GetSum(zptInst) != zptInst->sulTarget) &&
-	  (xtCurrTime < muwTimeLimit) &&
-	  (xbDone == false))
+	while((xulSum != xptInput->sulTarget) &&
+	  (Deadline_Check(zptDeadline) == false) &&
+	  (xbDone == false) &&
+	  (Subset_Sum_Cancelled(zptInst) == false))
 	{
 		
-		// Scan for an incuded element to exclude
+		// Scan the included elements for one to exclude. If none of
+		// them can be improved this is a local optimum and we are done.
 		
-		for (xuwIndex = 0; xuwIndex < zptInst->suwSize; xuwIndex++)
+		xbDone = true;
+		
+		for (xuwIndex = Subset_Sum_NextIncluded(zptInst, 0u);
+		     xuwIndex < xptInput->suwSize;
+		     xuwIndex = Subset_Sum_NextIncluded(zptInst, xuwIndex + 1u))
 		{
+			// Every index is a full scan of the set, so check the clock
+			// and the other solvers before each one, not once per pass
 			
-			if (zptInst->saucSolution[xuwIndex] == INCLUDED)
+			if ((Deadline_Check(zptDeadline) == true) ||
+			    (Subset_Sum_Cancelled(zptInst) == true))
 			{
-				// Determine the initial "best"
-				
-				xuwTempSum = Subset_Sum_GetSum(zptInst);
+				break;
+			}
+			
+			// Score every excluded element as a replacement, ignoring
+			// candidates that have been swapped with this one before
+			// (tabu), and take the best one. If it yields a better
+			// solution, improve it and reset the search
+			
+			for (xuwEntry = xauwHead[xuwIndex]; xuwEntry != P5_TABU_NONE;
+			                            xuwEntry = xauwNext[xuwEntry])
+			{
+				xaulSkip[xauwPartner[xuwEntry] >> 6] |= 
+				                    1ull << (xauwPartner[xuwEntry] & 63u);
+			}
+			
+			xuwLoop = Subset_Sum_FindSwap(zptInst, xuwIndex, xulSum, 
+			                                                    xaulSkip);
+			
+			for (xuwEntry = xauwHead[xuwIndex]; xuwEntry != P5_TABU_NONE;
+			                            xuwEntry = xauwNext[xuwEntry])
+			{
+				xaulSkip[xauwPartner[xuwEntry] >> 6] = 0u;
+			}
+			
+			if (xuwLoop < xptInput->suwSize)
+			{
+				Subset_Sum_Select(zptInst, xuwIndex, EXCLUDED);
+				Subset_Sum_Select(zptInst, xuwLoop, INCLUDED);
+				xulSum = xulSum - SUBSETSUM_VALUE(xptInput, xuwIndex) + 
+				                    SUBSETSUM_VALUE(xptInput, xuwLoop);
+				Subset_Sum_Publish(zptInst);
 				
-				// Scan for an excluded element to include
+				// Once the ring is full, forget its oldest pair. Each of
+				// its entries heads its owner's list, the owner being the
+				// other entry's partner
 				
-				for (xuwLoop = 0; xuwLoop < zptInst->suwSize; xuwLoop++)
+				for (xuwSide = 0u; (xbFull == true) && (xuwSide < 2u); 
+				                                                xuwSide++)
 				{
+					xuwEntry = xuwRing + xuwSide;
+					xuwOwner = xauwPartner[xuwEntry ^ 1u];
+					xauwHead[xuwOwner] = xauwNext[xuwEntry];
 					
-					// If the candidates have been swapped before (tabu) ignore them
-					
-					if (xaabList[xuwIndex][xuwLoop] == true)
+					if (xauwHead[xuwOwner] == P5_TABU_NONE)
 					{
-						continue;
+						xauwTail[xuwOwner] = P5_TABU_NONE;
 					}
+				}
+				
+				// Then add the pair to both its elements' lists
+				
+				xauwPartner[xuwRing] = xuwLoop;
+				xauwPartner[xuwRing + 1u] = xuwIndex;
+				
+				for (xuwSide = 0u; xuwSide < 2u; xuwSide++)
+				{
+					xuwEntry = xuwRing + xuwSide;
+					xuwOwner = xauwPartner[xuwEntry ^ 1u];
+					xauwNext[xuwEntry] = P5_TABU_NONE;
 					
-					// Test any possible swap candidates for a better solution
-					
-					if ((zptInst->saucSolution[xuwLoop] == EXCLUDED) && 
-						(xuwLoop != xuwIndex))
+					if (xauwTail[xuwOwner] == P5_TABU_NONE)
+					{
+						xauwHead[xuwOwner] = xuwEntry;
+					}
+					else
 					{
-						
-						// If the candidate yields a better solution, improve it and reset the
-						// search
-						
-						if ((zptInst->sauwInputSet[xuwIndex] < zptInst->sauwInputSet[xuwLoop]) &&
-						    (xuwTempSum - zptInst->sauwInputSet[xuwIndex] + zptInst->sauwInputSet[xuwLoop]) <= zptInst->sulTarget)
-						{
-								zptInst->saucSolution[xuwIndex] = EXCLUDED;
-								zptInst->saucSolution[xuwLoop] = INCLUDED;
-								
-								xaabList[xuwIndex][xuwLoop] = true;
-								xaabList[xuwLoop][xuwIndex] = true;
-								
-								xbDone = true;
-								break;
-						}
+						xauwNext[xauwTail[xuwOwner]] = xuwEntry;
 					}
+					
+					xauwTail[xuwOwner] = xuwEntry;
 				}
-			}
-			
-			// Update the elapsed time
-
-            xtCurrTime = time(NULL) - xtStartTime;
-			
-			// If a better solution was found, reset outter loop as well.
-			
-			if (xbDone == true)
-			{
+				
+				xuwRing += 2u;
+				
+				if (xuwRing == xuwEntries)
+				{
+					xuwRing = 0u;
+					xbFull = true;
+				}
+				
+				// A better solution was found, reset the outer loop
+				
+				STATS_ADD(sulRestarts, 1u);
 				xbDone = false;
 				break;
 			}
-			
-			// If we have made it to the last element and no better set was found,
-			// this is a local optimum and we are done.
-			
-			if (xuwIndex == (zptInst->suwSize - 1u))
-			{
-				xbDone = true;
-				break;
-			}
 		}
 	}
 	
-	// Update the total elapsed time
+	// Update the total elapsed time, from the start of the solver
+
+    zptInst->sulTime = Deadline_Elapsed(zptDeadline);
+
+    if (xbHeap == true)
+    {
+        free(xaulSkip);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Warm
+*
+* \brief       Take a warm start if the instance has one
+*
+* \details     After Subset_Sum_SetTarget and friends the solution from
+*              before the edit is still there and fits the new target. The
+*              solvers then skip their construction and only run the local
+*              search, which just has to make up for the edit.
+*
+* \param[in]   zptInst            Instance to solve
+*
+* \retval      bool               true if the current solution is the start
+*
+******************************************************************************/
+
+static bool P5__Warm(Subset_Sum_t * zptInst)
+{
+    if (zptInst->sbWarm == false)
+    {
+        return false;
+    }
+
+    // An edit leaves the sum behind, a cache warm start does not
+
+    zptInst->sulInitialSol = (zptInst->sulSum != SUBSETSUM_UNKNOWN) ?
+                                zptInst->sulSum : Subset_Sum_GetSum(zptInst);
+    Subset_Sum_Publish(zptInst);
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Portfolio
+*
+* \brief       Run a set of registered solvers concurrently
+*
+* \details     Loads the input set once, attaches one problem per requested
+*              solver and hands them all to the portfolio, which runs them on
+*              parallel threads against a shared incumbent. Each solver's
+*              result is still written to its own output folder.
+*
+* \param[in]   zpsFilePath        Input file name
+* \param[in]   zpsSolvers         Comma separated solver names, NULL for all
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int P5__Portfolio(char * zpsFilePath, char * zpsSolvers)
+{
+    Subset_Sum_t xatProblems[P5_SOLVER_COUNT];
+    const Portfolio_Solver_t * xaptChosen[P5_SOLVER_COUNT];
+    const Portfolio_Solver_t * xptSolver;
+    Subset_Sum_Input_t * xptInput;
+    uint32_t xuwCount = 0u;
+    uint32_t xuwLoop;
+    uint64_t xulBest;
+    char * xpsName;
+
+    // Pick the solvers to run
+
+    if (zpsSolvers == NULL)
+    {
+        for (xuwLoop = 0u; xuwLoop < P5_SOLVER_COUNT; xuwLoop++)
+        {
+            xaptChosen[xuwCount++] = &matSolvers[xuwLoop];
+        }
+    }
+    else
+    {
+        for (xpsName = strtok(zpsSolvers, ","); xpsName != NULL;
+             xpsName = strtok(NULL, ","))
+        {
+            xptSolver = Portfolio_Find(matSolvers, P5_SOLVER_COUNT, xpsName);
+
+            if (xptSolver == NULL)
+            {
+                printf("Unknown solver: %s\n", xpsName);
+
+                return -1;
+            }
+
+            if (xuwCount < P5_SOLVER_COUNT)
+            {
+                xaptChosen[xuwCount++] = xptSolver;
+            }
+        }
+    }
+
+    // Load the input set once, every solver attaches to the same copy
+
+    xptInput = Subset_Sum_Load(zpsFilePath);
+
+    if (xptInput == NULL)
+    {
+        return -1;
+    }
+
+    for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+    {
+        if (Subset_Sum_Attach(&xatProblems[xuwLoop], xptInput) == false)
+        {
+            fprintf(stderr, "%s: out of memory\n", zpsFilePath);
+
+            // The failed one is left detached, freeing it does nothing
+
+            for (xuwCount = xuwLoop + 1u; xuwCount > 0u; xuwCount--)
+            {
+                Subset_Sum_Free(&xatProblems[xuwCount - 1u]);
+            }
+
+            Subset_Sum_Release(xptInput);
+
+            return -1;
+        }
+
+        Subset_Sum_SetSolver(&xatProblems[xuwLoop], 
+                                    xaptChosen[xuwLoop]->spfSolver);
+        Subset_Sum_SetTimeLimit(&xatProblems[xuwLoop], mulTimeLimit);
+    }
+
+    Subset_Sum_Release(xptInput);
+
+    // They run at the same time, every one needs its own arena
+
+    P5__Arenas_Start(xuwCount);
+
+    for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+    {
+        Subset_Sum_SetArena(&xatProblems[xuwLoop], &matArenas[xuwLoop]);
+    }
+
+    // Solve them all at once
+
+    xulBest = Portfolio_Run(xatProblems, xuwCount);
+    printf("%s Portfolio solved, best %llu\r\n", zpsFilePath, 
+                                    (unsigned long long)xulBest);
+    printf("%s Scratch peak %zu bytes\r\n", zpsFilePath, P5__Arenas_Stop());
+
+    // Write outfiles and cleanup
+
+    for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+    {
+        sprintf(mnOutFldr, "%s", xaptChosen[xuwLoop]->spsName);
+        Subset_SumWriteData(&xatProblems[xuwLoop], mnOutFldr);
+        Subset_Sum_Free(&xatProblems[xuwLoop]);
+    }
+
+    return 0;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Auto
+*
+* \brief       Solve with what the cost model picks for the instance
+*
+* \details     A single pick runs on this thread with the arena, a
+*              portfolio on one thread per solver from the heap. With a
+*              result cache each pick is cached under its own name, the
+*              same entries as the plain mode.
+*
+* \param[in]   zpsFilePath        Input file name
+* \param[in]   zpsMemory          Memory budget, NULL for none
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int P5__Auto(char * zpsFilePath, char * zpsMemory)
+{
+    const Portfolio_Solver_t * xptSolver;
+    Subset_Sum_Input_t * xptInput;
+    Subset_Sum_t xtProblem;
+    uint64_t xulMemory = 0u;
+
+    if ((zpsMemory != NULL) && 
+        (Select_Parse_Memory(zpsMemory, &xulMemory) == false))
+    {
+        printf("Invalid memory budget: %s\n", zpsMemory);
+
+        return -1;
+    }
+
+    xptInput = Subset_Sum_Load(zpsFilePath);
+
+    if (xptInput == NULL)
+    {
+        return -1;
+    }
+
+    if (Subset_Sum_Attach(&xtProblem, xptInput) == false)
+    {
+        fprintf(stderr, "%s: out of memory\n", zpsFilePath);
+        Subset_Sum_Release(xptInput);
+
+        return -1;
+    }
+
+    P5__Arenas_Start(1u);
+
+    Subset_Sum_SetTimeLimit(&xtProblem, mulTimeLimit);
+    Subset_Sum_SetArena(&xtProblem, &matArenas[0u]);
+    Subset_Sum_SetCache(&xtProblem, "p5.auto");
+    Subset_Sum_Release(xptInput);
+
+    xptSolver = Select_Solve(&xtProblem, matSolvers, P5_SOLVER_COUNT, "p5.",
+                                                                xulMemory);
+
+    if (xptSolver == NULL)
+    {
+        printf("%s No solver has a cost model\r\n", zpsFilePath);
+        Subset_Sum_Free(&xtProblem);
+        P5__Arenas_Stop();
+
+        return -1;
+    }
+
+    printf("%s Auto solved with %s\r\n", zpsFilePath, xptSolver->spsName);
+    sprintf(mnOutFldr, "%s", xptSolver->spsName);
+    Subset_SumWriteData(&xtProblem, mnOutFldr);
+    Subset_Sum_Free(&xtProblem);
+
+    printf("%s Scratch peak %zu bytes\r\n", zpsFilePath, P5__Arenas_Stop());
+
+    return 0;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Batch
+*
+* \brief       Solve a whole directory or manifest of instances
+*
+* \details     Every instance is loaded and solved by all registered solvers
+*              on one of the pool's threads. The results are kept in memory
+*              and written out in a single pass at the end, in the same
+*              folders as the one-instance mode or all to one output.
+*
+* \param[in]   zpsSource          Instance directory or manifest
+* \param[in]   zuwThreads         Pool size, 0 for one per CPU
+* \param[in]   zpsOutput          File for all results, "-" for stdout,
+*                                 NULL for one file per result
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int P5__Batch(char * zpsSource, uint32_t zuwThreads, 
+                                                    char * zpsOutput)
+{
+    P5__Result_t * xatResults;
+    Sink_t xtSink;
+    char ** xapsPaths;
+    uint32_t xuwCount;
+    uint32_t xuwDone = 0u;
+    uint32_t xuwLoop, xuwSolver;
+    size_t xulPeak;
+    int xiFailed = 0;
+
+    if (Batch_Collect(zpsSource, &xapsPaths, &xuwCount) == false)
+    {
+        return -1;
+    }
+
+    if ((zpsOutput != NULL) && (Sink_Open(&xtSink, zpsOutput) == false))
+    {
+        Batch_Free(xapsPaths, xuwCount);
+
+        return -1;
+    }
+
+    xatResults = (P5__Result_t *)calloc(xuwCount, sizeof(P5__Result_t));
+
+    if (xatResults == NULL)
+    {
+        fprintf(stderr, "Out of memory for %u results\n", xuwCount);
+
+        if (zpsOutput != NULL)
+        {
+            Sink_Close(&xtSink);
+        }
+
+        Batch_Free(xapsPaths, xuwCount);
+
+        return -1;
+    }
+
+    // Nothing ran if the pool could not be set up, every result stays
+    // unsolved
+
+    P5__Arenas_Start(Batch_Threads(zuwThreads, xuwCount));
+    Batch_Run(xapsPaths, xuwCount, zuwThreads, P5__Batch_Job, xatResults);
+    xulPeak = P5__Arenas_Stop();
+
+    // Write everything out
+
+    for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+    {
+        if (xatResults[xuwLoop].sbSolved == false)
+        {
+            xiFailed = -1;
+            continue;
+        }
+
+        xuwDone++;
+
+        for (xuwSolver = 0u; xuwSolver < P5_SOLVER_COUNT; xuwSolver++)
+        {
+            P5__Write(&xatResults[xuwLoop].satProblems[xuwSolver], xuwSolver,
+                                (zpsOutput != NULL) ? &xtSink : NULL);
+            Subset_Sum_Free(&xatResults[xuwLoop].satProblems[xuwSolver]);
+        }
+    }
+
+    if ((zpsOutput != NULL) && (Sink_Close(&xtSink) == false))
+    {
+        fprintf(stderr, "Could not write all results to %s\n", zpsOutput);
+        xiFailed = -1;
+    }
+
+    fprintf(stderr, "%u of %u instances solved\n", xuwDone, xuwCount);
+    fprintf(stderr, "Scratch peak %zu bytes per thread\n", xulPeak);
+
+    free(xatResults);
+    Batch_Free(xapsPaths, xuwCount);
+
+    return xiFailed;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Batch_Job
+*
+* \brief       Solve one batch instance with every solver
+*
+* \param[in]   zuwIndex           Instance number
+* \param[in]   zpsPath            Instance file
+* \param[in]   zpvContext         P5__Result_t array
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void P5__Batch_Job(uint32_t zuwIndex, char * zpsPath, void * zpvContext)
+{
+    P5__Result_t * xptResult = &((P5__Result_t *)zpvContext)[zuwIndex];
+    Subset_Sum_Input_t * xptInput;
+
+    xptInput = Subset_Sum_Load(zpsPath);
+
+    if (xptInput == NULL)
+    {
+        return;
+    }
+
+    if (P5__Solve_All(xptResult, xptInput, mulTimeLimit) == true)
+    {
+        fprintf(stderr, "%s solved\n", zpsPath);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Solve_All
+*
+* \brief       Run every solver on one loaded instance
+*
+* \details     Called on a pool thread, the solvers use that thread's arena.
+*              Without memory for every solver none of them runs and the
+*              instance stays unsolved.
+*
+* \param[in]   zptResult          Where the problems are kept
+* \param[in]   zptInput           Input set, released here
+* \param[in]   zulTimeLimit       Time limit of each solver, ns
+*
+* \retval      bool               false if out of memory
+*
+******************************************************************************/
+
+static bool P5__Solve_All(P5__Result_t * zptResult, 
+                    Subset_Sum_Input_t * zptInput, uint64_t zulTimeLimit)
+{
+    uint32_t xuwSolver;
+    char xacCache[48];
+
+    for (xuwSolver = 0u; xuwSolver < P5_SOLVER_COUNT; xuwSolver++)
+    {
+        snprintf(xacCache, sizeof(xacCache), "p5.%s", 
+                                        matSolvers[xuwSolver].spsName);
+
+        if (Subset_Sum_Attach(&zptResult->satProblems[xuwSolver], 
+                                                        zptInput) == false)
+        {
+            fprintf(stderr, "%s: out of memory\n", zptInput->sacName);
+
+            // The failed one is left detached, freeing it does nothing
+
+            for (xuwSolver++; xuwSolver > 0u; xuwSolver--)
+            {
+                Subset_Sum_Free(&zptResult->satProblems[xuwSolver - 1u]);
+            }
+
+            Subset_Sum_Release(zptInput);
+
+            return false;
+        }
+
+        Subset_Sum_SetSolver(&zptResult->satProblems[xuwSolver], 
+                                        matSolvers[xuwSolver].spfSolver);
+        Subset_Sum_SetTimeLimit(&zptResult->satProblems[xuwSolver], 
+                                                            zulTimeLimit);
+        Subset_Sum_SetArena(&zptResult->satProblems[xuwSolver], 
+                                                &matArenas[Batch_Worker()]);
+        Subset_Sum_SetCache(&zptResult->satProblems[xuwSolver], xacCache);
+    }
+
+    Subset_Sum_Release(zptInput);
+
+    for (xuwSolver = 0u; xuwSolver < P5_SOLVER_COUNT; xuwSolver++)
+    {
+        Subset_Sum_Solve(&zptResult->satProblems[xuwSolver]);
+    }
+
+    zptResult->sbSolved = true;
+
+    return true;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Budget
+*
+* \brief       Solve a directory or manifest within one total time budget
+*
+* \details     Loads every instance first to weigh it (Batch_Weight from its
+*              size and bit width), then solves them lightest first. Each
+*              instance gets its share of the budget that is left when it
+*              starts, split evenly between the solvers, so whatever the
+*              easy ones do not use goes to the hard ones. Results are
+*              written out at the end like batch mode.
+*
+* \param[in]   zpsSource          Instance directory or manifest
+* \param[in]   zuwThreads         Pool size, 0 for one per CPU
+* \param[in]   zpsOutput          File for all results, "-" for stdout,
+*                                 NULL for one file per result
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int P5__Budget(char * zpsSource, uint32_t zuwThreads, 
+                                                    char * zpsOutput)
+{
+    P5__Result_t * xatResults;
+    P5__Budget_t xtBudget;
+    Sink_t xtSink;
+    char ** xapsPaths;
+    char ** xapsOrder;
+    uint64_t xulWeight = 0u;
+    uint64_t xulStart;
+    uint32_t xuwCount;
+    uint32_t xuwSolved = 0u;
+    uint32_t xuwLoop, xuwSolver;
+    size_t xulPeak;
+    int xiFailed = 0;
+
+    if (Batch_Collect(zpsSource, &xapsPaths, &xuwCount) == false)
+    {
+        return -1;
+    }
+
+    if ((zpsOutput != NULL) && (Sink_Open(&xtSink, zpsOutput) == false))
+    {
+        Batch_Free(xapsPaths, xuwCount);
+
+        return -1;
+    }
+
+    xatResults = (P5__Result_t *)calloc(xuwCount, sizeof(P5__Result_t));
+    xtBudget.saptOrder = (P5__Result_t **)calloc(xuwCount, 
+                                                sizeof(P5__Result_t *));
+    xapsOrder = (char **)calloc(xuwCount, sizeof(char *));
+
+    if ((xatResults == NULL) || (xtBudget.saptOrder == NULL) || 
+        (xapsOrder == NULL))
+    {
+        fprintf(stderr, "Out of memory for %u results\n", xuwCount);
+
+        if (zpsOutput != NULL)
+        {
+            Sink_Close(&xtSink);
+        }
+
+        free(xapsOrder);
+        free(xtBudget.saptOrder);
+        free(xatResults);
+        Batch_Free(xapsPaths, xuwCount);
+
+        return -1;
+    }
+
+    // Load and weigh everything, the loading counts against the budget too.
+    // If the pool cannot be set up nothing loads and every result stays
+    // unsolved.
+
+    xulStart = Deadline_Now();
+
+    Batch_Run(xapsPaths, xuwCount, zuwThreads, P5__Budget_Load, xatResults);
+
+    for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+    {
+        xulWeight += xatResults[xuwLoop].sulWeight;
+        xtBudget.saptOrder[xuwLoop] = &xatResults[xuwLoop];
+    }
+
+    // Lightest first, the queues hand them out in this order
+
+    qsort(xtBudget.saptOrder, xuwCount, sizeof(P5__Result_t *), 
+                                                    P5__Budget_Compare);
+
+    for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+    {
+        xapsOrder[xuwLoop] = xapsPaths[xtBudget.saptOrder[xuwLoop] - xatResults];
+    }
+
+    xulStart = Deadline_Now() - xulStart;
+
+    // As many threads as the pool really has, fewer than asked for if
+    // there are fewer instances
+
+    Batch_Budget_Start(&xtBudget.stBudget, 
+            (mulTimeLimit > xulStart) ? (mulTimeLimit - xulStart) : 0u,
+            Batch_Threads(zuwThreads, xuwCount), xulWeight);
+
+    P5__Arenas_Start(Batch_Threads(zuwThreads, xuwCount));
+    Batch_Run(xapsOrder, xuwCount, zuwThreads, P5__Budget_Job, &xtBudget);
+    xulPeak = P5__Arenas_Stop();
+
+    // Every job drops its input, anything left was never solved
+
+    for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+    {
+        if (xatResults[xuwLoop].sptInput != NULL)
+        {
+            Subset_Sum_Release(xatResults[xuwLoop].sptInput);
+        }
+    }
+
+    // Write everything out
+
+    for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+    {
+        if (xatResults[xuwLoop].sbSolved == false)
+        {
+            xiFailed = -1;
+            continue;
+        }
+
+        for (xuwSolver = 0u; xuwSolver < P5_SOLVER_COUNT; xuwSolver++)
+        {
+            if (Subset_Sum_GetSum(&xatResults[xuwLoop].satProblems[xuwSolver]) 
+                        == xatResults[xuwLoop].satProblems[xuwSolver].
+                                                    sptInput->sulTarget)
+            {
+                xuwSolved++;
+                break;
+            }
+        }
+
+        for (xuwSolver = 0u; xuwSolver < P5_SOLVER_COUNT; xuwSolver++)
+        {
+            P5__Write(&xatResults[xuwLoop].satProblems[xuwSolver], xuwSolver,
+                                (zpsOutput != NULL) ? &xtSink : NULL);
+            Subset_Sum_Free(&xatResults[xuwLoop].satProblems[xuwSolver]);
+        }
+    }
+
+    if ((zpsOutput != NULL) && (Sink_Close(&xtSink) == false))
+    {
+        fprintf(stderr, "Could not write all results to %s\n", zpsOutput);
+        xiFailed = -1;
+    }
+
+    fprintf(stderr, "%u of %u instances hit the target\n", xuwSolved, 
+                                                                xuwCount);
+    fprintf(stderr, "Scratch peak %zu bytes per thread\n", xulPeak);
+
+    free(xapsOrder);
+    free(xtBudget.saptOrder);
+    free(xatResults);
+    Batch_Free(xapsPaths, xuwCount);
+
+    return xiFailed;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Budget_Load
+*
+* \brief       Load and weigh one budget mode instance
+*
+* \param[in]   zuwIndex           Instance number
+* \param[in]   zpsPath            Instance file
+* \param[in]   zpvContext         P5__Result_t array
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void P5__Budget_Load(uint32_t zuwIndex, char * zpsPath, 
+                                                    void * zpvContext)
+{
+    P5__Result_t * xptResult = &((P5__Result_t *)zpvContext)[zuwIndex];
+
+    xptResult->sptInput = Subset_Sum_Load(zpsPath);
+
+    if (xptResult->sptInput != NULL)
+    {
+        xptResult->sulWeight = Batch_Weight(xptResult->sptInput->suwSize, 
+                                    Subset_Sum_GetBits(xptResult->sptInput));
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Budget_Job
+*
+* \brief       Solve one budget mode instance in its share of the budget
+*
+* \param[in]   zuwIndex           Position in weight order
+* \param[in]   zpsPath            Instance file
+* \param[in]   zpvContext         P5__Budget_t
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void P5__Budget_Job(uint32_t zuwIndex, char * zpsPath, 
+                                                    void * zpvContext)
+{
+    P5__Budget_t * xptBudget = (P5__Budget_t *)zpvContext;
+    P5__Result_t * xptResult = xptBudget->saptOrder[zuwIndex];
+    Subset_Sum_Input_t * xptInput;
+    uint64_t xulSlice;
+
+    if (xptResult->sptInput == NULL)
+    {
+        return;
+    }
+
+    // The solvers run one after the other, each gets an equal part
+
+    xulSlice = Batch_Budget_Slice(&xptBudget->stBudget, xptResult->sulWeight);
+
+    xptInput = xptResult->sptInput;
+    xptResult->sptInput = NULL;
+
+    if (P5__Solve_All(xptResult, xptInput, 
+                                    xulSlice / P5_SOLVER_COUNT) == true)
+    {
+        fprintf(stderr, "%s solved, %.6f second slice\n", zpsPath, 
+                        (double)xulSlice / (double)DEADLINE_NS_PER_SEC);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Budget_Compare
+*
+* \brief       qsort order of budget mode instances, lightest first
+*
+* \param[in]   zpvLeft            P5__Result_t **
+* \param[in]   zpvRight           P5__Result_t **
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int P5__Budget_Compare(const void * zpvLeft, const void * zpvRight)
+{
+    const P5__Result_t * xptLeft = *(P5__Result_t * const *)zpvLeft;
+    const P5__Result_t * xptRight = *(P5__Result_t * const *)zpvRight;
+
+    if (xptLeft->sulWeight != xptRight->sulWeight)
+    {
+        return (xptLeft->sulWeight < xptRight->sulWeight) ? -1 : 1;
+    }
+
+    return (xptLeft < xptRight) ? -1 : (xptLeft > xptRight);
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Arenas_Start
+*
+* \brief       Set up the scratch arenas
+*
+* \details     An arena that cannot be mapped stays empty, the tabu list
+*              then comes from the heap.
+*
+* \param[in]   zuwCount           Solvers that run at the same time
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void P5__Arenas_Start(uint32_t zuwCount)
+{
+    uint32_t xuwLoop;
+
+    matArenas = (Arena_t *)calloc(zuwCount, sizeof(Arena_t));
+    muwArenas = (matArenas != NULL) ? zuwCount : 0u;
+
+    for (xuwLoop = 0u; xuwLoop < muwArenas; xuwLoop++)
+    {
+        Arena_Init(&matArenas[xuwLoop], P5_ARENA_RESERVE);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Arenas_Stop
+*
+* \brief       Free the scratch arenas
+*
+* \retval      size_t             Largest peak use of any of them, bytes
+*
+******************************************************************************/
+
+static size_t P5__Arenas_Stop(void)
+{
+    size_t xulPeak = 0u;
+    uint32_t xuwLoop;
+
+    for (xuwLoop = 0u; xuwLoop < muwArenas; xuwLoop++)
+    {
+        if (Arena_Peak(&matArenas[xuwLoop]) > xulPeak)
+        {
+            xulPeak = Arena_Peak(&matArenas[xuwLoop]);
+        }
+
+        Arena_Free(&matArenas[xuwLoop]);
+    }
+
+    free(matArenas);
+    matArenas = NULL;
+    muwArenas = 0u;
+
+    return xulPeak;
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Phase
+*
+* \brief       Mark the start of a solver phase
+*
+* \details     Counted by the profile of this thread, if it has one, and
+*              posted to the telemetry ring.
+*
+* \param[in]   zuwPhase           PERF_LOAD etc.
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void P5__Phase(uint32_t zuwPhase)
+{
+    Perf_Phase(zuwPhase);
+    Telemetry_Post(TELEMETRY_PHASE, zuwPhase);
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Write
+*
+* \brief       Write one batch result
+*
+* \details     To the solver's output folder, or as a record to the run's
+*              consolidated output if there is one.
+*
+* \param[in]   zptProblem         Solved problem
+* \param[in]   zuwSolver          Index of its solver in matSolvers
+* \param[in]   zptSink            Consolidated output, NULL for none
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void P5__Write(Subset_Sum_t * zptProblem, uint32_t zuwSolver,
+                                                    Sink_t * zptSink)
+{
+    if (zptSink != NULL)
+    {
+        Subset_Sum_WriteRecord(zptProblem, zptSink,
+                                        matSolvers[zuwSolver].spsName);
+
+        return;
+    }
+
+    sprintf(mnOutFldr, "%s", matSolvers[zuwSolver].spsName);
+    Subset_SumWriteData(zptProblem, mnOutFldr);
+}
+
+/**************************************************************************//**
+*
+* \anchor      P5__Profile
+*
+* \brief       Solve one instance with every solver under hardware counters
+*
+* \details     Same as the plain mode, but the calling thread is profiled
+*              (see Perf.c). Loading is reported on its own, then every
+*              solver's construction, local search and output. Everything
+*              runs on this thread, one solver at a time, so the counts of
+*              one solver are not mixed with another's.
+*
+* \param[in]   zpsFilePath        Input file name
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int P5__Profile(char * zpsFilePath)
+{
+    Subset_Sum_t xtProblem;
+    Subset_Sum_Input_t * xptInput;
+    Perf_t xtPerf;
+    uint32_t xuwLoop;
+    char xacLabel[512];
+    int xiResult = 0;
+
+    Perf_Open(&xtPerf);
+
+    P5__Phase(PERF_LOAD);
+
+    xptInput = Subset_Sum_Load(zpsFilePath);
+
+    if (xptInput == NULL)
+    {
+        Perf_Close(&xtPerf);
+
+        return -1;
+    }
+
+    snprintf(xacLabel, sizeof(xacLabel), "%s load", zpsFilePath);
+    Perf_Report(&xtPerf, stdout, xacLabel);
+
+    P5__Arenas_Start(1u);
+
+    for (xuwLoop = 0u; xuwLoop < P5_SOLVER_COUNT; xuwLoop++)
+    {
+        if (Subset_Sum_Attach(&xtProblem, xptInput) == false)
+        {
+            fprintf(stderr, "%s: out of memory\n", zpsFilePath);
+            xiResult = -1;
+            break;
+        }
+
+        Subset_Sum_SetSolver(&xtProblem, matSolvers[xuwLoop].spfSolver);
+        Subset_Sum_SetTimeLimit(&xtProblem, mulTimeLimit);
+        Subset_Sum_SetArena(&xtProblem, &matArenas[0u]);
+
+        Subset_Sum_Solve(&xtProblem);
+
+        P5__Phase(PERF_OUTPUT);
+
+        sprintf(mnOutFldr, "%s", matSolvers[xuwLoop].spsName);
+        Subset_SumWriteData(&xtProblem, mnOutFldr);
+        Subset_Sum_Free(&xtProblem);
+
+        snprintf(xacLabel, sizeof(xacLabel), "%s %s", zpsFilePath,
+                                            matSolvers[xuwLoop].spsName);
+        Perf_Report(&xtPerf, stdout, xacLabel);
+    }
+
+    Subset_Sum_Release(xptInput);
+
+    printf("%s Scratch peak %zu bytes\r\n", zpsFilePath, P5__Arenas_Stop());
+
+    Perf_Close(&xtPerf);
 
-    zptInst->suwTime = xtCurrTime;
+    return xiResult;
 }
 
 // \}
@@ -1,6 +1,5 @@
 #!/bin/bash
 
-for file in ../../instances/*
-do
-	./p5 "$file" 60
-done 
+# One process for all instances, one solver thread per CPU
+
+./p5 ../../instances 60 batch
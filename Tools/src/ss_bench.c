@@ -0,0 +1,675 @@
+/**************************************************************************//**
+*
+* \file        ss_bench.c
+*
+* \defgroup    ss_bench             Microbenchmarks
+*
+* \details     Times the operations the solvers are built from on the given
+*              instances, each on its own:
+*
+*                  load          Subset_Sum_Load and release of the file
+*                  getsum        Subset_Sum_GetSum of a half full selection
+*                  move          One Subset_Sum_FindSwap, the 1-OPT move
+*                                evaluation
+*                  greedy_step   One element decision of the P3/P5 greedy
+*                                construction, sum check included
+*                  random_step   The same for the P5 random construction
+*                  opt_scan      One 1-OPT neighbourhood scan of P5, a move
+*                                for every included element
+*                  exhaust_step  One subset of the P1 enumeration, increment
+*                                and sum
+*                  edit          One edit of a solved instance with its
+*                                repair, removing an element, adding it
+*                                back and moving the target in turn. What
+*                                it saves is a load and solve from scratch.
+*
+*              Every benchmark is calibrated to BM_SAMPLE_NS per sample and
+*              sampled several times. One CSV line per benchmark and
+*              instance goes to stdout with the distribution of the time per
+*              operation, for bench.py to collect and compare against its
+*              baseline.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <getopt.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+#include "Deadline.h"
+
+// ***** Definitions **********************************************************
+
+//! Default samples per benchmark, odd so there is a middle one
+
+#define BM_SAMPLES          31u
+
+//! A sample is at least this long, ns, so the clock does not dominate
+
+#define BM_SAMPLE_NS        2000000ull
+
+//! What every benchmark works on
+
+typedef struct BM__Context_s
+{
+    char * spsPath;
+    Subset_Sum_Input_t * sptInput;
+    Subset_Sum_t stProblem;
+    uint32_t suwNext;           // Where a step benchmark carries on
+    uint64_t sulSink;           // Results, so nothing is optimized away
+    Subset_Sum_t stEdited;      // The edit benchmark's own copy, attached
+                                // on first use
+    uint64_t sulRemoved;        // Value it took out last
+    uint32_t suwEdits;
+} BM__Context_t;
+
+//! Runs the given number of operations
+
+typedef void (*BM__Run_t)(BM__Context_t * zptContext, uint32_t zuwOps);
+
+typedef struct BM__Bench_s
+{
+    const char * spsName;
+    BM__Run_t spfRun;
+} BM__Bench_t;
+
+// ***** Local function prototypes ********************************************
+
+static void BM__Load (BM__Context_t * zptContext, uint32_t zuwOps);
+static void BM__GetSum (BM__Context_t * zptContext, uint32_t zuwOps);
+static void BM__Move (BM__Context_t * zptContext, uint32_t zuwOps);
+static void BM__Greedy_Step (BM__Context_t * zptContext, uint32_t zuwOps);
+static void BM__Random_Step (BM__Context_t * zptContext, uint32_t zuwOps);
+static void BM__Opt_Scan (BM__Context_t * zptContext, uint32_t zuwOps);
+static void BM__Exhaust_Step (BM__Context_t * zptContext, uint32_t zuwOps);
+static void BM__Edit (BM__Context_t * zptContext, uint32_t zuwOps);
+static void BM__Half (BM__Context_t * zptContext);
+static void BM__Measure (BM__Context_t * zptContext,
+                            const BM__Bench_t * zptBench, uint32_t zuwSamples);
+static int BM__Compare (const void * zpvLeft, const void * zpvRight);
+
+// ***** Local variables ******************************************************
+
+static const BM__Bench_t matBenches[] =
+{
+    {"load",         BM__Load},
+    {"getsum",       BM__GetSum},
+    {"move",         BM__Move},
+    {"greedy_step",  BM__Greedy_Step},
+    {"random_step",  BM__Random_Step},
+    {"opt_scan",     BM__Opt_Scan},
+    {"exhaust_step", BM__Exhaust_Step},
+    {"edit",         BM__Edit},
+};
+
+#define BM_BENCH_COUNT      (sizeof(matBenches) / sizeof(matBenches[0]))
+
+/**************************************************************************//**
+*
+* \defgroup    main                   Main function
+*
+* \{
+*
+******************************************************************************/
+
+/**************************************************************************//**
+*
+* \anchor      main
+*
+* \brief       Main function for the microbenchmarks
+*
+* \param[in]   -s               Samples per benchmark, BM_SAMPLES if not given
+* \param[in]   -b               Comma separated benchmarks, all if not given
+* \param[in]   argv[optind...]  Instance files
+*
+* \retval      int
+*
+******************************************************************************/
+
+int main(int argc, char **argv)
+{
+        BM__Context_t xtContext;
+        uint32_t xuwSamples = BM_SAMPLES;
+        uint32_t xuwLoop;
+        const char * xpsOnly = NULL;
+        char xacName[64u];
+        char xacList[256u];
+        int xiOpt;
+
+        while ((xiOpt = getopt(argc, argv, "s:b:")) != -1)
+        {
+            switch (xiOpt)
+            {
+                case 's': xuwSamples = (uint32_t)atoi(optarg);      break;
+                case 'b': xpsOnly = optarg;                         break;
+
+                default:
+                    xuwSamples = 0u;
+                    break;
+            }
+        }
+
+        if ((optind >= argc) || (xuwSamples == 0u))
+        {
+            printf("Invalid arguments! \n");
+            printf("Usage: ss_bench [-s samples] [-b bench,...] "
+                   "[input file name]...\n");
+
+            return -1;
+        }
+
+        if (xpsOnly != NULL)
+        {
+            snprintf(xacList, sizeof(xacList), ",%s,", xpsOnly);
+        }
+
+        srand(1u);
+
+        printf("benchmark,instance,n,b,ops,samples,min_ns,median_ns,p90_ns,"
+               "max_ns,ops_per_sec\n");
+
+        for (; optind < argc; optind++)
+        {
+            memset(&xtContext, 0, sizeof(xtContext));
+            xtContext.spsPath = argv[optind];
+            xtContext.sptInput = Subset_Sum_Load(argv[optind]);
+
+            if (xtContext.sptInput == NULL)
+            {
+                return -1;
+            }
+
+            if (Subset_Sum_Attach(&xtContext.stProblem, 
+                                        xtContext.sptInput) == false)
+            {
+                fprintf(stderr, "%s: out of memory\n", argv[optind]);
+                Subset_Sum_Release(xtContext.sptInput);
+
+                return -1;
+            }
+
+            for (xuwLoop = 0u; xuwLoop < BM_BENCH_COUNT; xuwLoop++)
+            {
+                // Whole names only, "move" is not in "opt_scan,remove"
+
+                snprintf(xacName, sizeof(xacName), ",%s,",
+                                            matBenches[xuwLoop].spsName);
+
+                if ((xpsOnly != NULL) && (strstr(xacList, xacName) == NULL))
+                {
+                    continue;
+                }
+
+                BM__Half(&xtContext);
+                BM__Measure(&xtContext, &matBenches[xuwLoop], xuwSamples);
+            }
+
+            Subset_Sum_Free(&xtContext.stProblem);
+            Subset_Sum_Release(xtContext.sptInput);
+
+            if (xtContext.stEdited.sptInput != NULL)
+            {
+                Subset_Sum_Free(&xtContext.stEdited);
+            }
+        }
+
+        return 0;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    ss_bench Benchmarks    Benchmarked operations
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      BM__Load
+*
+* \brief       Load and release the instance file
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zuwOps             Operations
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Load (BM__Context_t * zptContext, uint32_t zuwOps)
+{
+    Subset_Sum_Input_t * xptInput;
+
+    while (zuwOps-- > 0u)
+    {
+        xptInput = Subset_Sum_Load(zptContext->spsPath);
+
+        if (xptInput != NULL)
+        {
+            zptContext->sulSink += xptInput->sulTarget;
+            Subset_Sum_Release(xptInput);
+        }
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__GetSum
+*
+* \brief       Sum the current selection
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zuwOps             Operations
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__GetSum (BM__Context_t * zptContext, uint32_t zuwOps)
+{
+    while (zuwOps-- > 0u)
+    {
+        zptContext->sulSink += Subset_Sum_GetSum(&zptContext->stProblem);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__Move
+*
+* \brief       Best swap partner of one included element after another
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zuwOps             Operations
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Move (BM__Context_t * zptContext, uint32_t zuwOps)
+{
+    Subset_Sum_t * xptProblem = &zptContext->stProblem;
+    uint32_t xuwSize = zptContext->sptInput->suwSize;
+    uint64_t xulSum = Subset_Sum_GetSum(xptProblem);
+    uint32_t xuwOut;
+
+    while (zuwOps-- > 0u)
+    {
+        xuwOut = Subset_Sum_NextIncluded(xptProblem, zptContext->suwNext);
+
+        if (xuwOut >= xuwSize)
+        {
+            xuwOut = Subset_Sum_NextIncluded(xptProblem, 0u);
+        }
+
+        zptContext->suwNext = xuwOut + 1u;
+        zptContext->sulSink += Subset_Sum_FindSwap(xptProblem, xuwOut,
+                                                            xulSum, NULL);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__Greedy_Step
+*
+* \brief       Decide the next element the way the greedy constructions do
+*
+* \details     Starts over with an empty selection after the last element.
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zuwOps             Operations
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Greedy_Step (BM__Context_t * zptContext, uint32_t zuwOps)
+{
+    const Subset_Sum_Input_t * xptInput = zptContext->sptInput;
+    Subset_Sum_t * xptProblem = &zptContext->stProblem;
+    uint32_t xuwIndex;
+    uint64_t xulSum;
+
+    while (zuwOps-- > 0u)
+    {
+        xuwIndex = zptContext->suwNext++ % xptInput->suwSize;
+
+        if (xuwIndex == 0u)
+        {
+            Subset_Sum_Clear(xptProblem);
+        }
+
+        xulSum = Subset_Sum_GetSum(xptProblem);
+
+        Subset_Sum_Select(xptProblem, xuwIndex,
+            (SUBSETSUM_VALUE(xptInput, xuwIndex) <=
+                (xptInput->sulTarget - xulSum)) ? INCLUDED : EXCLUDED);
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__Random_Step
+*
+* \brief       Decide the next element the way the random construction does
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zuwOps             Operations
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Random_Step (BM__Context_t * zptContext, uint32_t zuwOps)
+{
+    const Subset_Sum_Input_t * xptInput = zptContext->sptInput;
+    Subset_Sum_t * xptProblem = &zptContext->stProblem;
+    uint32_t xuwIndex;
+    uint64_t xulSum;
+
+    while (zuwOps-- > 0u)
+    {
+        xuwIndex = zptContext->suwNext++ % xptInput->suwSize;
+
+        if (xuwIndex == 0u)
+        {
+            Subset_Sum_Clear(xptProblem);
+        }
+
+        xulSum = Subset_Sum_GetSum(xptProblem);
+
+        if (SUBSETSUM_VALUE(xptInput, xuwIndex) <=
+                (xptInput->sulTarget - xulSum))
+        {
+            Subset_Sum_Select(xptProblem, xuwIndex,
+                                ((rand() % 2) > 0) ? INCLUDED : EXCLUDED);
+        }
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__Opt_Scan
+*
+* \brief       Look for a swap for every included element, as one 1-OPT
+*              iteration does
+*
+* \details     The selection is not changed, every scan sees the same
+*              neighbourhood.
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zuwOps             Operations
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Opt_Scan (BM__Context_t * zptContext, uint32_t zuwOps)
+{
+    Subset_Sum_t * xptProblem = &zptContext->stProblem;
+    uint32_t xuwSize = zptContext->sptInput->suwSize;
+    uint64_t xulSum;
+    uint32_t xuwOut;
+
+    while (zuwOps-- > 0u)
+    {
+        xulSum = Subset_Sum_GetSum(xptProblem);
+
+        for (xuwOut = Subset_Sum_NextIncluded(xptProblem, 0u);
+             xuwOut < xuwSize;
+             xuwOut = Subset_Sum_NextIncluded(xptProblem, xuwOut + 1u))
+        {
+            zptContext->sulSink += Subset_Sum_FindSwap(xptProblem, xuwOut,
+                                                            xulSum, NULL);
+        }
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__Exhaust_Step
+*
+* \brief       Try the next subset the way the exhaustive search does
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zuwOps             Operations
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Exhaust_Step (BM__Context_t * zptContext, uint32_t zuwOps)
+{
+    Subset_Sum_t * xptProblem = &zptContext->stProblem;
+
+    while (zuwOps-- > 0u)
+    {
+        zptContext->sulSink += Subset_Sum_GetSum(xptProblem);
+
+        if (Subset_Sum_Increment(xptProblem) == false)
+        {
+            Subset_Sum_Clear(xptProblem);
+        }
+    }
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    ss_bench Internal      Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      BM__Edit
+*
+* \brief       Edit a solved instance and repair its solution
+*
+* \details     Works on a handle of its own, so the instance the other
+*              benchmarks use stays as loaded. Its selection starts as the
+*              half full one. The first edit copies the set, every later
+*              one works in place.
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zuwOps             Operations
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Edit (BM__Context_t * zptContext, uint32_t zuwOps)
+{
+    Subset_Sum_t * xptEdited = &zptContext->stEdited;
+    uint64_t xulTarget = zptContext->sptInput->sulTarget;
+    uint32_t xuwIndex;
+
+    if (xptEdited->sptInput == NULL)
+    {
+        if (Subset_Sum_Attach(xptEdited, zptContext->sptInput) == false)
+        {
+            fprintf(stderr, "%s: out of memory\n", zptContext->spsPath);
+
+            return;
+        }
+
+        Subset_Sum_Copy(xptEdited, &zptContext->stProblem);
+    }
+
+    while ((zuwOps-- > 0u) && (xptEdited->sptInput->suwSize > 0u))
+    {
+        switch (zptContext->suwEdits++ % 3u)
+        {
+            case 0u:
+                xuwIndex = (zptContext->suwEdits * 7919u) % 
+                                            xptEdited->sptInput->suwSize;
+                zptContext->sulRemoved = SUBSETSUM_VALUE(xptEdited->sptInput, 
+                                                                xuwIndex);
+                Subset_Sum_RemoveElement(xptEdited, xuwIndex);
+                break;
+
+            case 1u:
+                Subset_Sum_AddElement(xptEdited, zptContext->sulRemoved);
+                break;
+
+            default:
+                Subset_Sum_SetTarget(xptEdited, (zptContext->suwEdits & 1u) ?
+                                                xulTarget - 1u : xulTarget);
+                break;
+        }
+
+        zptContext->sulSink += xptEdited->sulSum;
+    }
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__Half
+*
+* \brief       Greedily fill the selection up to half the target
+*
+* \details     Every benchmark starts from the same, typical selection:
+*              about half the elements in, well under the target so there
+*              are moves to find.
+*
+* \param[in]   zptContext         Benchmark state
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Half (BM__Context_t * zptContext)
+{
+    const Subset_Sum_Input_t * xptInput = zptContext->sptInput;
+    Subset_Sum_t * xptProblem = &zptContext->stProblem;
+    uint64_t xulLeft = xptInput->sulTarget / 2u;
+    uint32_t xuwLoop;
+
+    Subset_Sum_Clear(xptProblem);
+
+    for (xuwLoop = 0u; xuwLoop < xptInput->suwSize; xuwLoop += 2u)
+    {
+        if (SUBSETSUM_VALUE(xptInput, xuwLoop) <= xulLeft)
+        {
+            xulLeft -= SUBSETSUM_VALUE(xptInput, xuwLoop);
+            Subset_Sum_Select(xptProblem, xuwLoop, INCLUDED);
+        }
+    }
+
+    zptContext->suwNext = 0u;
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__Measure
+*
+* \brief       Calibrate, sample and report one benchmark
+*
+* \param[in]   zptContext         Benchmark state
+* \param[in]   zptBench           Benchmark
+* \param[in]   zuwSamples         Samples to take
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void BM__Measure (BM__Context_t * zptContext,
+                            const BM__Bench_t * zptBench, uint32_t zuwSamples)
+{
+    const Subset_Sum_Input_t * xptInput = zptContext->sptInput;
+    uint64_t * xaulSamples;
+    uint64_t xulStart, xulTime;
+    uint32_t xuwOps = 1u;
+    uint32_t xuwLoop;
+    double xdMedian;
+
+    xaulSamples = (uint64_t *)malloc(zuwSamples * sizeof(uint64_t));
+
+    if (xaulSamples == NULL)
+    {
+        return;
+    }
+
+    // Double the operations per sample until a sample is long enough, the
+    // last round also warms the caches up
+
+    while (true)
+    {
+        xulStart = Deadline_Now();
+        (zptBench->spfRun)(zptContext, xuwOps);
+        xulTime = Deadline_Now() - xulStart;
+
+        if ((xulTime >= BM_SAMPLE_NS) || (xuwOps >= (1u << 30)))
+        {
+            break;
+        }
+
+        xuwOps *= 2u;
+    }
+
+    for (xuwLoop = 0u; xuwLoop < zuwSamples; xuwLoop++)
+    {
+        xulStart = Deadline_Now();
+        (zptBench->spfRun)(zptContext, xuwOps);
+        xaulSamples[xuwLoop] = Deadline_Now() - xulStart;
+    }
+
+    qsort(xaulSamples, zuwSamples, sizeof(uint64_t), BM__Compare);
+
+    xdMedian = (double)xaulSamples[zuwSamples / 2u] / xuwOps;
+
+    printf("%s,%s,%u,%u,%u,%u,%.3f,%.3f,%.3f,%.3f,%.1f\n",
+            zptBench->spsName, xptInput->sacName, xptInput->suwSize,
+            Subset_Sum_GetBits(xptInput), xuwOps, zuwSamples,
+            (double)xaulSamples[0] / xuwOps, xdMedian,
+            (double)xaulSamples[(zuwSamples * 9u) / 10u] / xuwOps,
+            (double)xaulSamples[zuwSamples - 1u] / xuwOps,
+            (xdMedian > 0.0) ? (1e9 / xdMedian) : 0.0);
+    fflush(stdout);
+
+    free(xaulSamples);
+}
+
+/**************************************************************************//**
+*
+* \anchor      BM__Compare
+*
+* \brief       qsort order of two samples
+*
+* \param[in]   zpvLeft            uint64_t *
+* \param[in]   zpvRight           uint64_t *
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int BM__Compare (const void * zpvLeft, const void * zpvRight)
+{
+    uint64_t xulLeft = *(const uint64_t *)zpvLeft;
+    uint64_t xulRight = *(const uint64_t *)zpvRight;
+
+    return (xulLeft < xulRight) ? -1 : (xulLeft > xulRight);
+}
+
+// \}
+
+// \}
@@ -0,0 +1,106 @@
+/**************************************************************************//**
+*
+* \file        ss_convert.c
+*
+* \defgroup    ss_convert           Instance file converter
+*
+* \details     Converts a subset sum instance between the text format used
+*              in instances/, the binary format (see Subset_Sum_Header_t)
+*              and the AMPL .dat/.run pair. The input format is detected
+*              automatically by the loader.
+*
+*              Keeping only binary instances around and generating the AMPL
+*              files on demand avoids storing every instance three times.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+
+/**************************************************************************//**
+*
+* \anchor      main
+*
+* \brief       Main function for the converter
+*
+* \details     Loads the input file and saves it again in the requested
+*              format.
+*
+* \ref         Subset_Sum_Load
+* \ref         Subset_Sum_Save
+* \ref         Subset_Sum_Release
+*
+* \param[in]   argv[1]          Input file name
+* \param[in]   argv[2]          Output file name
+* \param[in]   argv[3]          Output format: text, binary or ampl
+*
+* \retval      int
+*
+******************************************************************************/
+
+int main(int argc, char **argv)
+{
+        Subset_Sum_Input_t * xptInput;
+        uint8_t xeFormat;
+        bool xbOk;
+
+        // Verify all arguments were recieved
+
+        if (argc != 4)
+        {
+            printf("Invalid arguments! \n");
+            printf("Usage: ss_convert [input file name] [output file name] "
+                   "[text|binary|ampl]\n");
+
+            return -1;
+        }
+
+        if (strcmp(argv[3], "text") == 0)
+        {
+            xeFormat = SUBSETSUM_TEXT;
+        }
+        else if (strcmp(argv[3], "binary") == 0)
+        {
+            xeFormat = SUBSETSUM_BINARY;
+        }
+        else if (strcmp(argv[3], "ampl") == 0)
+        {
+            xeFormat = SUBSETSUM_AMPL;
+        }
+        else
+        {
+            printf("Unknown format: %s\n", argv[3]);
+
+            return -1;
+        }
+
+        // Load whatever we were given and write it back out
+
+        xptInput = Subset_Sum_Load(argv[1]);
+
+        if (xptInput == NULL)
+        {
+            return -1;
+        }
+
+        xbOk = Subset_Sum_Save(xptInput, argv[2], xeFormat);
+
+        Subset_Sum_Release(xptInput);
+
+        return (xbOk == true) ? 0 : -1;
+}
+
+// \}
@@ -0,0 +1,446 @@
+/**************************************************************************//**
+*
+* \file        ss_gen.c
+*
+* \defgroup    ss_gen               Native instance generator
+*
+* \details     Drop-in replacement for instance_generator.py. Generates a
+*              sweep of subset sum instances over the bit width b and the set
+*              size n, with the same semantics: every element is a uniform
+*              b-bit number, the largest element has exactly b bits and the
+*              target is the sum of exactly n/2 randomly chosen elements.
+*              Files are named ss_inst_<b>b_<n>n[_<uniq>] as before.
+*
+*              Instances of the sweep are generated in parallel. Each one is
+*              seeded from the user seed and its own (b, n), so a given seed
+*              produces the same files whatever the thread count.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+#include "Random.h"
+
+// ***** Definitions **********************************************************
+
+//! Same retry budget as the python generator for hitting the bit width
+
+#define GEN_ATTEMPTS        50u
+
+//! One (b, n) point of the sweep
+
+typedef struct Gen_Job_s
+{
+    uint32_t suwBits;
+    uint32_t suwSize;
+    uint64_t sulTarget;
+    bool sbOk;
+} Gen_Job_t;
+
+// ***** Local function prototypes ********************************************
+
+static void * GEN__Worker (void * zpvArg);
+static bool GEN__Create (Gen_Job_t * zptJob);
+
+// ***** Local variables ******************************************************
+
+static Gen_Job_t * matJobs;
+static uint32_t muwJobCount;
+static uint32_t muwNextJob;
+
+static uint64_t mulSeed;
+static const char * mpsDir = ".";
+static const char * mpsUniq = "";
+static uint8_t meFormat = SUBSETSUM_TEXT;
+static bool mbPrintOnly = false;
+
+/**************************************************************************//**
+*
+* \defgroup    main                   Main function
+*
+* \{
+*
+******************************************************************************/
+
+/**************************************************************************//**
+*
+* \anchor      main
+*
+* \brief       Main function for the generator
+*
+* \details     Parses the sweep (same options as instance_generator.py plus
+*              --binary and -t), then generates every instance on a pool of
+*              threads.
+*
+* \retval      int
+*
+******************************************************************************/
+
+int main(int argc, char **argv)
+{
+        static const struct option xatOptions[] =
+        {
+            {"uniq",     required_argument, NULL, 'u'},
+            {"ampl",     no_argument,       NULL, 'a'},
+            {"binary",   no_argument,       NULL, 'B'},
+            {"start_n",  required_argument, NULL, '1'},
+            {"end_n",    required_argument, NULL, '2'},
+            {"stride_n", required_argument, NULL, '3'},
+            {"start_b",  required_argument, NULL, '4'},
+            {"end_b",    required_argument, NULL, '5'},
+            {"stride_b", required_argument, NULL, '6'},
+            {NULL,       0,                 NULL, 0}
+        };
+        uint32_t xuwStartN = 2u, xuwEndN = 2u, xuwStrideN = 2u;
+        uint32_t xuwStartB = 1u, xuwEndB = 2u, xuwStrideB = 1u;
+        uint32_t xuwThreads = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+        pthread_t * xatThreads;
+        uint32_t xuwN, xuwB, xuwLoop, xuwFailed = 0u, xuwStarted;
+        int xiError;
+        double xdDensity, xdMin = 0.0, xdMax = 0.0, xdSum = 0.0;
+        int xiOpt;
+
+        mulSeed = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32);
+
+        while ((xiOpt = getopt_long(argc, argv, "s:d:t:p", xatOptions, NULL)) != -1)
+        {
+            switch (xiOpt)
+            {
+                case 's': mulSeed = strtoull(optarg, NULL, 0);      break;
+                case 'd': mpsDir = optarg;                          break;
+                case 't': xuwThreads = (uint32_t)atoi(optarg);      break;
+                case 'p': mbPrintOnly = true;                       break;
+                case 'u': mpsUniq = optarg;                         break;
+                case 'a': meFormat = SUBSETSUM_AMPL;                break;
+                case 'B': meFormat = SUBSETSUM_BINARY;              break;
+                case '1': xuwStartN = (uint32_t)atoi(optarg);       break;
+                case '2': xuwEndN = (uint32_t)atoi(optarg);         break;
+                case '3': xuwStrideN = (uint32_t)atoi(optarg);      break;
+                case '4': xuwStartB = (uint32_t)atoi(optarg);       break;
+                case '5': xuwEndB = (uint32_t)atoi(optarg);         break;
+                case '6': xuwStrideB = (uint32_t)atoi(optarg);      break;
+
+                default:
+                    printf("Usage: ss_gen [-s seed] [-d dir] [-t threads] [-p] "
+                           "[--uniq U] [--ampl|--binary]\n"
+                           "              [--start_n N] [--end_n N] [--stride_n N]"
+                           " [--start_b B] [--end_b B] [--stride_b B]\n");
+
+                    return -1;
+            }
+        }
+
+        // Same restrictions as the python generator, plus the element width
+
+        if (((xuwStartN % 2u) != 0u) || ((xuwEndN % 2u) != 0u) ||
+            (xuwStrideN == 0u) || ((xuwStrideN % 2u) != 0u) ||
+            (xuwStrideB == 0u) || (xuwStartB == 0u) || (xuwEndB > 64u))
+        {
+            printf("n values and stride must be even, b must be in 1..64\n");
+
+            return -1;
+        }
+
+        // Unroll the sweep, n outer and b inner like the python version
+
+        for (xuwN = xuwStartN; xuwN <= xuwEndN; xuwN += xuwStrideN)
+        {
+            for (xuwB = xuwStartB; xuwB <= xuwEndB; xuwB += xuwStrideB)
+            {
+                muwJobCount++;
+            }
+        }
+
+        matJobs = (Gen_Job_t *)calloc(muwJobCount, sizeof(Gen_Job_t));
+
+        if ((matJobs == NULL) && (muwJobCount > 0u))
+        {
+            perror("ss_gen");
+
+            return -1;
+        }
+
+        xuwLoop = 0u;
+
+        for (xuwN = xuwStartN; xuwN <= xuwEndN; xuwN += xuwStrideN)
+        {
+            for (xuwB = xuwStartB; xuwB <= xuwEndB; xuwB += xuwStrideB)
+            {
+                matJobs[xuwLoop].suwBits = xuwB;
+                matJobs[xuwLoop].suwSize = xuwN;
+                xuwLoop++;
+            }
+        }
+
+        // Generate everything
+
+        xuwThreads = (xuwThreads == 0u) ? 1u : xuwThreads;
+        xuwThreads = (xuwThreads > muwJobCount) ? muwJobCount : xuwThreads;
+        xatThreads = (pthread_t *)malloc((xuwThreads + 1u) * sizeof(pthread_t));
+
+        if (xatThreads == NULL)
+        {
+            perror("ss_gen");
+            free(matJobs);
+
+            return -1;
+        }
+
+        // The workers share the jobs, if a thread does not start the ones
+        // that did (at least this one) do its share
+
+        for (xuwStarted = 1u; xuwStarted < xuwThreads; xuwStarted++)
+        {
+            xiError = pthread_create(&xatThreads[xuwStarted], NULL,
+                                                        GEN__Worker, NULL);
+
+            if (xiError != 0)
+            {
+                fprintf(stderr, "ss_gen: %s, running %u threads\n",
+                                            strerror(xiError), xuwStarted);
+                break;
+            }
+        }
+
+        GEN__Worker(NULL);
+
+        for (xuwLoop = 1u; xuwLoop < xuwStarted; xuwLoop++)
+        {
+            pthread_join(xatThreads[xuwLoop], NULL);
+        }
+
+        // Report
+
+        for (xuwLoop = 0u; xuwLoop < muwJobCount; xuwLoop++)
+        {
+            xdDensity = matJobs[xuwLoop].suwSize / (double)matJobs[xuwLoop].suwBits;
+
+            xdMin = ((xuwLoop == 0u) || (xdDensity < xdMin)) ? xdDensity : xdMin;
+            xdMax = ((xuwLoop == 0u) || (xdDensity > xdMax)) ? xdDensity : xdMax;
+            xdSum += xdDensity;
+
+            xuwFailed += (matJobs[xuwLoop].sbOk == false);
+
+            if (mbPrintOnly == true)
+            {
+                printf("b=%u n=%u target=%llu density=%f\n",
+                        matJobs[xuwLoop].suwBits, matJobs[xuwLoop].suwSize,
+                        (unsigned long long)matJobs[xuwLoop].sulTarget, xdDensity);
+            }
+        }
+
+        if ((mbPrintOnly == true) && (muwJobCount > 0u))
+        {
+            printf("------------------------\n");
+            printf("Max density: %f\n", xdMax);
+            printf("Min density: %f\n", xdMin);
+            printf("Avg density: %f\n", xdSum / muwJobCount);
+        }
+
+        printf("------------------\n");
+        printf("%u instances created.\n", muwJobCount - xuwFailed);
+
+        free(xatThreads);
+        free(matJobs);
+
+        return (xuwFailed == 0u) ? 0 : -1;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    Local              Helper definition
+*
+* \{
+*
+******************************************************************************/
+
+/**************************************************************************//**
+*
+* \anchor      GEN__Worker
+*
+* \brief       Generator thread
+*
+* \details     Claims sweep points one at a time until none are left, so a
+*              few very large instances do not hold up a whole partition.
+*
+* \param[in]   zpvArg             Unused
+*
+* \retval      void *
+*
+******************************************************************************/
+
+static void * GEN__Worker (void * zpvArg)
+{
+    uint32_t xuwJob;
+
+    while ((xuwJob = __atomic_fetch_add(&muwNextJob, 1u, __ATOMIC_RELAXED))
+                                                            < muwJobCount)
+    {
+        matJobs[xuwJob].sbOk = GEN__Create(&matJobs[xuwJob]);
+    }
+
+    return NULL;
+}
+
+/**************************************************************************//**
+*
+* \anchor      GEN__Create
+*
+* \brief       Generate and write a single instance
+*
+* \details     Draws n b-bit values (retrying until the largest has exactly b
+*              bits), picks n/2 distinct elements with a partial
+*              Fisher-Yates shuffle for the target and saves the result.
+*
+* \param[in]   zptJob             Sweep point, the target is filled in
+*
+* \retval      bool
+*
+******************************************************************************/
+
+static bool GEN__Create (Gen_Job_t * zptJob)
+{
+    Subset_Sum_Input_t * xptInput;
+    Random_t xtRng;
+    unsigned __int128 xTarget = 0u;
+    uint64_t * xaulValues;
+    uint32_t * xauwIndex;
+    uint64_t xulMax = 0u;
+    uint32_t xuwAttempt, xuwLoop, xuwPick, xuwTemp;
+    char xacName[64u];
+    char xacPath[512u];
+    const char * xpsExt;
+    bool xbOk = true;
+
+    Random_Seed(&xtRng, mulSeed ^
+            Random_Mix(((uint64_t)zptJob->suwBits << 32) | zptJob->suwSize));
+
+    xaulValues = (uint64_t *)malloc(zptJob->suwSize * sizeof(uint64_t));
+    xauwIndex = (uint32_t *)malloc(zptJob->suwSize * sizeof(uint32_t));
+
+    if ((xaulValues == NULL) || (xauwIndex == NULL))
+    {
+        fprintf(stderr, "b=%u n=%u: %s\n", zptJob->suwBits, zptJob->suwSize,
+                                                        strerror(errno));
+        free(xaulValues);
+        free(xauwIndex);
+
+        return false;
+    }
+
+    // Generate the values, the largest one has to have exactly b bits
+
+    for (xuwAttempt = 0u; xuwAttempt < GEN_ATTEMPTS; xuwAttempt++)
+    {
+        xulMax = 0u;
+
+        for (xuwLoop = 0u; xuwLoop < zptJob->suwSize; xuwLoop++)
+        {
+            xaulValues[xuwLoop] = Random_Bits(&xtRng, zptJob->suwBits);
+            xulMax = (xaulValues[xuwLoop] > xulMax) ? xaulValues[xuwLoop] : xulMax;
+        }
+
+        if ((xulMax >> (zptJob->suwBits - 1u)) == 1u)
+        {
+            break;
+        }
+    }
+
+    if (xuwAttempt == GEN_ATTEMPTS)
+    {
+        fprintf(stderr, "b=%u n=%u: could not reach the bit width after %u "
+                "attempts\n", zptJob->suwBits, zptJob->suwSize, GEN_ATTEMPTS);
+        free(xaulValues);
+        free(xauwIndex);
+
+        return false;
+    }
+
+    // Target is the sum of exactly n/2 distinct elements
+
+    for (xuwLoop = 0u; xuwLoop < zptJob->suwSize; xuwLoop++)
+    {
+        xauwIndex[xuwLoop] = xuwLoop;
+    }
+
+    for (xuwLoop = 0u; xuwLoop < (zptJob->suwSize / 2u); xuwLoop++)
+    {
+        xuwPick = xuwLoop +
+            (uint32_t)Random_Below(&xtRng, zptJob->suwSize - xuwLoop);
+
+        xuwTemp = xauwIndex[xuwLoop];
+        xauwIndex[xuwLoop] = xauwIndex[xuwPick];
+        xauwIndex[xuwPick] = xuwTemp;
+
+        xTarget += xaulValues[xauwIndex[xuwLoop]];
+    }
+
+    // Targets are stored in 64 bits
+
+    if (xTarget > UINT64_MAX)
+    {
+        fprintf(stderr, "b=%u n=%u: target does not fit in 64 bits\n",
+                                    zptJob->suwBits, zptJob->suwSize);
+        free(xaulValues);
+        free(xauwIndex);
+
+        return false;
+    }
+
+    zptJob->sulTarget = (uint64_t)xTarget;
+
+    // Write it out
+
+    if (mbPrintOnly == false)
+    {
+        snprintf(xacName, sizeof(xacName), "ss_inst_%ub_%un%s%s",
+                            zptJob->suwBits, zptJob->suwSize,
+                            (mpsUniq[0] != '\0') ? "_" : "", mpsUniq);
+
+        xpsExt = (meFormat == SUBSETSUM_BINARY) ? "bin" : "dat";
+        snprintf(xacPath, sizeof(xacPath), "%s/%s.%s", mpsDir, xacName, xpsExt);
+
+        xptInput = Subset_Sum_Create(xacName, xaulValues,
+                                    zptJob->suwSize, zptJob->sulTarget);
+        xbOk = (xptInput != NULL);
+
+        if (xbOk == true)
+        {
+            xptInput->suwCardinality = zptJob->suwSize / 2u;
+            xbOk = Subset_Sum_Save(xptInput, xacPath, meFormat);
+            Subset_Sum_Release(xptInput);
+        }
+    }
+
+    free(xaulValues);
+    free(xauwIndex);
+
+    return xbOk;
+}
+
+// \}
+
+// \}
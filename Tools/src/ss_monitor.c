@@ -0,0 +1,428 @@
+/**************************************************************************//**
+*
+* \file        ss_monitor.c
+*
+* \defgroup    ss_monitor           Live solver monitor
+*
+* \details     Follows the telemetry ring of a running p1, p3 or p5 (see
+*              Telemetry.c) and prints every new incumbent, phase change
+*              and progress record as it is posted, one line each:
+*
+*                  <seconds> <thread> <event> <value> <gap> <moves/s>
+*                  <nodes/s> <subsets/s>
+*
+*              The gap is how far the thread's sum is below its target,
+*              the rates are taken between the thread's last two records.
+*              The monitor only ever reads the ring, the solver does not
+*              notice it.
+*
+*              Given a stall time the monitor also stops a run that has not
+*              improved on anything for that long, with SIGTERM so p1 still
+*              writes its checkpoint. Without a pid it lists the rings there
+*              are, "clean" removes those of processes that are gone.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <dirent.h>
+
+// Modules
+
+#include "Telemetry.h"
+#include "Perf.h"
+#include "Deadline.h"
+
+// ***** Local constants ******************************************************
+
+//! How long to sleep when the ring has nothing new, ns
+
+#define MON_POLL                50000000l
+
+//! Threads followed separately, later ones share the last entry
+
+#define MON_THREADS             256u
+
+static const char * const mapsKinds[TELEMETRY_KINDS] =
+{
+    "start", "phase", "improved", "progress", "end"
+};
+
+static const char * const mapsPhases[PERF_PHASES] =
+{
+    "load", "construct", "search", "output"
+};
+
+//! What the monitor remembers of every thread
+
+typedef struct MON__Thread_s
+{
+    uint64_t sulTarget;
+    Telemetry_Record_t stLast;
+} MON__Thread_t;
+
+// ***** Local function prototypes ********************************************
+
+static int MON__List (bool zbClean);
+static int MON__Follow (uint32_t zuwPid, double zdStall);
+static void MON__Print (MON__Thread_t * zatThreads,
+                                        const Telemetry_Record_t * zptRecord);
+static bool MON__Alive (uint32_t zuwPid);
+
+/**************************************************************************//**
+*
+* \anchor      main
+*
+* \brief       Main function for the monitor
+*
+* \param[in]   argv[1]          Optional pid of the process to follow, or
+*                               "clean"
+* \param[in]   argv[2]          Optional stall time in seconds, stop the
+*                               process if it has not improved for that long
+*
+* \retval      int
+*
+******************************************************************************/
+
+int main(int argc, char **argv)
+{
+        char * xpsEnd;
+        long xlPid;
+        double xdStall = 0.0;
+
+        if (argc == 1)
+        {
+            return MON__List(false);
+        }
+
+        if ((argc == 2) && (strcmp(argv[1], "clean") == 0))
+        {
+            return MON__List(true);
+        }
+
+        xlPid = strtol(argv[1], &xpsEnd, 10);
+
+        if (argc == 3)
+        {
+            xdStall = atof(argv[2]);
+        }
+
+        if ((argc > 3) || (*xpsEnd != '\0') || (xlPid <= 0) ||
+            (xdStall < 0.0))
+        {
+            printf("Invalid arguments! \n");
+            printf("Usage: ss_monitor [pid [stall seconds]]\n");
+            printf("       ss_monitor clean\n");
+
+            return -1;
+        }
+
+        return MON__Follow((uint32_t)xlPid, xdStall);
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    ss_monitor Internal    Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      MON__List
+*
+* \brief       List the rings in the telemetry directory
+*
+* \param[in]   zbClean            Remove the ones of processes that are gone
+*                                 instead
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int MON__List (bool zbClean)
+{
+    Telemetry_Reader_t xtReader;
+    const Telemetry_Ring_t * xptRing;
+    struct dirent * xptEntry;
+    char xacPath[256u];
+    char * xpsSlash;
+    DIR * xptDir;
+    uint32_t xuwPid;
+    bool xbAlive;
+
+    // Whichever directory this machine's rings go to
+
+    Telemetry_Path(0u, xacPath, sizeof(xacPath));
+    xpsSlash = strrchr(xacPath, '/');
+    *xpsSlash = '\0';
+
+    xptDir = opendir(xacPath);
+
+    if (xptDir == NULL)
+    {
+        perror(xacPath);
+
+        return -1;
+    }
+
+    if (zbClean == false)
+    {
+        printf("%8s %6s %8s %7s  %s\n", "pid", "state", "records",
+                                                    "threads", "name");
+    }
+
+    while ((xptEntry = readdir(xptDir)) != NULL)
+    {
+        if (strncmp(xptEntry->d_name, TELEMETRY_PREFIX,
+                                        strlen(TELEMETRY_PREFIX)) != 0)
+        {
+            continue;
+        }
+
+        xuwPid = (uint32_t)strtoul(&xptEntry->d_name[strlen(TELEMETRY_PREFIX)],
+                                                                NULL, 10);
+        xbAlive = MON__Alive(xuwPid);
+
+        if (zbClean == true)
+        {
+            if (xbAlive == false)
+            {
+                Telemetry_Path(xuwPid, xacPath, sizeof(xacPath));
+                unlink(xacPath);
+                printf("Removed %s\n", xacPath);
+            }
+
+            continue;
+        }
+
+        if (Telemetry_Attach(&xtReader, xuwPid) == false)
+        {
+            continue;
+        }
+
+        xptRing = xtReader.sptRing;
+
+        printf("%8u %6s %8llu %7u  %s\n", xuwPid,
+                (xbAlive == true) ? "live" : "gone",
+                (unsigned long long)__atomic_load_n(&xptRing->sulHead,
+                                                        __ATOMIC_ACQUIRE),
+                xptRing->suwThreads, xptRing->sacName);
+
+        Telemetry_Detach(&xtReader);
+    }
+
+    closedir(xptDir);
+
+    return 0;
+}
+
+/**************************************************************************//**
+*
+* \anchor      MON__Follow
+*
+* \brief       Print a ring's records until its process is gone
+*
+* \param[in]   zuwPid             Process
+* \param[in]   zdStall            Stop the process after this many seconds
+*                                 without an improvement, 0 never
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int MON__Follow (uint32_t zuwPid, double zdStall)
+{
+    static MON__Thread_t xatThreads[MON_THREADS];
+    struct timespec xtPoll = {0, MON_POLL};
+    Telemetry_Reader_t xtReader;
+    Telemetry_Record_t xtRecord;
+    uint64_t xulImproved = 0u;      // Ring time of the last improvement
+    uint64_t xulStall = (uint64_t)(zdStall * 1e9);
+    uint64_t xulNow;
+    bool xbStopped = false;
+    bool xbAlive = true;
+
+    if (Telemetry_Attach(&xtReader, zuwPid) == false)
+    {
+        printf("No telemetry from process %u\n", zuwPid);
+
+        return -1;
+    }
+
+    printf("Following %u, %s\n", zuwPid, xtReader.sptRing->sacName);
+    printf("%12s %4s %-9s %20s %20s %14s %14s %14s\n", "seconds", "thr",
+            "event", "value", "gap", "moves/s", "nodes/s", "subsets/s");
+
+    while (true)
+    {
+        while (Telemetry_Read(&xtReader, &xtRecord) == true)
+        {
+            if (xtRecord.suwKind == TELEMETRY_IMPROVED)
+            {
+                xulImproved = xtRecord.sulTime;
+            }
+
+            MON__Print(xatThreads, &xtRecord);
+        }
+
+        fflush(stdout);
+
+        // Look at the process only after the ring is drained, so nothing it
+        // posted right before it exited is missed
+
+        if (xbAlive == false)
+        {
+            break;
+        }
+
+        xbAlive = MON__Alive(zuwPid);
+
+        if (xbAlive == false)
+        {
+            continue;
+        }
+
+        xulNow = Deadline_Now() - xtReader.sptRing->sulStart;
+
+        if ((xulStall > 0u) && (xbStopped == false) &&
+            ((xulNow - xulImproved) > xulStall))
+        {
+            printf("No improvement for %.1f seconds, stopping %u\n",
+                    (double)(xulNow - xulImproved) / 1e9, zuwPid);
+            kill((pid_t)zuwPid, SIGTERM);
+            xbStopped = true;
+        }
+
+        nanosleep(&xtPoll, NULL);
+    }
+
+    printf("Process %u is gone", zuwPid);
+
+    if (xtReader.sulLost > 0u)
+    {
+        printf(", %llu records were overwritten before they could be read",
+                (unsigned long long)xtReader.sulLost);
+    }
+
+    printf("\n");
+
+    Telemetry_Detach(&xtReader);
+
+    return 0;
+}
+
+/**************************************************************************//**
+*
+* \anchor      MON__Print
+*
+* \brief       Print one record
+*
+* \param[in]   zatThreads         What is known of every thread
+* \param[in]   zptRecord          Record
+*
+* \retval      void
+*
+******************************************************************************/
+
+static void MON__Print (MON__Thread_t * zatThreads,
+                                        const Telemetry_Record_t * zptRecord)
+{
+    MON__Thread_t * xptThread;
+    const Telemetry_Record_t * xptLast;
+    double xdSpan;
+    char xacValue[24u];
+    char xacGap[24u];
+
+    xptThread = &zatThreads[(zptRecord->suwThread < MON_THREADS) ?
+                                zptRecord->suwThread : (MON_THREADS - 1u)];
+    xptLast = &xptThread->stLast;
+
+    // A new solve starts its counters from zero
+
+    if (zptRecord->suwKind == TELEMETRY_START)
+    {
+        xptThread->sulTarget = zptRecord->sulValue;
+        memset(&xptThread->stLast, 0, sizeof(Telemetry_Record_t));
+        xptThread->stLast.sulTime = zptRecord->sulTime;
+    }
+
+    strcpy(xacValue, "");
+    strcpy(xacGap, "");
+
+    if (zptRecord->suwKind == TELEMETRY_PHASE)
+    {
+        snprintf(xacValue, sizeof(xacValue), "%s",
+                    (zptRecord->sulValue < PERF_PHASES) ?
+                            mapsPhases[zptRecord->sulValue] : "?");
+    }
+    else if (zptRecord->suwKind != TELEMETRY_PROGRESS)
+    {
+        snprintf(xacValue, sizeof(xacValue), "%llu",
+                                (unsigned long long)zptRecord->sulValue);
+    }
+
+    if (((zptRecord->suwKind == TELEMETRY_IMPROVED) ||
+         (zptRecord->suwKind == TELEMETRY_END)) &&
+        (zptRecord->sulValue <= xptThread->sulTarget))
+    {
+        snprintf(xacGap, sizeof(xacGap), "%llu",
+            (unsigned long long)(xptThread->sulTarget - zptRecord->sulValue));
+    }
+
+    printf("%12.6f %4u %-9s %20s %20s", (double)zptRecord->sulTime / 1e9,
+            zptRecord->suwThread, (zptRecord->suwKind < TELEMETRY_KINDS) ?
+                            mapsKinds[zptRecord->suwKind] : "?",
+            xacValue, xacGap);
+
+    xdSpan = (double)(zptRecord->sulTime - xptLast->sulTime) / 1e9;
+
+    if ((zptRecord->suwKind == TELEMETRY_PROGRESS) && (xdSpan > 0.0))
+    {
+        printf(" %14.0f %14.0f %14.0f",
+            (double)(zptRecord->sulMoves - xptLast->sulMoves) / xdSpan,
+            (double)(zptRecord->sulNodes - xptLast->sulNodes) / xdSpan,
+            (double)(zptRecord->sulSubsets - xptLast->sulSubsets) / xdSpan);
+    }
+
+    printf("\n");
+
+    xptThread->stLast = *zptRecord;
+}
+
+/**************************************************************************//**
+*
+* \anchor      MON__Alive
+*
+* \brief       Check if a process still exists
+*
+* \param[in]   zuwPid             Process
+*
+* \retval      bool
+*
+******************************************************************************/
+
+static bool MON__Alive (uint32_t zuwPid)
+{
+    return ((kill((pid_t)zuwPid, 0) == 0) || (errno == EPERM));
+}
+
+// \}
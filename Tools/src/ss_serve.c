@@ -0,0 +1,409 @@
+/**************************************************************************//**
+*
+* \file        ss_serve.c
+*
+* \defgroup    ss_serve             Multi-target query server
+*
+* \details     Loads one instance, builds its sum index (see Index.c) once and
+*              then answers targets for as long as it runs, on stdin/stdout
+*              or on a Unix socket.
+*
+*              Every request is one line of whitespace separated targets. All
+*              targets of a line are answered as one batch, one reply line
+*              each, in the order given:
+*
+*                  <target> <best sum> <YES|NO> <microseconds> : <elements>
+*
+*              The time is the line's lookup time divided by its targets,
+*              the elements are the 0 based positions in the instance file
+*              of the chosen subset. "quit" ends the session, "shutdown"
+*              also stops a socket server. A line with anything but decimal
+*              targets that fit 64 bits gets a single "ERROR" line instead.
+*
+* \version     10/19/26  gcg  Initial version.
+*
+* \{
+*
+******************************************************************************/
+
+// ***** Header files *********************************************************
+
+#define _GNU_SOURCE
+
+// C Standard
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Modules
+
+#include "Subset_Sum.h"
+#include "Index.h"
+#include "Deadline.h"
+
+// ***** Local function prototypes ********************************************
+
+static bool SRV__Session (Index_t * zptIndex, uint32_t zuwSize,
+                                            FILE * zptIn, FILE * zptOut);
+static int SRV__Listen (Index_t * zptIndex, uint32_t zuwSize,
+                                            const char * zpsPath);
+
+/**************************************************************************//**
+*
+* \anchor      main
+*
+* \brief       Main function for the query server
+*
+* \ref         Subset_Sum_Load
+* \ref         Index_Build
+* \ref         Index_Query_Batch
+*
+* \param[in]   argv[1]          Instance file name
+* \param[in]   argv[2]          Optional Unix socket path, stdin/stdout if
+*                               not given
+*
+* \retval      int
+*
+******************************************************************************/
+
+int main(int argc, char **argv)
+{
+        Subset_Sum_Input_t * xptInput;
+        Index_t * xptIndex;
+        uint64_t xulStart;
+        uint32_t xuwSize;
+        int xiResult = 0;
+
+        // Verify all arguments were recieved
+
+        if ((argc < 2) || (argc > 3))
+        {
+            printf("Invalid arguments! \n");
+            printf("Usage: ss_serve [input file name] [socket path]\n");
+
+            return -1;
+        }
+
+        // Load and index the instance once
+
+        xptInput = Subset_Sum_Load(argv[1]);
+
+        if (xptInput == NULL)
+        {
+            return -1;
+        }
+
+        xulStart = Deadline_Now();
+        xptIndex = Index_Build(xptInput);
+        xuwSize = xptInput->suwSize;
+
+        Subset_Sum_Release(xptInput);
+
+        if (xptIndex == NULL)
+        {
+            return -1;
+        }
+
+        fprintf(stderr, "%s: %u elements, %s index built in %.6f seconds\n",
+                argv[1], xuwSize, Index_Kind(xptIndex),
+                (double)(Deadline_Now() - xulStart) / DEADLINE_NS_PER_SEC);
+
+        // Serve
+
+        if (argc == 3)
+        {
+            xiResult = SRV__Listen(xptIndex, xuwSize, argv[2]);
+        }
+        else
+        {
+            SRV__Session(xptIndex, xuwSize, stdin, stdout);
+        }
+
+        Index_Free(xptIndex);
+
+        return xiResult;
+}
+
+// \}
+
+/**************************************************************************//**
+*
+* \defgroup    ss_serve Internal      Private Functions
+*
+* \{
+*
+******************************************************************************/
+/**************************************************************************//**
+*
+* \anchor      SRV__Session
+*
+* \brief       Answer requests until end of input or "quit"
+*
+* \param[in]   zptIndex             Index of the instance
+* \param[in]   zuwSize              Elements in the instance
+* \param[in]   zptIn                Requests
+* \param[in]   zptOut               Replies
+*
+* \retval      bool                 true if "shutdown" was received
+*
+******************************************************************************/
+
+static bool SRV__Session (Index_t * zptIndex, uint32_t zuwSize,
+                                            FILE * zptIn, FILE * zptOut)
+{
+    uint32_t xuwWords = SUBSETSUM_WORDS(zuwSize);
+    uint64_t * xaulTargets = NULL;
+    uint64_t * xaulBest = NULL;
+    uint64_t * xaulSolutions = NULL;
+    uint64_t * xpulGrown;
+    uint32_t xuwCapacity = 0u;
+    uint32_t xuwCount, xuwLoop, xuwElement;
+    uint64_t xulStart;
+    double xdMicros;
+    char * xpsLine = NULL;
+    char * xpsNext;
+    char * xpsEnd;
+    const char * xpsError;
+    size_t xulLength = 0u;
+    bool xbShutdown = false;
+
+    while (getline(&xpsLine, &xulLength, zptIn) > 0)
+    {
+        if (strncmp(xpsLine, "quit", 4u) == 0)
+        {
+            break;
+        }
+
+        if (strncmp(xpsLine, "shutdown", 8u) == 0)
+        {
+            xbShutdown = true;
+            break;
+        }
+
+        // Parse every target on the line. strtoull would also take a sign
+        // and wrap a negative number around, so only digits start one.
+
+        xuwCount = 0u;
+        xpsError = NULL;
+
+        for (xpsNext = xpsLine; xpsError == NULL; xpsNext = xpsEnd)
+        {
+            uint64_t xulTarget;
+
+            while (isspace((unsigned char)*xpsNext))
+            {
+                xpsNext++;
+            }
+
+            if (*xpsNext == '\0')
+            {
+                break;
+            }
+
+            errno = 0;
+            xulTarget = strtoull(xpsNext, &xpsEnd, 10);
+
+            if ((isdigit((unsigned char)*xpsNext) == 0) || (errno == ERANGE))
+            {
+                xpsError = "invalid target";
+                break;
+            }
+
+            if (xuwCount == xuwCapacity)
+            {
+                // Keep whatever did grow, the capacity only moves once all
+                // three have
+
+                xuwCapacity = (xuwCapacity == 0u) ? 16u : (2u * xuwCapacity);
+
+                xpulGrown = (uint64_t *)realloc(xaulTargets,
+                                        xuwCapacity * sizeof(uint64_t));
+                xaulTargets = (xpulGrown != NULL) ? xpulGrown : xaulTargets;
+
+                if (xpulGrown != NULL)
+                {
+                    xpulGrown = (uint64_t *)realloc(xaulBest,
+                                        xuwCapacity * sizeof(uint64_t));
+                    xaulBest = (xpulGrown != NULL) ? xpulGrown : xaulBest;
+                }
+
+                if (xpulGrown != NULL)
+                {
+                    xpulGrown = (uint64_t *)realloc(xaulSolutions,
+                            (uint64_t)xuwCapacity * xuwWords * sizeof(uint64_t));
+                    xaulSolutions = (xpulGrown != NULL) ? xpulGrown : 
+                                                                xaulSolutions;
+                }
+
+                if (xpulGrown == NULL)
+                {
+                    xuwCapacity = xuwCount;
+                    xpsError = "out of memory";
+                    break;
+                }
+            }
+
+            xaulTargets[xuwCount++] = xulTarget;
+        }
+
+        if (xpsError != NULL)
+        {
+            fprintf(zptOut, "ERROR %s: %s", xpsError, xpsNext);
+            fflush(zptOut);
+
+            continue;
+        }
+
+        if (xuwCount == 0u)
+        {
+            continue;
+        }
+
+        xulStart = Deadline_Now();
+        Index_Query_Batch(zptIndex, xaulTargets, xuwCount, xaulBest,
+                                                            xaulSolutions);
+        xdMicros = (double)(Deadline_Now() - xulStart) / 1000.0 / xuwCount;
+
+        for (xuwLoop = 0u; xuwLoop < xuwCount; xuwLoop++)
+        {
+            uint64_t * xaulSolution =
+                            &xaulSolutions[(uint64_t)xuwLoop * xuwWords];
+
+            fprintf(zptOut, "%llu %llu %s %.3f :",
+                    (unsigned long long)xaulTargets[xuwLoop],
+                    (unsigned long long)xaulBest[xuwLoop],
+                    (xaulBest[xuwLoop] == xaulTargets[xuwLoop]) ? "YES" : "NO",
+                    xdMicros);
+
+            for (xuwElement = 0u; xuwElement < zuwSize; xuwElement++)
+            {
+                if ((xaulSolution[xuwElement >> 6] >> (xuwElement & 63u)) & 1u)
+                {
+                    fprintf(zptOut, " %u", xuwElement);
+                }
+            }
+
+            fprintf(zptOut, "\n");
+        }
+
+        // A client that went away ends its session
+
+        if ((fflush(zptOut) != 0) || (ferror(zptOut) != 0))
+        {
+            break;
+        }
+    }
+
+    free(xpsLine);
+    free(xaulTargets);
+    free(xaulBest);
+    free(xaulSolutions);
+
+    return xbShutdown;
+}
+
+/**************************************************************************//**
+*
+* \anchor      SRV__Listen
+*
+* \brief       Serve clients on a Unix socket, one at a time
+*
+* \details     Runs until a client sends "shutdown". A stale socket file
+*              from an earlier run is replaced.
+*
+* \param[in]   zptIndex             Index of the instance
+* \param[in]   zuwSize              Elements in the instance
+* \param[in]   zpsPath              Socket path
+*
+* \retval      int
+*
+******************************************************************************/
+
+static int SRV__Listen (Index_t * zptIndex, uint32_t zuwSize,
+                                            const char * zpsPath)
+{
+    struct sockaddr_un xtAddress;
+    FILE * xptIn;
+    FILE * xptOut;
+    bool xbShutdown = false;
+    int xiSocket, xiClient;
+
+    if (strlen(zpsPath) >= sizeof(xtAddress.sun_path))
+    {
+        fprintf(stderr, "Socket path too long: %s\n", zpsPath);
+
+        return -1;
+    }
+
+    memset(&xtAddress, 0, sizeof(xtAddress));
+    xtAddress.sun_family = AF_UNIX;
+    strcpy(xtAddress.sun_path, zpsPath);
+
+    // Writing to a client that hung up must fail, not kill the server
+
+    signal(SIGPIPE, SIG_IGN);
+
+    xiSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(zpsPath);
+
+    if ((xiSocket < 0) ||
+        (bind(xiSocket, (struct sockaddr *)&xtAddress, sizeof(xtAddress)) != 0) ||
+        (listen(xiSocket, 16) != 0))
+    {
+        perror(zpsPath);
+
+        if (xiSocket >= 0)
+        {
+            close(xiSocket);
+        }
+
+        return -1;
+    }
+
+    while (xbShutdown == false)
+    {
+        xiClient = accept(xiSocket, NULL, NULL);
+
+        if (xiClient < 0)
+        {
+            continue;
+        }
+
+        xptIn = fdopen(xiClient, "r");
+        xptOut = fdopen(dup(xiClient), "w");
+
+        if ((xptIn != NULL) && (xptOut != NULL))
+        {
+            xbShutdown = SRV__Session(zptIndex, zuwSize, xptIn, xptOut);
+        }
+
+        if (xptOut != NULL)
+        {
+            fclose(xptOut);
+        }
+
+        if (xptIn != NULL)
+        {
+            fclose(xptIn);
+        }
+        else
+        {
+            close(xiClient);
+        }
+    }
+
+    close(xiSocket);
+    unlink(zpsPath);
+
+    return 0;
+}
+
+// \}
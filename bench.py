@@ -0,0 +1,454 @@
+#!/usr/bin/python2.7
+#####################################################
+#
+# bench.py
+#     - Micro and macro benchmarks of every solver.
+#     - Microbenchmarks: Tools/src/ss_bench times the
+#       loader, Subset_Sum_GetSum, the 1-OPT move and
+#       every solver's inner step.
+#     - Macro suite: every solver over the instances/
+#       set plus a seeded sweep of large generated
+#       instances, several times each.
+#     - Writes runtime distribution, margin error and
+#       throughput CSVs in the same n x b layout as
+#       runme.py -r, and flags regressions against a
+#       stored baseline.
+#     - With --model, fits the cost model of the
+#       auto solver to the macro suite (see
+#       Abstraction/Select.c).
+#     - Assumes the projects and tools have already
+#       been compiled ("make bench" in Tools/src
+#       does both).
+#
+#####################################################
+
+from __future__ import division, print_function
+import subprocess
+import argparse
+import tempfile
+import shutil
+import glob
+import time
+import csv
+import sys
+import os
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+
+P1 = os.path.join(ROOT, 'Project1', 'src', 'p1')
+P3 = os.path.join(ROOT, 'Project3', 'src', 'p3')
+P5 = os.path.join(ROOT, 'Project5', 'src', 'p5')
+SS_GEN = os.path.join(ROOT, 'Tools', 'src', 'ss_gen')
+SS_BENCH = os.path.join(ROOT, 'Tools', 'src', 'ss_bench')
+
+# Solver name (as in the report CSVs), output folder of its .stats.csv
+# sidecars. P5 writes all three of its solvers in one batch run.
+SOLVERS = [
+    ('exhaustive', '.'),
+    ('greedy', '.'),
+    ('local_search_greedy', 'greedy'),
+    ('local_search_random', 'random'),
+    ('local_search_tabu', 'tabu'),
+]
+
+# Cost model rows (see Select_Open): solver name in the result cache, how
+# its runtime and memory grow with n, memory bits per unit and fixed bytes
+# (what the solver allocates, not measured here), and whether it proves the
+# optimum when it runs to the end.
+MODELS = {
+    'exhaustive': ('p1.exhaustive', '2n', 'n', 1, 4096, 1),
+    'greedy': ('p3.greedy', 'n', 'n', 1, 4096, 0),
+    'local_search_greedy': ('p5.greedy', 'n2', 'n', 1, 4096, 0),
+    'local_search_random': ('p5.random', 'n2', 'n', 1, 4096, 0),
+    'local_search_tabu': ('p5.tabu', 'n2', 'n', 194, 4096, 0),
+}
+
+
+def percentile(values, fraction):
+    """Nearest rank percentile of a non-empty list."""
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def get_bit_width(name):
+    """Bit width from an instance name like ss_inst_27b_18n."""
+    try:
+        return int(os.path.basename(name).split('_')[2][:-1])
+    except (IndexError, ValueError):
+        return 0
+
+
+def parse_limit(text):
+    """Seconds of a time limit like '100ms', as Deadline_Parse reads it."""
+    for unit, scale in (('ms', 1e-3), ('us', 1e-6), ('ns', 1e-9), ('s', 1.0)):
+        if text.endswith(unit):
+            return float(text[:-len(unit)]) * scale
+    return float(text)
+
+
+def get_features(path):
+    """n, b and density class of a .dat instance, as Select_Features."""
+    fhandle = open(path, 'r')
+    values = [int(v) for v in fhandle.read().split()[2:]]
+    fhandle.close()
+    bits = max(values).bit_length() if values else 0
+    return {'n': len(values), 'b': bits, 'dense': len(set(values)) >= bits}
+
+
+def generate_large(work, seed):
+    """Seeded sweep of large instances, the same files for the same seed."""
+    large = os.path.join(work, 'large')
+    os.mkdir(large)
+    subprocess.check_call([SS_GEN, '-s', str(seed), '-d', large,
+                           '--start_n', '1000', '--end_n', '5000', '--stride_n', '2000',
+                           '--start_b', '20', '--end_b', '40', '--stride_b', '10'],
+                          stdout=open(os.devnull, 'w'))
+    return sorted(glob.glob(large + '/*.dat'))
+
+
+def run_project(work, commands, folders):
+    """Run commands in a fresh <work>/src and return the stats rows per folder."""
+    if os.path.isdir(os.path.join(work, 'src')):
+        shutil.rmtree(os.path.join(work, 'src'))
+        shutil.rmtree(os.path.join(work, 'outputs'))
+    os.makedirs(os.path.join(work, 'src'))
+    for folder in folders:
+        if not os.path.isdir(os.path.join(work, 'outputs', folder)):
+            os.makedirs(os.path.join(work, 'outputs', folder))
+
+    # A result cache would time the lookups, not the solvers
+    env = dict(os.environ)
+    env.pop('SSUM_CACHE', None)
+
+    start = time.time()
+    for cmd in commands:
+        subprocess.call(cmd, cwd=os.path.join(work, 'src'), env=env,
+                        stdout=open(os.devnull, 'w'), stderr=subprocess.STDOUT)
+    wall = time.time() - start
+
+    rows = {}
+    for folder in folders:
+        rows[folder] = []
+        for fname in glob.glob(os.path.join(work, 'outputs', folder, '*.stats.csv')):
+            rows[folder].extend(csv.DictReader(open(fname, 'r')))
+    return rows, wall
+
+
+def run_macro(args, work, instances):
+    """Every solver over every instance, args.n times. Returns samples and walls."""
+    manifest = os.path.join(work, 'manifest')
+    open(manifest, 'w').write('\n'.join(instances) + '\n')
+
+    samples = []
+    walls = dict((solver, 0.0) for solver, folder in SOLVERS)
+    for rep in range(args.n):
+        print('Repetition', rep + 1, 'of', args.n)
+        runs = [
+            (['exhaustive'], [[P1, i, args.l] for i in instances], ['.']),
+            (['greedy'], [[P3, i] for i in instances], ['.']),
+            (['local_search_greedy', 'local_search_random', 'local_search_tabu'],
+             [[P5, manifest, args.l, 'batch', '1']], ['greedy', 'random', 'tabu']),
+        ]
+        for solvers, commands, folders in runs:
+            solvers = [s for s in solvers if s in args.s]
+            if len(solvers) == 0:
+                continue
+            rows, wall = run_project(work, commands, folders)
+            for solver in solvers:
+                walls[solver] += wall / len(solvers)
+                for row in rows[dict(SOLVERS)[solver]]:
+                    sum_ = float(row['sum'])
+                    target = float(row['target'])
+                    seconds = float(row['seconds'])
+                    work_done = int(row['moves']) + int(row['nodes']) + int(row['subsets'])
+                    samples.append({
+                        'solver': solver,
+                        'instance': row['instance'],
+                        'n': int(row['size']),
+                        'b': get_bit_width(row['instance']),
+                        'rep': rep,
+                        'seconds': seconds,
+                        # Same definition as runme.py: final sum over target
+                        'margin': sum_ / target if target > 0 else 1.0,
+                        'throughput': work_done / seconds if seconds > 0 else 0.0,
+                        'solved': int(row['solved']),
+                    })
+    return samples, walls
+
+
+def write_grid(path, cells):
+    """Write {(n, b): value} with n down and b across, like runme.py -r."""
+    bit_widths = sorted(set(b for n, b in cells))
+    sizes = sorted(set(n for n, b in cells))
+    fhandle = open(path, 'w')
+    fhandle.write(',' + ','.join(str(b) for b in bit_widths) + '\n')
+    for n in sizes:
+        row = [str(cells[(n, b)]) if (n, b) in cells else ' ' for b in bit_widths]
+        fhandle.write(str(n) + ',' + ','.join(row) + '\n')
+    fhandle.close()
+
+
+def units(kind, n):
+    """Units of work of n elements, as SE__Units."""
+    if kind == '2n':
+        return float(2 ** n) if n < 1000 else float('inf')
+    return float(n * n) if kind == 'n2' else float(n)
+
+
+def fit_line(points):
+    """Least squares y = fixed + slope * x, neither negative."""
+    if len(points) == 0:
+        return 0.0, 0.0
+    mean_x = sum(x for x, y in points) / len(points)
+    mean_y = sum(y for x, y in points) / len(points)
+    sxx = sum((x - mean_x) ** 2 for x, y in points)
+    if sxx == 0:
+        return 0.0, mean_y
+    slope = sum((x - mean_x) * (y - mean_y) for x, y in points) / sxx
+    fixed = mean_y - slope * mean_x
+    if fixed < 0:
+        # Through the origin instead
+        slope, fixed = sum(x * y for x, y in points) / sum(x * x for x, y in points), 0.0
+    if slope < 0:
+        slope, fixed = 0.0, mean_y
+    return slope, fixed
+
+
+def write_model(args, samples, instances):
+    """Fit the auto solver's cost model to the macro samples."""
+    limit = parse_limit(args.l)
+    features = dict((os.path.basename(i)[:-len('.dat')], get_features(i))
+                    for i in instances)
+
+    fhandle = open(args.model, 'w')
+    fhandle.write('# Fitted by bench.py to %d samples at %s per solve\n' %
+                  (len(samples), args.l))
+    fhandle.write('solver,time,ps_per_unit,ns_fixed,memory,bits_per_unit,'
+                  'bytes_fixed,exact,dense,sparse\n')
+    for solver in [s for s, f in SOLVERS if s in args.s]:
+        name, time_kind, memory_kind, bits, fixed, exact = MODELS[solver]
+        mine = [s for s in samples if s['solver'] == solver]
+        if len(mine) == 0:
+            continue
+
+        # Runs cut off by the limit tell nothing about the time to the end
+        done = [s for s in mine if s['solved'] or s['seconds'] < 0.9 * limit]
+        slope, fixed_ns = fit_line([(units(time_kind, s['n']), s['seconds'] * 1e9)
+                                    for s in done])
+
+        # An exact solver mostly stops early on a hit, its time to the end
+        # is its rate of subsets tried, over runs long enough to measure
+        if exact:
+            rates = [s['throughput'] for s in mine
+                     if s['seconds'] >= 1e-3 and s['n'] < 64 and s['throughput'] > 0]
+            if len(rates):
+                slope = 1e9 / percentile(rates, 0.5)
+            fixed_ns = min(s['seconds'] for s in mine) * 1e9
+        per_unit = int(round(slope * 1000))
+
+        # The hit rates only matter when an exact solver cannot finish, so
+        # they are taken over those instances only
+        if exact:
+            mine = [s for s in mine
+                    if fixed_ns + slope * units(time_kind, s['n']) > limit * 1e9]
+
+        rates = []
+        for dense in (True, False):
+            runs = [s for s in mine if features[s['instance']]['dense'] == dense]
+            rates.append(int(round(1000 * sum(s['solved'] for s in runs) / len(runs)))
+                         if len(runs) else 0)
+
+        fhandle.write('%s,%s,%d,%d,%s,%d,%d,%d,%d,%d\n' % (
+            name, time_kind, per_unit, int(fixed_ns), memory_kind, bits, fixed, exact,
+            rates[0], rates[1]))
+    fhandle.close()
+    print('Wrote the cost model to', args.model)
+
+
+def report_macro(args, samples, walls):
+    """Grids per solver plus the long form samples and a suite summary."""
+    results = []
+    fhandle = open(os.path.join(args.o, 'samples' + args.u + '.csv'), 'w')
+    fhandle.write('solver,instance,n,b,rep,seconds,margin,throughput,solved\n')
+    for s in samples:
+        fhandle.write('%s,%s,%d,%d,%d,%.9f,%.10f,%.1f,%d\n' % (
+            s['solver'], s['instance'], s['n'], s['b'], s['rep'],
+            s['seconds'], s['margin'], s['throughput'], s['solved']))
+    fhandle.close()
+
+    summary = open(os.path.join(args.o, 'summary' + args.u + '.csv'), 'w')
+    summary.write('solver,solves,solved,wall_seconds,solves_per_second,'
+                  'median_seconds,p90_seconds,median_margin\n')
+
+    for solver in [s for s, f in SOLVERS if s in args.s]:
+        mine = [s for s in samples if s['solver'] == solver]
+        if len(mine) == 0:
+            continue
+        grids = dict((name, {}) for name in
+                     ['runtime_min', 'runtime_median', 'runtime_p90', 'runtime_max',
+                      'margin_error', 'throughput'])
+        for instance in sorted(set(s['instance'] for s in mine)):
+            runs = [s for s in mine if s['instance'] == instance]
+            key = (runs[0]['n'], runs[0]['b'])
+            seconds = [s['seconds'] for s in runs]
+            grids['runtime_min'][key] = min(seconds)
+            grids['runtime_median'][key] = percentile(seconds, 0.5)
+            grids['runtime_p90'][key] = percentile(seconds, 0.9)
+            grids['runtime_max'][key] = max(seconds)
+            grids['margin_error'][key] = percentile([s['margin'] for s in runs], 0.5)
+            grids['throughput'][key] = percentile([s['throughput'] for s in runs], 0.5)
+            results.append(('macro', solver, instance, 'seconds',
+                            percentile(seconds, 0.5), min(seconds)))
+            results.append(('macro', solver, instance, 'margin_error',
+                            abs(1 - grids['margin_error'][key]),
+                            min(abs(1 - s['margin']) for s in runs)))
+        for name, cells in grids.items():
+            write_grid(os.path.join(args.o, name + '_' + solver + args.u + '.csv'), cells)
+
+        seconds = [s['seconds'] for s in mine]
+        summary.write('%s,%d,%d,%.3f,%.1f,%.9f,%.9f,%.10f\n' % (
+            solver, len(mine), sum(s['solved'] for s in mine), walls[solver],
+            len(mine) / walls[solver] if walls[solver] > 0 else 0.0,
+            percentile(seconds, 0.5), percentile(seconds, 0.9),
+            percentile([s['margin'] for s in mine], 0.5)))
+    summary.close()
+    return results
+
+
+def run_micro(args, instances):
+    """ss_bench over a few instances of growing size."""
+    # The largest of the fixed set and every generated one
+    fixed = sorted([i for i in instances if '/large/' not in i],
+                   key=lambda i: os.path.getsize(i))
+    chosen = fixed[-1:] + [i for i in instances if '/large/' in i]
+
+    path = os.path.join(args.o, 'micro' + args.u + '.csv')
+    subprocess.check_call([SS_BENCH, '-s', str(args.samples)] + chosen,
+                          stdout=open(path, 'w'))
+    results = []
+    for row in csv.DictReader(open(path, 'r')):
+        # The minimum is the least noisy, but the median is what is compared
+        results.append(('micro', row['benchmark'], row['instance'], 'median_ns',
+                        float(row['median_ns']), float(row['min_ns'])))
+    return results
+
+
+def compare(args, results):
+    """Flag results worse than the baseline by more than the noise threshold."""
+    baseline = {}
+    for row in csv.DictReader(open(args.baseline, 'r')):
+        baseline[(row['kind'], row['name'], row['instance'], row['metric'])] = \
+            float(row['value'])
+
+    regressions = []
+    for kind, name, instance, metric, value, best in results:
+        key = (kind, name, instance, metric)
+        if key not in baseline:
+            continue
+        base = baseline[key]
+        floor = {'seconds': args.floor, 'median_ns': args.floor_ns}.get(metric, 1e-9)
+        # Worse by more than the threshold, and even the best run is worse
+        # than the baseline, so one noisy repetition is not enough
+        if (value > base * (1 + args.threshold) + floor) and (best > base):
+            regressions.append((kind, name, instance, metric, base, value))
+
+    fhandle = open(os.path.join(args.o, 'regressions' + args.u + '.csv'), 'w')
+    fhandle.write('kind,name,instance,metric,baseline,current,change\n')
+    for kind, name, instance, metric, base, value in regressions:
+        change = (value / base - 1) if base > 0 else float('inf')
+        fhandle.write('%s,%s,%s,%s,%r,%r,%.3f\n' % (kind, name, instance, metric,
+                                                    base, value, change))
+        print('REGRESSION %s %s %s %s: %g -> %g (%+.1f%%)' %
+              (kind, name, instance, metric, base, value, 100 * change))
+    fhandle.close()
+    print(len(regressions), 'regressions against', args.baseline,
+          'with a threshold of %g%%' % (100 * args.threshold))
+    return regressions
+
+
+def save_baseline(args, results):
+    fhandle = open(args.baseline, 'w')
+    fhandle.write('kind,name,instance,metric,value\n')
+    for kind, name, instance, metric, value, best in results:
+        fhandle.write('%s,%s,%s,%s,%r\n' % (kind, name, instance, metric, value))
+    fhandle.close()
+    print('Saved', len(results), 'results as the baseline', args.baseline)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description=('Run the micro and macro benchmarks and compare them against '
+                     'a stored baseline. Assumes everything has been compiled.'))
+
+    parser.add_argument('-i', type=str, default='instances',
+                        help="Fixed instance set. Default = '%(default)s'")
+    parser.add_argument('-l', type=str, default='100ms',
+                        help="Time limit of every solve. Default = '%(default)s'")
+    parser.add_argument('-n', type=int, default=3,
+                        help='Repetitions of every solve. Default = %(default)d')
+    parser.add_argument('-s', type=str, default=','.join(s for s, f in SOLVERS),
+                        help="Solvers to run. Default = '%(default)s'")
+    parser.add_argument('-o', type=str, default='bench',
+                        help="Directory for the CSVs. Default = '%(default)s'")
+    parser.add_argument('-u', type=str, default='',
+                        help='Uniquifier term for the CSV names.')
+    parser.add_argument('--seed', type=int, default=46,
+                        help='Seed of the large generated instances. Default = %(default)d')
+    parser.add_argument('--samples', type=int, default=31,
+                        help='Samples per microbenchmark. Default = %(default)d')
+    parser.add_argument('--no-large', action='store_true',
+                        help='Only the fixed instance set.')
+    parser.add_argument('--micro-only', action='store_true')
+    parser.add_argument('--macro-only', action='store_true')
+    parser.add_argument('--baseline', type=str,
+                        help="Baseline to compare against. Default = '<-o>/baseline.csv'")
+    parser.add_argument('--model', type=str,
+                        help=('Also fit the cost model of the auto solver to the macro '
+                              'suite and write it here, for SSUM_MODEL.'))
+    parser.add_argument('--save-baseline', action='store_true',
+                        help='Store this run as the baseline instead of comparing.')
+    parser.add_argument('--threshold', type=float, default=0.15,
+                        help='Relative change taken as noise. Default = %(default)g')
+    parser.add_argument('--floor', type=float, default=0.001,
+                        help='Absolute change in seconds taken as noise. Default = %(default)g')
+    parser.add_argument('--floor-ns', type=float, default=5.0,
+                        help=('Absolute change in ns per operation taken as noise in '
+                              'the microbenchmarks. Default = %(default)g'))
+
+    args = parser.parse_args()
+    args.s = args.s.split(',')
+    if args.baseline is None:
+        args.baseline = os.path.join(args.o, 'baseline.csv')
+
+    for exe in [P1, P3, P5, SS_GEN, SS_BENCH]:
+        if not os.path.isfile(exe):
+            sys.exit('%s is missing, run "make bench" in Tools/src' % exe)
+
+    if not os.path.isdir(args.o):
+        os.makedirs(args.o)
+
+    work = tempfile.mkdtemp(prefix='ss_bench')
+    try:
+        instances = sorted(os.path.abspath(i) for i in glob.glob(args.i + '/*.dat'))
+        if not args.no_large:
+            instances += generate_large(work, args.seed)
+        print('Found', len(instances), 'instances to work on.')
+
+        results = []
+        if not args.macro_only:
+            results += run_micro(args, instances)
+        if not args.micro_only:
+            samples, walls = run_macro(args, work, instances)
+            results += report_macro(args, samples, walls)
+            if args.model:
+                write_model(args, samples, instances)
+    finally:
+        shutil.rmtree(work)
+
+    if args.save_baseline:
+        save_baseline(args, results)
+    elif os.path.isfile(args.baseline):
+        if len(compare(args, results)) > 0:
+            sys.exit(1)
+    else:
+        print('No baseline at', args.baseline + ', run with --save-baseline to store one')
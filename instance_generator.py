@@ -3,6 +3,8 @@
 #
 # instance_generator.py
 #     - Generate a series of subset sum instances
+#     - Tools/src/ss_gen is a much faster native
+#       equivalent (same options and file names)
 #
 #########################################################
 
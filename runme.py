@@ -17,6 +17,8 @@ from subprocess import PIPE, STDOUT
 import argparse
 import os
 import glob
+import csv
+import threading
 
 END_SUM = 2
 BIT_WIDTH = 2
@@ -382,9 +384,54 @@ def generate_report(dir_name, ampl, uniquifier):
     fhandle.write(','.join(str(n) for n in instance_names) + '\n')
 
     fhandle.close()
+
+    ####################################################################
+    # Summarize the solver counters, if the build wrote any
+
+    generate_stats_report(dir_name, uniquifier)
     
     pass
 
+def generate_stats_report(dir_name, uniquifier):
+    """Aggregate the solver counters in the .stats.csv sidecars of a directory."""
+    # One row per solve is appended to <instance>.stats.csv, only the latest
+    # solve of every instance is reported. Builds with -DSS_NO_STATS write
+    # no sidecars.
+    file_list = sorted(glob.glob(os.getcwd() + '/' + dir_name + '/*.stats.csv'))
+    if len(file_list) == 0:
+        return
+
+    print 'Found', len(file_list), 'stats files to process.'
+
+    counters = ['moves', 'improvements', 'restarts', 'tabu', 'nodes', 'subsets']
+    timings = ['seconds', 'first', 'best']
+    totals = dict((name, 0) for name in counters + timings)
+    solved = 0
+
+    fhandle = open('solver_stats' + uniquifier + '.csv', 'w')
+    fhandle.write('instance,solved,' + ','.join(counters + timings) + '\n')
+
+    for fname in file_list:
+        rows = list(csv.DictReader(open(fname, 'r')))
+        if len(rows) == 0:
+            continue
+        row = rows[-1]
+        solved += int(row['solved'])
+        for name in counters:
+            totals[name] += int(row[name])
+            pass
+        for name in timings:
+            totals[name] += float(row[name])
+            pass
+        fhandle.write(row['instance'] + ',' + row['solved'] + ',' +
+                      ','.join(row[name] for name in counters + timings) + '\n')
+        pass
+
+    fhandle.write('total,' + str(solved) + ',' +
+                  ','.join(str(totals[name]) for name in counters + timings) + '\n')
+    fhandle.close()
+    pass
+
 def run_thread(e, dir_name, instance_list, gen_log, ftype):
     """Run the executable with provided list of instances. Return the process."""
 
@@ -405,6 +452,45 @@ def run_thread(e, dir_name, instance_list, gen_log, ftype):
 
     return p
 
+def run_library(solver, limit, file_list, threads, uniquifier):
+    """Solve every instance in this process through libssum.so (see ssum.py)."""
+    import ssum
+
+    if args.c:
+        ssum.cache(args.c)
+        pass
+
+    rows = [None] * len(file_list)
+
+    def work(indices):
+        for index in indices:
+            instance = ssum.Instance.load(file_list[index])
+            result = instance.solve(solver, limit)
+            # For auto, the solver it picked
+            rows[index] = [instance.name, result.solver_name(), result.solved,
+                           result.sum, result.target, result.margin(), result.time / 1e9,
+                           result.initial, result.selected]
+            instance.close()
+            pass
+        pass
+
+    workers = [threading.Thread(target=work, args=(range(len(file_list))[i::threads],))
+               for i in xrange(threads)]
+    for worker in workers:
+        worker.start()
+        pass
+    for worker in workers:
+        worker.join()
+        pass
+
+    fhandle = open('results' + (uniquifier or '') + '.csv', 'w')
+    fhandle.write('instance,solver,solved,sum,target,margin,seconds,initial,selected\n')
+    for row in sorted(rows):
+        fhandle.write(','.join(str(n) for n in row) + '\n')
+        pass
+    fhandle.close()
+    print 'Solved', sum(row[2] for row in rows), 'of', len(rows), 'instances with', solver
+
 def build():
     """Build the project. BOZO_dhullih: Implement at some point for convenience."""
     pass
@@ -438,6 +524,22 @@ if __name__ == "__main__":
                         type=int,
                         default=8,
                         help=('Number of threads to spawn. Default = %(default)d.'))
+    parser.add_argument('-c',
+                        type=str,
+                        help=('Result cache directory. Instances already solved by the '
+                              'same solver with at least the same time limit are not '
+                              'solved again (exported to the solvers as SSUM_CACHE).'))
+    parser.add_argument('-s',
+                        type=str,
+                        help=('Solve the instances in this process with this solver of '
+                              'Library/src/libssum.so instead of running -e, e.g. p5.tabu, '
+                              'or auto to pick one per instance. Writes '
+                              'results<uniquifier>.csv.'))
+    parser.add_argument('--limit',
+                        type=float,
+                        default=0,
+                        help=('Time limit in seconds per instance for -s, 0 for none. '
+                              'Default = %(default)s.'))
     parser.add_argument('--ampl',
                         action='store_true',
                         help='Indicate data is generated by AMPL. For -r switch only.')
@@ -449,6 +551,11 @@ if __name__ == "__main__":
 
     args = parser.parse_args()
 
+    if args.c:
+        # The solvers run in the -d directory, so hand them an absolute path
+        os.environ['SSUM_CACHE'] = os.path.abspath(args.c)
+        pass
+
     if args.e:
         ####################################################################
         # Get the whole list of instances files and divide them up
@@ -483,6 +590,12 @@ if __name__ == "__main__":
             pass
         pass
 
+    if args.s:
+        file_list = sorted(glob.glob(os.getcwd() + '/' + (args.i) + '/*' + args.f))
+        print 'Found', len(file_list), 'instances to work on.'
+        run_library(args.s, args.limit, file_list, args.t, args.u)
+        pass
+
     if args.r:
         generate_report(args.r, args.ampl, args.u)
         pass
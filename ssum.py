@@ -0,0 +1,491 @@
+#####################################################
+#
+# ssum.py
+#     - ctypes binding of Library/src/libssum.so,
+#       every project's solvers in one shared
+#       library (see Library/src/Ssum.h).
+#     - Instances are loaded from a file or wrap a
+#       buffer the caller already has (array.array,
+#       numpy...) without copying it.
+#     - Solves run in this process and return a
+#       Result; ctypes drops the GIL for the call,
+#       so a thread pool solves in parallel.
+#     - Instance.start runs a solve on a thread of
+#       the library's own, the Job it returns has
+#       the best solution so far at any time.
+#     - Instance.edit returns a Problem whose target
+#       and elements can be changed and solved
+#       again from the repaired solution.
+#     - Solver "auto" picks one of the others per
+#       instance from a cost model, SSUM_MODEL
+#       names a calibrated one (bench.py --model).
+#     - Assumes the library has already been
+#       compiled ("make" in Library/src). SSUM_LIB
+#       overrides its path.
+#
+#####################################################
+
+from __future__ import division, print_function
+import ctypes
+import array
+import os
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+
+LIBRARY = os.environ.get('SSUM_LIB',
+                         os.path.join(ROOT, 'Library', 'src', 'libssum.so'))
+
+# Ssum.h
+VERSION = 4
+AUTO = 'auto'
+OK = 0
+UNKNOWN_SOLVER = -1
+NO_MEMORY = -2
+NO_ELEMENT = -3
+
+# Unsigned array typecodes by element width, see Instance.wrap. Python 2
+# has no 'Q', its 'L' is 8 bytes here.
+TYPECODES = {}
+for code in 'QLIHB':
+    try:
+        TYPECODES[array.array(code).itemsize] = code
+    except ValueError:
+        pass
+
+
+class SsumError(Exception):
+    """A library call failed."""
+    pass
+
+
+class Result(ctypes.Structure):
+    """What a solve found, Ssum_Result_t. Times are in nanoseconds. The
+    library fills in no more than bytes of it."""
+    _fields_ = [
+        ('bytes', ctypes.c_uint32),
+        ('solved', ctypes.c_uint32),
+        ('sum', ctypes.c_uint64),
+        ('target', ctypes.c_uint64),
+        ('initial', ctypes.c_uint64),
+        ('time', ctypes.c_uint64),
+        ('moves', ctypes.c_uint64),
+        ('improvements', ctypes.c_uint64),
+        ('restarts', ctypes.c_uint64),
+        ('tabu', ctypes.c_uint64),
+        ('nodes', ctypes.c_uint64),
+        ('subsets', ctypes.c_uint64),
+        ('first', ctypes.c_uint64),
+        ('best', ctypes.c_uint64),
+        ('selected', ctypes.c_uint32),
+        ('solver', ctypes.c_uint32),
+    ]
+
+    def __init__(self):
+        super(Result, self).__init__(bytes=ctypes.sizeof(Result))
+
+    def solver_name(self):
+        """Name of the solver that found the sum, the pick of 'auto'."""
+        return solvers()[self.solver]
+
+    def margin(self):
+        """Relative error of the sum, as in the .out files."""
+        if self.target == 0:
+            return 0 if self.sum == 0 else float('inf')
+        return abs(1 - self.sum / self.target)
+
+    def as_dict(self):
+        return dict((name, getattr(self, name)) for name, _ in self._fields_
+                    if name != 'bytes')
+
+    def __repr__(self):
+        return 'Result(%s)' % ', '.join('%s=%s' % (name, getattr(self, name))
+                                        for name, _ in self._fields_
+                                        if name != 'bytes')
+
+
+def _open(path):
+    lib = ctypes.CDLL(path)
+
+    lib.Ssum_Version.restype = ctypes.c_uint32
+    lib.Ssum_Version.argtypes = []
+    lib.Ssum_Load.restype = ctypes.c_void_p
+    lib.Ssum_Load.argtypes = [ctypes.c_char_p]
+    lib.Ssum_Wrap.restype = ctypes.c_void_p
+    lib.Ssum_Wrap.argtypes = [ctypes.c_char_p, ctypes.c_void_p, ctypes.c_uint32,
+                              ctypes.c_uint32, ctypes.c_uint64]
+    lib.Ssum_Cache.restype = ctypes.c_int
+    lib.Ssum_Cache.argtypes = [ctypes.c_char_p]
+    lib.Ssum_Model.restype = ctypes.c_int
+    lib.Ssum_Model.argtypes = [ctypes.c_char_p]
+    lib.Ssum_Memory.restype = None
+    lib.Ssum_Memory.argtypes = [ctypes.c_uint64]
+    lib.Ssum_Solver.restype = ctypes.c_char_p
+    lib.Ssum_Solver.argtypes = [ctypes.c_uint32]
+    lib.Ssum_Name.restype = ctypes.c_char_p
+    lib.Ssum_Name.argtypes = [ctypes.c_void_p]
+    lib.Ssum_Size.restype = ctypes.c_uint32
+    lib.Ssum_Size.argtypes = [ctypes.c_void_p]
+    lib.Ssum_Target.restype = ctypes.c_uint64
+    lib.Ssum_Target.argtypes = [ctypes.c_void_p]
+    lib.Ssum_Solve.restype = ctypes.c_int
+    lib.Ssum_Solve.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64,
+                               ctypes.c_void_p, ctypes.POINTER(Result)]
+    lib.Ssum_Start.restype = ctypes.c_int
+    lib.Ssum_Start.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64,
+                               ctypes.POINTER(ctypes.c_void_p)]
+    lib.Ssum_Best.restype = ctypes.c_uint64
+    lib.Ssum_Best.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+    lib.Ssum_Wait.restype = ctypes.c_int
+    lib.Ssum_Wait.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+    lib.Ssum_Cancel.restype = None
+    lib.Ssum_Cancel.argtypes = [ctypes.c_void_p]
+    lib.Ssum_Finish.restype = ctypes.c_int
+    lib.Ssum_Finish.argtypes = [ctypes.c_void_p, ctypes.c_void_p,
+                                ctypes.POINTER(Result)]
+    lib.Ssum_Release.restype = None
+    lib.Ssum_Release.argtypes = [ctypes.c_void_p]
+    lib.Ssum_Open.restype = ctypes.c_void_p
+    lib.Ssum_Open.argtypes = [ctypes.c_void_p]
+    lib.Ssum_SetTarget.restype = ctypes.c_int
+    lib.Ssum_SetTarget.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+    lib.Ssum_AddElement.restype = ctypes.c_int
+    lib.Ssum_AddElement.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+    lib.Ssum_RemoveElement.restype = ctypes.c_int
+    lib.Ssum_RemoveElement.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+    lib.Ssum_Edited.restype = ctypes.c_void_p
+    lib.Ssum_Edited.argtypes = [ctypes.c_void_p]
+    lib.Ssum_Current.restype = ctypes.c_uint64
+    lib.Ssum_Current.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+    lib.Ssum_Resolve.restype = ctypes.c_int
+    lib.Ssum_Resolve.argtypes = [ctypes.c_void_p, ctypes.c_char_p,
+                                 ctypes.c_uint64, ctypes.c_void_p,
+                                 ctypes.POINTER(Result)]
+    lib.Ssum_Close.restype = None
+    lib.Ssum_Close.argtypes = [ctypes.c_void_p]
+
+    if lib.Ssum_Version() < VERSION:
+        raise SsumError('%s is version %d, need %d' %
+                        (path, lib.Ssum_Version(), VERSION))
+    if os.environ.get('SSUM_MODEL'):
+        lib.Ssum_Model(_bytes(os.environ['SSUM_MODEL']))
+    return lib
+
+_lib = None
+
+
+def library():
+    """The loaded library, opened on first use."""
+    global _lib
+    if _lib is None:
+        _lib = _open(LIBRARY)
+    return _lib
+
+
+def _bytes(text):
+    return text if isinstance(text, bytes) else text.encode('utf-8')
+
+
+def _text(data):
+    return data if isinstance(data, str) else data.decode('utf-8')
+
+
+def _words(size):
+    return (ctypes.c_uint64 * ((size + 63) // 64))()
+
+
+def _indices(words, size):
+    return [index for index in range(size)
+            if (words[index >> 6] >> (index & 63)) & 1]
+
+
+def _check(status, instance, solver):
+    if status == UNKNOWN_SOLVER:
+        raise SsumError('Unknown solver %s, have %s' %
+                        (solver, ', '.join(solvers())))
+    elif status != OK:
+        raise SsumError('Solving %s with %s failed (%d)' %
+                        (instance.name, solver, status))
+
+
+def solvers():
+    """Names of every solver in the library, e.g. 'p5.tabu'."""
+    names = []
+    while True:
+        name = library().Ssum_Solver(len(names))
+        if name is None:
+            return names
+        names.append(_text(name))
+
+
+def cache(directory):
+    """Cache every following solve's result in directory (None: stop)."""
+    return library().Ssum_Cache(None if directory is None
+                                else _bytes(os.path.abspath(directory))) == 1
+
+
+def model(path):
+    """Load a calibrated cost model for 'auto', see bench.py --model."""
+    return library().Ssum_Model(_bytes(path)) == 1
+
+
+def memory(budget):
+    """Memory budget in bytes of every following 'auto' solve (0: none)."""
+    library().Ssum_Memory(int(budget))
+
+
+class Instance(object):
+    """A loaded or wrapped input set. Any number of threads may solve it."""
+
+    def __init__(self, handle, values=None):
+        self._handle = None
+        if not handle:
+            raise SsumError('Could not create the instance')
+        self._handle = handle
+        # Wrapped values stay referenced as long as the library uses them
+        self._values = values
+
+    @classmethod
+    def load(cls, path):
+        """Load a .dat or binary instance file."""
+        return cls(library().Ssum_Load(_bytes(path)))
+
+    @classmethod
+    def wrap(cls, values, target, name='wrapped'):
+        """Use values in place. Buffers of unsigned 1, 2, 4 or 8 byte ints are
+        not copied; anything else is copied into the narrowest array.array
+        that holds it."""
+        address = None
+        if isinstance(values, array.array) and values.typecode in 'BHILQ':
+            width, count = values.itemsize, len(values)
+            if count:
+                address = values.buffer_info()[0]
+        else:
+            try:
+                # Writable buffers of unsigned ints only, e.g. numpy uint32
+                view = memoryview(values)
+                if (view.format.lstrip('@=<') not in ('B', 'H', 'I', 'L', 'Q') or
+                        view.ndim != 1):
+                    raise TypeError
+                width, count = view.itemsize, len(view)
+                if count:
+                    address = ctypes.addressof(
+                        (ctypes.c_char * (count * width)).from_buffer(values))
+            except (TypeError, ValueError):
+                return cls.wrap(cls._narrow(values), target, name)
+        return cls(library().Ssum_Wrap(_bytes(name), address, width, count,
+                                       target), values)
+
+    @staticmethod
+    def _narrow(values):
+        values = [int(value) for value in values]
+        if values and min(values) < 0:
+            raise SsumError('Element values must not be negative')
+        top = max(values) if values else 0
+        width = 1
+        while width < 8 and top >> (8 * width):
+            width *= 2
+        if top >> 64:
+            raise SsumError('Element values must fit 64 bits')
+        return array.array(TYPECODES[width], values)
+
+    @property
+    def name(self):
+        return _text(library().Ssum_Name(self._handle))
+
+    def __len__(self):
+        return library().Ssum_Size(self._handle)
+
+    @property
+    def target(self):
+        return library().Ssum_Target(self._handle)
+
+    def solve(self, solver, limit=0, solution=False):
+        """Solve with the named solver for at most limit seconds (0: none).
+        Returns the Result, and with solution=True also the indices of the
+        chosen elements."""
+        result = Result()
+        words = None
+        if solution:
+            words = _words(len(self))
+        _check(library().Ssum_Solve(self._handle, _bytes(solver),
+                                    int(limit * 1e9), words,
+                                    ctypes.byref(result)), self, solver)
+        if not solution:
+            return result
+        return result, _indices(words, len(self))
+
+    def start(self, solver, limit=0):
+        """Start solving in the background, see solve. 'auto' runs only the
+        solver the cost model ranks first. Returns the running Job."""
+        handle = ctypes.c_void_p()
+        _check(library().Ssum_Start(self._handle, _bytes(solver),
+                                    int(limit * 1e9), ctypes.byref(handle)),
+               self, solver)
+        return Job(handle.value, self)
+
+    def edit(self):
+        """A Problem on this instance, to change and solve again. The
+        instance itself is never changed."""
+        return Problem(library().Ssum_Open(self._handle), self._values)
+
+    def close(self):
+        if self._handle:
+            library().Ssum_Release(self._handle)
+            self._handle = None
+            self._values = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        if _lib is not None:
+            self.close()
+
+
+class Job(object):
+    """A solve running in the background, see Instance.start. Keeps its
+    instance open until finished."""
+
+    def __init__(self, handle, instance):
+        self._handle = handle
+        self._instance = instance
+
+    def best(self, solution=False):
+        """Sum of the best solution so far, with solution=True also the
+        indices of its elements."""
+        words = _words(len(self._instance)) if solution else None
+        total = library().Ssum_Best(self._handle, words)
+        if not solution:
+            return total
+        return total, _indices(words, len(self._instance))
+
+    def wait(self, timeout=None):
+        """Wait at most timeout seconds (None: until done). True if done."""
+        timeout = (2 ** 64 - 1) if timeout is None else int(timeout * 1e9)
+        return library().Ssum_Wait(self._handle, timeout) == 1
+
+    def cancel(self):
+        """Ask the solver to stop, finish then reports its best so far."""
+        library().Ssum_Cancel(self._handle)
+
+    def finish(self, solution=False):
+        """Stop the solve if still running and return its Result, like
+        Instance.solve. The job is gone afterwards."""
+        if not self._handle:
+            raise SsumError('Job already finished')
+        result = Result()
+        size = len(self._instance)
+        words = _words(size) if solution else None
+        library().Ssum_Finish(self._handle, words, ctypes.byref(result))
+        self._handle = None
+        self._instance = None
+        if not solution:
+            return result
+        return result, _indices(words, size)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        if self._handle:
+            self.finish()
+
+    def __del__(self):
+        if _lib is not None and self._handle:
+            self.finish()
+
+
+class Problem(object):
+    """An instance being edited and its solution, see Instance.edit. One
+    thread at a time."""
+
+    def __init__(self, handle, values=None):
+        self._handle = None
+        if not handle:
+            raise SsumError('Could not create the problem')
+        self._handle = handle
+        # A new target alone still shares wrapped values
+        self._values = values
+
+    def _edited(self):
+        return library().Ssum_Edited(self._handle)
+
+    def _check(self, status):
+        if status == NO_ELEMENT:
+            raise IndexError('No such element')
+        elif status != OK:
+            raise SsumError('Editing %s failed (%d)' % (self.name, status))
+
+    @property
+    def name(self):
+        return _text(library().Ssum_Name(self._edited()))
+
+    def __len__(self):
+        return library().Ssum_Size(self._edited())
+
+    @property
+    def target(self):
+        return library().Ssum_Target(self._edited())
+
+    def set_target(self, target):
+        """Change the target, the solution is trimmed or topped up to fit."""
+        self._check(library().Ssum_SetTarget(self._handle, int(target)))
+
+    def add(self, value):
+        """Append an element, returns its index."""
+        value = int(value)
+        if value < 0 or value >> 64:
+            raise SsumError('Element values must fit 64 bits unsigned')
+        self._check(library().Ssum_AddElement(self._handle, value))
+        return len(self) - 1
+
+    def remove(self, index):
+        """Remove an element, the ones after it move down one index."""
+        size = len(self)
+        if not -size <= index < size:
+            raise IndexError('No element %d of %d' % (index, size))
+        if index < 0:
+            index += size
+        self._check(library().Ssum_RemoveElement(self._handle, index))
+
+    def best(self, solution=False):
+        """Sum of the current solution, with solution=True also the indices
+        of its elements."""
+        size = len(self)
+        words = _words(size) if solution else None
+        total = library().Ssum_Current(self._handle, words)
+        if not solution:
+            return total
+        return total, _indices(words, size)
+
+    def solve(self, solver, limit=0, solution=False):
+        """Solve again from the current solution, see Instance.solve. Not
+        cached."""
+        result = Result()
+        size = len(self)
+        words = _words(size) if solution else None
+        _check(library().Ssum_Resolve(self._handle, _bytes(solver),
+                                      int(limit * 1e9), words,
+                                      ctypes.byref(result)), self, solver)
+        if not solution:
+            return result
+        return result, _indices(words, size)
+
+    def close(self):
+        if self._handle:
+            library().Ssum_Close(self._handle)
+            self._handle = None
+            self._values = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        if _lib is not None:
+            self.close()